@@ -30,19 +30,21 @@ def test_mnist_cnn(FLAGS):
     x_test_batch = x_test[:FLAGS.batch_size]
     y_test_batch = y_test[:FLAGS.batch_size]
 
-    data = x_test_batch.flatten('C')
     print('Client batch size from FLAG:', FLAGS.batch_size)
 
     port = 34000
 
+    # The client encrypts straight from the array, and decrypts into a new
+    # array with the shape of the result
     encrypt_str = 'encrypt' if FLAGS.encrypt_data else 'plain'
-    client = pyhe_client.HESealClient(FLAGS.hostname, port, FLAGS.batch_size,
-                                      {'input': (encrypt_str, data)})
-
-    results = client.get_results()
-    results = np.round(results, 2)
-
-    y_pred_reshape = np.array(results).reshape(FLAGS.batch_size, 10)
+    client = pyhe_client.HESealClient('tcp://{}:{}'.format(
+        FLAGS.hostname, port))
+    results = client.infer_array({
+        'input': (encrypt_str, x_test_batch)
+    }, FLAGS.batch_size).get()
+    client.close_connection()
+
+    y_pred_reshape = np.round(results, 2).reshape(FLAGS.batch_size, 10)
     with np.printoptions(precision=3, suppress=True):
         print(y_pred_reshape)
 
@@ -48,6 +48,9 @@ def server_config_from_flags(FLAGS, tensor_param_name):
         FLAGS.enable_client)).encode()
     if FLAGS.enable_client:
         server_config.parameter_map[tensor_param_name].s = b'client_input'
+    if FLAGS.server_uri:
+        server_config.parameter_map[
+            'server_uri'].s = FLAGS.server_uri.encode()
 
     config = tf.compat.v1.ConfigProto()
     config.MergeFrom(
@@ -95,6 +98,12 @@ if __name__ == '__main__':
         help=
         'Filename containing json description of encryption parameters, or json description itself'
     )
+    parser.add_argument(
+        '--server_uri',
+        type=str,
+        default='',
+        help='URI the server listens on, e.g. tcp://0.0.0.0:34000, '
+        'unix:///tmp/he.sock, or shm:///tmp/he.sock')
 
     FLAGS, unparsed = parser.parse_known_args()
     main(FLAGS)
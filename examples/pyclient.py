@@ -25,9 +25,12 @@ def main(FLAGS):
     port = 34000
     batch_size = 1
 
-    client = pyhe_client.HESealClient(
-        FLAGS.hostname, port, batch_size,
-        {'client_parameter_name': ('encrypt', data)})
+    inputs = {'client_parameter_name': ('encrypt', data)}
+    if FLAGS.server_uri:
+        client = pyhe_client.HESealClient(FLAGS.server_uri, batch_size, inputs)
+    else:
+        client = pyhe_client.HESealClient(FLAGS.hostname, port, batch_size,
+                                          inputs)
 
     results = client.get_results()
 
@@ -38,6 +41,12 @@ if __name__ == '__main__':
     parser = argparse.ArgumentParser()
     parser.add_argument(
         '--hostname', type=str, default='localhost', help='Hostname of server')
+    parser.add_argument(
+        '--server_uri',
+        type=str,
+        default='',
+        help='URI of server, e.g. tcp://localhost:34000, '
+        'unix:///tmp/he.sock, or shm:///tmp/he.sock. Overrides hostname')
 
     FLAGS, unparsed = parser.parse_known_args()
 
@@ -16,31 +16,220 @@
 
 #include "pyhe_client/he_seal_client.hpp"
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <chrono>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "ngraph/check.hpp"
 #include "seal/he_seal_client.hpp"
 
 namespace py = pybind11;
 
+namespace {
+using ngraph::Shape;
+namespace element = ngraph::element;
+
+// NumPy arrays an inference reads from and decrypts into. Released with the
+// GIL held, possibly from a client worker thread
+struct ArrayInferenceState {
+  std::vector<py::array> inputs;
+  py::object output{py::none()};
+};
+
+std::shared_ptr<ArrayInferenceState> make_array_inference_state() {
+  return std::shared_ptr<ArrayInferenceState>(
+      new ArrayInferenceState, [](ArrayInferenceState* state) {
+        py::gil_scoped_acquire gil;
+        delete state;
+      });
+}
+
+// Destroys a client with the GIL released: the destructor joins the I/O
+// thread, whose handlers take the GIL to allocate and release NumPy arrays
+struct ReleaseGilDelete {
+  void operator()(ngraph::runtime::he::HESealClient* client) const {
+    py::gil_scoped_release release;
+    delete client;
+  }
+};
+
+// Inference on NumPy arrays queued by infer_array()
+struct ArrayInferenceFuture {
+  std::shared_future<Shape> shape;
+  std::shared_ptr<ArrayInferenceState> state;
+};
+
+// Returns the datatype of a float32 or float64 array, or undefined
+element::Type array_type(const py::array& array) {
+  if (py::isinstance<py::array_t<float>>(array)) {
+    return element::f32;
+  }
+  if (py::isinstance<py::array_t<double>>(array)) {
+    return element::f64;
+  }
+  return element::undefined;
+}
+
+// Returns a new array of the given shape, in the datatype of the result if
+// it is float32, or float64 otherwise
+py::array new_result_array(const Shape& shape, const element::Type& type) {
+  std::vector<size_t> array_shape{shape.begin(), shape.end()};
+  if (type == element::f32) {
+    return py::array_t<float>(array_shape);
+  }
+  return py::array_t<double>(array_shape);
+}
+
+// Returns a view of the array with the shape of the result
+py::object reshape(const py::object& array, const Shape& shape) {
+  py::tuple array_shape(shape.size());
+  for (size_t i = 0; i < shape.size(); ++i) {
+    array_shape[i] = shape[i];
+  }
+  return array.attr("reshape")(array_shape);
+}
+}  // namespace
+
 void regclass_pyhe_client(py::module m) {
-  py::class_<ngraph::runtime::he::HESealClient> he_seal_client(m,
-                                                               "HESealClient");
+  using ngraph::runtime::he::HESealClient;
+  using ngraph::runtime::he::HETensorConfigMap;
+  using InferenceFuture = std::shared_future<std::vector<double>>;
+
+  // Waiting on the server releases the GIL, so other Python threads run
+  py::class_<InferenceFuture> inference_future(m, "InferenceFuture");
+  inference_future.doc() = "Results of an inference queued by infer()";
+  inference_future.def("get", &InferenceFuture::get,
+                       py::call_guard<py::gil_scoped_release>());
+  inference_future.def("ready", [](const InferenceFuture& future) {
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  });
+
+  py::class_<ArrayInferenceFuture> array_inference_future(
+      m, "ArrayInferenceFuture");
+  array_inference_future.doc() =
+      "Result of an inference queued by infer_array()";
+  array_inference_future.def("get", [](const ArrayInferenceFuture& future) {
+    Shape shape;
+    {
+      py::gil_scoped_release release;
+      shape = future.shape.get();
+    }
+    return reshape(future.state->output, shape);
+  });
+  array_inference_future.def("ready", [](const ArrayInferenceFuture& future) {
+    return future.shape.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  });
+
+  py::class_<HESealClient, std::unique_ptr<HESealClient, ReleaseGilDelete>>
+      he_seal_client(m, "HESealClient");
   he_seal_client.doc() = "he_seal_client wraps ngraph::he::HESealClient";
 
+  he_seal_client.def(py::init<const std::string&, const std::size_t,
+                              const std::size_t,
+                              const HETensorConfigMap<float>&>(),
+                     py::call_guard<py::gil_scoped_release>());
+  he_seal_client.def(
+      py::init<const std::string&, const std::size_t,
+               const HETensorConfigMap<float>&>(),
+      py::call_guard<py::gil_scoped_release>());
+  he_seal_client.def(py::init<const std::string&>(),
+                     py::call_guard<py::gil_scoped_release>());
+
+  he_seal_client.def(
+      "infer",
+      [](HESealClient& client, const HETensorConfigMap<float>& inputs,
+         std::size_t batch_size) {
+        return client.infer(inputs, batch_size).share();
+      },
+      py::arg("inputs"), py::arg("batch_size"),
+      py::call_guard<py::gil_scoped_release>());
+  // Encrypts straight from C-contiguous float32 or float64 arrays, which are
+  // only copied if they are not, and decrypts straight into the output array
   he_seal_client.def(
-      py::init<const std::string&, const std::size_t, const std::size_t,
-               const ngraph::runtime::he::HETensorConfigMap<float>&>());
-
-  he_seal_client.def("set_seal_context",
-                     &ngraph::runtime::he::HESealClient::set_seal_context);
-  he_seal_client.def("is_done", &ngraph::runtime::he::HESealClient::is_done);
-  he_seal_client.def("get_results",
-                     &ngraph::runtime::he::HESealClient::get_results);
-  he_seal_client.def("close_connection",
-                     &ngraph::runtime::he::HESealClient::close_connection);
+      "infer_array",
+      [](HESealClient& client, const py::dict& inputs, std::size_t batch_size,
+         const py::object& out) {
+        using ngraph::runtime::he::HEInputView;
+        using ngraph::runtime::he::HEInputViewMap;
+        using ngraph::runtime::he::HEOutputView;
+
+        auto state = make_array_inference_state();
+        HEInputViewMap input_views;
+        for (const auto& [name, config_values] : inputs) {
+          auto config_array = config_values.cast<py::tuple>();
+          NGRAPH_CHECK(config_array.size() == 2,
+                       "Inputs must map names to (config, array) tuples");
+          py::array array = py::array::ensure(py::object(config_array[1]),
+                                              py::array::c_style);
+          NGRAPH_CHECK(array, "Input ", name.cast<std::string>(),
+                       " is not an array");
+          if (array_type(array) == element::undefined) {
+            array = py::array_t<double, py::array::c_style |
+                                            py::array::forcecast>::
+                ensure(array);
+          }
+          input_views[name.cast<std::string>()] =
+              HEInputView{config_array[0].cast<std::string>(), array.data(),
+                          static_cast<size_t>(array.size()),
+                          array_type(array)};
+          state->inputs.emplace_back(std::move(array));
+        }
+        if (!out.is_none()) {
+          auto out_array = out.cast<py::array>();
+          NGRAPH_CHECK(array_type(out_array) != element::undefined,
+                       "Output must be a float32 or float64 array");
+          NGRAPH_CHECK(out_array.flags() & py::array::c_style,
+                       "Output must be C-contiguous");
+          NGRAPH_CHECK(out_array.writeable(), "Output must be writeable");
+          state->output = out_array;
+        }
+
+        // The state outlives the allocator, since the inference keeps it alive
+        auto allocate_output = [raw_state = state.get()](
+                                   const Shape& shape,
+                                   const element::Type& type) {
+          py::gil_scoped_acquire gil;
+          if (raw_state->output.is_none()) {
+            raw_state->output = new_result_array(shape, type);
+          }
+          auto output = raw_state->output.cast<py::array>();
+          return HEOutputView{output.mutable_data(),
+                              static_cast<size_t>(output.size()),
+                              array_type(output)};
+        };
+
+        std::future<Shape> shape;
+        {
+          py::gil_scoped_release release;
+          shape = client.infer(input_views, batch_size, allocate_output, state);
+        }
+        return ArrayInferenceFuture{shape.share(), state};
+      },
+      py::arg("inputs"), py::arg("batch_size"), py::arg("out") = py::none());
+  he_seal_client.def("set_seal_context", &HESealClient::set_seal_context);
+  he_seal_client.def("is_done", &HESealClient::is_done);
+  he_seal_client.def("get_results", &HESealClient::get_results,
+                     py::call_guard<py::gil_scoped_release>());
+  he_seal_client.def("close_connection", &HESealClient::close_connection,
+                     py::call_guard<py::gil_scoped_release>());
+  he_seal_client.def("zero_pool_stats", [](const HESealClient& client) {
+    auto stats = client.zero_pool_stats();
+    py::dict result;
+    result["size"] = stats.size;
+    result["capacity"] = stats.capacity;
+    result["refill_threads"] = stats.refill_threads;
+    result["hits"] = stats.hits;
+    result["misses"] = stats.misses;
+    result["hit_rate"] = stats.hit_rate();
+    return result;
+  });
 }
@@ -0,0 +1,77 @@
+# ==============================================================================
+#  Copyright 2018-2019 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+
+# Run with the pyhe_client wheel, ngraph_bridge and tensorflow installed:
+#   python -m unittest discover -s python/test
+
+import os
+import subprocess
+import sys
+import time
+import unittest
+
+import numpy as np
+
+EXAMPLES_DIR = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', '..', 'examples')
+SERVER_URI = 'tcp://localhost:34000'
+TIMEOUT_SECONDS = 300
+
+
+def drop_client_during_inference():
+    import pyhe_client
+
+    client = pyhe_client.HESealClient(SERVER_URI)
+    inputs = {
+        'client_parameter_name': ('encrypt', np.array([[2, 4, 6, 8]],
+                                                      dtype=np.float32))
+    }
+    future = client.infer_array(inputs, 1)
+
+    # Hold the GIL until the result arrives, so the client worker blocks
+    # allocating the output array, then drop the client while holding it
+    sys.setswitchinterval(TIMEOUT_SECONDS)
+    deadline = time.time() + 120
+    while not future.ready() and time.time() < deadline:
+        pass
+    del client
+    sys.setswitchinterval(0.005)
+
+
+class PyheClientTest(unittest.TestCase):
+    def test_drop_client_during_inference(self):
+        server = subprocess.Popen([
+            sys.executable,
+            os.path.join(EXAMPLES_DIR, 'ax.py'), '--backend=HE_SEAL',
+            '--enable_client=yes', '--server_uri=' + SERVER_URI
+        ])
+        try:
+            # The client runs in its own process, so a deadlock fails the
+            # test through the timeout rather than hanging it
+            client = subprocess.run(
+                [sys.executable, os.path.abspath(__file__), '--drop-client'],
+                timeout=TIMEOUT_SECONDS)
+            self.assertEqual(client.returncode, 0)
+        finally:
+            server.kill()
+            server.wait()
+
+
+if __name__ == '__main__':
+    if sys.argv[1:] == ['--drop-client']:
+        drop_client_during_inference()
+    else:
+        unittest.main()
@@ -0,0 +1,431 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "dense_kernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+template <typename Func>
+void dense_binary(const std::vector<double>& arg0,
+                  const std::vector<double>& arg1, std::vector<double>& out,
+                  Func func) {
+  NGRAPH_CHECK(arg0.size() == arg1.size(), "Argument sizes ", arg0.size(),
+               " and ", arg1.size(), " don't match");
+  out.resize(arg0.size());
+  const double* arg0_data = arg0.data();
+  const double* arg1_data = arg1.data();
+  double* out_data = out.data();
+  const size_t count = out.size();
+#pragma omp parallel for simd
+  for (size_t i = 0; i < count; ++i) {
+    out_data[i] = func(arg0_data[i], arg1_data[i]);
+  }
+}
+
+template <typename Func>
+void dense_unary(const std::vector<double>& arg, std::vector<double>& out,
+                 Func func) {
+  out.resize(arg.size());
+  const double* arg_data = arg.data();
+  double* out_data = out.data();
+  const size_t count = out.size();
+#pragma omp parallel for simd
+  for (size_t i = 0; i < count; ++i) {
+    out_data[i] = func(arg_data[i]);
+  }
+}
+
+/// \brief Returns the row-major index in a tensor whose axis i has stride
+/// axis_strides[i] of the element at row-major index in shape
+size_t source_index(size_t index, const Shape& shape,
+                    const std::vector<size_t>& axis_strides) {
+  size_t source = 0;
+  for (size_t axis = shape.size(); axis-- > 0;) {
+    source += (index % shape[axis]) * axis_strides[axis];
+    index /= shape[axis];
+  }
+  return source;
+}
+
+/// \brief Returns, for each position f of a window over the spatial axes and
+/// each spatial output position o, the offset within one input channel of the
+/// element at offsets[f * shape_size(out_shape) + o], or -1 where the window
+/// lies in the padding or between dilated elements
+std::vector<std::ptrdiff_t> window_offsets(
+    const Shape& in_shape, const Shape& out_shape, const Shape& window_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const Strides& data_dilation_strides) {
+  const size_t spatial_dims = in_shape.size();
+  NGRAPH_CHECK(out_shape.size() == spatial_dims &&
+                   window_shape.size() == spatial_dims &&
+                   window_movement_strides.size() == spatial_dims &&
+                   window_dilation_strides.size() == spatial_dims &&
+                   padding_below.size() == spatial_dims &&
+                   data_dilation_strides.size() == spatial_dims,
+               "Window attributes don't match the input rank");
+
+  const size_t out_size = shape_size(out_shape);
+  const size_t window_size = shape_size(window_shape);
+  const Strides in_strides = row_major_strides(in_shape);
+  std::vector<std::ptrdiff_t> offsets(window_size * out_size);
+
+#pragma omp parallel for
+  for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+    std::vector<size_t> window_coord(spatial_dims);
+    size_t remainder = window_idx;
+    for (size_t axis = spatial_dims; axis-- > 0;) {
+      window_coord[axis] = remainder % window_shape[axis];
+      remainder /= window_shape[axis];
+    }
+    for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+      std::ptrdiff_t offset = 0;
+      remainder = out_idx;
+      for (size_t axis = spatial_dims; axis-- > 0;) {
+        const auto out_coord =
+            static_cast<std::ptrdiff_t>(remainder % out_shape[axis]);
+        remainder /= out_shape[axis];
+
+        const auto dilation =
+            static_cast<std::ptrdiff_t>(data_dilation_strides[axis]);
+        const auto dilated_extent =
+            (static_cast<std::ptrdiff_t>(in_shape[axis]) - 1) * dilation + 1;
+        const std::ptrdiff_t position =
+            out_coord *
+                static_cast<std::ptrdiff_t>(window_movement_strides[axis]) +
+            static_cast<std::ptrdiff_t>(window_coord[axis] *
+                                        window_dilation_strides[axis]) -
+            padding_below[axis];
+        if (offset < 0 || position < 0 || position >= dilated_extent ||
+            position % dilation != 0) {
+          offset = -1;
+        } else {
+          offset += (position / dilation) *
+                    static_cast<std::ptrdiff_t>(in_strides[axis]);
+        }
+      }
+      offsets[window_idx * out_size + out_idx] = offset;
+    }
+  }
+  return offsets;
+}
+}  // namespace
+
+void dense_add(const std::vector<double>& arg0, const std::vector<double>& arg1,
+               std::vector<double>& out) {
+  dense_binary(arg0, arg1, out, [](double x, double y) { return x + y; });
+}
+
+void dense_subtract(const std::vector<double>& arg0,
+                    const std::vector<double>& arg1, std::vector<double>& out) {
+  dense_binary(arg0, arg1, out, [](double x, double y) { return x - y; });
+}
+
+void dense_multiply(const std::vector<double>& arg0,
+                    const std::vector<double>& arg1, std::vector<double>& out) {
+  dense_binary(arg0, arg1, out, [](double x, double y) { return x * y; });
+}
+
+void dense_divide(const std::vector<double>& arg0,
+                  const std::vector<double>& arg1, std::vector<double>& out) {
+  dense_binary(arg0, arg1, out, [](double x, double y) { return x / y; });
+}
+
+void dense_minimum(const std::vector<double>& arg0,
+                   const std::vector<double>& arg1, std::vector<double>& out) {
+  dense_binary(arg0, arg1, out,
+               [](double x, double y) { return std::min(x, y); });
+}
+
+void dense_negate(const std::vector<double>& arg, std::vector<double>& out) {
+  dense_unary(arg, out, [](double x) { return -x; });
+}
+
+void dense_relu(const std::vector<double>& arg, std::vector<double>& out) {
+  dense_unary(arg, out, [](double x) { return x > 0 ? x : 0.; });
+}
+
+void dense_bounded_relu(const std::vector<double>& arg,
+                        std::vector<double>& out, float alpha) {
+  dense_unary(arg, out, [alpha](double x) {
+    return x > alpha ? static_cast<double>(alpha) : (x > 0 ? x : 0.);
+  });
+}
+
+void dense_dot(const std::vector<double>& arg0, const std::vector<double>& arg1,
+               std::vector<double>& out, const Shape& arg0_shape,
+               const Shape& arg1_shape, size_t reduction_axes_count) {
+  NGRAPH_CHECK(reduction_axes_count <= arg0_shape.size() &&
+                   reduction_axes_count <= arg1_shape.size(),
+               "Too many reduction axes ", reduction_axes_count);
+  const auto reduction_axes =
+      static_cast<std::ptrdiff_t>(reduction_axes_count);
+  NGRAPH_CHECK(std::equal(arg0_shape.end() - reduction_axes, arg0_shape.end(),
+                          arg1_shape.begin()),
+               "Reduction axes of ", arg0_shape, " and ", arg1_shape,
+               " don't match");
+  NGRAPH_CHECK(arg0.size() == shape_size(arg0_shape) &&
+                   arg1.size() == shape_size(arg1_shape),
+               "Argument sizes don't match their shapes");
+
+  // Contract as a (rows x inner) by (inner x cols) matrix product
+  const size_t inner =
+      shape_size(Shape(arg0_shape.end() - reduction_axes, arg0_shape.end()));
+  const size_t rows = shape_size(
+      Shape(arg0_shape.begin(), arg0_shape.end() - reduction_axes));
+  const size_t cols = shape_size(
+      Shape(arg1_shape.begin() + reduction_axes, arg1_shape.end()));
+  out.assign(rows * cols, 0.);
+
+  const double* arg0_data = arg0.data();
+  const double* arg1_data = arg1.data();
+  double* out_data = out.data();
+#pragma omp parallel for
+  for (size_t row = 0; row < rows; ++row) {
+    double* out_row = out_data + row * cols;
+    for (size_t k = 0; k < inner; ++k) {
+      const double scale = arg0_data[row * inner + k];
+      const double* arg1_row = arg1_data + k * cols;
+#pragma omp simd
+      for (size_t col = 0; col < cols; ++col) {
+        out_row[col] += scale * arg1_row[col];
+      }
+    }
+  }
+}
+
+void dense_convolution(
+    const std::vector<double>& arg0, const std::vector<double>& arg1,
+    std::vector<double>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& /*padding_above*/,
+    const Strides& data_dilation_strides) {
+  NGRAPH_CHECK(arg0_shape.size() >= 2 &&
+                   arg1_shape.size() == arg0_shape.size() &&
+                   out_shape.size() == arg0_shape.size(),
+               "Convolution shapes ", arg0_shape, ", ", arg1_shape, " and ",
+               out_shape, " have mismatched ranks");
+  NGRAPH_CHECK(arg1_shape[1] == arg0_shape[1], "Filters ", arg1_shape,
+               " don't match the channels of ", arg0_shape);
+  NGRAPH_CHECK(arg0.size() == shape_size(arg0_shape) &&
+                   arg1.size() == shape_size(arg1_shape),
+               "Argument sizes don't match their shapes");
+
+  const size_t batch_size = arg0_shape[0];
+  const size_t in_channels = arg0_shape[1];
+  const size_t out_channels = arg1_shape[0];
+  const Shape in_spatial(arg0_shape.begin() + 2, arg0_shape.end());
+  const Shape filter_spatial(arg1_shape.begin() + 2, arg1_shape.end());
+  const Shape out_spatial(out_shape.begin() + 2, out_shape.end());
+  const size_t in_size = shape_size(in_spatial);
+  const size_t filter_size = shape_size(filter_spatial);
+  const size_t out_size = shape_size(out_spatial);
+
+  // The window positions are the same for every image and channel
+  const std::vector<std::ptrdiff_t> offsets = window_offsets(
+      in_spatial, out_spatial, filter_spatial, window_movement_strides,
+      window_dilation_strides, padding_below, data_dilation_strides);
+  out.assign(batch_size * out_channels * out_size, 0.);
+
+  const double* arg0_data = arg0.data();
+  const double* arg1_data = arg1.data();
+  double* out_data = out.data();
+#pragma omp parallel for collapse(2)
+  for (size_t batch = 0; batch < batch_size; ++batch) {
+    for (size_t out_channel = 0; out_channel < out_channels; ++out_channel) {
+      double* out_row =
+          out_data + (batch * out_channels + out_channel) * out_size;
+      for (size_t in_channel = 0; in_channel < in_channels; ++in_channel) {
+        const double* in =
+            arg0_data + (batch * in_channels + in_channel) * in_size;
+        const double* filter =
+            arg1_data + (out_channel * in_channels + in_channel) * filter_size;
+        for (size_t filter_idx = 0; filter_idx < filter_size; ++filter_idx) {
+          const double weight = filter[filter_idx];
+          const std::ptrdiff_t* offset = offsets.data() + filter_idx * out_size;
+#pragma omp simd
+          for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+            out_row[out_idx] +=
+                offset[out_idx] < 0 ? 0. : weight * in[offset[out_idx]];
+          }
+        }
+      }
+    }
+  }
+}
+
+void dense_avg_pool(const std::vector<double>& arg, std::vector<double>& out,
+                    const Shape& arg_shape, const Shape& out_shape,
+                    const Shape& window_shape,
+                    const Strides& window_movement_strides,
+                    const Shape& padding_below, const Shape& /*padding_above*/,
+                    bool include_padding_in_avg_computation) {
+  NGRAPH_CHECK(arg_shape.size() >= 2 && out_shape.size() == arg_shape.size(),
+               "AvgPool shapes ", arg_shape, " and ", out_shape,
+               " have mismatched ranks");
+  NGRAPH_CHECK(arg.size() == shape_size(arg_shape),
+               "Argument size doesn't match its shape");
+
+  const Shape in_spatial(arg_shape.begin() + 2, arg_shape.end());
+  const Shape out_spatial(out_shape.begin() + 2, out_shape.end());
+  const size_t in_size = shape_size(in_spatial);
+  const size_t out_size = shape_size(out_spatial);
+  const size_t window_size = shape_size(window_shape);
+  const size_t channels = arg_shape[0] * arg_shape[1];
+
+  const std::vector<std::ptrdiff_t> offsets = window_offsets(
+      in_spatial, out_spatial, window_shape, window_movement_strides,
+      Strides(window_shape.size(), 1),
+      CoordinateDiff(padding_below.begin(), padding_below.end()),
+      Strides(window_shape.size(), 1));
+
+  // The divisor of each output position, shared by all channels
+  std::vector<double> divisors(out_size, static_cast<double>(window_size));
+  if (!include_padding_in_avg_computation) {
+    for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+      size_t n_elements = 0;
+      for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+        n_elements += offsets[window_idx * out_size + out_idx] >= 0 ? 1 : 0;
+      }
+      NGRAPH_CHECK(n_elements != 0, "AvgPool num_elements must be non-zero");
+      divisors[out_idx] = static_cast<double>(n_elements);
+    }
+  }
+  out.assign(channels * out_size, 0.);
+
+  const double* arg_data = arg.data();
+  double* out_data = out.data();
+#pragma omp parallel for
+  for (size_t channel = 0; channel < channels; ++channel) {
+    const double* in = arg_data + channel * in_size;
+    double* out_row = out_data + channel * out_size;
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      const std::ptrdiff_t* offset = offsets.data() + window_idx * out_size;
+#pragma omp simd
+      for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+        out_row[out_idx] += offset[out_idx] < 0 ? 0. : in[offset[out_idx]];
+      }
+    }
+#pragma omp simd
+    for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+      out_row[out_idx] /= divisors[out_idx];
+    }
+  }
+}
+
+void dense_max_pool(const std::vector<double>& arg, std::vector<double>& out,
+                    const Shape& arg_shape, const Shape& out_shape,
+                    const Shape& window_shape,
+                    const Strides& window_movement_strides,
+                    const Shape& padding_below,
+                    const Shape& /*padding_above*/) {
+  NGRAPH_CHECK(arg_shape.size() >= 2 && out_shape.size() == arg_shape.size(),
+               "MaxPool shapes ", arg_shape, " and ", out_shape,
+               " have mismatched ranks");
+  NGRAPH_CHECK(arg.size() == shape_size(arg_shape),
+               "Argument size doesn't match its shape");
+
+  const Shape in_spatial(arg_shape.begin() + 2, arg_shape.end());
+  const Shape out_spatial(out_shape.begin() + 2, out_shape.end());
+  const size_t in_size = shape_size(in_spatial);
+  const size_t out_size = shape_size(out_spatial);
+  const size_t window_size = shape_size(window_shape);
+  const size_t channels = arg_shape[0] * arg_shape[1];
+
+  const std::vector<std::ptrdiff_t> offsets = window_offsets(
+      in_spatial, out_spatial, window_shape, window_movement_strides,
+      Strides(window_shape.size(), 1),
+      CoordinateDiff(padding_below.begin(), padding_below.end()),
+      Strides(window_shape.size(), 1));
+  out.assign(channels * out_size, std::numeric_limits<double>::lowest());
+
+  const double* arg_data = arg.data();
+  double* out_data = out.data();
+#pragma omp parallel for
+  for (size_t channel = 0; channel < channels; ++channel) {
+    const double* in = arg_data + channel * in_size;
+    double* out_row = out_data + channel * out_size;
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      const std::ptrdiff_t* offset = offsets.data() + window_idx * out_size;
+#pragma omp simd
+      for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+        if (offset[out_idx] >= 0) {
+          out_row[out_idx] = std::max(out_row[out_idx], in[offset[out_idx]]);
+        }
+      }
+    }
+  }
+}
+
+void dense_broadcast(const std::vector<double>& arg, std::vector<double>& out,
+                     const Shape& arg_shape, const Shape& out_shape,
+                     const AxisSet& broadcast_axes) {
+  NGRAPH_CHECK(arg_shape.size() + broadcast_axes.size() == out_shape.size(),
+               "Cannot broadcast ", arg_shape, " to ", out_shape);
+  NGRAPH_CHECK(arg.size() == shape_size(arg_shape),
+               "Argument size doesn't match its shape");
+
+  const Strides arg_strides = row_major_strides(arg_shape);
+  std::vector<size_t> axis_strides(out_shape.size(), 0);
+  size_t arg_axis = 0;
+  for (size_t axis = 0; axis < out_shape.size(); ++axis) {
+    if (broadcast_axes.find(axis) == broadcast_axes.end()) {
+      axis_strides[axis] = arg_strides[arg_axis++];
+    }
+  }
+
+  out.resize(shape_size(out_shape));
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < out.size(); ++out_idx) {
+    out[out_idx] = arg[source_index(out_idx, out_shape, axis_strides)];
+  }
+}
+
+void dense_reshape(const std::vector<double>& arg, std::vector<double>& out,
+                   const Shape& arg_shape, const AxisVector& input_order) {
+  NGRAPH_CHECK(input_order.size() == arg_shape.size(), "Input order ",
+               input_order, " doesn't match the rank of ", arg_shape);
+  NGRAPH_CHECK(arg.size() == shape_size(arg_shape),
+               "Argument size doesn't match its shape");
+
+  if (std::is_sorted(input_order.begin(), input_order.end())) {
+    out = arg;
+    return;
+  }
+  const Strides arg_strides = row_major_strides(arg_shape);
+  Shape permuted_shape(arg_shape.size());
+  std::vector<size_t> axis_strides(arg_shape.size());
+  for (size_t axis = 0; axis < input_order.size(); ++axis) {
+    permuted_shape[axis] = arg_shape[input_order[axis]];
+    axis_strides[axis] = arg_strides[input_order[axis]];
+  }
+
+  out.resize(arg.size());
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < out.size(); ++out_idx) {
+    out[out_idx] = arg[source_index(out_idx, permuted_shape, axis_strides)];
+  }
+}
+
+}  // namespace ngraph::runtime::he
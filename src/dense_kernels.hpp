@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "ngraph/axis_set.hpp"
+#include "ngraph/axis_vector.hpp"
+#include "ngraph/coordinate_diff.hpp"
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
+
+namespace ngraph::runtime::he {
+// Kernels on contiguous, row-major buffers holding one plaintext value per
+// tensor element. They evaluate ops whose operands are all unpacked
+// plaintexts, without the per-element overhead of HEType.
+
+/// \brief Adds two buffers element-wise
+/// \param[in] arg0 Values to add
+/// \param[in] arg1 Values to add, of the same size as arg0
+/// \param[out] out Stores the sum. Resized to match arg0
+void dense_add(const std::vector<double>& arg0, const std::vector<double>& arg1,
+               std::vector<double>& out);
+
+/// \brief Subtracts arg1 from arg0 element-wise
+void dense_subtract(const std::vector<double>& arg0,
+                    const std::vector<double>& arg1, std::vector<double>& out);
+
+/// \brief Multiplies two buffers element-wise
+void dense_multiply(const std::vector<double>& arg0,
+                    const std::vector<double>& arg1, std::vector<double>& out);
+
+/// \brief Divides arg0 by arg1 element-wise
+void dense_divide(const std::vector<double>& arg0,
+                  const std::vector<double>& arg1, std::vector<double>& out);
+
+/// \brief Computes the element-wise minimum of two buffers
+void dense_minimum(const std::vector<double>& arg0,
+                   const std::vector<double>& arg1, std::vector<double>& out);
+
+/// \brief Negates each element
+void dense_negate(const std::vector<double>& arg, std::vector<double>& out);
+
+/// \brief Computes max(x, 0) of each element
+void dense_relu(const std::vector<double>& arg, std::vector<double>& out);
+
+/// \brief Computes min(max(x, 0), alpha) of each element
+void dense_bounded_relu(const std::vector<double>& arg,
+                        std::vector<double>& out, float alpha);
+
+/// \brief Computes a tensor dot product, contracting the last
+/// reduction_axes_count axes of arg0 with the first reduction_axes_count axes
+/// of arg1
+/// \param[in] arg0 First operand, of shape arg0_shape
+/// \param[in] arg1 Second operand, of shape arg1_shape
+/// \param[out] out Stores the product
+/// \param[in] arg0_shape Shape of arg0
+/// \param[in] arg1_shape Shape of arg1
+/// \param[in] reduction_axes_count Number of axes to contract
+void dense_dot(const std::vector<double>& arg0, const std::vector<double>& arg1,
+               std::vector<double>& out, const Shape& arg0_shape,
+               const Shape& arg1_shape, size_t reduction_axes_count);
+
+/// \brief Convolves data of shape (N, C_in, d_1, ..., d_n) with filters of
+/// shape (C_out, C_in, f_1, ..., f_n) into an output of shape
+/// (N, C_out, o_1, ..., o_n)
+void dense_convolution(
+    const std::vector<double>& arg0, const std::vector<double>& arg1,
+    std::vector<double>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides);
+
+/// \brief Averages windows of data of shape (N, C, d_1, ..., d_n). Padding
+/// counts towards the averages only if include_padding_in_avg_computation
+void dense_avg_pool(const std::vector<double>& arg, std::vector<double>& out,
+                    const Shape& arg_shape, const Shape& out_shape,
+                    const Shape& window_shape,
+                    const Strides& window_movement_strides,
+                    const Shape& padding_below, const Shape& padding_above,
+                    bool include_padding_in_avg_computation);
+
+/// \brief Computes the maximum of windows of data of shape
+/// (N, C, d_1, ..., d_n). Padding is excluded from the maxima
+void dense_max_pool(const std::vector<double>& arg, std::vector<double>& out,
+                    const Shape& arg_shape, const Shape& out_shape,
+                    const Shape& window_shape,
+                    const Strides& window_movement_strides,
+                    const Shape& padding_below, const Shape& padding_above);
+
+/// \brief Broadcasts arg to out_shape by replicating it along broadcast_axes
+void dense_broadcast(const std::vector<double>& arg, std::vector<double>& out,
+                     const Shape& arg_shape, const Shape& out_shape,
+                     const AxisSet& broadcast_axes);
+
+/// \brief Permutes the axes of arg by input_order, as op::Reshape does before
+/// reinterpreting the values with the output shape
+void dense_reshape(const std::vector<double>& arg, std::vector<double>& out,
+                   const Shape& arg_shape, const AxisVector& input_order);
+
+}  // namespace ngraph::runtime::he
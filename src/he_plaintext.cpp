@@ -16,7 +16,13 @@
 
 #include "he_plaintext.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
@@ -24,29 +30,120 @@
 
 namespace ngraph::runtime::he {
 
-HEPlaintext::HEPlaintext(const std::initializer_list<double>& values)
-    : std::vector<double>(values) {}
+HEPlaintext::~HEPlaintext() { release(); }
 
-HEPlaintext::HEPlaintext(const std::vector<double>& values)
-    : std::vector<double>(values) {}
+HEPlaintext::HEPlaintext(const HEPlaintext& plain) { *this = plain; }
 
-HEPlaintext::HEPlaintext(std::vector<double>&& values)
-    : std::vector<double>(std::move(values)) {}
+HEPlaintext::HEPlaintext(HEPlaintext&& plain) noexcept {
+  *this = std::move(plain);
+}
+
+HEPlaintext::HEPlaintext(const std::initializer_list<double>& values) {
+  assign(values.begin(), values.end());
+}
+
+HEPlaintext::HEPlaintext(const std::vector<double>& values) {
+  assign(values.begin(), values.end());
+}
 
-HEPlaintext::HEPlaintext(size_t n, double initial_value)
-    : std::vector<double>(n, initial_value) {}
+HEPlaintext::HEPlaintext(size_t n, double initial_value) {
+  resize(n, initial_value);
+}
 
 HEPlaintext& HEPlaintext::operator=(const HEPlaintext& v) {
-  static_cast<std::vector<double>*>(this)->operator=(v);
+  if (this == &v) {
+    return *this;
+  }
+  // Copies of single-precision values are widened, so they can be modified
+  assign(v.begin(), v.end());
   return *this;
 }
 
 HEPlaintext& HEPlaintext::operator=(HEPlaintext&& v) noexcept {
-  static_cast<std::vector<double>*>(this)->operator=(v);
+  if (this == &v) {
+    return *this;
+  }
+  if (v.is_inline()) {
+    // Fits in the current storage, whether inline or not
+    clear();
+    std::copy(v.m_inline, v.m_inline + v.m_size, data());
+  } else {
+    release();
+    if (v.is_float()) {
+      m_float = v.m_float;
+    } else {
+      m_heap = v.m_heap;
+    }
+    m_storage = v.m_storage;
+    v.m_storage = Storage::inline_values;
+  }
+  m_size = v.m_size;
+  v.m_size = 0;
   return *this;
 }
 
-void HEPlaintext::write(void* target, const element::Type& element_type) {
+void HEPlaintext::reserve(size_t n) {
+  check_double();
+  if (n <= capacity()) {
+    return;
+  }
+  NGRAPH_CHECK(n <= std::numeric_limits<std::uint32_t>::max(),
+               "Plaintext capacity ", n, " too large");
+  auto heap = std::make_unique<double[]>(n);
+  std::copy(data(), data() + m_size, heap.get());
+  release();
+  m_heap.data = heap.release();
+  m_heap.capacity = static_cast<std::uint32_t>(n);
+  m_storage = Storage::heap;
+}
+
+void HEPlaintext::resize(size_t n, double value) {
+  reserve(n);
+  if (n > m_size) {
+    std::fill(data() + m_size, data() + n, value);
+  }
+  m_size = static_cast<std::uint32_t>(n);
+}
+
+void HEPlaintext::clear() {
+  if (is_float()) {
+    release();
+  }
+  m_size = 0;
+}
+
+void HEPlaintext::release() {
+  if (m_storage == Storage::heap) {
+    delete[] m_heap.data;
+  } else if (m_storage == Storage::single) {
+    delete[] m_float;
+  }
+  m_storage = Storage::inline_values;
+}
+
+void HEPlaintext::to_float() {
+  if (is_inline() || is_float() || empty()) {
+    return;
+  }
+  auto values = std::make_unique<float[]>(m_size);
+  std::transform(m_heap.data, m_heap.data + m_size, values.get(),
+                 [](double value) { return static_cast<float>(value); });
+  release();
+  m_float = values.release();
+  m_storage = Storage::single;
+}
+
+void HEPlaintext::widen() {
+  auto values = std::make_unique<double[]>(m_size);
+  std::copy(m_float, m_float + m_size, values.get());
+  release();
+  m_heap.data = values.release();
+  m_heap.capacity = m_size;
+  m_storage = Storage::heap;
+}
+
+void HEPlaintext::write(void* target,
+                        const element::Type& element_type) const {
   NGRAPH_CHECK(!empty(), "Input has no values");
   size_t count = this->size();
   size_t type_byte_size = element_type.size();
@@ -55,14 +152,17 @@ void HEPlaintext::write(void* target, const element::Type& element_type) {
 #pragma clang diagnostic ignored "-Wswitch-enum"
   switch (element_type.get_type_enum()) {
     case element::Type_t::f32: {
+      if (is_float()) {
+        std::memcpy(target, m_float, type_byte_size * count);
+        break;
+      }
       std::vector<float> float_values{begin(), end()};
       auto type_values_src = static_cast<const void*>(float_values.data());
       std::memcpy(target, type_values_src, type_byte_size * count);
       break;
     }
     case element::Type_t::f64: {
-      auto type_values_src = static_cast<const void*>(this->data());
-      std::memcpy(target, type_values_src, type_byte_size * count);
+      std::copy(begin(), end(), static_cast<double*>(target));
       break;
     }
     case element::Type_t::i32: {
@@ -99,6 +199,10 @@ void HEPlaintext::write(void* target, const element::Type& element_type) {
 #pragma clang diagnostic pop
 }
 
+bool operator==(const HEPlaintext& a, const HEPlaintext& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
 std::ostream& operator<<(std::ostream& os, const HEPlaintext& plain) {
   os << "HEPlaintext( ";
   for (const auto& value : plain) {
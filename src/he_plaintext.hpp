@@ -16,42 +16,296 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
+#include "ngraph/check.hpp"
 #include "ngraph/type/element_type.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing a plaintext value
-class HEPlaintext : public std::vector<double> {
+/// \brief Class representing a plaintext value, with the interface of a
+/// std::vector<double>.
+///
+/// Up to inline_capacity values are stored inline, without allocating. Most
+/// plaintexts in unpacked graphs, such as constants and the results of
+/// plaintext arithmetic, hold a single value.
+///
+/// Values stored on the heap, such as packed values, may be kept in single
+/// precision, see to_float(). Const accessors then return values converted to
+/// double. Non-const accessors and modifiers throw until to_double() is
+/// called, so single-precision values shared between threads are only read.
+/// Copies store their values in double precision.
+class HEPlaintext {
  public:
+  using value_type = double;
+  using size_type = size_t;
+  using reference = double&;
+  using const_reference = double;
+  using iterator = double*;
+
+  /// \brief Random access iterator over the values of a const plaintext,
+  /// which yields the values by value
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = double;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = double;
+
+    const_iterator() = default;
+    const_iterator(const HEPlaintext* plain, size_t index)
+        : m_plain(plain), m_index(index) {}
+
+    double operator*() const { return (*m_plain)[m_index]; }
+    double operator[](difference_type n) const { return *(*this + n); }
+
+    const_iterator& operator++() {
+      ++m_index;
+      return *this;
+    }
+    const_iterator operator++(int) { return {m_plain, m_index++}; }
+    const_iterator& operator--() {
+      --m_index;
+      return *this;
+    }
+    const_iterator operator--(int) { return {m_plain, m_index--}; }
+    const_iterator& operator+=(difference_type n) {
+      m_index = static_cast<size_t>(static_cast<difference_type>(m_index) + n);
+      return *this;
+    }
+    const_iterator& operator-=(difference_type n) {
+      m_index = static_cast<size_t>(static_cast<difference_type>(m_index) - n);
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const {
+      const_iterator it(*this);
+      return it += n;
+    }
+    const_iterator operator-(difference_type n) const {
+      const_iterator it(*this);
+      return it -= n;
+    }
+    friend const_iterator operator+(difference_type n,
+                                    const const_iterator& it) {
+      return it + n;
+    }
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(m_index) -
+             static_cast<difference_type>(other.m_index);
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return m_index == other.m_index;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return m_index != other.m_index;
+    }
+    bool operator<(const const_iterator& other) const {
+      return m_index < other.m_index;
+    }
+    bool operator>(const const_iterator& other) const {
+      return m_index > other.m_index;
+    }
+    bool operator<=(const const_iterator& other) const {
+      return m_index <= other.m_index;
+    }
+    bool operator>=(const const_iterator& other) const {
+      return m_index >= other.m_index;
+    }
+
+   private:
+    const HEPlaintext* m_plain{nullptr};
+    size_t m_index{0};
+  };
+
+  /// \brief Number of values stored without allocating
+  static constexpr size_t inline_capacity = 4;
+
   HEPlaintext() = default;
-  ~HEPlaintext() = default;
-  HEPlaintext(const HEPlaintext& plain) = default;
-  HEPlaintext(HEPlaintext&& plain) = default;
+  ~HEPlaintext();
+  HEPlaintext(const HEPlaintext& plain);
+  HEPlaintext(HEPlaintext&& plain) noexcept;
 
   HEPlaintext(const std::initializer_list<double>& values);
 
   explicit HEPlaintext(const std::vector<double>& values);
 
-  explicit HEPlaintext(std::vector<double>&& values);
-
   explicit HEPlaintext(size_t n, double initial_value = 0);
 
-  template <class InputIterator>
-  HEPlaintext(InputIterator first, InputIterator last)
-      : std::vector<double>(first, last) {}
+  template <class InputIterator,
+            typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
+  HEPlaintext(InputIterator first, InputIterator last) {
+    assign(first, last);
+  }
 
   HEPlaintext& operator=(const HEPlaintext& v);
 
   HEPlaintext& operator=(HEPlaintext&& v) noexcept;
 
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  size_t capacity() const {
+    switch (m_storage) {
+      case Storage::inline_values:
+        return inline_capacity;
+      case Storage::heap:
+        return m_heap.capacity;
+      case Storage::single:
+        return m_size;
+    }
+    return 0;
+  }
+
+  /// \throws ngraph_error if the values are stored in single precision
+  double* data() {
+    check_double();
+    return is_inline() ? m_inline : m_heap.data;
+  }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + m_size; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, m_size}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  double& operator[](size_t i) { return data()[i]; }
+  double operator[](size_t i) const {
+    return is_float() ? static_cast<double>(m_float[i]) : double_data()[i];
+  }
+
+  double& front() { return data()[0]; }
+  double front() const { return (*this)[0]; }
+  double& back() { return data()[m_size - 1]; }
+  double back() const { return (*this)[m_size - 1]; }
+
+  /// \brief Returns the double precision values, or nullptr if is_float()
+  const double* double_data() const {
+    if (is_float()) {
+      return nullptr;
+    }
+    return is_inline() ? m_inline : m_heap.data;
+  }
+
+  /// \brief Returns the single precision values, or nullptr unless is_float()
+  float* float_data() { return is_float() ? m_float : nullptr; }
+  const float* float_data() const { return is_float() ? m_float : nullptr; }
+
+  /// \brief Ensures capacity for at least n values
+  /// \throws ngraph_error if the values are stored in single precision
+  void reserve(size_t n);
+
+  /// \brief Resizes to n values, setting new values to value
+  /// \throws ngraph_error if the values are stored in single precision
+  void resize(size_t n, double value = 0);
+
+  void clear();
+
+  void push_back(double value) { emplace_back(value); }
+
+  double& emplace_back(double value) {
+    if (m_size == capacity()) {
+      reserve(2 * capacity());
+    }
+    double* values = data();
+    values[m_size] = value;
+    return values[m_size++];
+  }
+
+  void pop_back() { --m_size; }
+
+  /// \brief Replaces the values with those in [first, last)
+  template <class InputIterator>
+  void assign(InputIterator first, InputIterator last) {
+    clear();
+    if constexpr (std::is_base_of_v<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<
+                          InputIterator>::iterator_category>) {
+      reserve(static_cast<size_t>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      emplace_back(static_cast<double>(*first));
+    }
+  }
+
+  /// \brief Returns whether or not the plaintext values are stored inline
+  bool is_inline() const { return m_storage == Storage::inline_values; }
+
+  /// \brief Returns whether or not the plaintext values are stored in single
+  /// precision
+  bool is_float() const { return m_storage == Storage::single; }
+
+  /// \brief Stores the values in single precision, rounding them, unless they
+  /// are stored inline
+  void to_float();
+
+  /// \brief Stores the values in double precision. Not thread-safe, so call
+  /// it where the plaintext is not shared, e.g. before a parallel loop
+  void to_double() {
+    if (is_float()) {
+      widen();
+    }
+  }
+
   /// \brief Writes the plaintext to the target as a vector of type
-  void write(void* target, const element::Type& element_type);
+  void write(void* target, const element::Type& element_type) const;
 
   /// \brief Reads plaintext to the target as a vector of type
   void read(void* source, size_t num_bytes, const element::Type& element_type);
+
+ private:
+  /// \brief Where the values are stored
+  enum class Storage : std::uint8_t {
+    /// \brief In m_inline
+    inline_values,
+    /// \brief In m_heap, in double precision
+    heap,
+    /// \brief In m_float, with capacity m_size
+    single
+  };
+
+  /// \brief Values on the heap, in double precision
+  struct HeapValues {
+    double* data;
+    std::uint32_t capacity;
+  };
+
+  void widen();
+
+  // Frees heap storage and switches to inline storage, keeping m_size
+  void release();
+
+  // Throws if the values are stored in single precision
+  void check_double() const {
+    NGRAPH_CHECK(!is_float(),
+                 "Single-precision plaintext values are read-only, see "
+                 "to_double()");
+  }
+
+  // Only the member selected by m_storage is active. The heap capacity is
+  // kept in the union rather than next to m_size, which keeps the object at
+  // 40 bytes
+  union {
+    double m_inline[inline_capacity]{};
+    HeapValues m_heap;
+    float* m_float;
+  };
+  std::uint32_t m_size{0};
+  Storage m_storage{Storage::inline_values};
 };
 
+bool operator==(const HEPlaintext& a, const HEPlaintext& b);
+
+inline bool operator!=(const HEPlaintext& a, const HEPlaintext& b) {
+  return !(a == b);
+}
+
 std::ostream& operator<<(std::ostream& os, const HEPlaintext& plain);
 }  // namespace ngraph::runtime::he
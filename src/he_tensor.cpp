@@ -16,12 +16,19 @@
 
 #include "he_tensor.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/descriptor/tensor.hpp"
 #include "ngraph/util.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_ciphertext_pool.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
@@ -31,7 +38,9 @@ HETensor::HETensor(const element::Type& element_type, const Shape& shape,
                    std::shared_ptr<seal::SEALContext> context,
                    const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
                    const HESealEncryptionParameters& encryption_params,
-                   const std::string& name)
+                   const std::string& name,
+                   HESealCiphertextPool* ciphertext_pool,
+                   const seal::parms_id_type& ciphertext_parms_id)
     : runtime::Tensor(
           std::make_shared<descriptor::Tensor>(element_type, shape, name)),
       m_packed(plaintext_packing),
@@ -55,11 +64,15 @@ HETensor::HETensor(const element::Type& element_type, const Shape& shape,
           : 0;
 
   if (encrypted) {
-    m_data.resize(num_elements, HEType(HESealBackend::create_empty_ciphertext(),
-                                       complex_packing, get_batch_size()));
+    const seal::parms_id_type& parms_id =
+        ciphertext_parms_id == seal::parms_id_zero ? m_context->first_parms_id()
+                                                   : ciphertext_parms_id;
+    m_data.reserve(num_elements);
     for (size_t i = 0; i < num_elements; ++i) {
-      m_data[i] = HEType(HESealBackend::create_empty_ciphertext(),
-                         complex_packing, get_batch_size());
+      m_data.emplace_back(ciphertext_pool != nullptr
+                              ? ciphertext_pool->acquire(parms_id)
+                              : HESealBackend::create_empty_ciphertext(),
+                          complex_packing, get_batch_size());
     }
   } else {
     m_data.resize(num_elements,
@@ -70,12 +83,28 @@ HETensor::HETensor(const element::Type& element_type, const Shape& shape,
 HETensor::HETensor(const element::Type& element_type, const Shape& shape,
                    bool plaintext_packing, bool complex_packing, bool encrypted,
                    const HESealBackend& he_seal_backend,
-                   const std::string& name)
+                   const std::string& name,
+                   HESealCiphertextPool* ciphertext_pool,
+                   const seal::parms_id_type& ciphertext_parms_id)
     : HETensor(element_type, shape, plaintext_packing, complex_packing,
                encrypted, *he_seal_backend.get_ckks_encoder(),
                he_seal_backend.get_context(), *he_seal_backend.get_encryptor(),
                *he_seal_backend.get_decryptor(),
-               he_seal_backend.get_encryption_parameters(), name) {}
+               he_seal_backend.get_encryption_parameters(), name,
+               ciphertext_pool, ciphertext_parms_id) {
+  m_symmetric_encryption = he_seal_backend.symmetric_encryption();
+}
+
+HETensorStorage HETensor::to_storage() const {
+  bool complex_packing = !m_data.empty() && m_data[0].complex_packing();
+  return HETensorStorage(m_data, get_batch_size(), complex_packing);
+}
+
+void HETensor::load_storage(const HETensorStorage& storage) {
+  NGRAPH_CHECK(storage.size() == m_data.size(), "Storage size ",
+               storage.size(), " doesn't match tensor size ", m_data.size());
+  storage.to_he_types(m_data);
+}
 
 Shape HETensor::pack_shape(const Shape& shape, size_t pack_axis) {
   if (pack_axis != 0) {
@@ -114,7 +143,7 @@ void HETensor::pack(size_t pack_axis) {
                                HEType(HEPlaintext(), false));
 
   for (size_t idx = 0; idx < m_data.size(); ++idx) {
-    auto& plain = m_data[idx].get_plaintext();
+    const HEPlaintext& plain = m_data[idx].get_plaintext();
     if (!plain.empty()) {
       size_t new_idx = idx % new_data.size();
       new_data[new_idx].get_plaintext().emplace_back(plain[0]);
@@ -125,6 +154,11 @@ void HETensor::pack(size_t pack_axis) {
   m_data = std::move(new_data);
   m_packed = true;
   m_packed_shape = HETensor::pack_shape(get_shape());
+  if (m_float_plaintexts) {
+    for (auto& he_type : m_data) {
+      he_type.get_plaintext().to_float();
+    }
+  }
 }
 
 void HETensor::unpack() {
@@ -139,7 +173,7 @@ void HETensor::unpack() {
   std::vector<HEType> new_data;
   for (size_t batch_idx = 0; batch_idx < old_batch_size; ++batch_idx) {
     for (auto& data : m_data) {
-      auto& plain = data.get_plaintext();
+      const HEPlaintext& plain = data.get_plaintext();
       new_data.emplace_back(
           HEPlaintext({static_cast<double>(plain[batch_idx])}), false);
     }
@@ -148,6 +182,20 @@ void HETensor::unpack() {
   m_packed_shape = get_shape();
 }
 
+void HETensor::set_float_plaintexts(bool float_plaintexts) {
+  m_float_plaintexts = float_plaintexts;
+#pragma omp parallel for
+  for (size_t i = 0; i < m_data.size(); ++i) {
+    if (m_data[i].is_plaintext()) {
+      if (float_plaintexts) {
+        m_data[i].get_plaintext().to_float();
+      } else {
+        m_data[i].get_plaintext().to_double();
+      }
+    }
+  }
+}
+
 uint64_t HETensor::batch_size(const Shape& shape, bool packed) {
   if (packed && !shape.empty()) {
     return shape[0];
@@ -191,85 +239,272 @@ void HETensor::check_io_bounds(size_t n) const {
   }
 }
 
-void HETensor::write(const void* p, size_t n) {
-  check_io_bounds(n);
+namespace {
+// Elements and batch values per block when transposing between batch-major
+// values and element-major plaintexts, so both sides stay in cache
+constexpr size_t io_block_size = 64;
 
-  const element::Type& element_type = get_tensor_layout()->get_element_type();
-  size_t type_byte_size = element_type.size();
+// Plaintexts reused by each thread to encrypt from and decrypt to, so their
+// buffers are allocated only once per thread
+std::vector<HEPlaintext>& io_scratch() {
+  thread_local std::vector<HEPlaintext> scratch(io_block_size);
+  return scratch;
+}
 
-  size_t num_elements_to_write = n / element_type.size();
-  if (get_batch_size() != 0) {
-    num_elements_to_write /= get_batch_size();
+// Whether the value holds a plaintext or a ciphertext. The bulk loops below
+// cannot throw, so they check every element up front
+bool is_specified(const HEType& he_type) {
+  return he_type.is_plaintext() || he_type.get_ciphertext() != nullptr;
+}
+
+template <typename T, typename U>
+void gather_values(const T* src, size_t stride, U* dst, size_t count) {
+#pragma omp simd
+  for (size_t k = 0; k < count; ++k) {
+    dst[k] = static_cast<U>(src[k * stride]);
+  }
+}
+
+template <typename T, typename U>
+void scatter_values(const U* src, T* dst, size_t stride, size_t count) {
+#pragma omp simd
+  for (size_t k = 0; k < count; ++k) {
+    if constexpr (std::is_integral_v<T>) {
+      dst[k * stride] = static_cast<T>(std::round(src[k]));
+    } else {
+      dst[k * stride] = static_cast<T>(src[k]);
+    }
+  }
+}
+}  // namespace
+
+template <typename T>
+void HETensor::write_values(const T* values, size_t num_elements) {
+  const element::Type& element_type = get_tensor_layout()->get_element_type();
+  const size_t batch_size = get_batch_size();
+  size_t num_blocks = (num_elements + io_block_size - 1) / io_block_size;
+  for (size_t i = 0; i < num_elements; ++i) {
+    NGRAPH_CHECK(is_specified(m_data[i]),
+                 "Cannot write into tensor of unspecified type");
   }
 
 #pragma omp parallel for
   // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_write; ++i) {
-    HEPlaintext plain(get_batch_size());
-    for (size_t j = 0; j < get_batch_size(); ++j) {
-      const auto* src = static_cast<const void*>(
-          static_cast<const char*>(p) +
-          type_byte_size * (i + j * num_elements_to_write));
-      plain[j] = type_to_double(src, element_type);
+  for (size_t block = 0; block < num_blocks; ++block) {
+    size_t first = block * io_block_size;
+    size_t last = std::min(first + io_block_size, num_elements);
+    std::vector<HEPlaintext>& scratch = io_scratch();
+
+    // Plaintexts are written in place; single-precision plaintexts of the
+    // right size keep their storage
+    std::array<double*, io_block_size> double_targets{};
+    std::array<float*, io_block_size> float_targets{};
+    for (size_t i = first; i < last; ++i) {
+      HEType& he_type = m_data[i];
+      HEPlaintext& plain = he_type.is_plaintext() ? he_type.get_plaintext()
+                                                  : scratch[i - first];
+      if (m_float_plaintexts && plain.is_float() &&
+          plain.size() == batch_size) {
+        float_targets[i - first] = plain.float_data();
+      } else {
+        plain.to_double();
+        plain.resize(batch_size);
+        double_targets[i - first] = plain.data();
+      }
     }
 
-    if (m_data[i].is_plaintext()) {
-      m_data[i].set_plaintext(plain);
-    } else {
-      NGRAPH_CHECK(m_data[i].is_ciphertext(),
-                   "Cannot write into tensor of unspecified type");
+    for (size_t j = 0; j < batch_size; j += io_block_size) {
+      size_t count = std::min(io_block_size, batch_size - j);
+      for (size_t i = first; i < last; ++i) {
+        const T* src = values + j * num_elements + i;
+        if (float_targets[i - first] != nullptr) {
+          gather_values(src, num_elements, float_targets[i - first] + j,
+                        count);
+        } else {
+          gather_values(src, num_elements, double_targets[i - first] + j,
+                        count);
+        }
+      }
+    }
+
+    for (size_t i = first; i < last; ++i) {
+      HEType& he_type = m_data[i];
+      if (he_type.is_plaintext()) {
+        if (m_float_plaintexts) {
+          he_type.get_plaintext().to_float();
+        }
+        continue;
+      }
       auto cipher = HESealBackend::create_empty_ciphertext();
+      encrypt(cipher, scratch[i - first], m_context->first_parms_id(),
+              element_type, m_encryption_params.scale(), m_ckks_encoder,
+              m_encryptor, he_type.complex_packing(),
+              seal::MemoryPoolHandle::ThreadLocal(), m_symmetric_encryption);
+      he_type.set_ciphertext(cipher);
+    }
+  }
+}
+
+template <typename T>
+void HETensor::read_values(T* values, size_t num_elements, size_t begin,
+                           size_t end) const {
+  const size_t batch_size = get_batch_size();
+  size_t num_blocks = (end - begin + io_block_size - 1) / io_block_size;
+  for (size_t i = begin; i < end; ++i) {
+    NGRAPH_CHECK(is_specified(m_data[i]),
+                 "Cannot read from tensor of unspecified type");
+  }
 
-      encrypt(cipher, plain, m_context->first_parms_id(), element_type,
-              m_encryption_params.scale(), m_ckks_encoder, m_encryptor,
-              m_data[i].complex_packing());
-      m_data[i].set_ciphertext(cipher);
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t block = 0; block < num_blocks; ++block) {
+    size_t first = begin + block * io_block_size;
+    size_t last = std::min(first + io_block_size, end);
+    std::vector<HEPlaintext>& scratch = io_scratch();
+
+    std::array<const HEPlaintext*, io_block_size> sources{};
+    for (size_t i = first; i < last; ++i) {
+      const HEType& he_type = m_data[i];
+      if (he_type.is_ciphertext()) {
+        decrypt(scratch[i - first], *he_type.get_ciphertext(),
+                he_type.complex_packing(), m_decryptor, m_ckks_encoder);
+        sources[i - first] = &scratch[i - first];
+      } else {
+        sources[i - first] = &he_type.get_plaintext();
+      }
     }
+
+    // Missing batch values are read as zero
+    for (size_t j = 0; j < batch_size; j += io_block_size) {
+      size_t count = std::min(io_block_size, batch_size - j);
+      for (size_t i = first; i < last; ++i) {
+        const HEPlaintext& plain = *sources[i - first];
+        T* dst = values + j * num_elements + i;
+        size_t available =
+            plain.size() > j ? std::min(count, plain.size() - j) : 0;
+        if (available > 0 && plain.is_float()) {
+          scatter_values(plain.float_data() + j, dst, num_elements, available);
+        } else if (available > 0) {
+          scatter_values(plain.double_data() + j, dst, num_elements,
+                         available);
+        }
+        for (size_t k = available; k < count; ++k) {
+          dst[k * num_elements] = T{0};
+        }
+      }
+    }
+  }
+}
+
+void HETensor::write(const void* p, size_t n) {
+  check_io_bounds(n);
+
+  const element::Type& element_type = get_tensor_layout()->get_element_type();
+  size_t num_elements_to_write = n / element_type.size();
+  if (get_batch_size() != 0) {
+    num_elements_to_write /= get_batch_size();
+  }
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (element_type.get_type_enum()) {
+    case element::Type_t::f32:
+      write_values(static_cast<const float*>(p), num_elements_to_write);
+      break;
+    case element::Type_t::f64:
+      write_values(static_cast<const double*>(p), num_elements_to_write);
+      break;
+    case element::Type_t::i32:
+      write_values(static_cast<const int32_t*>(p), num_elements_to_write);
+      break;
+    case element::Type_t::i64:
+      write_values(static_cast<const int64_t*>(p), num_elements_to_write);
+      break;
+    case element::Type_t::i8:
+    case element::Type_t::i16:
+    case element::Type_t::u8:
+    case element::Type_t::u16:
+    case element::Type_t::u32:
+    case element::Type_t::u64:
+    case element::Type_t::dynamic:
+    case element::Type_t::undefined:
+    case element::Type_t::bf16:
+    case element::Type_t::f16:
+    case element::Type_t::boolean:
+      NGRAPH_CHECK(false, "Unsupported element type ", element_type);
   }
+#pragma clang diagnostic pop
   m_write_count += num_elements_to_write;
 }
 
 void HETensor::read(void* p, size_t n) const {
+  const element::Type& element_type = get_tensor_layout()->get_element_type();
+  read(p, n, 0, n / (element_type.size() * get_batch_size()));
+}
+
+void HETensor::read(void* p, size_t n, size_t begin, size_t end) const {
   check_io_bounds(n);
   const element::Type& element_type = get_tensor_layout()->get_element_type();
   size_t type_byte_size = element_type.size();
   size_t num_elements_to_read = n / (type_byte_size * get_batch_size());
+  NGRAPH_CHECK(begin <= end && end <= num_elements_to_read,
+               "Invalid range [", begin, ", ", end, ") to read from ",
+               num_elements_to_read, " elements");
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (element_type.get_type_enum()) {
+    case element::Type_t::f32:
+      read_values(static_cast<float*>(p), num_elements_to_read, begin, end);
+      break;
+    case element::Type_t::f64:
+      read_values(static_cast<double*>(p), num_elements_to_read, begin, end);
+      break;
+    case element::Type_t::i32:
+      read_values(static_cast<int32_t*>(p), num_elements_to_read, begin, end);
+      break;
+    case element::Type_t::i64:
+      read_values(static_cast<int64_t*>(p), num_elements_to_read, begin, end);
+      break;
+    case element::Type_t::i8:
+    case element::Type_t::i16:
+    case element::Type_t::u8:
+    case element::Type_t::u16:
+    case element::Type_t::u32:
+    case element::Type_t::u64:
+    case element::Type_t::dynamic:
+    case element::Type_t::undefined:
+    case element::Type_t::bf16:
+    case element::Type_t::f16:
+    case element::Type_t::boolean:
+      NGRAPH_CHECK(false, "Unsupported element type ", element_type);
+  }
+#pragma clang diagnostic pop
+}
 
-  auto copy_batch_values_to_src = [&](size_t element_idx, void* copy_target,
-                                      const void* type_values_src) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-    auto* src = static_cast<char*>(const_cast<void*>(type_values_src));
-    for (size_t j = 0; j < get_batch_size(); ++j) {
-      auto* dst_with_offset = static_cast<void*>(
-          static_cast<char*>(copy_target) +
-          type_byte_size * (element_idx + j * num_elements_to_read));
-      std::memcpy(dst_with_offset, src, type_byte_size);
-      src += type_byte_size;
-    }
-  };
-
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_read; ++i) {
-    HEPlaintext plain;
-    if (m_data[i].is_ciphertext()) {
-      decrypt(plain, *m_data[i].get_ciphertext(), m_data[i].complex_packing(),
-              m_decryptor, m_ckks_encoder);
-    } else {
-      plain = m_data[i].get_plaintext();
-    }
-
-    void* dst = ngraph_malloc(type_byte_size * get_batch_size());
-    plain.resize(get_batch_size());
-    plain.write(dst, element_type);
+size_t HETensor::proto_chunk_size(size_t max_bytes, size_t index) const {
+  NGRAPH_CHECK(index < m_data.size(), "Index ", index, " out of range");
+  pb::HEType tmp_type;
+  m_data[index].save(tmp_type);
 
-    copy_batch_values_to_src(i, p, dst);
+  size_t he_type_size = tmp_type.ByteSize();
+  // Leave room for the tensor attributes
+  return std::max(max_bytes / std::max(he_type_size, size_t(1)), size_t(3)) -
+         2;
+}
 
-    ngraph_free(dst);
-  }
+void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                               size_t max_bytes) const {
+  write_to_protos(proto_tensors, max_bytes, 0, m_data.size());
 }
 
-void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors) const {
+void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                               size_t max_bytes, size_t begin,
+                               size_t end) const {
+  NGRAPH_CHECK(max_bytes > 0 && max_bytes <= max_proto_bytes,
+               "Invalid maximum proto size ", max_bytes);
+  NGRAPH_CHECK(begin <= end && end <= m_data.size(), "Invalid range [", begin,
+               ", ", end, ") to write from ", m_data.size(), " elements");
   // Populate attributes of tensor to estimate byte size
   proto_tensors.resize(1);
   proto_tensors[0].set_name(get_name());
@@ -277,27 +512,21 @@ void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors) const {
   *proto_tensors[0].mutable_shape() = {int_shape.begin(), int_shape.end()};
   proto_tensors[0].set_type(type_to_pb_type(get_element_type()));
   proto_tensors[0].set_packed(m_packed);
-  proto_tensors[0].set_offset(0);
+  proto_tensors[0].set_offset(begin);
 
   NGRAPH_HE_LOG(5) << "Writing tensor shape " << get_shape();
 
-  if (!m_data.empty()) {
-    pb::HEType tmp_type;
-    m_data[0].save(tmp_type);
-
-    size_t he_type_size = tmp_type.ByteSize();
-    size_t max_num_data_per_tensor =
-        std::floor(std::numeric_limits<int32_t>::max() /
-                   static_cast<float>(he_type_size)) -
-        2;
+  size_t data_count = end - begin;
+  if (data_count > 0) {
+    size_t max_num_data_per_tensor = proto_chunk_size(max_bytes, begin);
 
-    size_t num_tensors = m_data.size() / max_num_data_per_tensor;
-    if (m_data.size() % max_num_data_per_tensor != 0) {
+    size_t num_tensors = data_count / max_num_data_per_tensor;
+    if (data_count % max_num_data_per_tensor != 0) {
       num_tensors++;
     }
     proto_tensors.resize(num_tensors);
 
-    size_t offset = 0;
+    size_t offset = begin;
 
     for (size_t tensor_idx = 0; tensor_idx < num_tensors; ++tensor_idx) {
       proto_tensors[tensor_idx].set_name(get_name());
@@ -310,8 +539,7 @@ void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors) const {
       auto* mutable_data = proto_tensors[tensor_idx].mutable_data();
       size_t num_data_in_tensor = max_num_data_per_tensor;
       if (tensor_idx == num_tensors - 1) {
-        num_data_in_tensor =
-            m_data.size() - tensor_idx * max_num_data_per_tensor;
+        num_data_in_tensor = data_count - tensor_idx * max_num_data_per_tensor;
       }
       for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
         mutable_data->Add();
@@ -334,14 +562,14 @@ std::shared_ptr<HETensor> HETensor::load_from_proto_tensors(
     const std::shared_ptr<seal::SEALContext>& context,
     const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
     const HESealEncryptionParameters& encryption_params) {
-  NGRAPH_CHECK(proto_tensors.size() == 1,
-               "Load from protos only supports 1 proto");
+  NGRAPH_CHECK(!proto_tensors.empty(), "No proto tensors to load");
 
   const auto& proto_tensor = proto_tensors[0];
   const auto& proto_name = proto_tensor.name();
   const auto& proto_shape = proto_tensor.shape();
   const auto& element_type = pb_type_to_type(proto_tensor.type());
   const auto& proto_packed = proto_tensor.packed();
+  const auto& proto_offset = proto_tensor.offset();
   size_t result_count = proto_tensor.data_size();
   Shape shape{proto_shape.begin(), proto_shape.end()};
 
@@ -350,14 +578,23 @@ std::shared_ptr<HETensor> HETensor::load_from_proto_tensors(
       false, ckks_encoder, context, encryptor, decryptor, encryption_params,
       proto_name);
 
+  NGRAPH_CHECK(proto_offset + result_count <= he_tensor->data().size(),
+               "Proto tensor with offset ", proto_offset, " and ", result_count,
+               " elements does not fit in tensor of size ",
+               he_tensor->data().size());
+
 #pragma omp parallel for
   // NOLINTNEXTLINE
   for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
     const auto& loaded = HEType::load(proto_tensor.data(result_idx), context);
-    he_tensor->data(result_idx) = loaded;
+    he_tensor->data(proto_offset + result_idx) = loaded;
   }
   he_tensor->m_write_count += result_count;
 
+  // Remaining chunks, which may arrive in any order
+  for (size_t proto_idx = 1; proto_idx < proto_tensors.size(); ++proto_idx) {
+    load_from_proto_tensor(he_tensor, proto_tensors[proto_idx], context);
+  }
   return he_tensor;
 }
 
@@ -380,6 +617,11 @@ void HETensor::load_from_proto_tensor(
                "HETensor has wrong packing ", he_tensor->is_packed(),
                ", expected ", proto_packed);
 
+  NGRAPH_CHECK(proto_offset + result_count <= he_tensor->data().size(),
+               "Proto tensor with offset ", proto_offset, " and ", result_count,
+               " elements does not fit in tensor of size ",
+               he_tensor->data().size());
+
 #pragma omp parallel for
   // NOLINTNEXTLINE
   for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <memory>
 
 #include "he_plaintext.hpp"
+#include "he_tensor_storage.hpp"
 #include "he_type.hpp"
 #include "ngraph/runtime/tensor.hpp"
 #include "ngraph/type/element_type.hpp"
@@ -28,7 +32,9 @@
 
 namespace ngraph::runtime::he {
 class HESealBackend;
+class HESealCiphertextPool;
 class HEType;
+class HETensorStorage;
 /// \brief Class representing a Tensor of either ciphertexts or plaintexts
 class HETensor : public runtime::Tensor {
  public:
@@ -47,13 +53,21 @@ class HETensor : public runtime::Tensor {
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
   /// \param[in] name Name of the tensor
+  /// \param[in] ciphertext_pool If set, pool from which to take the
+  /// ciphertexts of an encrypted tensor
+  /// \param[in] ciphertext_parms_id Encryption parameters of the ciphertexts
+  /// to take from the pool, e.g. those of the arguments of the op computing
+  /// the tensor. The first parameters of the context if parms_id_zero
   HETensor(const element::Type& element_type, const Shape& shape,
            bool plaintext_packing, bool complex_packing, bool encrypted,
            seal::CKKSEncoder& ckks_encoder,
            std::shared_ptr<seal::SEALContext> context,
            const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
            const HESealEncryptionParameters& encryption_params,
-           const std::string& name = "external");
+           const std::string& name = "external",
+           HESealCiphertextPool* ciphertext_pool = nullptr,
+           const seal::parms_id_type& ciphertext_parms_id =
+               seal::parms_id_zero);
 
   /// \brief Constructs a generic HETensor
   /// \param[in] element_type Datatype of data stored in the tensor
@@ -65,10 +79,18 @@ class HETensor : public runtime::Tensor {
   /// \param[in] encrypted Whether or not tensor is initialized with ciphertexts
   /// \param[in] he_seal_backend Backend used for encryption and decryption
   /// \param[in] name Name of the tensor
+  /// \param[in] ciphertext_pool If set, pool from which to take the
+  /// ciphertexts of an encrypted tensor
+  /// \param[in] ciphertext_parms_id Encryption parameters of the ciphertexts
+  /// to take from the pool. The first parameters of the context if
+  /// parms_id_zero
   HETensor(const element::Type& element_type, const Shape& shape,
            bool plaintext_packing, bool complex_packing, bool encrypted,
            const HESealBackend& he_seal_backend,
-           const std::string& name = "external");
+           const std::string& name = "external",
+           HESealCiphertextPool* ciphertext_pool = nullptr,
+           const seal::parms_id_type& ciphertext_parms_id =
+               seal::parms_id_zero);
 
   /// \brief Write bytes directly into the tensor
   /// \param[in] p Pointer to source of data
@@ -80,6 +102,16 @@ class HETensor : public runtime::Tensor {
   /// \param[in] n Number of bytes to read, must be integral number of elements.
   void read(void* p, size_t n) const override;
 
+  /// \brief Reads elements [begin, end) of the tensor into their place in a
+  /// destination for the whole tensor. Disjoint ranges may be read
+  /// concurrently
+  /// \param[out] p Pointer to destination for data of the whole tensor
+  /// \param[in] n Number of bytes of the whole destination, must be integral
+  /// number of elements
+  /// \param[in] begin Index of the first element to read
+  /// \param[in] end Index one past the last element to read
+  void read(void* p, size_t n, size_t begin, size_t end) const;
+
   /// \brief Reduces shape along pack axis
   /// \param[in] shape Input shape to pack
   /// \param[in] pack_axis Axis along which to pack
@@ -109,6 +141,15 @@ class HETensor : public runtime::Tensor {
 
   bool any_encrypted_data() const;
 
+  /// \brief Returns a copy of the elements in struct-of-arrays storage.
+  /// Ciphertexts are shared
+  HETensorStorage to_storage() const;
+
+  /// \brief Replaces the elements with those of a struct-of-arrays storage
+  /// \param[in] storage Storage with one element per batched element
+  /// \throws ngraph_error if the number of elements doesn't match
+  void load_storage(const HETensorStorage& storage);
+
   /// \brief Returns the batch size of a given shape
   /// \param[in] shape Shape of the tensor
   /// \param[in] packed Whether or not batch-axis packing is used
@@ -126,14 +167,54 @@ class HETensor : public runtime::Tensor {
   /// \brief Returns whether or not the tensor is packed
   bool is_packed() const { return m_packed; }
 
+  /// \brief Sets whether or not the tensor stores its plaintext values in
+  /// single precision, converting the current values. Halves the memory of
+  /// packed plaintexts. Lossless for values written as f32
+  /// \param[in] float_plaintexts Whether or not to use single precision
+  void set_float_plaintexts(bool float_plaintexts);
+
+  /// \brief Returns whether or not the tensor stores its plaintext values in
+  /// single precision
+  bool float_plaintexts() const { return m_float_plaintexts; }
+
+  /// \brief Maximum size of a proto tensor, due to the 2GB limit on protobufs
+  static constexpr size_t max_proto_bytes =
+      std::numeric_limits<int32_t>::max();
+
+  /// \brief Size of the proto tensors when a tensor is striped across several
+  /// connections. Small enough that every connection gets a share of typical
+  /// input and result tensors
+  static constexpr size_t stripe_proto_bytes = 16 * 1024 * 1024;
+
   /// \brief Writes the tensor to a vector of proto tensors.
   /// Due to the 2GB limit on protobufs, large ciphertext tensors may not be
   /// able to store the entire tensor in one SealCipherTensor message.
-  /// \param[out] proto_tensors
-  void write_to_protos(std::vector<pb::HETensor>& proto_tensors) const;
+  /// \param[out] proto_tensors Proto tensors, each storing a contiguous chunk
+  /// of the tensor at the chunk's offset
+  /// \param[in] max_bytes Approximate maximum size of each proto tensor. At
+  /// most max_proto_bytes
+  void write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                       size_t max_bytes = max_proto_bytes) const;
+
+  /// \brief Returns the number of elements which fit in a proto tensor of
+  /// approximately max_bytes, estimated from the size of one element
+  /// \param[in] max_bytes Approximate maximum size of the proto tensor
+  /// \param[in] index Index of the element from which to estimate
+  size_t proto_chunk_size(size_t max_bytes, size_t index = 0) const;
+
+  /// \brief Writes elements [begin, end) of the tensor to a vector of proto
+  /// tensors, each storing a contiguous chunk at the chunk's offset
+  /// \param[out] proto_tensors Proto tensors
+  /// \param[in] max_bytes Approximate maximum size of each proto tensor. At
+  /// most max_proto_bytes
+  /// \param[in] begin Index of the first element to write
+  /// \param[in] end Index one past the last element to write
+  void write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                       size_t max_bytes, size_t begin, size_t end) const;
 
   /// \brief Loads a tensor from protobuf tensors
-  /// \param[in] proto_tensors vector of protobuf tensors to load from
+  /// \param[in] proto_tensors vector of protobuf tensors to load from. Each
+  /// stores a chunk of the tensor, in any order
   /// \param[in] ckks_encoder CKKS encoder to associate with loaded tensor
   /// \param[in] context SEAL context to associate with loaded tensor
   /// \param[in] encryptor SEAL encryptor to associate with loaded tensor
@@ -178,18 +259,40 @@ class HETensor : public runtime::Tensor {
 
  private:
   bool m_packed;
+  bool m_float_plaintexts{false};
   Shape m_packed_shape;
   std::vector<HEType> m_data;
 
-  size_t m_write_count{0};  // Number of elements written to the tensor
+  // Number of elements written to the tensor. Atomic, since chunks of a
+  // tensor may be loaded concurrently
+  std::atomic<size_t> m_write_count{0};
 
   seal::CKKSEncoder& m_ckks_encoder;
   std::shared_ptr<seal::SEALContext> m_context;
   const seal::Encryptor& m_encryptor;
+  // Whether or not m_encryptor encrypts with the secret key
+  bool m_symmetric_encryption{false};
   seal::Decryptor& m_decryptor;
   const HESealEncryptionParameters& m_encryption_params;
 
   void check_io_bounds(size_t n) const;
+
+  /// \brief Writes batch-major values to the first num_elements elements
+  /// \param[in] values Values, with batch j of element i at index
+  /// i + j * num_elements
+  /// \param[in] num_elements Number of elements to write
+  template <typename T>
+  void write_values(const T* values, size_t num_elements);
+
+  /// \brief Reads elements [begin, end) to batch-major values
+  /// \param[out] values Values, with batch j of element i at index
+  /// i + j * num_elements
+  /// \param[in] num_elements Number of elements in values
+  /// \param[in] begin Index of first element to read
+  /// \param[in] end Index past the last element to read
+  template <typename T>
+  void read_values(T* values, size_t num_elements, size_t begin,
+                   size_t end) const;
 };
 
 }  // namespace ngraph::runtime::he
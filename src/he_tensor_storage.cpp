@@ -0,0 +1,142 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "he_tensor_storage.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+HETensorStorage::HETensorStorage(size_t count, size_t batch_size,
+                                 bool complex_packing)
+    : m_batch_size(batch_size),
+      m_complex_packing(complex_packing),
+      m_tags(count, Tag::empty),
+      m_plaintext_values(count * batch_size),
+      m_ciphertexts(count),
+      m_pool(seal::MemoryPoolHandle::New()) {}
+
+HETensorStorage::HETensorStorage(const std::vector<HEType>& values,
+                                 size_t batch_size, bool complex_packing)
+    : HETensorStorage(values.size(), batch_size, complex_packing) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    set(i, values[i]);
+  }
+}
+
+const std::shared_ptr<SealCiphertextWrapper>& HETensorStorage::ciphertext(
+    size_t index) const {
+  NGRAPH_CHECK(is_ciphertext(index), "Element ", index,
+               " is not a ciphertext");
+  return m_ciphertexts[index];
+}
+
+void HETensorStorage::set_tag(size_t index, Tag tag) {
+  if (m_tags[index] == Tag::ciphertext) {
+    --m_ciphertext_count;
+  }
+  if (tag == Tag::ciphertext) {
+    ++m_ciphertext_count;
+  } else {
+    m_ciphertexts[index] = nullptr;
+  }
+  m_tags[index] = tag;
+}
+
+void HETensorStorage::set_plaintext(size_t index, const HEPlaintext& plain) {
+  if (plain.empty()) {
+    set_tag(index, Tag::empty);
+    return;
+  }
+  NGRAPH_CHECK(plain.size() == 1 || plain.size() == m_batch_size,
+               "Plaintext size ", plain.size(), " doesn't match batch size ",
+               m_batch_size);
+  std::copy(plain.begin(), plain.end(), plaintext(index));
+  set_tag(index, plain.size() == m_batch_size ? Tag::plaintext : Tag::scalar);
+}
+
+void HETensorStorage::set_ciphertext(
+    size_t index, std::shared_ptr<SealCiphertextWrapper> cipher) {
+  NGRAPH_CHECK(cipher != nullptr, "Ciphertext is null");
+  set_tag(index, Tag::ciphertext);
+  m_ciphertexts[index] = std::move(cipher);
+}
+
+seal::Ciphertext& HETensorStorage::emplace_ciphertext(size_t index) {
+  auto cipher = std::make_shared<SealCiphertextWrapper>();
+  cipher->ciphertext() = seal::Ciphertext(m_pool);
+  set_ciphertext(index, cipher);
+  return cipher->ciphertext();
+}
+
+HEType HETensorStorage::get(size_t index) const {
+  switch (m_tags[index]) {
+    case Tag::empty:
+      return HEType(HEPlaintext(), m_complex_packing);
+    case Tag::scalar:
+      return HEType(HEPlaintext{*plaintext(index)}, m_complex_packing);
+    case Tag::plaintext:
+      return HEType(HEPlaintext(plaintext(index),
+                                plaintext(index) + m_batch_size),
+                    m_complex_packing);
+    case Tag::ciphertext:
+      return HEType(m_ciphertexts[index], m_complex_packing, m_batch_size);
+  }
+  throw ngraph_error("Unknown tag");
+}
+
+void HETensorStorage::set(size_t index, const HEType& value) {
+  NGRAPH_CHECK(value.complex_packing() == m_complex_packing,
+               "Complex packing of element ", index,
+               " doesn't match the storage");
+  if (value.is_plaintext()) {
+    set_plaintext(index, value.get_plaintext());
+  } else {
+    set_ciphertext(index, value.get_ciphertext());
+  }
+}
+
+void HETensorStorage::copy(size_t index, const HETensorStorage& src,
+                           size_t src_index) {
+  NGRAPH_CHECK(src.m_batch_size == m_batch_size &&
+                   src.m_complex_packing == m_complex_packing,
+               "Storage layouts don't match");
+  Tag tag = src.m_tags[src_index];
+  if (tag == Tag::ciphertext) {
+    set_ciphertext(index, src.m_ciphertexts[src_index]);
+    return;
+  }
+  size_t value_count = tag == Tag::plaintext ? m_batch_size : 1;
+  if (tag != Tag::empty) {
+    std::copy_n(src.plaintext(src_index), value_count, plaintext(index));
+  }
+  set_tag(index, tag);
+}
+
+void HETensorStorage::to_he_types(std::vector<HEType>& values) const {
+  values.clear();
+  values.reserve(size());
+  for (size_t i = 0; i < size(); ++i) {
+    values.emplace_back(get(i));
+  }
+}
+
+}  // namespace ngraph::runtime::he
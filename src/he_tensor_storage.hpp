@@ -0,0 +1,181 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "he_type.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Struct-of-arrays storage for the elements of a tensor.
+///
+/// A std::vector<HEType> stores each plaintext in its own heap-allocated
+/// vector, so iterating over a tensor chases a pointer per element. Here the
+/// plaintext values of all elements share one contiguous buffer, with
+/// batch_size values per element, and a one-byte tag per element records
+/// whether the element holds a plaintext or a ciphertext.
+///
+/// Ciphertexts created by the storage allocate their polynomials from a
+/// memory pool owned by the storage. SEAL's pool serves each allocation size,
+/// i.e. each level, from its own contiguous blocks, so ciphertexts at the
+/// same level are laid out together. Ciphertexts copied between storages
+/// are shared rather than deep-copied, as with HEType.
+class HETensorStorage {
+ public:
+  /// \brief Kind of value an element holds
+  enum class Tag : std::uint8_t {
+    /// \brief No value
+    empty,
+    /// \brief A single plaintext value, broadcast along the batch axis
+    scalar,
+    /// \brief batch_size plaintext values
+    plaintext,
+    /// \brief A ciphertext
+    ciphertext
+  };
+
+  /// \brief Constructs storage of empty elements
+  /// \param[in] count Number of elements
+  /// \param[in] batch_size Number of plaintext values per element
+  /// \param[in] complex_packing Whether or not elements use complex packing
+  HETensorStorage(size_t count, size_t batch_size, bool complex_packing);
+
+  /// \brief Constructs storage from HEType elements
+  /// \param[in] values Elements to store
+  /// \param[in] batch_size Number of plaintext values per element
+  /// \param[in] complex_packing Whether or not elements use complex packing
+  /// \throws ngraph_error if an element has a different complex packing, or a
+  /// plaintext with neither one nor batch_size values
+  HETensorStorage(const std::vector<HEType>& values, size_t batch_size,
+                  bool complex_packing);
+
+  /// \brief Returns the number of elements
+  size_t size() const { return m_tags.size(); }
+
+  /// \brief Returns the number of plaintext values per element
+  size_t batch_size() const { return m_batch_size; }
+
+  /// \brief Returns whether or not elements use complex packing
+  bool complex_packing() const { return m_complex_packing; }
+
+  /// \brief Returns the tags of all elements
+  const std::vector<Tag>& tags() const { return m_tags; }
+
+  /// \brief Returns the tag of an element
+  /// \param[in] index Index of the element
+  Tag tag(size_t index) const { return m_tags[index]; }
+
+  /// \brief Returns whether or not an element holds a plaintext
+  /// \param[in] index Index of the element
+  bool is_plaintext(size_t index) const {
+    return m_tags[index] == Tag::scalar || m_tags[index] == Tag::plaintext;
+  }
+
+  /// \brief Returns whether or not an element holds a ciphertext
+  /// \param[in] index Index of the element
+  bool is_ciphertext(size_t index) const {
+    return m_tags[index] == Tag::ciphertext;
+  }
+
+  /// \brief Returns the number of elements holding a ciphertext
+  size_t ciphertext_count() const { return m_ciphertext_count; }
+
+  /// \brief Returns the plaintext values of all elements, batch_size values
+  /// per element. Only the first value of a scalar element is meaningful
+  std::vector<double>& plaintext_values() { return m_plaintext_values; }
+
+  /// \brief Returns the plaintext values of all elements, batch_size values
+  /// per element. Only the first value of a scalar element is meaningful
+  const std::vector<double>& plaintext_values() const {
+    return m_plaintext_values;
+  }
+
+  /// \brief Returns a pointer to the batch_size plaintext values of an element
+  /// \param[in] index Index of the element
+  double* plaintext(size_t index) {
+    return m_plaintext_values.data() + index * m_batch_size;
+  }
+
+  /// \brief Returns a pointer to the batch_size plaintext values of an element
+  /// \param[in] index Index of the element
+  const double* plaintext(size_t index) const {
+    return m_plaintext_values.data() + index * m_batch_size;
+  }
+
+  /// \brief Returns the ciphertext of an element
+  /// \param[in] index Index of the element
+  /// \throws ngraph_error if the element doesn't hold a ciphertext
+  const std::shared_ptr<SealCiphertextWrapper>& ciphertext(size_t index) const;
+
+  /// \brief Sets an element to a plaintext
+  /// \param[in] index Index of the element
+  /// \param[in] plain Plaintext with either one or batch_size values
+  void set_plaintext(size_t index, const HEPlaintext& plain);
+
+  /// \brief Sets an element to a ciphertext, sharing it
+  /// \param[in] index Index of the element
+  /// \param[in] cipher Ciphertext
+  void set_ciphertext(size_t index,
+                      std::shared_ptr<SealCiphertextWrapper> cipher);
+
+  /// \brief Sets an element to an empty ciphertext whose polynomials will be
+  /// allocated from the storage's memory pool, and returns it
+  /// \param[in] index Index of the element
+  seal::Ciphertext& emplace_ciphertext(size_t index);
+
+  /// \brief Returns an element as an HEType
+  /// \param[in] index Index of the element
+  HEType get(size_t index) const;
+
+  /// \brief Sets an element from an HEType
+  /// \param[in] index Index of the element
+  /// \param[in] value Value to set
+  void set(size_t index, const HEType& value);
+
+  /// \brief Copies an element of another storage into an element. Plaintext
+  /// values are copied, ciphertexts shared
+  /// \param[in] index Index of the destination element
+  /// \param[in] src Storage to copy from
+  /// \param[in] src_index Index of the source element
+  void copy(size_t index, const HETensorStorage& src, size_t src_index);
+
+  /// \brief Writes the elements as HEType values
+  /// \param[out] values Destination, resized to the number of elements
+  void to_he_types(std::vector<HEType>& values) const;
+
+  /// \brief Returns the memory pool ciphertexts are allocated from
+  const seal::MemoryPoolHandle& pool() const { return m_pool; }
+
+ private:
+  void set_tag(size_t index, Tag tag);
+
+  size_t m_batch_size;
+  bool m_complex_packing;
+  size_t m_ciphertext_count{0};
+  std::vector<Tag> m_tags;
+  std::vector<double> m_plaintext_values;
+  std::vector<std::shared_ptr<SealCiphertextWrapper>> m_ciphertexts;
+  seal::MemoryPoolHandle m_pool;
+};
+
+}  // namespace ngraph::runtime::he
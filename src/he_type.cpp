@@ -17,8 +17,10 @@
 #include "he_type.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "he_plaintext.hpp"
+#include "ngraph/check.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
@@ -63,7 +65,7 @@ void HEType::save(pb::HEType& proto_he_type) const {
 
   if (is_plaintext()) {
     // TODO(fboemer): more efficient
-    for (auto& elem : get_plaintext()) {
+    for (double elem : get_plaintext()) {
       proto_he_type.add_plain(static_cast<float>(elem));
     }
   } else {
@@ -79,4 +81,21 @@ void HEType::set_plaintext(HEPlaintext plain) {
   }
 }
 
+HETypeKind homogeneous_kind(const std::vector<HEType>& values, size_t count) {
+  NGRAPH_CHECK(count <= values.size(), "Count ", count,
+               " is too large for values, with size ", values.size());
+  if (count == 0) {
+    return HETypeKind::mixed;
+  }
+  const bool is_cipher = values[0].is_ciphertext();
+  const bool complex_packing = values[0].complex_packing();
+  for (size_t i = 1; i < count; ++i) {
+    if (values[i].is_ciphertext() != is_cipher ||
+        values[i].complex_packing() != complex_packing) {
+      return HETypeKind::mixed;
+    }
+  }
+  return is_cipher ? HETypeKind::ciphertext : HETypeKind::plaintext;
+}
+
 }  // namespace ngraph::runtime::he
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "he_plaintext.hpp"
 #include "ngraph/type/element_type.hpp"
@@ -82,4 +83,16 @@ class HEType {
   std::shared_ptr<SealCiphertextWrapper> m_cipher;
 };
 
+/// \brief Representation shared by every element of a range of HETypes
+enum class HETypeKind { plaintext, ciphertext, mixed };
+
+/// \brief Returns whether the first count values are all plaintexts or all
+/// ciphertexts with a single complex packing. Elementwise kernels call this
+/// once per op to select a loop without per-element representation checks
+/// \param[in] values Values to inspect
+/// \param[in] count Number of values to inspect
+/// \returns HETypeKind::mixed if the values differ in representation or
+/// complex packing, or if count is zero
+HETypeKind homogeneous_kind(const std::vector<HEType>& values, size_t count);
+
 }  // namespace ngraph::runtime::he
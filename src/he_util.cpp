@@ -73,6 +73,19 @@ bool flag_to_bool(const char* flag, bool default_value) {
   throw ngraph_error("Unknown flag value " + std::string(flag));
 }
 
+size_t env_to_size_t(const char* value, size_t default_value) {
+  if (value == nullptr) {
+    return default_value;
+  }
+  std::string value_str(value);
+  if (value_str.empty() ||
+      value_str.find_first_not_of("0123456789") != std::string::npos ||
+      value_str.size() > 18) {
+    throw ngraph_error("Invalid integer value " + value_str);
+  }
+  return std::stoull(value_str);
+}
+
 double type_to_double(const void* src, const element::Type& element_type) {
 #pragma clang diagnostic push
 #pragma clang diagnostic error "-Wswitch"
@@ -68,6 +68,12 @@ map_to_double_map(
 /// \returns True if flag represents a True value, False otherwise
 bool flag_to_bool(const char* flag, bool default_value = false);
 
+/// \brief Interprets a string as a non-negative integer
+/// \param[in] value Value, for instance of an environment variable
+/// \param[in] default_value Value to return if value is nullptr
+/// \throws ngraph_error if value is not a non-negative integer
+size_t env_to_size_t(const char* value, size_t default_value);
+
 /// \brief Converts a type to a double using static_cast
 /// Note, this means a reduction of range in int64 and uint64 values.
 /// \param[in] src Source from which to read
@@ -112,6 +112,7 @@
 #include "ngraph/op/topk.hpp"
 #include "ngraph/op/xor.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 
 namespace ngraph::runtime::he {
 
@@ -126,7 +127,8 @@ NodeWrapper::NodeWrapper(std::shared_ptr<const ngraph::Node> node)
   static std::unordered_map<std::string, ngraph::runtime::he::OP_TYPEID>
       typeid_map{
 #include "ngraph/op/op_tbl.hpp"
-          NGRAPH_OP(BoundedRelu, ngraph::op)};
+          NGRAPH_OP(BoundedRelu, ngraph::op)
+          NGRAPH_OP(ReluMaxPool, ngraph::op)};
 #undef NGRAPH_OP
   auto it = typeid_map.find(m_node->description());
   NGRAPH_CHECK(it != typeid_map.end(), "Unsupported op ",
@@ -277,6 +279,9 @@ std::shared_ptr<const op::Op> NodeWrapper::get_op() const {
     case OP_TYPEID::Relu: {
       return std::static_pointer_cast<const op::Relu>(m_node);
     }
+    case OP_TYPEID::ReluMaxPool: {
+      return std::static_pointer_cast<const op::ReluMaxPool>(m_node);
+    }
     case OP_TYPEID::Reshape: {
       return std::static_pointer_cast<const op::Reshape>(m_node);
     }
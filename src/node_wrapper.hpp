@@ -33,6 +33,7 @@ class NodeWrapper;
 enum class ngraph::runtime::he::OP_TYPEID {
 #include "ngraph/op/op_tbl.hpp"
   NGRAPH_OP(BoundedRelu, ngraph::op)
+  NGRAPH_OP(ReluMaxPool, ngraph::op)
 };
 #undef NGRAPH_OP
 
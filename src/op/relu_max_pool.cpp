@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "op/relu_max_pool.hpp"
+
+#include <string>
+
+#include "ngraph/util.hpp"
+
+namespace ngraph::op {
+
+const std::string ReluMaxPool::type_name{"ReluMaxPool"};
+
+ReluMaxPool::ReluMaxPool(const Output<Node>& arg, const Shape& window_shape,
+                         const Strides& window_movement_strides,
+                         const Shape& padding_below, const Shape& padding_above,
+                         std::optional<float> bound)
+    : Op({arg}),
+      m_window_shape(window_shape),
+      m_window_movement_strides(window_movement_strides),
+      m_padding_below(padding_below),
+      m_padding_above(padding_above),
+      m_bound(bound) {
+  constructor_validate_and_infer_types();
+}
+
+void ReluMaxPool::validate_and_infer_types() {
+  const Shape& arg_shape = get_input_shape(0);
+  size_t spatial_dims = m_window_shape.size();
+  NODE_VALIDATION_CHECK(this, arg_shape.size() == spatial_dims + 2,
+                        "Argument shape ", arg_shape,
+                        " does not match window shape ", m_window_shape);
+  NODE_VALIDATION_CHECK(this,
+                        m_window_movement_strides.size() == spatial_dims &&
+                            m_padding_below.size() == spatial_dims &&
+                            m_padding_above.size() == spatial_dims,
+                        "Window attributes have inconsistent ranks");
+
+  // Batch and channel axes are kept, each spatial axis is pooled
+  Shape out_shape{arg_shape[0], arg_shape[1]};
+  for (size_t i = 0; i < spatial_dims; ++i) {
+    size_t padded_dim =
+        arg_shape[i + 2] + m_padding_below[i] + m_padding_above[i];
+    NODE_VALIDATION_CHECK(this, m_window_shape[i] <= padded_dim,
+                          "Window shape ", m_window_shape,
+                          " larger than padded argument shape");
+    NODE_VALIDATION_CHECK(this, m_window_movement_strides[i] > 0,
+                          "Window strides must be positive");
+    out_shape.emplace_back((padded_dim - m_window_shape[i]) /
+                               m_window_movement_strides[i] +
+                           1);
+  }
+  set_output_type(0, get_input_element_type(0), out_shape);
+}
+
+std::shared_ptr<Node> ReluMaxPool::copy_with_new_args(
+    const NodeVector& new_args) const {
+  NGRAPH_CHECK(new_args.size() == 1, "Incorrect number of new arguments");
+  return std::make_shared<ReluMaxPool>(
+      new_args.at(0), m_window_shape, m_window_movement_strides,
+      m_padding_below, m_padding_above, m_bound);
+}
+
+float ReluMaxPool::get_bound() const {
+  NGRAPH_CHECK(m_bound.has_value(), "ReluMaxPool is not bounded");
+  return *m_bound;
+}
+
+}  // namespace ngraph::op
@@ -0,0 +1,72 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "ngraph/node.hpp"
+#include "ngraph/op/op.hpp"
+
+namespace ngraph::op {
+/// \brief MaxPool(Relu(arg)) or MaxPool(BoundedRelu(arg, bound)) operation.
+/// Fusing the two lets the client evaluate both in a single round trip
+class ReluMaxPool : public Op {
+ public:
+  static const std::string type_name;
+
+  const std::string& description() const override { return type_name; }
+
+  /// \brief Constructs a ReluMaxPool operation.
+  /// \param[in] arg Node input to the Relu
+  /// \param[in] window_shape Shape of the pooling window
+  /// \param[in] window_movement_strides Strides of the pooling window
+  /// \param[in] padding_below Padding below the spatial axes
+  /// \param[in] padding_above Padding above the spatial axes
+  /// \param[in] bound If set, the upper bound of a BoundedRelu
+  ReluMaxPool(const Output<Node>& arg, const Shape& window_shape,
+              const Strides& window_movement_strides,
+              const Shape& padding_below, const Shape& padding_above,
+              std::optional<float> bound = std::nullopt);
+
+  void validate_and_infer_types() override;
+
+  virtual std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+
+  const Shape& get_window_shape() const { return m_window_shape; }
+  const Strides& get_window_movement_strides() const {
+    return m_window_movement_strides;
+  }
+  const Shape& get_padding_below() const { return m_padding_below; }
+  const Shape& get_padding_above() const { return m_padding_above; }
+
+  /// \brief Returns whether or not the Relu is a BoundedRelu
+  bool is_bounded() const { return m_bound.has_value(); }
+
+  /// \brief Returns the bound of the BoundedRelu
+  /// \throws ngraph_error if the Relu is not bounded
+  float get_bound() const;
+
+ private:
+  Shape m_window_shape;
+  Strides m_window_movement_strides;
+  Shape m_padding_below;
+  Shape m_padding_above;
+  std::optional<float> m_bound;
+};
+}  // namespace ngraph::op
@@ -17,14 +17,17 @@
 #include "pass/he_fusion.hpp"
 
 #include <memory>
+#include <optional>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/builder/make_constant.hpp"
+#include "ngraph/op/max_pool.hpp"
 #include "ngraph/op/minimum.hpp"
 #include "ngraph/op/relu.hpp"
 #include "ngraph/pattern/matcher.hpp"
 #include "ngraph/pattern/op/label.hpp"
 #include "ngraph/runtime/cpu/op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 
 namespace ngraph::runtime::he::pass {
 
@@ -86,4 +89,54 @@ void HEFusion::construct_bounded_relu() {
   this->add_matcher(m, callback);
 }
 
+void HEFusion::construct_relu_max_pool() {
+  auto relu_pred = [](const std::shared_ptr<Node>& n) {
+    return (std::dynamic_pointer_cast<op::Relu>(n) != nullptr) ||
+           (std::dynamic_pointer_cast<op::BoundedRelu>(n) != nullptr);
+  };
+  auto relu =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{1, 1, 2, 2},
+                                           relu_pred);
+  auto max_pool = std::make_shared<op::MaxPool>(relu, Shape{1, 1});
+
+  auto callback = [relu](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_relu_max_pool against "
+                     << m.get_match_root()->get_name();
+
+    auto max_pool_node =
+        std::static_pointer_cast<op::MaxPool>(m.get_match_root());
+    auto relu_node = m.get_pattern_map()[relu];
+
+    // The Relu output is also needed elsewhere
+    if (relu_node->get_users().size() != 1) {
+      NGRAPH_HE_LOG(5) << "Relu " << relu_node->get_name()
+                       << " has multiple users";
+      return false;
+    }
+
+    std::optional<float> bound;
+    if (auto bounded_relu =
+            std::dynamic_pointer_cast<op::BoundedRelu>(relu_node)) {
+      bound = bounded_relu->get_alpha();
+    }
+
+    auto relu_max_pool = std::make_shared<op::ReluMaxPool>(
+        relu_node->input_value(0), max_pool_node->get_window_shape(),
+        max_pool_node->get_window_movement_strides(),
+        max_pool_node->get_padding_below(), max_pool_node->get_padding_above(),
+        bound);
+
+    // E.g. MaxPool with ceil mode
+    if (relu_max_pool->get_shape() != max_pool_node->get_shape()) {
+      NGRAPH_HE_LOG(5) << "Output shapes do not match";
+      return false;
+    }
+    replace_node(m.get_match_root(), relu_max_pool);
+    return true;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(max_pool, "ReluMaxPool");
+  this->add_matcher(m, callback);
+}
+
 }  // namespace ngraph::runtime::he::pass
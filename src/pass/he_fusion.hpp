@@ -23,9 +23,16 @@ namespace ngraph::runtime::he::pass {
 /// \brief performs HE-friendly fusion operations
 class HEFusion : public ngraph::pass::GraphRewrite {
  public:
-  HEFusion() : GraphRewrite() { construct_bounded_relu(); }
+  HEFusion() : GraphRewrite() {
+    construct_bounded_relu();
+    construct_relu_max_pool();
+  }
 
   /// \brief Fuses Min(Relu, Constant) op into BoundedRelu(Constant) op
   void construct_bounded_relu();
+
+  /// \brief Fuses MaxPool(Relu) and MaxPool(BoundedRelu) ops into a
+  /// ReluMaxPool op, which the client evaluates in a single round trip
+  void construct_relu_max_pool();
 };
 }  // namespace ngraph::runtime::he::pass
@@ -28,6 +28,7 @@
 #include "seal/he_seal_executable.hpp"
 #include "seal/seal.h"
 #include "seal/seal_util.hpp"
+#include "tcp/tcp_transport.hpp"
 
 using json = nlohmann::json;
 
@@ -59,13 +60,17 @@ void HESealBackend::generate_context() {
   auto context_data = m_context->key_context_data();
 
   m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
-  if (m_context->using_keyswitching()) {
-    m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
-    m_galois_keys = std::make_shared<seal::GaloisKeys>(m_keygen->galois_keys());
+  {
+    std::lock_guard<std::mutex> guard(m_eval_key_mutex);
+    m_relin_keys = nullptr;
+    m_galois_keys = nullptr;
+    m_galois_elements.clear();
   }
   m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
   m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
-  m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+  m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key,
+                                                  *m_secret_key);
+  m_encryptor_has_secret_key = true;
   m_decryptor = std::make_shared<seal::Decryptor>(m_context, *m_secret_key);
   m_evaluator = std::make_shared<seal::Evaluator>(m_context);
   m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(m_context);
@@ -106,6 +111,51 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
       auto new_parms = HESealEncryptionParameters::parse_config_or_use_default(
           setting.c_str());
       update_encryption_parameters(new_parms);
+    } else if (option == "server_uri") {
+      // Parse now, so an invalid URI fails at configuration time
+      m_server_uri = TransportAddress::parse(setting).uri();
+      NGRAPH_HE_LOG(3) << "Server URI " << m_server_uri;
+    } else if (option == "data_connections") {
+      NGRAPH_CHECK(
+          !setting.empty() &&
+              setting.find_first_not_of("0123456789") == std::string::npos &&
+              setting.size() <= 2,
+          "Invalid number of data connections ", setting);
+      m_data_connections = std::stoul(setting);
+      NGRAPH_CHECK(m_data_connections >= 1 &&
+                       m_data_connections <= max_data_connections,
+                   "Number of data connections must be in [1, ",
+                   max_data_connections, "] (got ", setting, ")");
+    } else if (option == "key_cache_bytes") {
+      NGRAPH_CHECK(
+          !setting.empty() &&
+              setting.find_first_not_of("0123456789") == std::string::npos,
+          "Invalid key cache size ", setting);
+      m_key_cache.set_max_bytes(std::stoull(setting));
+    } else if (option == "memory_pool_bytes") {
+      NGRAPH_CHECK(
+          !setting.empty() &&
+              setting.find_first_not_of("0123456789") == std::string::npos,
+          "Invalid memory pool size ", setting);
+      m_memory_pools.set_max_bytes(std::stoull(setting));
+    } else if (option == "spill_bytes") {
+      NGRAPH_CHECK(
+          !setting.empty() &&
+              setting.find_first_not_of("0123456789") == std::string::npos,
+          "Invalid spill size ", setting);
+      m_spill_bytes = std::stoull(setting);
+    } else if (option == "spill_dir") {
+      NGRAPH_CHECK(!setting.empty(), "Invalid spill directory");
+      m_spill_directory = setting;
+      NGRAPH_HE_LOG(3) << "Spill directory " << setting;
+    } else if (option == "key_cache_dir") {
+      m_key_cache.set_spill_directory(setting);
+      NGRAPH_HE_LOG(3) << "Key cache directory " << setting;
+    } else if (option == "symmetric_encryption") {
+      m_enable_symmetric_encryption = flag_to_bool(setting.c_str(), true);
+      NGRAPH_HE_LOG(3) << "Symmetric encryption "
+                       << (m_enable_symmetric_encryption ? "enabled"
+                                                         : "disabled");
     } else {
       std::string lower_option = to_lower(option);
       std::vector<std::string> lower_settings = split(to_lower(setting), ',');
@@ -149,6 +199,42 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
   return true;
 }
 
+const std::shared_ptr<seal::RelinKeys> HESealBackend::get_relin_keys() const {
+  std::lock_guard<std::mutex> guard(m_eval_key_mutex);
+  if (m_relin_keys == nullptr && m_context->using_keyswitching()) {
+    NGRAPH_HE_LOG(3) << "Generating relinearization keys";
+    m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+  }
+  return m_relin_keys;
+}
+
+void HESealBackend::add_galois_elements(
+    const std::set<std::uint64_t>& galois_elements) {
+  std::lock_guard<std::mutex> guard(m_eval_key_mutex);
+  for (const auto galois_element : galois_elements) {
+    if (m_galois_elements.insert(galois_element).second) {
+      // Regenerate on next use, to cover the new element
+      m_galois_keys = nullptr;
+    }
+  }
+}
+
+const std::shared_ptr<seal::GaloisKeys> HESealBackend::get_galois_keys()
+    const {
+  std::lock_guard<std::mutex> guard(m_eval_key_mutex);
+  if (m_galois_keys == nullptr) {
+    NGRAPH_CHECK(!m_galois_elements.empty(), "No Galois keys requested");
+    NGRAPH_CHECK(m_context->using_keyswitching(),
+                 "Galois keys require key switching");
+    NGRAPH_HE_LOG(3) << "Generating Galois keys for "
+                     << m_galois_elements.size() << " Galois elements";
+    m_galois_keys = std::make_shared<seal::GaloisKeys>(m_keygen->galois_keys(
+        std::vector<std::uint64_t>(m_galois_elements.begin(),
+                                   m_galois_elements.end())));
+  }
+  return m_galois_keys;
+}
+
 void HESealBackend::update_encryption_parameters(
     const HESealEncryptionParameters& new_parms) {
   if (HESealEncryptionParameters::same_context(m_encryption_params,
@@ -175,9 +261,11 @@ std::shared_ptr<runtime::Tensor> HESealBackend::create_plain_tensor(
 
 std::shared_ptr<runtime::Tensor> HESealBackend::create_cipher_tensor(
     const element::Type& type, const Shape& shape, const bool plaintext_packing,
-    const std::string& name) const {
+    const std::string& name, HESealCiphertextPool* ciphertext_pool,
+    const seal::parms_id_type& ciphertext_parms_id) const {
   auto tensor = std::make_shared<HETensor>(
-      type, shape, plaintext_packing, complex_packing(), true, *this, name);
+      type, shape, plaintext_packing, complex_packing(), true, *this, name,
+      ciphertext_pool, ciphertext_parms_id);
   return std::static_pointer_cast<runtime::Tensor>(tensor);
 }
 
@@ -243,14 +331,15 @@ void HESealBackend::encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
   NGRAPH_CHECK(!input.empty(), "Input has no values in encrypt");
   ngraph::runtime::he::encrypt(output, input, m_context->first_parms_id(), type,
                                get_scale(), *m_ckks_encoder, *m_encryptor,
-                               complex_packing);
+                               complex_packing, memory_pool(),
+                               symmetric_encryption());
 }
 
 void HESealBackend::decrypt(HEPlaintext& output,
                             const SealCiphertextWrapper& input,
                             const bool complex_packing) const {
   ngraph::runtime::he::decrypt(output, input, complex_packing, *m_decryptor,
-                               *m_ckks_encoder);
+                               *m_ckks_encoder, memory_pool());
 }
 
 }  // namespace ngraph::runtime::he
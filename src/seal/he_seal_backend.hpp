@@ -17,8 +17,13 @@
 #pragma once
 
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "he_op_annotations.hpp"
@@ -42,10 +47,14 @@
 #include "ngraph/type/element_type.hpp"
 #include "ngraph/util.hpp"
 #include "node_wrapper.hpp"
+#include "seal/he_seal_ciphertext_pool.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/he_seal_key_cache.hpp"
+#include "seal/he_seal_memory_pools.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
+#include "tcp/tcp_transport.hpp"
 
 extern "C" void ngraph_register_he_seal_backend();
 
@@ -109,6 +118,28 @@ class HESealBackend : public runtime::Backend {
   ///     should use plaintext packing.
   ///     5) {"encryption_parameters" : "filename
   ///     or json string"}, which sets the encryption parameters to use.
+  ///     6) {"server_uri" : "tcp://hostname:port", "unix:///path/to/socket",
+  ///     or "shm:///path/to/socket"}, which sets the address and transport
+  ///     the server listens on for the client.
+  ///     7) {"data_connections" : "N"}, which sets the number of parallel
+  ///     connections the client opens. Input and result tensors are striped
+  ///     across them.
+  ///     8) {"key_cache_bytes" : "N"}, which bounds the memory used to cache
+  ///     client public and relinearization keys across connections.
+  ///     9) {"key_cache_dir" : "path"}, which sets a directory in which
+  ///     cached client keys persist across server restarts.
+  ///     10) {"symmetric_encryption" : "True" / "False"}, which indicates
+  ///     whether or not the server encrypts with its secret key while it owns
+  ///     the keys. Enabled by default.
+  ///     11) {"memory_pool_bytes" : "N"}, which bounds the memory SEAL retains
+  ///     for temporaries. The memory pools are freed between ops once they
+  ///     exceed N bytes.
+  ///     12) {"spill_bytes" : "N"}, which bounds the memory held by the
+  ///     ciphertexts of live tensors during a call. Once over N bytes,
+  ///     intermediate tensors used furthest in the future are spilled to disk,
+  ///     and prefetched before the ops consuming them.
+  ///     13) {"spill_dir" : "path"}, which sets the directory spilled tensors
+  ///     are written to. Defaults to the system temporary directory.
   ///
   ///     Note, entries with the same tensor key should be comma-separated,
   ///     for instance: {tensor_name : "client_input,encrypt,packed"}
@@ -158,11 +189,19 @@ class HESealBackend : public runtime::Backend {
   /// \param[in] shape Shape of the tensor
   /// \param[in] plaintext_packing Whether or not to use plaintext packing
   /// \param[in] name Name of the created tensor
+  /// \param[in] ciphertext_pool If set, pool from which to take the
+  /// ciphertexts
+  /// \param[in] ciphertext_parms_id Encryption parameters of the ciphertexts
+  /// to take from the pool. The first parameters of the context if
+  /// parms_id_zero
   /// \returns Pointer to created tensor
   std::shared_ptr<runtime::Tensor> create_cipher_tensor(
       const element::Type& type, const Shape& shape,
       const bool plaintext_packing = false,
-      const std::string& name = "external") const;
+      const std::string& name = "external",
+      HESealCiphertextPool* ciphertext_pool = nullptr,
+      const seal::parms_id_type& ciphertext_parms_id =
+          seal::parms_id_zero) const;
 
   /// \brief Creates empty ciphertext
   /// \returns Pointer to created ciphertext
@@ -188,16 +227,30 @@ class HESealBackend : public runtime::Backend {
     return m_context;
   }
 
-  /// \brief Returns pointer to relinearization keys
-  const std::shared_ptr<seal::RelinKeys> get_relin_keys() const {
-    return m_relin_keys;
+  /// \brief Returns pointer to public key
+  const std::shared_ptr<seal::PublicKey> get_public_key() const {
+    return m_public_key;
   }
 
-  /// \brief Returns pointer to Galois keys
-  const std::shared_ptr<seal::GaloisKeys> get_galois_keys() const {
-    return m_galois_keys;
+  /// \brief Returns pointer to relinearization keys. Unless set by a client,
+  /// the keys are generated on first use
+  const std::shared_ptr<seal::RelinKeys> get_relin_keys() const;
+
+  /// \brief Requests Galois keys for the given Galois elements. The keys are
+  /// generated on the next call to get_galois_keys
+  /// \param[in] galois_elements Galois elements to generate keys for
+  void add_galois_elements(const std::set<std::uint64_t>& galois_elements);
+
+  /// \brief Returns the Galois element used for complex conjugation
+  std::uint64_t complex_conjugate_galois_element() const {
+    return 2 * m_encryption_params.poly_modulus_degree() - 1;
   }
 
+  /// \brief Returns pointer to Galois keys for the requested Galois elements,
+  /// generating them on first use
+  /// \throws ngraph_error if no Galois elements were requested
+  const std::shared_ptr<seal::GaloisKeys> get_galois_keys() const;
+
   /// \brief Returns pointer to encryptor
   const std::shared_ptr<seal::Encryptor> get_encryptor() const {
     return m_encryptor;
@@ -233,15 +286,39 @@ class HESealBackend : public runtime::Backend {
   /// with the other SEAL keys
   /// \param[in] keys relinearization keys
   void set_relin_keys(const seal::RelinKeys& keys) {
+    std::lock_guard<std::mutex> guard(m_eval_key_mutex);
     m_relin_keys = std::make_shared<seal::RelinKeys>(keys);
   }
 
+  /// \brief Sets the relinearization keys without copying them
+  /// \param[in] keys relinearization keys
+  void set_relin_keys(std::shared_ptr<seal::RelinKeys> keys) {
+    std::lock_guard<std::mutex> guard(m_eval_key_mutex);
+    m_relin_keys = std::move(keys);
+  }
+
   /// \brief Sets the public keys. Note, they may not be compatible
   /// with the other SEAL keys
   /// \param[in] key public key
   void set_public_key(const seal::PublicKey& key) {
     m_public_key = std::make_shared<seal::PublicKey>(key);
     m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+    m_encryptor_has_secret_key = false;
+  }
+
+  /// \brief Sets the public key without copying it
+  /// \param[in] key public key
+  void set_public_key(std::shared_ptr<seal::PublicKey> key) {
+    m_public_key = std::move(key);
+    m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+    m_encryptor_has_secret_key = false;
+  }
+
+  /// \brief Returns whether or not encryption uses the secret key. This is
+  /// the case when the backend generated its own keys, since symmetric
+  /// encryption is faster and yields smaller noise than public-key encryption
+  bool symmetric_encryption() const {
+    return m_enable_symmetric_encryption && m_encryptor_has_secret_key;
   }
 
   /// \brief TODO(fboemer)
@@ -259,6 +336,36 @@ class HESealBackend : public runtime::Backend {
   /// \brief Returns whether or not the client is enabled
   bool enable_client() const { return m_enable_client; }
 
+  /// \brief Returns the URI of the address the server listens on
+  const std::string& server_uri() const { return m_server_uri; }
+
+  /// \brief Returns the number of connections the client opens, including the
+  /// first
+  size_t data_connections() const { return m_data_connections; }
+
+  /// \brief Maximum number of connections the client may open
+  static constexpr size_t max_data_connections = 64;
+
+  /// \brief Returns the cache of client evaluation keys
+  HESealKeyCache& key_cache() { return m_key_cache; }
+
+  /// \brief Returns the memory pool for temporaries of the calling thread.
+  /// Kernels should call this inside their parallel loops
+  const seal::MemoryPoolHandle& memory_pool() const {
+    return m_memory_pools.local();
+  }
+
+  /// \brief Returns the per-thread memory pools for temporaries
+  HESealMemoryPools& memory_pools() { return m_memory_pools; }
+
+  /// \brief Returns the memory budget in bytes for the ciphertexts of live
+  /// tensors, beyond which executables spill intermediate tensors to disk
+  size_t spill_bytes() const { return m_spill_bytes; }
+
+  /// \brief Returns the directory to which tensors are spilled. Empty to use
+  /// the system temporary directory
+  const std::string& spill_directory() const { return m_spill_directory; }
+
   /// \brief Returns the chain index, also known as level, of the ciphertext
   /// \param[in] cipher Ciphertext whose chain index to return
   /// \returns The chain index of the ciphertext.
@@ -277,16 +384,31 @@ class HESealBackend : public runtime::Backend {
 
  private:
   bool m_enable_client{false};
+  std::string m_server_uri{TransportAddress::default_uri};
+  size_t m_data_connections{1};
+  HESealKeyCache m_key_cache;
+  HESealMemoryPools m_memory_pools;
+  size_t m_spill_bytes{std::numeric_limits<size_t>::max()};
+  std::string m_spill_directory;
+  bool m_enable_symmetric_encryption{true};
+  // Whether or not m_encryptor holds the secret key matching m_public_key
+  bool m_encryptor_has_secret_key{false};
 
   std::shared_ptr<seal::SecretKey> m_secret_key;
   std::shared_ptr<seal::PublicKey> m_public_key;
-  std::shared_ptr<seal::RelinKeys> m_relin_keys;
   std::shared_ptr<seal::Encryptor> m_encryptor;
   std::shared_ptr<seal::Decryptor> m_decryptor;
   std::shared_ptr<seal::SEALContext> m_context;
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
-  std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+
+  // Evaluation keys are generated on first use, since Galois keys in
+  // particular are large and slow to generate, and a server with a client
+  // uses the client's keys instead
+  mutable std::mutex m_eval_key_mutex;
+  mutable std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  mutable std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+  std::set<std::uint64_t> m_galois_elements;
   HESealEncryptionParameters m_encryption_params;
   std::shared_ptr<seal::CKKSEncoder> m_ckks_encoder;
 
@@ -0,0 +1,83 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_ciphertext_pool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+HESealCiphertextPool::HESealCiphertextPool(size_t max_bytes)
+    : m_max_bytes(max_bytes) {}
+
+size_t HESealCiphertextPool::byte_count(const seal::Ciphertext& cipher) {
+  return cipher.uint64_count() * sizeof(std::uint64_t);
+}
+
+std::shared_ptr<SealCiphertextWrapper> HESealCiphertextPool::acquire(
+    const seal::parms_id_type& parms_id, size_t size) {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_stats.acquired;
+    auto it = m_buckets.find(Bucket{parms_id, size});
+    if (it != m_buckets.end() && !it->second.empty()) {
+      auto& ciphers = it->second;
+      auto cipher = std::move(ciphers.back());
+      ciphers.pop_back();
+      ++m_stats.reused;
+      --m_stats.size;
+      m_stats.bytes -= byte_count(cipher->ciphertext());
+      return cipher;
+    }
+  }
+  return std::make_shared<SealCiphertextWrapper>();
+}
+
+void HESealCiphertextPool::release(
+    std::shared_ptr<SealCiphertextWrapper>& cipher) {
+  if (cipher == nullptr || cipher.use_count() != 1 ||
+      cipher->ciphertext().size() == 0) {
+    return;
+  }
+  const seal::Ciphertext& ciphertext = cipher->ciphertext();
+  size_t bytes = byte_count(ciphertext);
+  Bucket bucket{ciphertext.parms_id(), ciphertext.size()};
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_stats.bytes + bytes > m_max_bytes) {
+    return;
+  }
+  m_buckets[bucket].emplace_back(std::move(cipher));
+  ++m_stats.released;
+  ++m_stats.size;
+  m_stats.bytes += bytes;
+}
+
+void HESealCiphertextPool::clear() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_buckets.clear();
+  m_stats.size = 0;
+  m_stats.bytes = 0;
+}
+
+HESealCiphertextPool::Stats HESealCiphertextPool::stats() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_stats;
+}
+}  // namespace ngraph::runtime::he
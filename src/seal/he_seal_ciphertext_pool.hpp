@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Pool of ciphertexts whose polynomial buffers are reused.
+///
+/// Ciphertexts of dead tensors are returned to the pool, bucketed by
+/// (encryption parameters, size). Acquired ciphertexts come from the bucket of
+/// the requested parameters and size, so SEAL overwrites them without
+/// reallocating their buffers.
+class HESealCiphertextPool {
+ public:
+  /// \brief Pool statistics
+  struct Stats {
+    /// \brief Number of ciphertexts handed out
+    size_t acquired{0};
+    /// \brief Number of acquired ciphertexts which came from the pool
+    size_t reused{0};
+    /// \brief Number of ciphertexts returned to the pool
+    size_t released{0};
+    /// \brief Number of ciphertexts in the pool
+    size_t size{0};
+    /// \brief Size in bytes of the pooled ciphertext buffers
+    size_t bytes{0};
+
+    /// \brief Returns the fraction of acquired ciphertexts which were reused
+    double reuse_rate() const {
+      return acquired == 0 ? 0.
+                           : static_cast<double>(reused) /
+                                 static_cast<double>(acquired);
+    }
+  };
+
+  /// \brief Constructs an empty pool
+  /// \param[in] max_bytes Maximum size in bytes of the pooled ciphertext
+  /// buffers. Ciphertexts released beyond this are freed
+  explicit HESealCiphertextPool(
+      size_t max_bytes = std::numeric_limits<size_t>::max());
+
+  HESealCiphertextPool(const HESealCiphertextPool&) = delete;
+  HESealCiphertextPool& operator=(const HESealCiphertextPool&) = delete;
+
+  /// \brief Returns a ciphertext with the given encryption parameters and
+  /// size from the pool, or a new empty ciphertext if there is none. Results
+  /// of an op are at most at the level of its arguments, whose buffers
+  /// therefore fit them. Safe to call from any thread
+  /// \param[in] parms_id Encryption parameters of the ciphertext
+  /// \param[in] size Number of polynomials of the ciphertext
+  std::shared_ptr<SealCiphertextWrapper> acquire(
+      const seal::parms_id_type& parms_id, size_t size = 2);
+
+  /// \brief Returns a ciphertext to the pool. Ciphertexts which are shared, or
+  /// which hold no buffer, are not pooled. Safe to call from any thread
+  /// \param[in,out] cipher Ciphertext to return. Reset if pooled
+  void release(std::shared_ptr<SealCiphertextWrapper>& cipher);
+
+  /// \brief Frees all pooled ciphertexts
+  void clear();
+
+  /// \brief Returns the pool statistics
+  Stats stats() const;
+
+ private:
+  // (encryption parameters, size)
+  using Bucket = std::pair<seal::parms_id_type, size_t>;
+
+  static size_t byte_count(const seal::Ciphertext& cipher);
+
+  size_t m_max_bytes;
+
+  mutable std::mutex m_mutex;
+  std::map<Bucket, std::vector<std::shared_ptr<SealCiphertextWrapper>>>
+      m_buckets;
+  Stats m_stats;
+};
+}  // namespace ngraph::runtime::he
@@ -17,11 +17,21 @@
 #include "seal/he_seal_client.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "boost/asio.hpp"
@@ -29,41 +39,138 @@
 #include "ngraph/log.hpp"
 #include "nlohmann/json.hpp"
 #include "seal/kernel/bounded_relu_seal.hpp"
-#include "seal/kernel/max_pool_seal.hpp"
 #include "seal/kernel/relu_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_transport.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using json = nlohmann::json;
 
 namespace ngraph::runtime::he {
 
-HESealClient::HESealClient(const std::string& hostname, const size_t port,
+namespace {
+// Counts the callers in a scope
+class ActiveCount {
+ public:
+  explicit ActiveCount(std::atomic<size_t>& counter)
+      : m_counter(counter), m_count(++counter) {}
+  ~ActiveCount() { --m_counter; }
+  ActiveCount(const ActiveCount&) = delete;
+  ActiveCount& operator=(const ActiveCount&) = delete;
+
+  // Number of callers in the scope when this one entered it, including itself
+  size_t count() const { return m_count; }
+
+ private:
+  std::atomic<size_t>& m_counter;
+  size_t m_count;
+};
+
+// Returns the maximum of each pooling window of a MaxPool request. Windows
+// hold consecutive values, with the sizes listed in the request; requests
+// without sizes hold a single window
+std::vector<HEPlaintext> max_pool_windows(
+    const std::vector<HEPlaintext>& values, const json& function_js) {
+  std::vector<size_t> window_sizes{values.size()};
+  if (function_js.find("window_sizes") != function_js.end()) {
+    window_sizes = function_js.at("window_sizes").get<std::vector<size_t>>();
+  }
+  std::vector<size_t> window_begins;
+  window_begins.reserve(window_sizes.size());
+  size_t window_begin = 0;
+  for (size_t window_size : window_sizes) {
+    NGRAPH_CHECK(window_size > 0, "MaxPool window is empty");
+    window_begins.push_back(window_begin);
+    window_begin += window_size;
+  }
+  NGRAPH_CHECK(window_begin == values.size(), "MaxPool window sizes add up to ",
+               window_begin, ", not to the ", values.size(), " values");
+  for (size_t window_idx = 0; window_idx < window_sizes.size(); ++window_idx) {
+    size_t begin = window_begins[window_idx];
+    for (size_t i = 1; i < window_sizes[window_idx]; ++i) {
+      NGRAPH_CHECK(values[begin + i].size() == values[begin].size(),
+                   "MaxPool values have different batch sizes");
+    }
+  }
+
+  std::vector<HEPlaintext> max_values(window_sizes.size());
+#pragma omp parallel for
+  for (size_t window_idx = 0; window_idx < window_sizes.size();
+       ++window_idx) {
+    size_t begin = window_begins[window_idx];
+    size_t end = begin + window_sizes[window_idx];
+    HEPlaintext max_value = values[begin];
+    for (size_t value_idx = begin + 1; value_idx < end; ++value_idx) {
+      for (size_t i = 0; i < max_value.size(); ++i) {
+        max_value[i] = std::max(max_value[i], values[value_idx][i]);
+      }
+    }
+    max_values[window_idx] = std::move(max_value);
+  }
+  return max_values;
+}
+
+template <typename Key>
+std::string serialize_key(const Key& key) {
+  std::stringstream stream;
+  key.save(stream);
+  return stream.str();
+}
+}  // namespace
+
+HESealClient::HESealClient(const TransportAddress& address)
+    : m_address{address} {
+  connect();
+  m_io_thread = std::thread([this]() { m_io_context.run(); });
+}
+
+HESealClient::HESealClient(const std::string& uri)
+    : HESealClient(TransportAddress::parse(uri)) {}
+
+HESealClient::HESealClient(const TransportAddress& address,
                            const size_t batch_size,
                            const HETensorConfigMap<double>& inputs)
-    : m_batch_size{batch_size}, m_input_config{inputs} {
+    : m_address{address}, m_close_when_idle{true} {
   NGRAPH_HE_LOG(5) << "Creating HESealClient from config";
-  NGRAPH_CHECK(m_input_config.size() == 1,
-               "Client supports only one input parameter");
-
   for (const auto& elem : inputs) {
     NGRAPH_HE_LOG(1) << "Client input tensor: " << elem.first;
   }
+  // The request is sent once the server sent the inference shape
+  infer(inputs, batch_size);
+  connect();
+  m_io_context.run();
+}
+
+HESealClient::~HESealClient() {
+  if (m_io_thread.joinable()) {
+    close_connection();
+    m_io_thread.join();
+  }
+}
 
-  boost::asio::io_context io_context;
-  boost::asio::ip::tcp::resolver resolver(io_context);
-  auto endpoints = resolver.resolve(hostname, std::to_string(port));
+void HESealClient::connect() {
+  NGRAPH_HE_LOG(1) << "Client connecting to " << m_address.uri();
   auto client_callback = [this](const TCPMessage& message) {
     return handle_message(message);
   };
+  NGRAPH_CHECK(m_worker_count > 0, "Client needs at least one worker");
   m_tcp_client =
-      std::make_unique<TCPClient>(io_context, endpoints, client_callback);
-  io_context.run();
+      std::make_unique<TCPClient>(m_io_context, m_address, client_callback,
+                                  m_worker_count, m_shm_ring_capacity);
 }
 
+HESealClient::HESealClient(const std::string& hostname, const size_t port,
+                           const size_t batch_size,
+                           const HETensorConfigMap<double>& inputs)
+    : HESealClient(TransportAddress(hostname, port), batch_size, inputs) {}
+
 HESealClient::HESealClient(const std::string& hostname, const size_t port,
                            const size_t batch_size,
                            const HETensorConfigMap<float>& inputs)
@@ -76,6 +183,192 @@ HESealClient::HESealClient(const std::string& hostname, const size_t port,
     : HESealClient(hostname, port, batch_size,
                    map_to_double_map<int64_t>(inputs)) {}
 
+HESealClient::HESealClient(const std::string& uri, const size_t batch_size,
+                           const HETensorConfigMap<double>& inputs)
+    : HESealClient(TransportAddress::parse(uri), batch_size, inputs) {}
+
+HESealClient::HESealClient(const std::string& uri, const size_t batch_size,
+                           const HETensorConfigMap<float>& inputs)
+    : HESealClient(uri, batch_size, map_to_double_map<float>(inputs)) {}
+
+HESealClient::HESealClient(const std::string& uri, const size_t batch_size,
+                           const HETensorConfigMap<int64_t>& inputs)
+    : HESealClient(uri, batch_size, map_to_double_map<int64_t>(inputs)) {}
+
+void HESealClient::InferenceRequest::complete(const Shape& shape) {
+  if (returns_values) {
+    results.set_value(std::move(values));
+  } else {
+    result_shape.set_value(shape);
+  }
+}
+
+void HESealClient::InferenceRequest::fail(const std::exception_ptr& error) {
+  if (returns_values) {
+    results.set_exception(error);
+  } else {
+    result_shape.set_exception(error);
+  }
+}
+
+std::future<std::vector<double>> HESealClient::infer(
+    const HETensorConfigMap<double>& inputs, size_t batch_size) {
+  auto request = std::make_shared<InferenceRequest>();
+  request->inputs = inputs;
+  for (const auto& [name, config_values] : request->inputs) {
+    const auto& [config, values] = config_values;
+    request->input_views[name] =
+        HEInputView{config, values.data(), values.size(), element::f64};
+  }
+  request->batch_size = batch_size;
+  // The request outlives its allocator, so a raw pointer avoids a cycle
+  InferenceRequest* raw_request = request.get();
+  request->allocate_output = [raw_request](const Shape& shape,
+                                           const element::Type& /*type*/) {
+    raw_request->values.resize(shape_size(shape));
+    return HEOutputView{raw_request->values.data(), raw_request->values.size(),
+                        element::f64};
+  };
+  request->returns_values = true;
+
+  auto results = request->results.get_future();
+  queue_request(std::move(request));
+  return results;
+}
+
+std::future<Shape> HESealClient::infer(const HEInputViewMap& inputs,
+                                       size_t batch_size,
+                                       HEOutputAllocator allocate_output,
+                                       std::shared_ptr<void> keep_alive) {
+  NGRAPH_CHECK(allocate_output != nullptr, "No output allocator");
+  auto request = std::make_shared<InferenceRequest>();
+  request->input_views = inputs;
+  request->batch_size = batch_size;
+  request->allocate_output = std::move(allocate_output);
+  request->keep_alive = std::move(keep_alive);
+
+  auto result_shape = request->result_shape.get_future();
+  queue_request(std::move(request));
+  return result_shape;
+}
+
+void HESealClient::queue_request(std::shared_ptr<InferenceRequest> request) {
+  NGRAPH_CHECK(request->input_views.size() == 1,
+               "Client supports only one input parameter");
+  NGRAPH_CHECK(request->batch_size > 0, "Batch size must be positive");
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    NGRAPH_CHECK(!is_done(), "Client connection is closed");
+    m_requests.emplace_back(std::move(request));
+  }
+  send_next_request();
+}
+
+std::future<std::vector<double>> HESealClient::infer(
+    const HETensorConfigMap<float>& inputs, size_t batch_size) {
+  return infer(map_to_double_map<float>(inputs), batch_size);
+}
+
+std::future<std::vector<double>> HESealClient::infer(
+    const HETensorConfigMap<int64_t>& inputs, size_t batch_size) {
+  return infer(map_to_double_map<int64_t>(inputs), batch_size);
+}
+
+void HESealClient::send_next_request() {
+  std::shared_ptr<InferenceRequest> request;
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    if (!m_inference_shape.has_value() || m_request_in_flight ||
+        m_requests.empty()) {
+      return;
+    }
+    m_request_in_flight = true;
+    request = m_requests.front();
+  }
+
+  std::exception_ptr error;
+  try {
+    send_inputs(request->input_views, request->batch_size);
+    return;
+  } catch (const std::exception& e) {
+    NGRAPH_ERR << "Client error sending inference: " << e.what();
+    error = std::current_exception();
+  }
+
+  // Nothing was sent, so the server still waits for inputs
+  bool close = false;
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    if (m_requests.empty() || m_requests.front() != request) {
+      // The connection was closed, which failed the request
+      return;
+    }
+    m_requests.pop_front();
+    m_request_in_flight = false;
+    close = m_close_when_idle && m_requests.empty();
+  }
+  request->fail(error);
+  if (close) {
+    close_connection();
+  } else {
+    send_next_request();
+  }
+}
+
+std::shared_ptr<HESealClient::InferenceRequest>
+HESealClient::request_in_flight() {
+  std::lock_guard<std::mutex> guard(m_request_mutex);
+  NGRAPH_CHECK(m_request_in_flight, "Client received result of no inference");
+  return m_requests.front();
+}
+
+HEOutputView HESealClient::allocate_output(InferenceRequest& request,
+                                           const Shape& shape,
+                                           const element::Type& type) {
+  HEOutputView output = request.allocate_output(shape, type);
+  NGRAPH_CHECK(output.data != nullptr || shape_size(shape) == 0,
+               "No destination for result");
+  NGRAPH_CHECK(output.count == shape_size(shape), "Result has ",
+               shape_size(shape), " values, destination holds ", output.count);
+  NGRAPH_CHECK(output.type == type || output.type == element::f32 ||
+                   output.type == element::f64,
+               "Cannot decrypt result of type ", type, " into type ",
+               output.type);
+  return output;
+}
+
+void HESealClient::finish_request(const Shape& shape,
+                                  const std::exception_ptr& error) {
+  std::shared_ptr<InferenceRequest> request;
+  bool close = false;
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    if (!m_request_in_flight) {
+      NGRAPH_WARN << "Client dropping result of closed inference";
+      return;
+    }
+    request = m_requests.front();
+    m_requests.pop_front();
+    m_request_in_flight = false;
+    close = m_close_when_idle && m_requests.empty();
+  }
+  if (error != nullptr) {
+    request->fail(error);
+  } else {
+    if (request->returns_values) {
+      std::lock_guard<std::mutex> guard(m_is_done_mutex);
+      m_results = request->values;
+    }
+    request->complete(shape);
+  }
+
+  if (close) {
+    close_connection();
+  } else {
+    send_next_request();
+  }
+}
+
 void HESealClient::set_seal_context() {
   NGRAPH_HE_LOG(5) << "Client setting seal context";
   auto seal_sec_level =
@@ -86,39 +379,140 @@ void HESealClient::set_seal_context() {
 
   print_encryption_parameters(m_encryption_params, *m_context);
 
-  m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
-  if (m_context->using_keyswitching()) {
-    m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+  m_keys_loaded = load_keys();
+  if (!m_keys_loaded) {
+    m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
+    m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
+    m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+    save_keys();
   }
-  m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
-  m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+  // The fingerprint covers the relinearization keys, so it is only known
+  // before the key upload if they were loaded too
+  if (m_keys_loaded &&
+      (m_relin_keys != nullptr || !m_context->using_keyswitching())) {
+    m_key_fingerprint = key_fingerprint(
+        serialize_key(*m_public_key),
+        m_relin_keys == nullptr ? "" : serialize_key(*m_relin_keys));
+  }
+
   m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+  // encrypt_value() encrypts inputs and re-encrypted results alike at the
+  // first level, so only that level is pooled
+  m_zero_pool = std::make_unique<HESealZeroPool>(
+      m_context, m_encryptor,
+      std::vector<seal::parms_id_type>{m_context->first_parms_id()},
+      m_zero_pool_size, m_zero_pool_threads);
   m_decryptor = std::make_shared<seal::Decryptor>(m_context, *m_secret_key);
   m_evaluator = std::make_shared<seal::Evaluator>(m_context);
   m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(m_context);
 }
 
+std::string HESealClient::key_directory() const {
+  return (std::filesystem::path(m_key_dir) /
+          hash_to_string(m_context->key_parms_id()))
+      .string();
+}
+
+bool HESealClient::load_keys() {
+  if (m_key_dir.empty()) {
+    return false;
+  }
+  std::filesystem::path directory(key_directory());
+  std::ifstream sk_stream(directory / "secret_key", std::ios::binary);
+  std::ifstream pk_stream(directory / "public_key", std::ios::binary);
+  if (!sk_stream || !pk_stream) {
+    return false;
+  }
+  try {
+    auto secret_key = std::make_shared<seal::SecretKey>();
+    secret_key->load(m_context, sk_stream);
+    auto public_key = std::make_shared<seal::PublicKey>();
+    public_key->load(m_context, pk_stream);
+    m_keygen = std::make_shared<seal::KeyGenerator>(m_context, *secret_key,
+                                                    *public_key);
+    m_secret_key = secret_key;
+    m_public_key = public_key;
+  } catch (const std::exception& e) {
+    NGRAPH_WARN << "Error loading client keys from " << directory << ": "
+                << e.what();
+    return false;
+  }
+
+  // Saved once the keys were first uploaded, and generated again if missing
+  std::ifstream evk_stream(directory / "relin_keys", std::ios::binary);
+  if (evk_stream && m_context->using_keyswitching()) {
+    try {
+      auto relin_keys = std::make_shared<seal::RelinKeys>();
+      relin_keys->load(m_context, evk_stream);
+      m_relin_keys = relin_keys;
+    } catch (const std::exception& e) {
+      NGRAPH_WARN << "Error loading relinearization keys from " << directory
+                  << ": " << e.what();
+    }
+  }
+  NGRAPH_HE_LOG(1) << "Client loaded keys from " << directory;
+  return true;
+}
+
+void HESealClient::save_keys() const {
+  if (m_key_dir.empty()) {
+    return;
+  }
+  std::filesystem::path directory(key_directory());
+  std::filesystem::create_directories(directory);
+  std::filesystem::permissions(directory, std::filesystem::perms::owner_all);
+
+  // Write the public key last, since its presence marks complete keys
+  save_key("secret_key", *m_secret_key);
+  save_key("public_key", *m_public_key);
+  NGRAPH_HE_LOG(1) << "Client saved keys to " << directory;
+}
+
+template <typename Key>
+void HESealClient::save_key(const std::string& name, const Key& key) const {
+  std::filesystem::path path = std::filesystem::path(key_directory()) / name;
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  NGRAPH_CHECK(stream.good(), "Error writing client key to ", path);
+  std::filesystem::permissions(path, std::filesystem::perms::owner_read |
+                                         std::filesystem::perms::owner_write);
+  key.save(stream);
+}
+
+void HESealClient::send_key_fingerprint() {
+  NGRAPH_HE_LOG(3) << "Client sending key fingerprint";
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  message.mutable_key_fingerprint()->set_fingerprint(m_key_fingerprint);
+  write_message(TCPMessage(std::move(message)));
+}
+
 void HESealClient::send_public_and_relin_keys() {
   NGRAPH_HE_LOG(3) << "Client sending public and relin keys";
   pb::TCPMessage message;
   message.set_type(pb::TCPMessage_Type_RESPONSE);
 
   // Set public key
-  std::stringstream pk_stream;
-  m_public_key->save(pk_stream);
   pb::PublicKey public_key;
-  public_key.set_public_key(pk_stream.str());
+  public_key.set_public_key(serialize_key(*m_public_key));
   *message.mutable_public_key() = public_key;
 
-  // Set relinearization keys
+  // Set relinearization keys, generated only once the server needs them
   if (m_context->using_keyswitching()) {
-    std::stringstream evk_stream;
-    m_relin_keys->save(evk_stream);
+    if (m_relin_keys == nullptr) {
+      m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+      // Persisted, so the fingerprint of the next client matches this upload
+      if (!m_key_dir.empty()) {
+        save_key("relin_keys", *m_relin_keys);
+      }
+    }
     pb::EvaluationKey eval_key;
-    eval_key.set_eval_key(evk_stream.str());
+    eval_key.set_eval_key(serialize_key(*m_relin_keys));
     *message.mutable_eval_key() = eval_key;
   }
 
+  m_key_fingerprint = key_fingerprint(message.public_key().public_key(),
+                                      message.eval_key().eval_key());
+  message.mutable_key_fingerprint()->set_fingerprint(m_key_fingerprint);
   write_message(TCPMessage(std::move(message)));
 }
 
@@ -138,7 +532,87 @@ void HESealClient::handle_encryption_parameters_response(
   m_encryption_params = HESealEncryptionParameters::load(param_stream);
 
   set_seal_context();
-  send_public_and_relin_keys();
+  // Servers predating data connections leave the count unset
+  size_t data_connections = message.encryption_parameters().data_connections();
+  m_session_token = message.encryption_parameters().session_token();
+  if (data_connections > 1) {
+    open_data_connections(data_connections - 1);
+  }
+  // The server may have cached persisted keys, and requests them otherwise
+  if (!m_key_fingerprint.empty()) {
+    send_key_fingerprint();
+  } else {
+    send_public_and_relin_keys();
+  }
+}
+
+void HESealClient::encrypt_value(HEType& value, const HEPlaintext& plain,
+                                 const element::Type& element_type) {
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher, plain, m_context->first_parms_id(), element_type, scale(),
+          *m_ckks_encoder, *m_zero_pool, value.complex_packing(),
+          seal::MemoryPoolHandle::ThreadLocal());
+  value.set_ciphertext(cipher);
+}
+
+void HESealClient::decrypt_value(HEPlaintext& plain,
+                                 const HEType& value) const {
+  if (value.is_plaintext()) {
+    plain = value.get_plaintext();
+  } else {
+    decrypt(plain, *value.get_ciphertext(), value.complex_packing(),
+            *m_decryptor, *m_ckks_encoder,
+            seal::MemoryPoolHandle::ThreadLocal());
+    plain.resize(value.batch_size());
+  }
+}
+
+size_t HESealClient::default_worker_count() {
+  return std::max(static_cast<size_t>(std::thread::hardware_concurrency()),
+                  TCPMessageDispatcher::default_worker_count);
+}
+
+HESealZeroPool::Stats HESealClient::zero_pool_stats() const {
+  if (m_zero_pool == nullptr) {
+    return HESealZeroPool::Stats{};
+  }
+  return m_zero_pool->stats();
+}
+
+std::chrono::microseconds HESealClient::busy_time() const {
+  std::lock_guard<std::mutex> guard(m_busy_mutex);
+  auto busy_time = m_busy_time;
+  if (m_busy_handlers > 0) {
+    busy_time += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_busy_start);
+  }
+  return busy_time;
+}
+
+void HESealClient::open_data_connections(size_t count) {
+  NGRAPH_HE_LOG(3) << "Client opening " << count << " data connections";
+  auto client_callback = [this](const TCPMessage& message) {
+    return handle_message(message);
+  };
+  for (size_t i = 0; i < count; ++i) {
+    auto data_client = std::make_unique<TCPClient>(
+        m_io_context, m_address, client_callback, m_worker_count, 0);
+    data_client->wait_until_connected();
+
+    // The server attaches the connection to this session once it sees the
+    // token
+    pb::SessionToken session_token;
+    session_token.set_token(m_session_token);
+    pb::TCPMessage proto_msg;
+    *proto_msg.mutable_session_token() = session_token;
+    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+    data_client->write_message(TCPMessage(std::move(proto_msg)));
+    // With shared memory, the token is written on the socket, and the server
+    // then attaches the connection to the channel of the first connection
+    data_client->wait_until_written();
+    data_client->set_channel(m_tcp_client->channel());
+    m_data_clients.emplace_back(std::move(data_client));
+  }
 }
 
 void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
@@ -151,10 +625,24 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   NGRAPH_CHECK(message.he_tensors_size() == 1,
                "Only support 1 encrypted parameter from client");
 
-  NGRAPH_CHECK(m_input_config.size() == 1,
-               "Client supports only input parameter");
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    m_inference_shape = message.he_tensors(0);
+  }
+  send_next_request();
+}
 
-  const auto& proto_tensor = message.he_tensors(0);
+void HESealClient::send_inputs(const HEInputViewMap& inputs,
+                               size_t batch_size) {
+  size_t max_batch_size = m_ckks_encoder->slot_count();
+  if (complex_packing()) {
+    max_batch_size *= 2;
+  }
+  NGRAPH_CHECK(batch_size <= max_batch_size, "Batch size ", batch_size,
+               " too large (maximum ", max_batch_size, ")");
+  m_batch_size = batch_size;
+
+  const auto& proto_tensor = *m_inference_shape;
   auto& proto_name = proto_tensor.name();
   auto proto_shape = proto_tensor.shape();
   Shape shape{proto_shape.begin(), proto_shape.end()};
@@ -162,11 +650,12 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   NGRAPH_HE_LOG(5) << "Inference request tensor has name " << proto_name;
 
   bool encrypt_tensor = true;
-  auto input_proto = m_input_config.find(proto_name);
-  NGRAPH_CHECK(input_proto != m_input_config.end(), "Tensor name ", proto_name,
+  auto input_view = inputs.find(proto_name);
+  NGRAPH_CHECK(input_view != inputs.end(), "Tensor name ", proto_name,
                " not found");
 
-  auto& [input_config, input_data] = input_proto->second;
+  const HEInputView& input = input_view->second;
+  const std::string& input_config = input.config;
   static std::unordered_set<std::string> known_configs{"encrypt", "plain"};
 
   NGRAPH_CHECK(known_configs.find(input_config) != known_configs.end(),
@@ -183,7 +672,6 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
                    << (encrypt_tensor ? "encrypted" : "plaintext");
 
   NGRAPH_HE_LOG(5) << "Client batch size " << m_batch_size;
-  NGRAPH_HE_LOG(5) << "m_input_config.size() " << m_input_config.size();
   if (complex_packing()) {
     NGRAPH_HE_LOG(5) << "Client complex packing";
   }
@@ -191,36 +679,80 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   size_t parameter_size = shape_size(HETensor::pack_shape(shape));
   NGRAPH_HE_LOG(5) << "Client parameter_size " << parameter_size;
 
-  NGRAPH_CHECK(input_data.size() == parameter_size * m_batch_size,
-               "incorrect input_data.size() ", input_data.size(),
+  NGRAPH_CHECK(input.count == parameter_size * m_batch_size,
+               "incorrect input size ", input.count,
                ", expected  ", parameter_size * m_batch_size,
                " (parameter_size=", parameter_size,
                "), (batch_size=", m_batch_size, ")");
 
   shape = HETensor::unpack_shape(shape, m_batch_size);
-  auto element_type = element::f64;
+  // The tensor reads the input in its own datatype, without conversion
+  const element::Type& element_type = input.type;
 
   auto he_tensor = HETensor(
       element_type, shape, proto_tensor.packed(),
-      m_encryption_params.complex_packing(), encrypt_tensor, *m_ckks_encoder,
-      m_context, *m_encryptor, *m_decryptor, m_encryption_params, proto_name);
+      m_encryption_params.complex_packing(), false, *m_ckks_encoder, m_context,
+      *m_encryptor, *m_decryptor, m_encryption_params, proto_name);
 
-  size_t num_bytes = parameter_size * sizeof(double) * m_batch_size;
+  size_t num_bytes = input.count * element_type.size();
   NGRAPH_HE_LOG(3) << "Writing to tensor";
-  he_tensor.write(input_data.data(), num_bytes);
+  he_tensor.write(input.data, num_bytes);
+
+  // Stripe the input across all connections. The server reassembles the
+  // chunks in any order, by their offsets
+  size_t connection_count = m_data_clients.size() + 1;
+  size_t max_proto_bytes = connection_count > 1 ? HETensor::stripe_proto_bytes
+                                                : HETensor::max_proto_bytes;
+
+  size_t proto_count = 0;
+  auto send_chunk = [&](size_t begin, size_t end) {
+    std::vector<pb::HETensor> tensor_protos;
+    NGRAPH_HE_LOG(3) << "Writing elements [" << begin << ", " << end
+                     << ") to protos";
+    he_tensor.write_to_protos(tensor_protos, max_proto_bytes, begin, end);
+    for (auto& tensor_proto : tensor_protos) {
+      pb::TCPMessage inputs_msg;
+      inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
+      *inputs_msg.add_he_tensors() = std::move(tensor_proto);
+
+      NGRAPH_HE_LOG(3) << "Client sending input chunk at offset "
+                       << inputs_msg.he_tensors(0).offset();
+      size_t connection_idx = proto_count++ % connection_count;
+      if (connection_idx == 0) {
+        write_message(TCPMessage(std::move(inputs_msg)));
+      } else {
+        m_data_clients[connection_idx - 1]->write_message(
+            TCPMessage(std::move(inputs_msg)));
+      }
+    }
+  };
 
-  std::vector<pb::HETensor> tensor_protos;
-  NGRAPH_HE_LOG(3) << "Writing to protos";
-  he_tensor.write_to_protos(tensor_protos);
-  for (const auto& tensor_proto : tensor_protos) {
-    pb::TCPMessage inputs_msg;
-    inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
-    *inputs_msg.add_he_tensors() = tensor_proto;
+  auto& values = he_tensor.data();
+  if (values.empty()) {
+    send_chunk(0, 0);
+    return;
+  }
 
-    auto param_shape = inputs_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Client sending encrypted input with shape "
-                     << Shape{param_shape.begin(), param_shape.end()};
-    write_message(TCPMessage(std::move(inputs_msg)));
+  // Encrypt and send the input in chunks, so earlier chunks are serialized
+  // and on the wire while later chunks are still being encrypted
+  size_t chunk_size = values.size();
+  for (size_t begin = 0; begin < values.size(); begin += chunk_size) {
+    if (encrypt_tensor) {
+      encrypt_value(values[begin], values[begin].get_plaintext(),
+                    element_type);
+    }
+    if (begin == 0) {
+      chunk_size = he_tensor.proto_chunk_size(HETensor::stripe_proto_bytes);
+    }
+    size_t end = std::min(begin + chunk_size, values.size());
+    if (encrypt_tensor) {
+#pragma omp parallel for
+      for (size_t value_idx = begin + 1; value_idx < end; ++value_idx) {
+        HEType& value = values[value_idx];
+        encrypt_value(value, value.get_plaintext(), element_type);
+      }
+    }
+    send_chunk(begin, end);
   }
 }
 
@@ -234,33 +766,98 @@ void HESealClient::handle_result(const pb::TCPMessage& message) {
 
   const auto& proto_tensor = message.he_tensors(0);
 
-  if (m_result_tensor == nullptr) {
-    m_result_tensor = HETensor::load_from_proto_tensor(
-        proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-        m_encryption_params);
-  } else {
-    HETensor::load_from_proto_tensor(m_result_tensor, proto_tensor, m_context);
+  // Chunks of the result may be handled concurrently, so only the creation
+  // of the result tensor is serialized. Each chunk holds the inference, which
+  // keeps its destination alive
+  std::shared_ptr<HETensor> result_tensor;
+  std::shared_ptr<InferenceRequest> request;
+  char* result_bytes = nullptr;
+  size_t result_byte_count = 0;
+  {
+    std::lock_guard<std::mutex> guard(m_result_mutex);
+    if (m_result_tensor == nullptr) {
+      m_result_request = request_in_flight();
+      Shape shape{proto_tensor.shape().begin(), proto_tensor.shape().end()};
+      auto type = pb_type_to_type(proto_tensor.type());
+      m_result_tensor = std::make_shared<HETensor>(
+          type, shape, proto_tensor.packed(), complex_packing(), false,
+          *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
+          m_encryption_params, proto_tensor.name());
+      m_result_error = nullptr;
+      try {
+        m_result_output = allocate_output(*m_result_request, shape, type);
+      } catch (const std::exception& e) {
+        // Keep loading the chunks of the result, and fail the inference once
+        // they all arrived, in step with the server
+        NGRAPH_ERR << "Client error allocating result: " << e.what();
+        m_result_error = std::current_exception();
+        m_result_output = HEOutputView{nullptr, 0, type};
+      }
+      // Decrypt straight into the destination if the datatypes match
+      if (m_result_output.type == type) {
+        m_result_bytes.clear();
+      } else {
+        m_result_bytes.resize(m_result_output.count * type.size());
+      }
+      m_result_decrypted_count = 0;
+    }
+    result_tensor = m_result_tensor;
+    request = m_result_request;
+    if (m_result_bytes.empty()) {
+      result_bytes = static_cast<char*>(m_result_output.data);
+      result_byte_count =
+          m_result_output.count * result_tensor->get_element_type().size();
+    } else {
+      result_bytes = m_result_bytes.data();
+      result_byte_count = m_result_bytes.size();
+    }
+  }
+  HETensor::load_from_proto_tensor(result_tensor, proto_tensor, m_context);
+
+  // Decrypt the chunk while later chunks are still in flight. Chunks cover
+  // disjoint ranges of the result, and the destination is not reused until
+  // all of them are decrypted
+  size_t begin = proto_tensor.offset();
+  size_t end = begin + proto_tensor.data_size();
+  if (result_byte_count > 0) {
+    result_tensor->read(result_bytes, result_byte_count, begin, end);
   }
 
-  if (m_result_tensor->done_loading()) {
-    size_t data_size =
-        m_result_tensor->data().size() * m_result_tensor->get_batch_size();
-    m_results.resize(data_size);
-
-    const auto& type = m_result_tensor->get_element_type();
-    size_t num_bytes = data_size * type.size();
-    auto bytes = ngraph_malloc(num_bytes);
-    m_result_tensor->read(bytes, num_bytes);
-
-    for (size_t i = 0; i < data_size; ++i) {
-      void* addr =
-          static_cast<void*>(static_cast<char*>(bytes) + i * type.size());
-      m_results[i] = type_to_double(addr, type);
+  HEOutputView output;
+  std::vector<char> bytes;
+  std::exception_ptr error;
+  {
+    // Only the chunk completing the tensor finishes the inference, and clears
+    // the tensor for the next inference
+    std::lock_guard<std::mutex> guard(m_result_mutex);
+    if (m_result_tensor != result_tensor) {
+      return;
+    }
+    m_result_decrypted_count += end - begin;
+    if (m_result_decrypted_count < result_tensor->data().size()) {
+      return;
     }
+    m_result_tensor = nullptr;
+    m_result_request = nullptr;
+    error = m_result_error;
+    output = m_result_output;
+    bytes = std::move(m_result_bytes);
+    m_result_bytes.clear();
+  }
 
-    ngraph_free(bytes);
-    close_connection();
+  // Convert to the datatype of the destination
+  if (!bytes.empty()) {
+    const auto& type = result_tensor->get_element_type();
+    for (size_t i = 0; i < output.count; ++i) {
+      double value = type_to_double(&bytes[i * type.size()], type);
+      if (output.type == element::f32) {
+        static_cast<float*>(output.data)[i] = static_cast<float>(value);
+      } else {
+        static_cast<double*>(output.data)[i] = value;
+      }
+    }
   }
+  finish_request(result_tensor->get_shape(), error);
 }
 
 void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
@@ -282,9 +879,15 @@ void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
 #pragma omp parallel for
   for (size_t result_idx = 0; result_idx < proto_tensor->data_size();
        ++result_idx) {
-    scalar_relu_seal(he_tensor->data(result_idx), he_tensor->data(result_idx),
-                     m_context->first_parms_id(), scale(), *m_ckks_encoder,
-                     *m_encryptor, *m_decryptor);
+    HEType& value = he_tensor->data(result_idx);
+    if (value.is_plaintext()) {
+      scalar_relu_seal(value.get_plaintext(), value.get_plaintext());
+    } else {
+      HEPlaintext plain;
+      decrypt_value(plain, value);
+      scalar_relu_seal(plain, plain);
+      encrypt_value(value, plain, element::f32);
+    }
   }
 
   std::vector<pb::HETensor> proto_output_tensors;
@@ -292,7 +895,7 @@ void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
 
   NGRAPH_CHECK(proto_output_tensors.size() == 1,
                "Only support single-output tensors");
-  *proto_tensor = proto_output_tensors[0];
+  *proto_tensor = std::move(proto_output_tensors[0]);
 
   write_message(TCPMessage(std::move(message)));
 }
@@ -320,16 +923,22 @@ void HESealClient::handle_bounded_relu_request(pb::TCPMessage&& message) {
 #pragma omp parallel for
   for (size_t result_idx = 0; result_idx < proto_tensor->data_size();
        ++result_idx) {
-    scalar_bounded_relu_seal(he_tensor->data(result_idx),
-                             he_tensor->data(result_idx), bound,
-                             m_context->first_parms_id(), scale(),
-                             *m_ckks_encoder, *m_encryptor, *m_decryptor);
+    HEType& value = he_tensor->data(result_idx);
+    if (value.is_plaintext()) {
+      scalar_bounded_relu_seal(value.get_plaintext(), value.get_plaintext(),
+                               bound);
+    } else {
+      HEPlaintext plain;
+      decrypt_value(plain, value);
+      scalar_bounded_relu_seal(plain, plain, bound);
+      encrypt_value(value, plain, element::f32);
+    }
   }
   std::vector<pb::HETensor> proto_output_tensors;
   he_tensor->write_to_protos(proto_output_tensors);
   NGRAPH_CHECK(proto_output_tensors.size() == 1,
                "Only support single-output tensors");
-  *proto_tensor = proto_output_tensors[0];
+  *proto_tensor = std::move(proto_output_tensors[0]);
 
   write_message(TCPMessage(std::move(message)));
 }
@@ -343,28 +952,32 @@ void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
   NGRAPH_CHECK(message.he_tensors_size() == 1,
                "Client supports only max pool requests with one tensor");
 
+  json js = json::parse(message.function().function());
   pb::HETensor* proto_tensor = message.mutable_he_tensors(0);
-  size_t cipher_count = proto_tensor->data_size();
-
-  std::vector<HEType> max_pool_ciphers(
-      cipher_count, HEType(HEPlaintext(m_batch_size), false));
-  std::vector<HEType> post_max_pool_ciphers(
-      {HEType(HEPlaintext(m_batch_size), false)});
-
   auto he_tensor = HETensor::load_from_proto_tensor(
       *proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
       m_encryption_params);
+  size_t value_count = he_tensor->data().size();
+  NGRAPH_CHECK(value_count > 0, "Max pool request has no values");
 
-  // We currently just support max_pool with single output
-  auto post_max_he_tensor =
-      HETensor(he_tensor->get_element_type(), Shape{m_batch_size, 1},
-               he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
-               m_context, *m_encryptor, *m_decryptor, m_encryption_params);
-
-  max_pool_seal(he_tensor->data(), post_max_he_tensor.data(),
-                Shape{1, 1, cipher_count}, Shape{1, 1, 1}, Shape{cipher_count},
-                Strides{1}, Shape{0}, Shape{0}, m_context->first_parms_id(),
-                scale(), *m_ckks_encoder, *m_encryptor, *m_decryptor);
+  std::vector<HEPlaintext> values(value_count);
+#pragma omp parallel for
+  for (size_t value_idx = 0; value_idx < value_count; ++value_idx) {
+    decrypt_value(values[value_idx], he_tensor->data(value_idx));
+  }
+  std::vector<HEPlaintext> max_values = max_pool_windows(values, js);
+
+  // One value per window. The function, including the offset of the first
+  // window, is sent back unchanged
+  auto post_max_he_tensor = HETensor(
+      he_tensor->get_element_type(), Shape{m_batch_size, max_values.size()},
+      he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
+      m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+#pragma omp parallel for
+  for (size_t window_idx = 0; window_idx < max_values.size(); ++window_idx) {
+    encrypt_value(post_max_he_tensor.data(window_idx), max_values[window_idx],
+                  element::f32);
+  }
 
   message.set_type(pb::TCPMessage_Type_RESPONSE);
   message.clear_he_tensors();
@@ -374,16 +987,101 @@ void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
   NGRAPH_CHECK(proto_output_tensors.size() == 1,
                "Only support single-output tensors");
 
-  *message.add_he_tensors() = proto_output_tensors[0];
+  *message.add_he_tensors() = std::move(proto_output_tensors[0]);
   TCPMessage max_pool_result_msg(std::move(message));
   write_message(std::move(max_pool_result_msg));
 }
 
+void HESealClient::handle_chain_request(pb::TCPMessage&& message) {
+  NGRAPH_HE_LOG(3) << "Client handling chain request";
+
+  NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function");
+  NGRAPH_CHECK(message.he_tensors_size() == 1,
+               "Client supports only chain requests with one tensor");
+
+  json js = json::parse(message.function().function());
+  const json& chain = js.at("chain");
+  NGRAPH_CHECK(chain.is_array() && !chain.empty(), "Chain has no functions");
+
+  pb::HETensor* proto_tensor = message.mutable_he_tensors(0);
+  auto he_tensor = HETensor::load_from_proto_tensor(
+      *proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
+      m_encryption_params);
+  size_t value_count = he_tensor->data().size();
+  NGRAPH_CHECK(value_count > 0, "Chain request has no values");
+
+  std::vector<HEPlaintext> values(value_count);
+#pragma omp parallel for
+  for (size_t value_idx = 0; value_idx < value_count; ++value_idx) {
+    decrypt_value(values[value_idx], he_tensor->data(value_idx));
+  }
+
+  for (const auto& function_js : chain) {
+    const std::string name = function_js.at("function");
+    if (name == "Relu") {
+#pragma omp parallel for
+      for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+        scalar_relu_seal(values[value_idx], values[value_idx]);
+      }
+    } else if (name == "BoundedRelu") {
+      float bound = function_js.at("bound");
+#pragma omp parallel for
+      for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+        scalar_bounded_relu_seal(values[value_idx], values[value_idx], bound);
+      }
+    } else if (name == "MaxPool") {
+      // The window sizes are sent with the chain
+      values = max_pool_windows(values, js);
+    } else {
+      NGRAPH_CHECK(false, "Unknown chain function ", name);
+    }
+  }
+
+  HETensor result_tensor(
+      he_tensor->get_element_type(),
+      Shape{he_tensor->get_batch_size(), values.size()},
+      he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
+      m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+#pragma omp parallel for
+  for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+    encrypt_value(result_tensor.data(value_idx), values[value_idx],
+                  element::f32);
+  }
+
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  message.clear_he_tensors();
+
+  std::vector<pb::HETensor> proto_output_tensors;
+  result_tensor.write_to_protos(proto_output_tensors);
+  NGRAPH_CHECK(proto_output_tensors.size() == 1,
+               "Only support single-output tensors");
+  *message.add_he_tensors() = std::move(proto_output_tensors[0]);
+
+  write_message(TCPMessage(std::move(message)));
+}
+
 void HESealClient::handle_message(const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling message";
 
+  // Messages are handled concurrently by m_worker_count workers. Each message
+  // in progress gets an equal share of the cores for its OpenMP loops, so
+  // concurrent requests don't oversubscribe the client
+  ActiveCount active(m_active_handlers);
+#ifdef _OPENMP
+  size_t core_count = std::max(std::thread::hardware_concurrency(), 1U);
+  omp_set_num_threads(
+      static_cast<int>(std::max(core_count / active.count(), size_t(1))));
+#endif
+
   std::shared_ptr<pb::TCPMessage> proto_msg = message.proto_message();
 
+  // Refilling the zero pool would compete with the handler for cores. The
+  // encryption parameters response creates the pool
+  std::optional<HESealZeroPool::Pause> pause_refill;
+  if (m_zero_pool != nullptr && !proto_msg->has_encryption_parameters()) {
+    pause_refill.emplace(*m_zero_pool);
+  }
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
   switch (proto_msg->type()) {
@@ -398,6 +1096,11 @@ void HESealClient::handle_message(const TCPMessage& message) {
       break;
     }
     case pb::TCPMessage_Type_REQUEST: {
+      // The server doesn't have the keys matching the fingerprint cached
+      if (proto_msg->has_key_fingerprint()) {
+        send_public_and_relin_keys();
+        break;
+      }
       NGRAPH_CHECK(proto_msg->has_function(), "Unknown request type");
 
       const std::string& function = proto_msg->function().function();
@@ -406,11 +1109,40 @@ void HESealClient::handle_message(const TCPMessage& message) {
 
       // TODO(fboemer): Move to any_of in message.proto
       static std::unordered_set<std::string> s_known_names{
-          "Parameter", "Relu", "BoundedRelu", "MaxPool"};
+          "Parameter", "Relu", "BoundedRelu", "MaxPool", "Chain"};
 
       NGRAPH_CHECK(s_known_names.find(name) != s_known_names.end(),
                    "Unknown name ", name);
 
+      // Measures busy_time() while the handler aids the server, until it
+      // returns or throws
+      class BusyScope {
+       public:
+        explicit BusyScope(HESealClient& client) : m_client(client) {
+          std::lock_guard<std::mutex> guard(m_client.m_busy_mutex);
+          if (m_client.m_busy_handlers++ == 0) {
+            m_client.m_busy_start = std::chrono::steady_clock::now();
+          }
+        }
+        ~BusyScope() {
+          std::lock_guard<std::mutex> guard(m_client.m_busy_mutex);
+          if (--m_client.m_busy_handlers == 0) {
+            m_client.m_busy_time +=
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - m_client.m_busy_start);
+          }
+        }
+        BusyScope(const BusyScope&) = delete;
+        BusyScope& operator=(const BusyScope&) = delete;
+
+       private:
+        HESealClient& m_client;
+      };
+      std::optional<BusyScope> busy;
+      if (name != "Parameter") {
+        busy.emplace(*this);
+      }
+
       if (name == "Parameter") {
         handle_inference_request(*proto_msg);
       } else if (name == "Relu") {
@@ -419,6 +1151,8 @@ void HESealClient::handle_message(const TCPMessage& message) {
         handle_bounded_relu_request(std::move(*proto_msg));
       } else if (name == "MaxPool") {
         handle_max_pool_request(std::move(*proto_msg));
+      } else if (name == "Chain") {
+        handle_chain_request(std::move(*proto_msg));
       }
       break;
     }
@@ -438,11 +1172,49 @@ std::vector<double> HESealClient::get_results() {
 }
 
 void HESealClient::close_connection() {
+  {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    if (m_is_done) {
+      return;
+    }
+    m_is_done = true;
+  }
   NGRAPH_HE_LOG(5) << "Closing connection";
-  m_tcp_client->close();
+  auto stats = zero_pool_stats();
+  NGRAPH_HE_LOG(1) << "Client zero pool: size " << stats.size << "/"
+                   << stats.capacity << ", " << stats.refill_threads
+                   << " refill threads, hit rate " << stats.hit_rate() << " ("
+                   << stats.hits << " hits, " << stats.misses << " misses)";
+
+  std::deque<std::shared_ptr<InferenceRequest>> unfinished_requests;
+  bool session_started = false;
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    unfinished_requests.swap(m_requests);
+    m_request_in_flight = false;
+    session_started = m_inference_shape.has_value();
+  }
+  for (auto& request : unfinished_requests) {
+    request->fail(std::make_exception_ptr(
+        ngraph_error("Client connection closed before inference completed")));
+  }
+
+  // Tell a server serving repeated inferences that the client is done
+  if (session_started) {
+    pb::TCPMessage message;
+    message.set_type(pb::TCPMessage_Type_REQUEST);
+    json js = {{"function", "Close"}};
+    pb::Function f;
+    f.set_function(js.dump());
+    *message.mutable_function() = f;
+    write_message(TCPMessage(std::move(message)));
+    m_tcp_client->wait_until_written();
+  }
 
-  std::lock_guard<std::mutex> guard(m_is_done_mutex);
-  m_is_done = true;
+  m_tcp_client->close();
+  for (auto& data_client : m_data_clients) {
+    data_client->close();
+  }
   m_is_done_cond.notify_all();
 }
 
@@ -16,19 +16,31 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "boost/asio.hpp"
 #include "he_tensor.hpp"
 #include "he_util.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/he_seal_zero_pool.hpp"
 #include "seal/seal.h"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
 
 namespace ngraph::runtime::he {
 
@@ -37,12 +49,64 @@ template <class T>
 using HETensorConfigMap =
     std::unordered_map<std::string, std::pair<std::string, std::vector<T>>>;
 
+/// \brief Unowned, contiguous input data of an inference
+struct HEInputView {
+  /// \brief 'encrypt' or 'plain'
+  std::string config;
+  /// \brief Values, in the layout of HETensor::write
+  const void* data{nullptr};
+  /// \brief Number of values
+  size_t count{0};
+  /// \brief Datatype of the values
+  element::Type type;
+};
+
+/// (tensor_name : input view)
+using HEInputViewMap = std::unordered_map<std::string, HEInputView>;
+
+/// \brief Unowned, contiguous destination of the result of an inference
+struct HEOutputView {
+  /// \brief Destination, in the layout of HETensor::read
+  void* data{nullptr};
+  /// \brief Number of values the destination holds
+  size_t count{0};
+  /// \brief Datatype of the destination. Either the datatype of the result,
+  /// or f32 or f64
+  element::Type type;
+};
+
+/// \brief Returns the destination of the result of an inference, given the
+/// shape and datatype of the result. Called once, from a worker thread, when
+/// the first chunk of the result arrives
+using HEOutputAllocator =
+    std::function<HEOutputView(const Shape&, const element::Type&)>;
+
 /// \brief Class representing a data owner. The client provides encrypted values
 /// to a server and receives the encrypted result. The client may also aid in
 /// the computation, for example by computing activation functions the sever
 /// cannot compute using homomorphic encryption
+///
+/// A client constructed with inputs performs a single inference and closes
+/// the connection. A client constructed with only an address keeps the
+/// connection, encryption context and keys, and performs an inference per call
+/// to infer()
 class HESealClient {
  public:
+  /// \brief Constructs a client object and connects to a server, without
+  /// performing an inference
+  /// \param[in] address Address of the server
+  explicit HESealClient(const TransportAddress& address);
+
+  /// \brief Constructs a client object and connects to a server, without
+  /// performing an inference
+  /// \param[in] uri URI of the server, i.e. tcp://hostname:port,
+  /// unix:///path/to/socket, or shm:///path/to/socket
+  explicit HESealClient(const std::string& uri);
+
+  /// \brief Closes the connection, failing inferences which have not
+  /// completed
+  ~HESealClient();
+
   /// \brief Constructs a client object and connects to a server
   /// \param[in] hostname Hostname of the server
   /// \param[in] port Port of the server
@@ -70,6 +134,76 @@ class HESealClient {
                const size_t batch_size,
                const HETensorConfigMap<int64_t>& inputs);
 
+  /// \brief Constructs a client object and connects to a server
+  /// \param[in] address Address of the server
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to pair of
+  /// ('encrypt', inputs) or ('plain', inputs)
+  HESealClient(const TransportAddress& address, const size_t batch_size,
+               const HETensorConfigMap<double>& inputs);
+
+  /// \brief Constructs a client object and connects to a server
+  /// \param[in] uri URI of the server, i.e. tcp://hostname:port,
+  /// unix:///path/to/socket, or shm:///path/to/socket
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to inputs
+  HESealClient(const std::string& uri, const size_t batch_size,
+               const HETensorConfigMap<double>& inputs);
+
+  /// \brief Constructs a client object and connects to a server
+  /// \param[in] uri URI of the server, i.e. tcp://hostname:port,
+  /// unix:///path/to/socket, or shm:///path/to/socket
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to inputs
+  HESealClient(const std::string& uri, const size_t batch_size,
+               const HETensorConfigMap<float>& inputs);
+
+  /// \brief Constructs a client object and connects to a server
+  /// \param[in] uri URI of the server, i.e. tcp://hostname:port,
+  /// unix:///path/to/socket, or shm:///path/to/socket
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to inputs
+  HESealClient(const std::string& uri, const size_t batch_size,
+               const HETensorConfigMap<int64_t>& inputs);
+
+  /// \brief Queues an inference. Inferences are performed one at a time, in
+  /// the order they were queued
+  /// \param[in] inputs Input data as a map from tensor name to pair of
+  /// ('encrypt', inputs) or ('plain', inputs)
+  /// \param[in] batch_size Batch size of the inference, at most the number of
+  /// slots of the encryption parameters
+  /// \returns Future holding the decrypted results. Holds an exception if the
+  /// inference fails or the connection closes before it completes
+  std::future<std::vector<double>> infer(
+      const HETensorConfigMap<double>& inputs, size_t batch_size);
+
+  /// \brief Queues an inference, see infer()
+  /// \param[in] inputs Input data as a map from tensor name to inputs
+  /// \param[in] batch_size Batch size of the inference
+  std::future<std::vector<double>> infer(const HETensorConfigMap<float>& inputs,
+                                         size_t batch_size);
+
+  /// \brief Queues an inference, see infer()
+  /// \param[in] inputs Input data as a map from tensor name to inputs
+  /// \param[in] batch_size Batch size of the inference
+  std::future<std::vector<double>> infer(
+      const HETensorConfigMap<int64_t>& inputs, size_t batch_size);
+
+  /// \brief Queues an inference on unowned inputs, and decrypts the result
+  /// straight into an unowned destination, without intermediate copies. See
+  /// infer()
+  /// \param[in] inputs Input data as a map from tensor name to input view
+  /// \param[in] batch_size Batch size of the inference
+  /// \param[in] allocate_output Returns the destination of the result
+  /// \param[in] keep_alive Keeps the inputs and the destination alive until
+  /// the inference completes or fails
+  /// \returns Future holding the shape of the result, once it is decrypted.
+  /// Holds an exception if the inference fails or the connection closes
+  /// before it completes
+  std::future<Shape> infer(const HEInputViewMap& inputs, size_t batch_size,
+                           HEOutputAllocator allocate_output,
+                           std::shared_ptr<void> keep_alive = nullptr);
+
   /// \brief Creates SEAL context
   void set_seal_context();
 
@@ -93,6 +227,11 @@ class HESealClient {
   /// \param[in] message Message to process
   void handle_bounded_relu_request(pb::TCPMessage&& message);
 
+  /// \brief Processes a request to perform a chain of functions, such as ReLU
+  /// followed by MaxPool. Each value is decrypted and encrypted only once
+  /// \param[in] message Message to process
+  void handle_chain_request(pb::TCPMessage&& message);
+
   /// \brief Processes a message containing the result from the server
   /// \param[in] message Message to process
   void handle_result(const pb::TCPMessage& message);
@@ -104,6 +243,10 @@ class HESealClient {
   /// \brief Sends the public key and relinearization keys to the server
   void send_public_and_relin_keys();
 
+  /// \brief Sends the key fingerprint only, for a server which may have
+  /// cached the client's keys
+  void send_key_fingerprint();
+
   /// \brief Writes a mesage to the server
   /// \param[in] message Message to write
   void write_message(ngraph::runtime::he::TCPMessage&& message) {
@@ -113,11 +256,12 @@ class HESealClient {
   /// \brief Returns whether or not the function is done evaluating
   bool is_done() { return m_is_done; }
 
-  /// \brief Returns decrypted results
-  /// \warning Will lock until results are ready
+  /// \brief Returns decrypted results of the most recent inference
+  /// \warning Will lock until the connection is closed
   std::vector<double> get_results();
 
-  /// \brief Closes conection with the server
+  /// \brief Closes conection with the server, telling the server the client
+  /// performs no more inferences
   void close_connection();
 
   /// \brief Returns whether or not the encryption parameters use complex
@@ -127,8 +271,120 @@ class HESealClient {
   /// \brief Returns the scale of the encryption parameters
   double scale() const { return m_encryption_params.scale(); }
 
+  /// \brief Returns statistics of the pool of precomputed encryptions of
+  /// zero. Empty before the encryption parameters are received
+  HESealZeroPool::Stats zero_pool_stats() const;
+
+  /// \brief Returns the wall time during which the client handled at least
+  /// one request aiding the server's computation, such as a ReLU, e.g. to
+  /// measure how much of the client's work overlaps with the server's
+  std::chrono::microseconds busy_time() const;
+
  private:
+  /// \brief An inference queued by infer()
+  struct InferenceRequest {
+    // Owned inputs, which input_views point into, if any
+    HETensorConfigMap<double> inputs;
+    HEInputViewMap input_views;
+    size_t batch_size;
+    HEOutputAllocator allocate_output;
+    std::shared_ptr<void> keep_alive;
+
+    // Results of inferences with owned inputs are returned as values
+    bool returns_values{false};
+    std::vector<double> values;
+    std::promise<std::vector<double>> results;
+    std::promise<Shape> result_shape;
+
+    /// \brief Fulfills the future of the inference
+    void complete(const Shape& shape);
+
+    /// \brief Fails the future of the inference
+    void fail(const std::exception_ptr& error);
+  };
+
+  /// \brief Queues an inference request and sends it if the connection is
+  /// idle
+  void queue_request(std::shared_ptr<InferenceRequest> request);
+
+  /// \brief Connects to the server at m_address
+  void connect();
+
+  /// \brief Encrypts and sends the inputs of the oldest queued inference, if
+  /// the server sent the inference shape and no inference is in flight
+  void send_next_request();
+
+  /// \brief Encrypts and sends inputs to the server
+  /// \param[in] inputs Input data as a map from tensor name to input view
+  /// \param[in] batch_size Batch size of the inference
+  void send_inputs(const HEInputViewMap& inputs, size_t batch_size);
+
+  /// \brief Returns the inference in flight
+  /// \throws ngraph_error if no inference is in flight
+  std::shared_ptr<InferenceRequest> request_in_flight();
+
+  /// \brief Returns the destination of the result of an inference
+  /// \param[in] request Inference the result belongs to
+  /// \param[in] shape Shape of the result
+  /// \param[in] type Datatype of the result
+  static HEOutputView allocate_output(InferenceRequest& request,
+                                      const Shape& shape,
+                                      const element::Type& type);
+
+  /// \brief Completes the inference in flight and sends the next one
+  /// \param[in] shape Shape of the decrypted result of the inference
+  /// \param[in] error Fails the inference instead, if set
+  void finish_request(const Shape& shape,
+                      const std::exception_ptr& error = nullptr);
+
+  /// \brief Encrypts a value at the top level, using a precomputed
+  /// encryption of zero if available
+  /// \param[in,out] value Value to store the ciphertext in
+  /// \param[in] plain Plaintext to encrypt
+  /// \param[in] element_type Datatype used for encoding
+  void encrypt_value(HEType& value, const HEPlaintext& plain,
+                     const element::Type& element_type);
+
+  /// \brief Decrypts a value, or copies it if it is a plaintext. The values
+  /// are resized to the batch size of the value
+  /// \param[out] plain Decrypted values
+  /// \param[in] value Value to decrypt
+  void decrypt_value(HEPlaintext& plain, const HEType& value) const;
+
+  /// \brief Returns the default number of workers handling server requests
+  static size_t default_worker_count();
+
+  /// \brief Opens additional connections to the server, across which input
+  /// tensors are striped. Blocks until they are connected
+  /// \param[in] count Number of additional connections
+  void open_data_connections(size_t count);
+
+  /// \brief Loads the secret and public keys from the key directory, if set
+  /// and it contains keys for the encryption parameters. Also loads the
+  /// relinearization keys, if they were saved
+  /// \returns Whether or not the secret and public keys were loaded
+  bool load_keys();
+
+  /// \brief Saves the secret and public keys to the key directory, if set
+  void save_keys() const;
+
+  /// \brief Saves a key to the key directory, readable by the owner only
+  /// \param[in] name File name of the key
+  /// \param[in] key Key to save
+  template <typename Key>
+  void save_key(const std::string& name, const Key& key) const;
+
+  /// \brief Returns the directory keys for the encryption parameters are
+  /// persisted in
+  std::string key_directory() const;
+
+  // Declared before the clients, which use it
+  boost::asio::io_context m_io_context;
+  TransportAddress m_address;
   std::unique_ptr<TCPClient> m_tcp_client;
+  std::vector<std::unique_ptr<TCPClient>> m_data_clients;
+  // Sent first on each data connection, as issued by the server
+  std::string m_session_token;
   HESealEncryptionParameters m_encryption_params;
   std::shared_ptr<seal::PublicKey> m_public_key;
   std::shared_ptr<seal::SecretKey> m_secret_key;
@@ -139,17 +395,68 @@ class HESealClient {
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
   std::shared_ptr<seal::RelinKeys> m_relin_keys;
-  size_t m_batch_size;
+  std::unique_ptr<HESealZeroPool> m_zero_pool;
+  std::string m_key_fingerprint;
+  bool m_keys_loaded{false};
+  size_t m_batch_size{1};
 
-  bool m_is_done{false};
+  std::atomic<bool> m_is_done{false};
   std::condition_variable m_is_done_cond;
   std::mutex m_is_done_mutex;
 
   std::shared_ptr<HETensor> m_loaded_function_tensor;
 
-  // Function inputs and configuration
-  HETensorConfigMap<double> m_input_config;
+  // Queued inferences. The front one is in flight if m_request_in_flight
+  std::mutex m_request_mutex;
+  std::deque<std::shared_ptr<InferenceRequest>> m_requests;
+  bool m_request_in_flight{false};
+  // Name and shape of the function input, sent once by the server
+  std::optional<pb::HETensor> m_inference_shape;
+  // Set for clients constructed with inputs, which perform one inference
+  bool m_close_when_idle{false};
+  // Runs m_io_context for clients which perform inferences through infer()
+  std::thread m_io_thread;
+
+  // Result chunks are decrypted into m_result_output as they arrive. If its
+  // datatype differs from the result, they are decrypted into m_result_bytes
+  // and converted once the result is complete
+  std::mutex m_result_mutex;
   std::shared_ptr<HETensor> m_result_tensor;
+  std::shared_ptr<InferenceRequest> m_result_request;
+  HEOutputView m_result_output;
+  std::exception_ptr m_result_error;
+  std::vector<char> m_result_bytes;
+  size_t m_result_decrypted_count{0};
   std::vector<double> m_results;  // Function outputs
+
+  // Directory in which keys persist across clients. Empty to generate new
+  // keys for each client
+  std::string m_key_dir{std::getenv("NGRAPH_HE_CLIENT_KEY_DIR") == nullptr
+                            ? ""
+                            : std::getenv("NGRAPH_HE_CLIENT_KEY_DIR")};
+
+  // Number of precomputed encryptions of zero, and threads computing them
+  size_t m_zero_pool_size{
+      env_to_size_t(std::getenv("NGRAPH_HE_CLIENT_ZERO_POOL_SIZE"), 0)};
+  size_t m_zero_pool_threads{
+      env_to_size_t(std::getenv("NGRAPH_HE_CLIENT_ZERO_POOL_THREADS"), 1)};
+
+  // Capacity in bytes of each ring of the shared-memory channel, which all
+  // connections of the client share
+  size_t m_shm_ring_capacity{
+      env_to_size_t(std::getenv("NGRAPH_HE_CLIENT_SHM_RING_BYTES"),
+                    SharedMemoryChannel::default_ring_capacity)};
+
+  // Number of workers handling server requests, e.g. Relu, concurrently. Each
+  // request in progress gets an equal share of the cores for its OpenMP loops
+  size_t m_worker_count{env_to_size_t(std::getenv("NGRAPH_HE_CLIENT_WORKERS"),
+                                      default_worker_count())};
+  std::atomic<size_t> m_active_handlers{0};
+
+  // Wall time during which at least one request was handled, see busy_time()
+  mutable std::mutex m_busy_mutex;
+  size_t m_busy_handlers{0};
+  std::chrono::steady_clock::time_point m_busy_start;
+  std::chrono::microseconds m_busy_time{0};
 };
 }  // namespace ngraph::runtime::he
@@ -16,13 +16,20 @@
 
 #include "seal/he_seal_executable.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <functional>
 #include <limits>
+#include <optional>
 #include <tuple>
+#include <string>
 #include <unordered_set>
 
+#include "dense_kernels.hpp"
 #include "he_op_annotations.hpp"
 #include "he_tensor.hpp"
+#include "he_util.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/op/avg_pool.hpp"
 #include "ngraph/op/batch_norm.hpp"
@@ -57,6 +64,7 @@
 #include "ngraph/util.hpp"
 #include "nlohmann/json.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 #include "pass/he_fusion.hpp"
 #include "pass/he_liveness.hpp"
 #include "pass/propagate_he_annotations.hpp"
@@ -92,15 +100,50 @@
 #include "seal/kernel/sum_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "tcp/tcp_flow_control.hpp"
 
 using json = nlohmann::json;
 using ngraph::descriptor::layout::DenseTensorLayout;
 
 namespace ngraph::runtime::he {
+namespace {
+/// \brief Reads the values of a tensor holding one plaintext value per
+/// element
+/// \returns false if the tensor is packed or holds ciphertexts
+bool read_dense(HETensor& tensor, std::vector<double>& values) {
+  if (tensor.is_packed()) {
+    return false;
+  }
+  values.resize(tensor.data().size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const HEType& he_type = tensor.data(i);
+    if (!he_type.is_plaintext() || he_type.get_plaintext().size() != 1) {
+      return false;
+    }
+    values[i] = he_type.get_plaintext()[0];
+  }
+  return true;
+}
+
+/// \brief Stores one plaintext value per element of an unpacked tensor
+void write_dense(const std::vector<double>& values, HETensor& tensor) {
+  NGRAPH_CHECK(!tensor.is_packed(), "Cannot write dense values to packed ",
+               "tensor ", tensor.get_name());
+  NGRAPH_CHECK(values.size() == tensor.data().size(), "Dense value count ",
+               values.size(), " doesn't match tensor size ",
+               tensor.data().size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    tensor.data(i).set_plaintext(HEPlaintext{values[i]});
+  }
+}
+}  // namespace
+
 HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
                                    bool enable_performance_collection,
                                    HESealBackend& he_seal_backend)
-    : m_he_seal_backend(he_seal_backend), m_batch_size{1}, m_port{34000} {
+    : m_he_seal_backend(he_seal_backend),
+      m_batch_size{1},
+      m_server_address{TransportAddress::parse(he_seal_backend.server_uri())} {
   // TODO(fboemer): Use
   (void)enable_performance_collection;  // Avoid unused parameter warning
 
@@ -170,6 +213,24 @@ HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
   pass_manager_he.run_passes(m_function);
 
   update_he_op_annotations();
+  find_constant_ops();
+
+  // Ciphertext-ciphertext multiplication with complex packing conjugates
+  // its arguments. The backend generates the key on first use
+  if (complex_packing()) {
+    // Ops whose kernels may multiply two ciphertexts
+    static const std::unordered_set<std::string> multiply_ops{
+        "AvgPool", "BatchNormInference", "Convolution",
+        "Divide",  "Dot",                "Multiply"};
+    const auto& ops = m_function->get_ordered_ops();
+    bool has_multiply = std::any_of(ops.begin(), ops.end(), [](const auto& op) {
+      return multiply_ops.count(op->description()) != 0;
+    });
+    if (has_multiply) {
+      m_he_seal_backend.add_galois_elements(
+          {m_he_seal_backend.complex_conjugate_galois_element()});
+    }
+  }
 }
 
 HESealExecutable::~HESealExecutable() noexcept {
@@ -193,6 +254,10 @@ HESealExecutable::~HESealExecutable() noexcept {
     }
     m_acceptor = nullptr;
     m_session = nullptr;
+    m_data_sessions.clear();
+    if (m_server_address.is_local()) {
+      std::remove(m_server_address.path().c_str());
+    }
   }
 }
 
@@ -210,6 +275,51 @@ void HESealExecutable::update_he_op_annotations() {
   set_parameters_and_results(*m_function);
 }
 
+void HESealExecutable::find_constant_ops() {
+  m_constant_ops.clear();
+  m_constant_outputs.clear();
+  auto is_constant = [this](const Output<Node>& output) {
+    return m_constant_ops.count(output.get_node()) != 0;
+  };
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const auto op = wrapped.get_op();
+    switch (wrapped.get_typeid()) {
+      case OP_TYPEID::Constant:
+        m_constant_ops.insert(op.get());
+        break;
+      case OP_TYPEID::Broadcast:
+      case OP_TYPEID::Concat:
+      case OP_TYPEID::Pad:
+      case OP_TYPEID::Reshape:
+      case OP_TYPEID::Reverse:
+      case OP_TYPEID::Slice: {
+        auto inputs = op->inputs();
+        if (std::all_of(inputs.begin(), inputs.end(), [&](const auto& input) {
+              return is_constant(input.get_source_output());
+            })) {
+          m_constant_ops.insert(op.get());
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    const auto op = wrapped.get_op();
+    if (m_constant_ops.count(op.get()) != 0) {
+      continue;
+    }
+    for (auto input : op->inputs()) {
+      if (is_constant(input.get_source_output())) {
+        m_constant_outputs.insert(&input.get_tensor());
+      }
+    }
+  }
+  NGRAPH_HE_LOG(3) << "Found " << m_constant_ops.size() << " constant ops";
+}
+
 size_t HESealExecutable::batch_size() const { return m_batch_size; }
 
 void HESealExecutable::set_batch_size(size_t batch_size) {
@@ -250,6 +360,7 @@ bool HESealExecutable::server_setup() {
     check_client_supports_function();
 
     NGRAPH_HE_LOG(1) << "Starting server";
+    m_session_token = generate_session_token();
     start_server();
 
     std::stringstream param_stream;
@@ -257,6 +368,8 @@ bool HESealExecutable::server_setup() {
 
     pb::EncryptionParameters proto_parms;
     *proto_parms.mutable_encryption_parameters() = param_stream.str();
+    proto_parms.set_data_connections(m_he_seal_backend.data_connections());
+    proto_parms.set_session_token(m_session_token);
 
     pb::TCPMessage proto_msg;
     *proto_msg.mutable_encryption_parameters() = proto_parms;
@@ -289,17 +402,37 @@ void HESealExecutable::accept_connection() {
 
   m_acceptor->async_accept(
       [this, server_callback](boost::system::error_code ec,
-                              boost::asio::ip::tcp::socket socket) {
+                              TransportSocket socket) {
         if (!ec) {
           NGRAPH_HE_LOG(1) << "Connection accepted";
-          m_session =
-              std::make_shared<TCPSession>(std::move(socket), server_callback);
-          m_session->start();
-          NGRAPH_HE_LOG(1) << "Session started";
+          auto session = std::make_shared<TCPSession>(
+              std::move(socket), server_callback,
+              TCPMessageDispatcher::default_worker_count,
+              m_server_address.type());
 
           std::lock_guard<std::mutex> guard(m_session_mutex);
-          m_session_started = true;
-          m_session_cond.notify_one();
+          if (m_session == nullptr) {
+            NGRAPH_HE_LOG(1) << "Session started";
+            m_session = session;
+            m_session_started = true;
+            m_session_cond.notify_one();
+          } else {
+            // Any process may connect, so a data connection is only attached
+            // once it presents the session token
+            ++m_pending_data_sessions;
+            std::weak_ptr<TCPSession> weak_session = session;
+            session->set_handshake_check(
+                [this, weak_session](const TCPMessage& message) {
+                  return add_data_session(message, weak_session.lock());
+                });
+          }
+          session->start();
+          // The client opens its data connections once it received the
+          // encryption parameters
+          if (m_data_sessions.size() + m_pending_data_sessions + 1 <
+              m_he_seal_backend.data_connections()) {
+            accept_connection();
+          }
         } else {
           NGRAPH_ERR << "error accepting connection " << ec.message();
           accept_connection();
@@ -307,12 +440,45 @@ void HESealExecutable::accept_connection() {
       });
 }
 
+bool HESealExecutable::add_data_session(
+    const TCPMessage& message, const std::shared_ptr<TCPSession>& session) {
+  const auto& proto_msg = *message.proto_message();
+  bool valid = session != nullptr && proto_msg.has_session_token() &&
+               tokens_equal(proto_msg.session_token().token(), m_session_token);
+
+  std::lock_guard<std::mutex> guard(m_session_mutex);
+  // accept_connection keeps accepting while connections are missing
+  bool accepting = m_data_sessions.size() + m_pending_data_sessions + 1 <
+                   m_he_seal_backend.data_connections();
+  --m_pending_data_sessions;
+  if (!valid) {
+    NGRAPH_ERR << "Rejecting data connection without session token";
+    // Accept another connection in its place
+    if (!accepting) {
+      accept_connection();
+    }
+    return false;
+  }
+  NGRAPH_HE_LOG(1) << "Data connection " << m_data_sessions.size() + 1
+                   << " started";
+  // With shared memory, all connections of the client share the channel of
+  // its first connection
+  session->set_channel(m_session->channel());
+  m_data_sessions.emplace_back(session);
+  return true;
+}
+
 void HESealExecutable::start_server() {
-  boost::asio::ip::tcp::resolver resolver(m_io_context);
-  boost::asio::ip::tcp::endpoint server_endpoints(boost::asio::ip::tcp::v4(),
-                                                  m_port);
-  m_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
-      m_io_context, server_endpoints);
+  NGRAPH_HE_LOG(1) << "Server listening on " << m_server_address.uri();
+  auto server_endpoints = m_server_address.resolve(m_io_context);
+  NGRAPH_CHECK(!server_endpoints.empty(), "Cannot resolve server address ",
+               m_server_address.uri());
+  if (m_server_address.is_local()) {
+    // Remove the socket file left behind by a previous server
+    std::remove(m_server_address.path().c_str());
+  }
+  m_acceptor = std::make_unique<TransportAcceptor>(m_io_context,
+                                                   server_endpoints.front());
   boost::asio::socket_base::reuse_address option(true);
   m_acceptor->set_option(option);
 
@@ -350,6 +516,52 @@ void HESealExecutable::load_eval_key(const pb::TCPMessage& proto_msg) {
   m_client_eval_key_set = true;
 }
 
+void HESealExecutable::handle_key_fingerprint(const pb::TCPMessage& proto_msg) {
+  const std::string& fingerprint = proto_msg.key_fingerprint().fingerprint();
+  NGRAPH_CHECK(is_key_fingerprint(fingerprint), "Invalid key fingerprint");
+  HESealKeyCache& key_cache = m_he_seal_backend.key_cache();
+
+  // The client sent its keys, which load_public_key and load_eval_key loaded
+  if (proto_msg.has_public_key()) {
+    // The fingerprint covers every key the entry stores, so a client which
+    // knows another client's public key can't replace that client's entry
+    NGRAPH_CHECK(key_fingerprint(proto_msg.public_key().public_key(),
+                                 proto_msg.eval_key().eval_key()) ==
+                     fingerprint,
+                 "Key fingerprint doesn't match public and relinearization ",
+                 "keys");
+    HESealKeyCache::Keys keys;
+    keys.public_key = m_he_seal_backend.get_public_key();
+    if (proto_msg.has_eval_key()) {
+      keys.relin_keys = m_he_seal_backend.get_relin_keys();
+    }
+    size_t byte_count = proto_msg.public_key().public_key().size() +
+                        proto_msg.eval_key().eval_key().size();
+    key_cache.insert(fingerprint, m_context, keys, byte_count);
+    return;
+  }
+
+  std::optional<HESealKeyCache::Keys> keys =
+      key_cache.find(fingerprint, m_context);
+  if (keys.has_value() && (keys->relin_keys != nullptr ||
+                           !m_context->using_keyswitching())) {
+    NGRAPH_HE_LOG(1) << "Server using cached client keys";
+    m_he_seal_backend.set_public_key(keys->public_key);
+    m_client_public_key_set = true;
+    if (keys->relin_keys != nullptr) {
+      m_he_seal_backend.set_relin_keys(keys->relin_keys);
+    }
+    m_client_eval_key_set = true;
+    return;
+  }
+
+  NGRAPH_HE_LOG(1) << "Server requesting client keys";
+  pb::TCPMessage request;
+  request.set_type(pb::TCPMessage_Type_REQUEST);
+  *request.mutable_key_fingerprint() = proto_msg.key_fingerprint();
+  m_session->write_message(TCPMessage(std::move(request)));
+}
+
 void HESealExecutable::send_inference_shape() {
   m_sent_inference_shape = true;
 
@@ -399,12 +611,16 @@ void HESealExecutable::send_inference_shape() {
 
 void HESealExecutable::handle_relu_result(const pb::TCPMessage& proto_msg) {
   NGRAPH_HE_LOG(3) << "Server handling relu result";
-  std::lock_guard<std::mutex> guard(m_relu_mutex);
 
   NGRAPH_CHECK(proto_msg.he_tensors_size() == 1,
                "Can only handle one tensor at a time, got ",
                proto_msg.he_tensors_size());
 
+  // Results may arrive in any order, so each batch carries the index of its
+  // first element in m_unknown_relu_idx
+  json js = json::parse(proto_msg.function().function());
+  size_t batch_offset = js.at("offset");
+
   const auto& proto_tensor = proto_msg.he_tensors(0);
   auto he_tensor = HETensor::load_from_proto_tensor(
       proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
@@ -413,12 +629,13 @@ void HESealExecutable::handle_relu_result(const pb::TCPMessage& proto_msg) {
       m_he_seal_backend.get_encryption_parameters());
 
   size_t result_count = proto_tensor.data_size();
+  NGRAPH_CHECK(batch_offset + result_count <= m_unknown_relu_idx.size(),
+               "Relu result out of range");
   for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    m_relu_data[m_unknown_relu_idx[result_idx + m_relu_done_count]] =
+    m_relu_data[m_unknown_relu_idx[batch_offset + result_idx]] =
         he_tensor->data(result_idx);
   }
-  m_relu_done_count += result_count;
-  m_relu_cond.notify_all();
+  m_relu_flow_control.on_reply(batch_offset);
 }
 
 void HESealExecutable::handle_bounded_relu_result(
@@ -427,27 +644,31 @@ void HESealExecutable::handle_bounded_relu_result(
 }
 
 void HESealExecutable::handle_max_pool_result(const pb::TCPMessage& proto_msg) {
-  std::lock_guard<std::mutex> guard(m_max_pool_mutex);
+  NGRAPH_HE_LOG(3) << "Server handling max pool result";
 
   NGRAPH_CHECK(proto_msg.he_tensors_size() == 1,
                "Can only handle one tensor at a time, got ",
                proto_msg.he_tensors_size());
 
-  const auto& proto_tensor = proto_msg.he_tensors(0);
-  size_t result_count = proto_tensor.data_size();
-
-  NGRAPH_CHECK(result_count == 1, "Maxpool only supports result_count 1, got ",
-               result_count);
+  // Results may arrive in any order, so each batch carries the index of its
+  // first window
+  json js = json::parse(proto_msg.function().function());
+  size_t batch_offset = js.at("offset");
 
+  const auto& proto_tensor = proto_msg.he_tensors(0);
   auto he_tensor = HETensor::load_from_proto_tensor(
       proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
       m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
       *m_he_seal_backend.get_decryptor(),
       m_he_seal_backend.get_encryption_parameters());
 
-  m_max_pool_data.emplace_back(he_tensor->data(0));
-  m_max_pool_done = true;
-  m_max_pool_cond.notify_all();
+  size_t result_count = proto_tensor.data_size();
+  NGRAPH_CHECK(batch_offset + result_count <= m_max_pool_data.size(),
+               "Max pool result out of range");
+  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+    m_max_pool_data[batch_offset + result_idx] = he_tensor->data(result_idx);
+  }
+  m_max_pool_flow_control.on_reply(batch_offset);
 }
 
 void HESealExecutable::handle_message(const TCPMessage& message) {
@@ -464,6 +685,9 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
       if (proto_msg->has_eval_key()) {
         load_eval_key(*proto_msg);
       }
+      if (proto_msg->has_key_fingerprint()) {
+        handle_key_fingerprint(*proto_msg);
+      }
       if (!m_sent_inference_shape && m_client_public_key_set &&
           m_client_eval_key_set) {
         send_inference_shape();
@@ -476,16 +700,17 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
         auto name = js.at("function");
 
         static std::unordered_set<std::string> known_function_names{
-            "Relu", "BoundedRelu", "MaxPool"};
+            "Relu", "BoundedRelu", "MaxPool", "Chain"};
         NGRAPH_CHECK(
             known_function_names.find(name) != known_function_names.end(),
             "Unknown function name ", name);
 
+        // Chains are only sent by ReluMaxPool, so end in a MaxPool
         if (name == "Relu") {
           handle_relu_result(*proto_msg);
         } else if (name == "BoundedRelu") {
           handle_bounded_relu_result(*proto_msg);
-        } else if (name == "MaxPool") {
+        } else if (name == "MaxPool" || name == "Chain") {
           handle_max_pool_result(*proto_msg);
         }
       }
@@ -494,6 +719,15 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
     case pb::TCPMessage_Type_REQUEST: {
       if (proto_msg->he_tensors_size() > 0) {
         handle_client_ciphers(*proto_msg);
+      } else if (proto_msg->has_function()) {
+        json js = json::parse(proto_msg->function().function());
+        auto name = js.at("function");
+        NGRAPH_CHECK(name == "Close", "Unknown client request ", name);
+
+        NGRAPH_HE_LOG(1) << "Client closing session";
+        std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+        m_client_closed = true;
+        m_client_inputs_cond.notify_all();
       }
       break;
     }
@@ -553,17 +787,20 @@ void HESealExecutable::handle_client_ciphers(const pb::TCPMessage& proto_msg) {
   NGRAPH_CHECK(find_matching_parameter_index(proto_tensor.name(), param_idx),
                "Could not find matching parameter name ", proto_tensor.name());
 
-  if (m_client_inputs[param_idx] == nullptr) {
-    auto he_tensor = HETensor::load_from_proto_tensor(
-        proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
-        m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-        *m_he_seal_backend.get_decryptor(),
-        m_he_seal_backend.get_encryption_parameters());
-    m_client_inputs[param_idx] = he_tensor;
-  } else {
-    HETensor::load_from_proto_tensor(m_client_inputs[param_idx], proto_tensor,
-                                     m_he_seal_backend.get_context());
+  // Chunks of the same tensor may be handled concurrently, so only the
+  // creation of the tensor is serialized
+  std::shared_ptr<HETensor> client_input;
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    if (m_client_inputs[param_idx] == nullptr) {
+      m_client_inputs[param_idx] = std::make_shared<HETensor>(
+          pb_type_to_type(proto_tensor.type()), shape, proto_tensor.packed(),
+          complex_packing(), false, m_he_seal_backend, proto_tensor.name());
+    }
+    client_input = m_client_inputs[param_idx];
   }
+  HETensor::load_from_proto_tensor(client_input, proto_tensor,
+                                   m_he_seal_backend.get_context());
 
   auto done_loading = [&]() {
     for (size_t parm_idx = 0; parm_idx < input_parameters.size(); ++parm_idx) {
@@ -581,10 +818,13 @@ void HESealExecutable::handle_client_ciphers(const pb::TCPMessage& proto_msg) {
     return true;
   };
 
+  std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+  if (m_client_inputs_received) {
+    return;
+  }
   if (done_loading()) {
     NGRAPH_HE_LOG(3) << "Done loading client ciphertexts";
 
-    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
     m_client_inputs_received = true;
     NGRAPH_HE_LOG(5) << "Notifying done loading client ciphertexts";
     m_client_inputs_cond.notify_all();
@@ -603,6 +843,15 @@ HESealExecutable::get_performance_data() const {
   return rc;
 }
 
+std::unordered_map<std::string, HESealMemoryPools::Usage>
+HESealExecutable::get_memory_usage() const {
+  std::unordered_map<std::string, HESealMemoryPools::Usage> usage;
+  for (const auto& [node, node_usage] : m_memory_usage_map) {
+    usage.emplace(node->get_name(), node_usage);
+  }
+  return usage;
+}
+
 bool HESealExecutable::call(
     const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
     const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
@@ -624,8 +873,13 @@ bool HESealExecutable::call(
     NGRAPH_HE_LOG(1) << "Waiting for m_client_inputs";
 
     std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
-    m_client_inputs_cond.wait(
-        mlock, std::bind(&HESealExecutable::client_inputs_received, this));
+    m_client_inputs_cond.wait(mlock, [this]() {
+      return client_inputs_received() || client_closed();
+    });
+    if (!client_inputs_received()) {
+      NGRAPH_HE_LOG(1) << "Client closed the session";
+      return false;
+    }
     NGRAPH_HE_LOG(1) << "Client inputs_received";
   }
 
@@ -682,6 +936,10 @@ bool HESealExecutable::call(
         }
         NGRAPH_HE_LOG(3) << "Done encrypting parameter " << param->get_name()
                          << " from server";
+      } else if (he_input->get_element_type() == element::f32) {
+        // Values written as f32 are exact in single precision, which halves
+        // the memory of packed plaintexts
+        he_input->set_float_plaintexts(true);
       }
     }
     NGRAPH_CHECK(he_input != nullptr, "HE input is nullptr");
@@ -741,8 +999,90 @@ bool HESealExecutable::call(
     tensor_map.insert({tv, he_output});
   }
 
+  // Tensors whose computation is deferred to a tiled client-aided ReLU
+  std::unordered_map<descriptor::Tensor*, TileProducer> tile_producers;
+
+  // Spill intermediate tensors to disk once the ciphertexts of the live
+  // tensors exceed the budget
+  bool spill = m_he_seal_backend.spill_bytes() !=
+               std::numeric_limits<size_t>::max();
+  // Indices of the ops using each tensor, in execution order
+  std::unordered_map<const descriptor::Tensor*, std::vector<size_t>>
+      tensor_uses;
+  // Encrypted intermediate tensors, which may be spilled
+  std::unordered_set<const descriptor::Tensor*> spillable_tensors;
+  if (spill) {
+    if (m_spill_store == nullptr) {
+      std::string directory = m_he_seal_backend.spill_directory();
+      if (directory.empty()) {
+        directory = std::filesystem::temp_directory_path().string();
+      }
+      m_spill_store = std::make_unique<HESealSpillStore>(m_context, directory);
+    }
+    m_spill_store->clear();
+    for (size_t op_idx = 0; op_idx < m_wrapped_nodes.size(); ++op_idx) {
+      for (auto input : m_wrapped_nodes[op_idx].get_op()->inputs()) {
+        tensor_uses[&input.get_tensor()].push_back(op_idx);
+      }
+    }
+  }
+  auto next_use = [&tensor_uses](const descriptor::Tensor* tensor,
+                                 size_t op_idx) {
+    const auto& uses = tensor_uses[tensor];
+    auto it = std::upper_bound(uses.begin(), uses.end(), op_idx);
+    return it == uses.end() ? std::numeric_limits<size_t>::max() : *it;
+  };
+
+  // Values of unpacked plaintext tensors, computed without HETypes. They are
+  // only written to HETensors consumed by ops computed on HETensors, and to
+  // function outputs
+  DenseTensorMap dense_values;
+  const bool dense = m_dense_plaintext && !enable_client();
+
+  // Constant outputs are kept across calls. f32 values are exact in single
+  // precision, which halves the memory of packed constants
+  auto keep_constant = [this](descriptor::Tensor* tensor,
+                              const std::shared_ptr<HETensor>& he_tensor) {
+    if (he_tensor->get_element_type() == element::f32) {
+      he_tensor->set_float_plaintexts(true);
+    }
+    m_constant_tensors[tensor] = he_tensor;
+  };
+
+  // delete any obsolete tensors
+  auto free_dead_tensors = [&](const Node& op) {
+    for (const descriptor::Tensor* t : op.liveness_free_list) {
+      dense_values.erase(t);
+      bool erased = false;
+      for (auto it = tensor_map.begin(); it != tensor_map.end(); ++it) {
+        const std::string& it_name = it->second->get_name();
+        if (it_name == t->get_name()) {
+          if (spill) {
+            m_spill_store->discard(*it->second);
+          }
+          // Recycle the ciphertexts, unless the tensor is still referenced
+          if (it->second.use_count() == 1) {
+            for (auto& he_type : it->second->data()) {
+              if (he_type.is_ciphertext()) {
+                m_ciphertext_pool.release(he_type.get_ciphertext());
+              }
+            }
+          }
+          tensor_map.erase(it);
+          erased = true;
+          break;
+        }
+      }
+      if (!erased) {
+        NGRAPH_HE_LOG(5) << "Failed to erase " << t->get_name()
+                         << " from tensor map";
+      }
+    }
+  };
+
   // for each ordered op in the graph
-  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+  for (size_t op_idx = 0; op_idx < m_wrapped_nodes.size(); ++op_idx) {
+    const NodeWrapper& wrapped = m_wrapped_nodes[op_idx];
     auto op = wrapped.get_op();
     auto type_id = wrapped.get_typeid();
     bool verbose = verbose_op(*op);
@@ -768,13 +1108,53 @@ bool HESealExecutable::call(
       }
       continue;
     }
+    if (m_constants_materialized && m_constant_ops.count(op.get()) != 0) {
+      // Computed on an earlier call
+      for (auto output : op->outputs()) {
+        auto it = m_constant_tensors.find(&output.get_tensor());
+        if (it != m_constant_tensors.end()) {
+          tensor_map.insert(*it);
+        }
+      }
+      continue;
+    }
     m_timer_map[op].start();
 
+    if (dense && generate_dense_calls(wrapped, tensor_map, dense_values)) {
+      m_timer_map[op].stop();
+      free_dead_tensors(*op);
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
+                         << m_timer_map[op].get_milliseconds()
+                         << "ms on dense plaintexts"
+                         << "\033[0m";
+      }
+      continue;
+    }
+
     // get op inputs from map
     std::vector<std::shared_ptr<HETensor>> op_inputs;
     for (auto input : op->inputs()) {
       descriptor::Tensor* tensor = &input.get_tensor();
-      op_inputs.push_back(tensor_map.at(tensor));
+      auto it = tensor_map.find(tensor);
+      if (it == tensor_map.end()) {
+        // Computed on dense plaintexts so far
+        auto he_tensor = std::static_pointer_cast<HETensor>(
+            m_he_seal_backend.create_plain_tensor(tensor->get_element_type(),
+                                                  tensor->get_shape(), false,
+                                                  tensor->get_name()));
+        if (m_constant_outputs.count(tensor) != 0) {
+          write_dense(m_constant_dense_values.at(tensor), *he_tensor);
+          keep_constant(tensor, he_tensor);
+        } else {
+          write_dense(dense_values.at(tensor), *he_tensor);
+        }
+        it = tensor_map.emplace(tensor, he_tensor).first;
+      }
+      op_inputs.push_back(it->second);
+      if (spill) {
+        m_spill_store->restore(*op_inputs.back());
+      }
     }
 
     if (enable_client() && type_id == OP_TYPEID::Result) {
@@ -809,10 +1189,24 @@ bool HESealExecutable::call(
         NGRAPH_HE_LOG(5) << "Creating output tensor with shape " << shape;
 
         if (encrypted_out) {
+          // Results are at most at the level of the arguments, so pooled
+          // ciphertexts at that level fit them
+          seal::parms_id_type parms_id = seal::parms_id_zero;
+          for (const auto& op_input : op_inputs) {
+            if (!op_input->data().empty() &&
+                op_input->data(0).is_ciphertext()) {
+              parms_id =
+                  op_input->data(0).get_ciphertext()->ciphertext().parms_id();
+              break;
+            }
+          }
           auto out_tensor = std::static_pointer_cast<HETensor>(
               m_he_seal_backend.create_cipher_tensor(element_type, shape,
-                                                     packed_out, name));
+                                                     packed_out, name,
+                                                     &m_ciphertext_pool,
+                                                     parms_id));
           tensor_map.insert({tensor, out_tensor});
+          spillable_tensors.insert(tensor);
         } else {
           auto out_tensor = std::static_pointer_cast<HETensor>(
               m_he_seal_backend.create_plain_tensor(element_type, shape,
@@ -831,31 +1225,129 @@ bool HESealExecutable::call(
       base_type = op->get_inputs().at(0).get_tensor().get_element_type();
     }
 
-    generate_calls(base_type, wrapped, op_outputs, op_inputs);
+    std::vector<TileProducer> input_producers;
+    for (auto input : op->inputs()) {
+      auto it = tile_producers.find(&input.get_tensor());
+      if (it != tile_producers.end()) {
+        input_producers.emplace_back(std::move(it->second));
+        tile_producers.erase(it);
+      }
+    }
+
+    if (is_tiled_relu_producer(*op)) {
+      // Defer the computation to the client-aided ReLU consuming the output,
+      // which computes it one tile at a time
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "Deferring " << op->get_name() << " to tiled relu";
+      }
+      tile_producers[&op->output(0).get_tensor()] =
+          [this, base_type, wrapped, op_outputs, op_inputs, input_producers](
+              size_t begin, size_t end) {
+            for (const auto& input_producer : input_producers) {
+              input_producer(begin, end);
+            }
+            generate_tile(base_type, wrapped, op_outputs, op_inputs, begin,
+                          end);
+          };
+    } else if (!input_producers.empty()) {
+      NGRAPH_CHECK(input_producers.size() == 1 &&
+                       (type_id == OP_TYPEID::Relu ||
+                        type_id == OP_TYPEID::BoundedRelu),
+                   "Unexpected tiled input to ", op->get_name());
+      handle_server_relu_op(op_inputs[0], op_outputs[0], wrapped,
+                            input_producers[0]);
+    } else {
+      generate_calls(base_type, wrapped, op_outputs, op_inputs);
+      if (m_constant_ops.count(op.get()) != 0) {
+        for (size_t i = 0; i < op->get_output_size(); ++i) {
+          descriptor::Tensor* tensor = &op->output(i).get_tensor();
+          if (m_constant_outputs.count(tensor) != 0) {
+            keep_constant(tensor, op_outputs[i]);
+          }
+        }
+      }
+    }
     m_timer_map[op].stop();
 
-    // delete any obsolete tensors
-    for (const descriptor::Tensor* t : op->liveness_free_list) {
-      bool erased = false;
-      for (auto it = tensor_map.begin(); it != tensor_map.end(); ++it) {
-        const std::string& it_name = it->second->get_name();
-        if (it_name == t->get_name()) {
-          tensor_map.erase(it);
-          erased = true;
-          break;
+    // Free the pools for temporaries once over their limit
+    auto pool_usage = m_he_seal_backend.memory_pools().trim();
+    auto& op_pool_usage = m_memory_usage_map[op];
+    op_pool_usage.current_bytes = pool_usage.current_bytes;
+    op_pool_usage.peak_bytes =
+        std::max(op_pool_usage.peak_bytes, pool_usage.peak_bytes);
+
+    // Drop this op's references, so its dead inputs can be recycled
+    op_inputs.clear();
+    op_outputs.clear();
+
+    free_dead_tensors(*op);
+
+    if (spill) {
+      // Spill the intermediates used furthest in the future until the live
+      // ciphertexts fit the budget
+      size_t spill_bytes = m_he_seal_backend.spill_bytes();
+      size_t live_bytes = 0;
+      std::vector<std::pair<size_t, descriptor::Tensor*>> spill_candidates;
+      for (auto& [tensor, he_tensor] : tensor_map) {
+        if (m_spill_store->is_spilled(*he_tensor)) {
+          continue;
+        }
+        live_bytes += HESealSpillStore::resident_bytes(*he_tensor);
+        size_t next_op_idx = next_use(tensor, op_idx);
+        // Skip tensors still referenced elsewhere, e.g. by a tile producer
+        if (spillable_tensors.count(tensor) != 0 &&
+            he_tensor.use_count() == 1 &&
+            next_op_idx > op_idx + spill_prefetch_distance) {
+          spill_candidates.emplace_back(next_op_idx, tensor);
         }
       }
-      if (!erased) {
-        NGRAPH_HE_LOG(5) << "Failed to erase " << t->get_name()
-                         << " from tensor map";
+      if (live_bytes > spill_bytes) {
+        // Pooled ciphertexts are the cheapest memory to give up
+        m_ciphertext_pool.clear();
+        std::sort(spill_candidates.begin(), spill_candidates.end(),
+                  std::greater<>());
+        for (const auto& candidate : spill_candidates) {
+          if (live_bytes <= spill_bytes) {
+            break;
+          }
+          size_t freed_bytes =
+              m_spill_store->spill(*tensor_map.at(candidate.second));
+          live_bytes -= std::min(live_bytes, freed_bytes);
+          if (verbose) {
+            NGRAPH_HE_LOG(3) << "Spilled " << freed_bytes << " bytes of "
+                             << candidate.second->get_name()
+                             << ", next used by op " << candidate.first;
+          }
+        }
+      }
+
+      // Load the spilled inputs of the next ops in the background
+      size_t last_prefetch_idx = std::min(op_idx + spill_prefetch_distance,
+                                          m_wrapped_nodes.size() - 1);
+      for (size_t next_idx = op_idx + 1; next_idx <= last_prefetch_idx;
+           ++next_idx) {
+        for (auto input : m_wrapped_nodes[next_idx].get_op()->inputs()) {
+          auto it = tensor_map.find(&input.get_tensor());
+          if (it != tensor_map.end()) {
+            m_spill_store->prefetch(it->second);
+          }
+        }
       }
     }
+
     if (verbose) {
       NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
                        << m_timer_map[op].get_milliseconds() << "ms"
                        << "\033[0m";
+      NGRAPH_HE_LOG(3) << op->get_name() << " memory pools hold "
+                       << pool_usage.peak_bytes << " bytes, "
+                       << pool_usage.current_bytes << " after trimming";
     }
   }
+  NGRAPH_CHECK(tile_producers.empty(), "Deferred computation of ",
+               tile_producers.size(), " tensors never ran");
+  m_constants_materialized = true;
+
   size_t total_time = 0;
   for (const auto& elem : m_timer_map) {
     total_time += elem.second.get_milliseconds();
@@ -863,39 +1355,93 @@ bool HESealExecutable::call(
   if (verbose_op("total")) {
     NGRAPH_HE_LOG(3) << "\033[1;32m"
                      << "Total time " << total_time << " (ms) \033[0m";
+    auto pool_stats = m_ciphertext_pool.stats();
+    NGRAPH_HE_LOG(3) << "Ciphertext pool reused " << pool_stats.reused << " of "
+                     << pool_stats.acquired << " ciphertexts, holds "
+                     << pool_stats.size << " (" << pool_stats.bytes
+                     << " bytes)";
+    if (spill) {
+      const auto& spill_stats = m_spill_store->stats();
+      NGRAPH_HE_LOG(3) << "Spilled " << spill_stats.spilled << " tensors ("
+                       << spill_stats.bytes << " bytes), "
+                       << spill_stats.prefetched << " loaded by prefetch, "
+                       << spill_stats.restored << " on demand";
+    }
   }
 
   // Send outputs to client.
   if (enable_client()) {
+    // The client sends the inputs of its next inference once it received the
+    // results, so be ready for them first
+    {
+      std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+      m_client_inputs.assign(get_parameters().size(), nullptr);
+      m_client_inputs_received = false;
+    }
     send_client_results();
   }
   return true;
 }
 
+size_t HESealExecutable::serve(
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
+  NGRAPH_CHECK(enable_client(), "Serving inferences requires the client");
+  size_t inference_count = 0;
+  while (call(outputs, server_inputs)) {
+    ++inference_count;
+    NGRAPH_HE_LOG(1) << "Server completed inference " << inference_count;
+  }
+  return inference_count;
+}
+
 void HESealExecutable::send_client_results() {
   NGRAPH_HE_LOG(3) << "Sending results to client";
   NGRAPH_CHECK(m_client_outputs.size() == 1,
                "HESealExecutable only supports output size 1 (got ",
                get_results().size(), "");
 
-  std::vector<pb::HETensor> proto_tensors;
-  m_client_outputs[0]->write_to_protos(proto_tensors);
-
-  for (const auto& proto_tensor : proto_tensors) {
-    pb::TCPMessage result_msg;
-    result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
-    *result_msg.add_he_tensors() = proto_tensor;
-
-    auto result_shape = result_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Server sending result with shape "
-                     << Shape{result_shape.begin(), result_shape.end()};
-    m_session->write_message(TCPMessage(std::move(result_msg)));
+  // Stripe the result across all connections. The client reassembles the
+  // chunks in any order, by their offsets, and decrypts each chunk as it
+  // arrives. So the result is serialized and sent in chunks even over a
+  // single connection
+  std::vector<std::shared_ptr<TCPSession>> sessions;
+  {
+    std::lock_guard<std::mutex> guard(m_session_mutex);
+    sessions.emplace_back(m_session);
+    sessions.insert(sessions.end(), m_data_sessions.begin(),
+                    m_data_sessions.end());
   }
 
+  const auto& result = *m_client_outputs[0];
+  size_t value_count = result.get_batched_element_count();
+  size_t chunk_size =
+      value_count == 0 ? 1
+                       : result.proto_chunk_size(HETensor::stripe_proto_bytes);
+  size_t proto_count = 0;
+  size_t begin = 0;
+  do {
+    size_t end = std::min(begin + chunk_size, value_count);
+    std::vector<pb::HETensor> proto_tensors;
+    result.write_to_protos(proto_tensors, HETensor::stripe_proto_bytes, begin,
+                           end);
+    for (auto& proto_tensor : proto_tensors) {
+      pb::TCPMessage result_msg;
+      result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
+      *result_msg.add_he_tensors() = std::move(proto_tensor);
+
+      NGRAPH_HE_LOG(3) << "Server sending result chunk at offset "
+                       << result_msg.he_tensors(0).offset();
+      sessions[proto_count++ % sessions.size()]->write_message(
+          TCPMessage(std::move(result_msg)));
+    }
+    begin = end;
+  } while (begin < value_count);
+
   // Wait until message is written
-  std::unique_lock<std::mutex> mlock(m_result_mutex);
-  std::condition_variable& writing_cond = m_session->is_writing_cond();
-  writing_cond.wait(mlock, [this] { return !m_session->is_writing(); });
+  for (const auto& session : sessions) {
+    session->wait_until_written();
+  }
 }
 
 void HESealExecutable::generate_calls(
@@ -1134,6 +1680,31 @@ void HESealExecutable::generate_calls(
                  out[0]->data().size(), type, m_he_seal_backend);
       break;
     }
+    case OP_TYPEID::ReluMaxPool: {
+      const auto* relu_max_pool = static_cast<const op::ReluMaxPool*>(op.get());
+      if (enable_client()) {
+        handle_server_max_pool_op(args[0], out[0], node_wrapper);
+      } else {
+        NGRAPH_WARN << "Performing ReluMaxPool without client is not "
+                       "privacy-preserving";
+        size_t output_size = args[0]->get_batched_element_count();
+        std::vector<HEType> relu_out(args[0]->data());
+        if (relu_max_pool->is_bounded()) {
+          bounded_relu_seal(args[0]->data(), relu_out,
+                            relu_max_pool->get_bound(), output_size,
+                            m_he_seal_backend);
+        } else {
+          relu_seal(args[0]->data(), relu_out, output_size, m_he_seal_backend);
+        }
+        max_pool_seal(relu_out, out[0]->data(), args[0]->get_packed_shape(),
+                      out[0]->get_packed_shape(),
+                      relu_max_pool->get_window_shape(),
+                      relu_max_pool->get_window_movement_strides(),
+                      relu_max_pool->get_padding_below(),
+                      relu_max_pool->get_padding_above(), m_he_seal_backend);
+      }
+      break;
+    }
     case OP_TYPEID::Relu: {
       if (enable_client()) {
         handle_server_relu_op(args[0], out[0], node_wrapper);
@@ -1329,6 +1900,234 @@ void HESealExecutable::generate_calls(
   }
 }
 
+bool HESealExecutable::generate_dense_calls(
+    const NodeWrapper& node_wrapper,
+    const std::unordered_map<descriptor::Tensor*, std::shared_ptr<HETensor>>&
+        tensor_map,
+    DenseTensorMap& dense_values) {
+  const auto op = node_wrapper.get_op();
+  const OP_TYPEID type_id = node_wrapper.get_typeid();
+  switch (type_id) {
+    case OP_TYPEID::Add:
+    case OP_TYPEID::AvgPool:
+    case OP_TYPEID::BoundedRelu:
+    case OP_TYPEID::Broadcast:
+    case OP_TYPEID::Convolution:
+    case OP_TYPEID::Divide:
+    case OP_TYPEID::Dot:
+    case OP_TYPEID::MaxPool:
+    case OP_TYPEID::Minimum:
+    case OP_TYPEID::Multiply:
+    case OP_TYPEID::Negative:
+    case OP_TYPEID::Relu:
+    case OP_TYPEID::Reshape:
+    case OP_TYPEID::Result:
+    case OP_TYPEID::Subtract:
+      break;
+    default:
+      return false;
+  }
+
+  // Function outputs are mapped up front, so Result ops have no annotation
+  if (type_id != OP_TYPEID::Result) {
+    auto he_op_annotation = HEOpAnnotations::he_op_annotation(*op);
+    if (he_op_annotation->encrypted() || he_op_annotation->packed()) {
+      return false;
+    }
+  }
+  if (!m_he_seal_backend.is_supported_type(op->get_input_element_type(0))) {
+    return false;
+  }
+  descriptor::Tensor* out_tensor = &op->output(0).get_tensor();
+  auto out_it = tensor_map.find(out_tensor);
+  if (out_it != tensor_map.end() && out_it->second->is_packed()) {
+    return false;
+  }
+
+  // Outputs of constant ops used by other ops are kept across calls
+  auto values_map = [&](const descriptor::Tensor* tensor) -> DenseTensorMap& {
+    return m_constant_outputs.count(tensor) != 0 ? m_constant_dense_values
+                                                 : dense_values;
+  };
+
+  std::vector<const std::vector<double>*> args;
+  for (auto input : op->inputs()) {
+    descriptor::Tensor* tensor = &input.get_tensor();
+    DenseTensorMap& tensor_values = values_map(tensor);
+    auto dense_it = tensor_values.find(tensor);
+    if (dense_it == tensor_values.end()) {
+      std::vector<double> values;
+      if (!read_dense(*tensor_map.at(tensor), values)) {
+        return false;
+      }
+      dense_it = tensor_values.emplace(tensor, std::move(values)).first;
+    }
+    args.push_back(&dense_it->second);
+  }
+
+  std::vector<double> out;
+  const Shape& in_shape = op->get_input_shape(0);
+  const Shape& out_shape = op->get_output_shape(0);
+  switch (type_id) {
+    case OP_TYPEID::Add: {
+      dense_add(*args[0], *args[1], out);
+      break;
+    }
+    case OP_TYPEID::AvgPool: {
+      const auto* avg_pool = static_cast<const op::AvgPool*>(op.get());
+      dense_avg_pool(*args[0], out, in_shape, out_shape,
+                     avg_pool->get_window_shape(),
+                     avg_pool->get_window_movement_strides(),
+                     avg_pool->get_padding_below(),
+                     avg_pool->get_padding_above(),
+                     avg_pool->get_include_padding_in_avg_computation());
+      break;
+    }
+    case OP_TYPEID::BoundedRelu: {
+      const auto* bounded_relu = static_cast<const op::BoundedRelu*>(op.get());
+      dense_bounded_relu(*args[0], out, bounded_relu->get_alpha());
+      break;
+    }
+    case OP_TYPEID::Broadcast: {
+      const auto* broadcast = static_cast<const op::Broadcast*>(op.get());
+      dense_broadcast(*args[0], out, in_shape, out_shape,
+                      broadcast->get_broadcast_axes());
+      break;
+    }
+    case OP_TYPEID::Convolution: {
+      const auto* c = static_cast<const op::Convolution*>(op.get());
+      dense_convolution(*args[0], *args[1], out, in_shape,
+                        op->get_input_shape(1), out_shape,
+                        c->get_window_movement_strides(),
+                        c->get_window_dilation_strides(),
+                        c->get_padding_below(), c->get_padding_above(),
+                        c->get_data_dilation_strides());
+      break;
+    }
+    case OP_TYPEID::Divide: {
+      dense_divide(*args[0], *args[1], out);
+      break;
+    }
+    case OP_TYPEID::Dot: {
+      const auto* dot = static_cast<const op::Dot*>(op.get());
+      dense_dot(*args[0], *args[1], out, in_shape, op->get_input_shape(1),
+                dot->get_reduction_axes_count());
+      break;
+    }
+    case OP_TYPEID::MaxPool: {
+      const auto* max_pool = static_cast<const op::MaxPool*>(op.get());
+      dense_max_pool(*args[0], out, in_shape, out_shape,
+                     max_pool->get_window_shape(),
+                     max_pool->get_window_movement_strides(),
+                     max_pool->get_padding_below(),
+                     max_pool->get_padding_above());
+      break;
+    }
+    case OP_TYPEID::Minimum: {
+      dense_minimum(*args[0], *args[1], out);
+      break;
+    }
+    case OP_TYPEID::Multiply: {
+      dense_multiply(*args[0], *args[1], out);
+      break;
+    }
+    case OP_TYPEID::Negative: {
+      dense_negate(*args[0], out);
+      break;
+    }
+    case OP_TYPEID::Relu: {
+      dense_relu(*args[0], out);
+      break;
+    }
+    case OP_TYPEID::Reshape: {
+      const auto* reshape = static_cast<const op::Reshape*>(op.get());
+      dense_reshape(*args[0], out, in_shape, reshape->get_input_order());
+      break;
+    }
+    case OP_TYPEID::Result: {
+      out = *args[0];
+      break;
+    }
+    case OP_TYPEID::Subtract: {
+      dense_subtract(*args[0], *args[1], out);
+      break;
+    }
+    default:
+      NGRAPH_CHECK(false, "Unsupported dense op ", op->get_name());
+  }
+
+  if (out_it != tensor_map.end()) {
+    write_dense(out, *out_it->second);
+  }
+  values_map(out_tensor)[out_tensor] = std::move(out);
+  return true;
+}
+
+bool HESealExecutable::is_tiled_relu_producer(const Node& node) const {
+  if (!m_pipeline_tiles || !enable_client() || node.get_output_size() != 1) {
+    return false;
+  }
+  auto type_id = NodeWrapper(node.shared_from_this()).get_typeid();
+  if (type_id != OP_TYPEID::Convolution && type_id != OP_TYPEID::Add) {
+    return false;
+  }
+  const auto users = node.get_users();
+  if (users.size() != 1) {
+    return false;
+  }
+  const auto& user = users[0];
+  auto user_type_id = NodeWrapper(user).get_typeid();
+  if (user_type_id == OP_TYPEID::Relu ||
+      user_type_id == OP_TYPEID::BoundedRelu) {
+    return true;
+  }
+  return user_type_id == OP_TYPEID::Add && is_tiled_relu_producer(*user);
+}
+
+void HESealExecutable::generate_tile(
+    const element::Type& type, const NodeWrapper& node_wrapper,
+    const std::vector<std::shared_ptr<HETensor>>& out,
+    const std::vector<std::shared_ptr<HETensor>>& args, size_t begin,
+    size_t end) {
+  const auto op = node_wrapper.get_op();
+  bool verbose = verbose_op(*op);
+
+  switch (node_wrapper.get_typeid()) {
+    case OP_TYPEID::Add: {
+      NGRAPH_CHECK(m_he_seal_backend.is_supported_type(type),
+                   "Unsupported type ", type);
+      NGRAPH_CHECK(end <= args[0]->data().size() &&
+                       end <= args[1]->data().size(),
+                   "Tile [", begin, ", ", end, ") out of range");
+#pragma omp parallel for
+      for (size_t i = begin; i < end; ++i) {
+        scalar_add_seal(args[0]->data(i), args[1]->data(i), out[0]->data(i),
+                        m_he_seal_backend);
+      }
+      break;
+    }
+    case OP_TYPEID::Convolution: {
+      const auto* c = static_cast<const op::Convolution*>(op.get());
+      convolution_seal(args[0]->data(), args[1]->data(), out[0]->data(),
+                       args[0]->get_packed_shape(), args[1]->get_packed_shape(),
+                       out[0]->get_packed_shape(),
+                       c->get_window_movement_strides(),
+                       c->get_window_dilation_strides(), c->get_padding_below(),
+                       c->get_padding_above(), c->get_data_dilation_strides(),
+                       0, 1, 1, 0, 0, 1, type, batch_size(), begin, end,
+                       m_he_seal_backend, false);
+      rescale_seal(out[0]->data(), begin, end, m_he_seal_backend, false);
+      break;
+    }
+    default:
+      NGRAPH_CHECK(false, "Unsupported tiled op ", op->get_name());
+  }
+  if (verbose) {
+    NGRAPH_HE_LOG(5) << "Computed " << op->get_name() << " tile [" << begin
+                     << ", " << end << ")";
+  }
+}
+
 void HESealExecutable::handle_server_max_pool_op(
     const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
     const NodeWrapper& node_wrapper) {
@@ -1336,75 +2135,153 @@ void HESealExecutable::handle_server_max_pool_op(
 
   const auto& op = node_wrapper.get_op();
   bool verbose = verbose_op(*op);
-  const auto* max_pool = static_cast<const op::MaxPool*>(op.get());
-
-  m_max_pool_done = false;
 
   Shape unpacked_arg_shape = op->get_input_shape(0);
   Shape out_shape = HETensor::pack_shape(op->get_output_shape(0));
 
   // TODO(fboemer): call max_pool_seal directly?
-  std::vector<std::vector<size_t>> maximize_lists = max_pool_seal_max_list(
-      unpacked_arg_shape, out_shape, max_pool->get_window_shape(),
-      max_pool->get_window_movement_strides(), max_pool->get_padding_below(),
-      max_pool->get_padding_above());
-
-  m_max_pool_data.clear();
-
-  for (const auto& maximize_list : maximize_lists) {
-    pb::TCPMessage proto_msg;
-    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
-
-    json js = {{"function", op->description()}};
-    pb::Function f;
-    f.set_function(js.dump());
-    *proto_msg.mutable_function() = f;
-
+  std::vector<std::vector<size_t>> maximize_lists;
+  json js;
+  if (node_wrapper.get_typeid() == OP_TYPEID::ReluMaxPool) {
+    const auto* relu_max_pool = static_cast<const op::ReluMaxPool*>(op.get());
+    maximize_lists = max_pool_seal_max_list(
+        unpacked_arg_shape, out_shape, relu_max_pool->get_window_shape(),
+        relu_max_pool->get_window_movement_strides(),
+        relu_max_pool->get_padding_below(), relu_max_pool->get_padding_above());
+
+    // The client applies each function of the chain in turn, with a single
+    // decryption and encryption
+    json relu_js = {{"function", "Relu"}};
+    if (relu_max_pool->is_bounded()) {
+      relu_js = {{"function", "BoundedRelu"},
+                 {"bound", relu_max_pool->get_bound()}};
+    }
+    js["function"] = "Chain";
+    js["chain"] = json::array({relu_js, {{"function", "MaxPool"}}});
+  } else {
+    const auto* max_pool = static_cast<const op::MaxPool*>(op.get());
+    maximize_lists = max_pool_seal_max_list(
+        unpacked_arg_shape, out_shape, max_pool->get_window_shape(),
+        max_pool->get_window_movement_strides(), max_pool->get_padding_below(),
+        max_pool->get_padding_above());
+    js["function"] = op->description();
+  }
+  size_t window_count = maximize_lists.size();
+  m_max_pool_data.assign(window_count, HEType(HEPlaintext(), false));
+  m_max_pool_flow_control.reset();
+
+  // Batches are sized from the first ciphertext and window, and charged
+  // their actual size
+  size_t cipher_bytes = 0;
+  for (const auto& he_type : arg->data()) {
+    if (he_type.is_ciphertext()) {
+      cipher_bytes = ciphertext_size(he_type.get_ciphertext()->ciphertext());
+      break;
+    }
+  }
+  size_t window_bytes = std::max(
+      cipher_bytes * (maximize_lists.empty() ? 1 : maximize_lists[0].size()),
+      size_t(1));
+
+  /// \brief Serializes and sends the windows [batch_offset, batch_offset +
+  /// batch_count), whose values are concatenated. The batch is identified by
+  /// the index of its first window
+  auto send_max_pool_batch = [&](size_t batch_offset, size_t batch_count) {
     std::vector<HEType> cipher_batch;
-    cipher_batch.reserve(maximize_list.size());
-    for (const size_t max_ind : maximize_list) {
-      cipher_batch.emplace_back(arg->data(max_ind));
+    json window_sizes = json::array();
+    size_t batch_bytes = 0;
+    for (size_t window_idx = batch_offset;
+         window_idx < batch_offset + batch_count; ++window_idx) {
+      const auto& maximize_list = maximize_lists[window_idx];
+      NGRAPH_CHECK(!maximize_list.empty(), "Maxpool window is empty");
+      window_sizes.push_back(maximize_list.size());
+      for (const size_t max_ind : maximize_list) {
+        const HEType& he_type = arg->data(max_ind);
+        if (he_type.is_ciphertext()) {
+          batch_bytes +=
+              ciphertext_size(he_type.get_ciphertext()->ciphertext());
+        }
+        cipher_batch.emplace_back(he_type);
+      }
     }
 
-    NGRAPH_CHECK(!cipher_batch.empty(), "Maxpool cipher batch is empty");
-
     HETensor max_pool_tensor(
         arg->get_element_type(),
         Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
         cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
         true, m_he_seal_backend);
-    max_pool_tensor.data() = cipher_batch;
+    max_pool_tensor.data() = std::move(cipher_batch);
     std::vector<pb::HETensor> proto_tensors;
     max_pool_tensor.write_to_protos(proto_tensors);
     NGRAPH_CHECK(proto_tensors.size() == 1,
-                 "Only support MaxPool with 1 proto tensor");
-    *proto_msg.add_he_tensors() = proto_tensors[0];
+                 "Max pool batch does not fit in one message");
 
-    // Send list of ciphertexts to maximize over to client
+    pb::TCPMessage proto_msg;
+    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+    json batch_js = js;
+    batch_js["offset"] = batch_offset;
+    batch_js["window_sizes"] = std::move(window_sizes);
+    proto_msg.mutable_function()->set_function(batch_js.dump());
+    *proto_msg.add_he_tensors() = std::move(proto_tensors[0]);
+
+    // Register the batch before sending, since the reply may arrive before
+    // write_message returns
+    m_max_pool_flow_control.on_send(batch_offset, batch_bytes, batch_count);
+    m_session->write_message(TCPMessage(std::move(proto_msg)));
+  };
+
+  // Sends the windows in batches sized by the flow control's estimate of the
+  // client throughput, while the client processes earlier batches. Replies
+  // are placed concurrently by the message handling threads
+  size_t next_window = 0;
+  while (next_window < window_count) {
+    size_t capacity_bytes = m_max_pool_flow_control.wait_for_capacity();
+    size_t batch_count = std::max(
+        m_max_pool_flow_control.batch_bytes() / window_bytes, size_t(1));
+
+    std::vector<std::pair<size_t, size_t>> batches;
+    size_t planned_bytes = 0;
+    while (next_window < window_count &&
+           batches.size() < max_planned_batches &&
+           (batches.empty() || planned_bytes < capacity_bytes)) {
+      size_t count = std::min(batch_count, window_count - next_window);
+      batches.emplace_back(next_window, count);
+      next_window += count;
+      planned_bytes += count * window_bytes;
+    }
     if (verbose) {
-      NGRAPH_HE_LOG(3) << "Sending " << cipher_batch.size()
-                       << " Maxpool ciphertexts to client";
+      NGRAPH_HE_LOG(3) << "Sending " << batches.size()
+                       << " max pool requests of up to " << batch_count
+                       << " windows";
     }
 
-    TCPMessage max_pool_message(std::move(proto_msg));
-    m_session->write_message(std::move(max_pool_message));
-
-    // Acquire lock
-    std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
-
-    // Wait until max is done
-    m_max_pool_cond.wait(mlock,
-                         std::bind(&HESealExecutable::max_pool_done, this));
+#pragma omp parallel for
+    for (size_t batch_idx = 0; batch_idx < batches.size(); ++batch_idx) {
+      send_max_pool_batch(batches[batch_idx].first,
+                          batches[batch_idx].second);
+    }
+  }
 
-    // Reset for next max_pool call
-    m_max_pool_done = false;
+  // Wait until all batches have been processed
+  m_max_pool_flow_control.wait_until_done();
+
+  if (verbose && window_count > 0) {
+    auto stats = m_max_pool_flow_control.stats();
+    NGRAPH_HE_LOG(3) << "Max pool sent " << stats.element_count
+                     << " windows in " << stats.batch_count << " batches ("
+                     << stats.bytes_sent / (1024 * 1024) << " MB) in "
+                     << stats.elapsed.count() / 1000 << " ms; server waited "
+                     << stats.wait_time.count() / 1000
+                     << " ms; client throughput "
+                     << stats.throughput / (1024 * 1024) << " MB/s";
   }
+
   out->data() = m_max_pool_data;
 }
 
 void HESealExecutable::handle_server_relu_op(
     const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
-    const NodeWrapper& node_wrapper) {
+    const NodeWrapper& node_wrapper, const TileProducer& producer) {
   NGRAPH_HE_LOG(3) << "Server handle_server_relu_op";
 
   auto type_id = node_wrapper.get_typeid();
@@ -1415,104 +2292,177 @@ void HESealExecutable::handle_server_relu_op(
   bool verbose = verbose_op(*op);
   size_t element_count = arg->data().size();
 
-  size_t smallest_ind =
-      match_to_smallest_chain_index(arg->data(), m_he_seal_backend);
+  m_relu_data.resize(element_count, HEType(HEPlaintext(), false));
 
-  if (verbose) {
-    NGRAPH_HE_LOG(3) << "Matched moduli to chain ind " << smallest_ind;
+  // Sized up front, so that replies can be placed while unknown values of
+  // later tiles are appended
+  m_relu_flow_control.reset();
+  m_unknown_relu_idx.resize(element_count);
+  size_t unknown_count = 0;
+  size_t next_unknown_idx = 0;
+
+  // TODO(fboemer): factor out serializing the function
+  json function_js = {{"function", op->description()}};
+  if (type_id == OP_TYPEID::BoundedRelu) {
+    const auto* bounded_relu = static_cast<const op::BoundedRelu*>(op.get());
+    function_js["bound"] = bounded_relu->get_alpha();
   }
 
-  m_relu_data.resize(element_count, HEType(HEPlaintext(), false));
+  // Size of the ciphertexts of the latest tile, used to size new batches.
+  // Chain indices are matched per tile, so tiles may end at different chain
+  // indices, and batches are charged their actual size
+  size_t cipher_bytes = 0;
+  auto relu_batch_count = [&]() {
+    return std::max(m_relu_flow_control.batch_bytes() / cipher_bytes,
+                    size_t(1));
+  };
 
-  // TODO(fboemer): tune
-  const size_t max_relu_message_cnt = 1000;
+  /// \brief Serializes and sends a batch of unknown values. The batch is
+  /// identified by the index of its first element in m_unknown_relu_idx
+  auto send_relu_batch = [&](size_t batch_offset, size_t batch_count) {
+    std::vector<HEType> cipher_batch;
+    cipher_batch.reserve(batch_count);
+    size_t batch_bytes = 0;
+    for (size_t i = 0; i < batch_count; ++i) {
+      const auto& he_type = arg->data(m_unknown_relu_idx[batch_offset + i]);
+      NGRAPH_CHECK(he_type.is_ciphertext(), "HEType should be ciphertext");
+      batch_bytes += ciphertext_size(he_type.get_ciphertext()->ciphertext());
+      cipher_batch.emplace_back(he_type);
+    }
 
-  m_unknown_relu_idx.clear();
-  m_unknown_relu_idx.reserve(element_count);
+    // TODO(fboemer): set complex_packing to correct values?
+    HETensor relu_tensor(arg->get_element_type(),
+                         Shape{cipher_batch[0].batch_size(), batch_count},
+                         arg->is_packed(), false, true, m_he_seal_backend);
+    relu_tensor.data() = std::move(cipher_batch);
 
-  // Process known values
-  for (size_t relu_idx = 0; relu_idx < element_count; ++relu_idx) {
-    auto& he_type = arg->data(relu_idx);
-    if (he_type.is_plaintext()) {
-      m_relu_data[relu_idx].set_plaintext(HEPlaintext());
-      if (type_id == OP_TYPEID::Relu) {
-        scalar_relu_seal(he_type.get_plaintext(),
-                         m_relu_data[relu_idx].get_plaintext());
-      } else {
-        const auto* bounded_relu =
-            static_cast<const op::BoundedRelu*>(op.get());
-        float alpha = bounded_relu->get_alpha();
-        scalar_bounded_relu_seal(he_type.get_plaintext(),
-                                 m_relu_data[relu_idx].get_plaintext(), alpha);
-      }
-    } else {
-      m_unknown_relu_idx.emplace_back(relu_idx);
-    }
-  }
-  auto process_unknown_relu_ciphers_batch =
-      [&](const std::vector<HEType>& cipher_batch) {
-        if (verbose) {
-          NGRAPH_HE_LOG(3) << "Sending relu request size "
-                           << cipher_batch.size();
+    std::vector<pb::HETensor> proto_tensors;
+    relu_tensor.write_to_protos(proto_tensors);
+    NGRAPH_CHECK(proto_tensors.size() == 1,
+                 "Relu batch does not fit in one message");
+
+    pb::TCPMessage proto_msg;
+    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+    json js = function_js;
+    js["offset"] = batch_offset;
+    proto_msg.mutable_function()->set_function(js.dump());
+    *proto_msg.add_he_tensors() = std::move(proto_tensors[0]);
+
+    // Register the batch before sending, since the reply may arrive before
+    // write_message returns
+    m_relu_flow_control.on_send(batch_offset, batch_bytes, batch_count);
+    NGRAPH_HE_LOG(5) << "Server writing relu request message";
+    m_session->write_message(TCPMessage(std::move(proto_msg)));
+  };
+
+  /// \brief Sends the pending unknown values in batches, sized by the flow
+  /// control's current estimate of the client throughput. Batches are
+  /// serialized in parallel. Unless flush is set, a partial last batch is
+  /// kept back until more values are known
+  auto send_relu_batches = [&](bool flush) {
+    while (next_unknown_idx < unknown_count) {
+      size_t capacity_bytes = m_relu_flow_control.wait_for_capacity();
+      size_t batch_count = relu_batch_count();
+
+      std::vector<std::pair<size_t, size_t>> batches;
+      size_t planned_bytes = 0;
+      while (next_unknown_idx < unknown_count &&
+             batches.size() < max_planned_batches &&
+             (batches.empty() || planned_bytes < capacity_bytes)) {
+        size_t count = std::min(batch_count, unknown_count - next_unknown_idx);
+        if (count < batch_count && !flush) {
+          break;
         }
+        batches.emplace_back(next_unknown_idx, count);
+        next_unknown_idx += count;
+        planned_bytes += count * cipher_bytes;
+      }
+      if (batches.empty()) {
+        break;
+      }
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "Sending " << batches.size()
+                         << " relu requests of up to " << batch_count
+                         << " ciphertexts";
+      }
 
-        // TODO(fboemer): set complex_packing to correct values?
-        HETensor relu_tensor(
-            arg->get_element_type(),
-            Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
-            arg->is_packed(), false, true, m_he_seal_backend);
-        relu_tensor.data() = cipher_batch;
-
-        std::vector<pb::HETensor> proto_tensors;
-        relu_tensor.write_to_protos(proto_tensors);
-        for (const auto& proto_tensor : proto_tensors) {
-          pb::TCPMessage proto_msg;
-          proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
-
-          // TODO(fboemer): factor out serializing the function
-          json js = {{"function", op->description()}};
-          if (type_id == OP_TYPEID::BoundedRelu) {
-            const auto* bounded_relu =
-                static_cast<const op::BoundedRelu*>(op.get());
-            float alpha = bounded_relu->get_alpha();
-            js["bound"] = alpha;
-          }
+#pragma omp parallel for
+      for (size_t batch_idx = 0; batch_idx < batches.size(); ++batch_idx) {
+        send_relu_batch(batches[batch_idx].first, batches[batch_idx].second);
+      }
+    }
+  };
 
-          pb::Function f;
-          f.set_function(js.dump());
-          *proto_msg.mutable_function() = f;
+  // Without a producer, arg is already computed and forms a single tile.
+  // Otherwise, each tile is computed while the client processes the previous
+  // tiles' batches. Replies are placed concurrently by the message handling
+  // threads.
+  size_t tile_size = producer ? min_relu_tile_size : element_count;
+  for (size_t tile_begin = 0; tile_begin < element_count;) {
+    size_t tile_end = std::min(tile_begin + tile_size, element_count);
+    if (producer) {
+      producer(tile_begin, tile_end);
+    }
 
-          *proto_msg.add_he_tensors() = proto_tensor;
-          TCPMessage relu_message(std::move(proto_msg));
+    size_t smallest_ind = match_to_smallest_chain_index(
+        arg->data(), tile_begin, tile_end, m_he_seal_backend);
+    if (verbose) {
+      NGRAPH_HE_LOG(3) << "Matched moduli of [" << tile_begin << ", "
+                       << tile_end << ") to chain ind " << smallest_ind;
+    }
 
-          NGRAPH_HE_LOG(5) << "Server writing relu request message";
-          m_session->write_message(std::move(relu_message));
+    // Process known values
+    size_t tile_cipher_bytes = 0;
+    for (size_t relu_idx = tile_begin; relu_idx < tile_end; ++relu_idx) {
+      auto& he_type = arg->data(relu_idx);
+      if (he_type.is_plaintext()) {
+        m_relu_data[relu_idx].set_plaintext(HEPlaintext());
+        if (type_id == OP_TYPEID::Relu) {
+          scalar_relu_seal(he_type.get_plaintext(),
+                           m_relu_data[relu_idx].get_plaintext());
+        } else {
+          const auto* bounded_relu =
+              static_cast<const op::BoundedRelu*>(op.get());
+          float alpha = bounded_relu->get_alpha();
+          scalar_bounded_relu_seal(he_type.get_plaintext(),
+                                   m_relu_data[relu_idx].get_plaintext(),
+                                   alpha);
         }
-      };
-
-  // Process unknown values
-  std::vector<HEType> relu_ciphers_batch;
-  relu_ciphers_batch.reserve(max_relu_message_cnt);
+      } else {
+        if (tile_cipher_bytes == 0) {
+          tile_cipher_bytes =
+              ciphertext_size(he_type.get_ciphertext()->ciphertext());
+        }
+        m_unknown_relu_idx[unknown_count++] = relu_idx;
+      }
+    }
+    if (tile_cipher_bytes != 0) {
+      cipher_bytes = tile_cipher_bytes;
+    }
+    tile_begin = tile_end;
 
-  for (const auto& unknown_relu_idx : m_unknown_relu_idx) {
-    NGRAPH_CHECK(arg->data(unknown_relu_idx).is_ciphertext(),
-                 "HEType should be ciphertext");
-    relu_ciphers_batch.emplace_back(arg->data(unknown_relu_idx));
-    if (relu_ciphers_batch.size() == max_relu_message_cnt) {
-      process_unknown_relu_ciphers_batch(relu_ciphers_batch);
-      relu_ciphers_batch.clear();
+    // Process unknown values
+    send_relu_batches(tile_begin == element_count);
+    if (producer && cipher_bytes != 0) {
+      tile_size =
+          std::max(relu_tile_batches * relu_batch_count(), min_relu_tile_size);
     }
   }
-  if (!relu_ciphers_batch.empty()) {
-    process_unknown_relu_ciphers_batch(relu_ciphers_batch);
-    relu_ciphers_batch.clear();
-  }
 
   // Wait until all batches have been processed
-  std::unique_lock<std::mutex> mlock(m_relu_mutex);
-  m_relu_cond.wait(
-      mlock, [=]() { return m_relu_done_count == m_unknown_relu_idx.size(); });
-  m_relu_done_count = 0;
+  m_relu_flow_control.wait_until_done();
+  m_unknown_relu_idx.resize(unknown_count);
+
+  if (verbose && unknown_count > 0) {
+    auto stats = m_relu_flow_control.stats();
+    NGRAPH_HE_LOG(3) << "Relu sent " << stats.element_count
+                     << " ciphertexts in " << stats.batch_count << " batches ("
+                     << stats.bytes_sent / (1024 * 1024) << " MB) in "
+                     << stats.elapsed.count() / 1000 << " ms; server waited "
+                     << stats.wait_time.count() / 1000
+                     << " ms; client throughput "
+                     << stats.throughput / (1024 * 1024) << " MB/s";
+  }
 
   out->data() = m_relu_data;
 }
@@ -19,10 +19,14 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "boost/asio.hpp"
@@ -33,10 +37,15 @@
 #include "ngraph/util.hpp"
 #include "node_wrapper.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_ciphertext_pool.hpp"
+#include "seal/he_seal_memory_pools.hpp"
+#include "seal/he_seal_spill_store.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "tcp/tcp_flow_control.hpp"
 #include "tcp/tcp_message.hpp"
 #include "tcp/tcp_session.hpp"
+#include "tcp/tcp_transport.hpp"
 
 namespace ngraph::runtime::he {
 
@@ -80,14 +89,27 @@ class HESealExecutable : public runtime::Executable {
       const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs)
       override;
 
+  /// \brief Calls the executable once per inference the client requests over
+  /// the same session, until the client closes the connection. Requires the
+  /// client to be enabled
+  /// \param[in] server_inputs Input tensor arguments to the function, see
+  /// call()
+  /// \param[out] outputs Output tensors, see call()
+  /// \returns The number of inferences performed
+  size_t serve(
+      const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+      const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs);
+
   // TOOD
   std::vector<runtime::PerformanceCounter> get_performance_data()
       const override;
 
   // TODO(fboemer): merge _done() methods
 
-  /// \brief Returns whether or not the maxpool op has completed
-  bool max_pool_done() const { return m_max_pool_done; }
+  /// \brief Returns the statistics of the latest client-aided ReLU
+  TCPFlowControl::Stats relu_stats() const {
+    return m_relu_flow_control.stats();
+  }
 
   /// \brief Returns whether or not the session has started
   bool session_started() const { return m_session_started; }
@@ -96,8 +118,20 @@ class HESealExecutable : public runtime::Executable {
   /// the function
   bool client_inputs_received() const { return m_client_inputs_received; }
 
+  /// \brief Returns whether or not the client closed the session, so it
+  /// requests no more inferences
+  bool client_closed() const { return m_client_closed; }
+
   void accept_connection();
 
+  /// \brief Attaches a data connection to the session if its first message
+  /// carries the session token. Called on the I/O thread
+  /// \param[in] message First message on the connection
+  /// \param[in] session Session of the data connection
+  /// \returns Whether or not the connection was attached
+  bool add_data_session(const TCPMessage& message,
+                        const std::shared_ptr<TCPSession>& session);
+
   /// \brief Returns whether or not encryption parameters use complex packing
   bool complex_packing() const {
     return m_he_seal_backend.get_encryption_parameters().complex_packing();
@@ -146,14 +180,34 @@ class HESealExecutable : public runtime::Executable {
   /// \param[in] proto_msg from which to load the evluation key
   void load_eval_key(const pb::TCPMessage& proto_msg);
 
+  /// \brief Caches the client's keys if the message contains them, and
+  /// otherwise looks them up in the key cache, requesting them from the client
+  /// on a cache miss
+  /// \param[in] proto_msg Message with a key fingerprint
+  void handle_key_fingerprint(const pb::TCPMessage& proto_msg);
+
+  /// \brief Computes the elements [begin, end) of a tensor whose computation
+  /// has been deferred
+  using TileProducer = std::function<void(size_t begin, size_t end)>;
+
   /// \brief Processes the ReLU operation if the client is enabled
   /// \param[in] arg Tensor argumnet
   /// \param[out] out Tensor result
   /// \param[in] node_wrapper Wrapper around operation to perform
+  /// \param[in] producer If set, computes tiles of arg, which are sent to the
+  /// client as soon as they are computed
   // TODO(fboemer): rename
   void handle_server_relu_op(const std::shared_ptr<HETensor>& arg,
                              const std::shared_ptr<HETensor>& out,
-                             const NodeWrapper& node_wrapper);
+                             const NodeWrapper& node_wrapper,
+                             const TileProducer& producer = nullptr);
+
+  /// \brief Returns whether or not the node's output can be computed in
+  /// tiles, which are streamed into a client-aided ReLU as they finish.
+  /// This holds for Convolution and Add nodes whose only user is a
+  /// client-aided ReLU, or another such node
+  /// \param[in] node Node to check
+  bool is_tiled_relu_producer(const Node& node) const;
 
   /// \brief Processes the MaxPool operation if the client is enabled
   /// \param[in] arg Tensor argumnet
@@ -188,6 +242,29 @@ class HESealExecutable : public runtime::Executable {
   /// \brief Sets verbosity of all operations
   void set_verbose_all_ops(bool value);
 
+  /// \brief Sets whether ops on unpacked plaintexts are computed on dense
+  /// buffers rather than per HEType, when the client is disabled. Enabled
+  /// unless NGRAPH_HE_DENSE_PLAINTEXT is false
+  void set_dense_plaintext(bool value) { m_dense_plaintext = value; }
+
+  /// \brief Returns statistics of the pool from which intermediate
+  /// ciphertexts are taken, and to which dead tensors return them
+  HESealCiphertextPool::Stats ciphertext_pool_stats() const {
+    return m_ciphertext_pool.stats();
+  }
+
+  /// \brief Returns the memory held by the pools for SEAL temporaries after
+  /// each op, keyed by op name
+  std::unordered_map<std::string, HESealMemoryPools::Usage> get_memory_usage()
+      const;
+
+  /// \brief Returns statistics of the intermediate tensors spilled to disk to
+  /// stay within the backend's spill_bytes budget
+  HESealSpillStore::Stats spill_stats() const {
+    return m_spill_store == nullptr ? HESealSpillStore::Stats{}
+                                    : m_spill_store->stats();
+  }
+
  private:
   friend class TestHESealExecutable;
 
@@ -202,15 +279,26 @@ class HESealExecutable : public runtime::Executable {
 
   bool m_server_setup{false};
   size_t m_batch_size;
-  size_t m_port;  // Which port the server is hosted at
+  TransportAddress m_server_address;  // Where the server is hosted
 
   std::unordered_map<std::shared_ptr<const Node>, stopwatch> m_timer_map;
+  std::unordered_map<std::shared_ptr<const Node>, HESealMemoryPools::Usage>
+      m_memory_usage_map;
   std::vector<NodeWrapper> m_wrapped_nodes;
 
-  std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+  std::unique_ptr<TransportAcceptor> m_acceptor;
 
   // Must be shared, since TCPSession uses enable_shared_from_this()
   std::shared_ptr<TCPSession> m_session;
+  // Additional connections from the client, across which input and result
+  // tensors are striped. Guarded by m_session_mutex
+  std::vector<std::shared_ptr<TCPSession>> m_data_sessions;
+  // Data connections accepted, but which haven't sent the session token yet.
+  // Guarded by m_session_mutex
+  size_t m_pending_data_sessions{0};
+  // Random token each data connection must send first. Generated once the
+  // server starts, and sent to the client with the encryption parameters
+  std::string m_session_token;
   std::thread m_message_handling_thread;
   boost::asio::io_context m_io_context;
 
@@ -222,24 +310,38 @@ class HESealExecutable : public runtime::Executable {
   std::vector<HEType> m_relu_data;
   std::vector<HEType> m_max_pool_data;
 
+  // Ciphertexts of dead intermediate tensors, reused across ops and calls
+  HESealCiphertextPool m_ciphertext_pool;
+
+  // Ciphertexts of intermediate tensors spilled to disk. Created on the first
+  // call with a spill budget
+  std::unique_ptr<HESealSpillStore> m_spill_store;
+
+  // Number of ops ahead of the current one whose spilled inputs are
+  // prefetched. Tensors used within this distance are not spilled
+  static constexpr size_t spill_prefetch_distance = 2;
+
   std::set<std::string> m_verbose_ops;
 
   std::shared_ptr<seal::SEALContext> m_context;
 
-  // To trigger when relu is done
-  std::mutex m_relu_mutex;
-  std::condition_variable m_relu_cond;
-  size_t m_relu_done_count{0};
+  // Relu requests in flight to the client, keyed by their offset into
+  // m_unknown_relu_idx
+  TCPFlowControl m_relu_flow_control;
   std::vector<size_t> m_unknown_relu_idx;
 
-  // To trigger when max_pool is done
-  std::mutex m_max_pool_mutex;
-  std::condition_variable m_max_pool_cond;
-  bool m_max_pool_done{false};
+  // Max pool requests in flight to the client, keyed by the index of their
+  // first window
+  TCPFlowControl m_max_pool_flow_control;
 
-  // To trigger when result message has been written
-  std::mutex m_result_mutex;
-  std::condition_variable m_result_cond;
+  // Maximum number of relu or max pool batches serialized in parallel before
+  // the flow control window is checked again
+  static constexpr size_t max_planned_batches = 16;
+
+  // Number of relu batches computed per tile of a tiled producer, and minimum
+  // number of elements per tile
+  static constexpr size_t relu_tile_batches = 4;
+  static constexpr size_t min_relu_tile_size = 64;
 
   // To trigger when session has started
   std::mutex m_session_mutex;
@@ -250,12 +352,53 @@ class HESealExecutable : public runtime::Executable {
   std::mutex m_client_inputs_mutex;
   std::condition_variable m_client_inputs_cond;
   bool m_client_inputs_received{false};
+  bool m_client_closed{false};
 
   void generate_calls(const element::Type& type,
                       const NodeWrapper& node_wrapper,
                       const std::vector<std::shared_ptr<HETensor>>& out,
                       const std::vector<std::shared_ptr<HETensor>>& args);
 
+  /// \brief Computes the output elements [begin, end) of an op for which
+  /// is_tiled_relu_producer holds
+  void generate_tile(const element::Type& type, const NodeWrapper& node_wrapper,
+                     const std::vector<std::shared_ptr<HETensor>>& out,
+                     const std::vector<std::shared_ptr<HETensor>>& args,
+                     size_t begin, size_t end);
+
+  /// \brief Values of unpacked plaintext tensors, one per element
+  using DenseTensorMap =
+      std::unordered_map<const descriptor::Tensor*, std::vector<double>>;
+
+  /// \brief Computes an op on dense plaintext values, if the op is supported
+  /// and none of its arguments or outputs is encrypted or packed. Arguments
+  /// missing from dense_values are read from tensor_map, and outputs present
+  /// in tensor_map, i.e. function outputs, are written back
+  /// \returns false if the op must be computed on HETensors instead
+  bool generate_dense_calls(
+      const NodeWrapper& node_wrapper,
+      const std::unordered_map<descriptor::Tensor*, std::shared_ptr<HETensor>>&
+          tensor_map,
+      DenseTensorMap& dense_values);
+
+  /// \brief Finds the ops computed only from Constant ops, i.e. Constant ops
+  /// and data movement ops on their outputs, and their outputs used by other
+  /// ops
+  void find_constant_ops();
+
+  // Constant ops run on the first call only. Their outputs used by other ops
+  // are kept, as HETensors and/or dense values, and shared by later calls
+  std::unordered_set<const Node*> m_constant_ops;
+  std::unordered_set<const descriptor::Tensor*> m_constant_outputs;
+  std::unordered_map<descriptor::Tensor*, std::shared_ptr<HETensor>>
+      m_constant_tensors;
+  DenseTensorMap m_constant_dense_values;
+  bool m_constants_materialized{false};
+
   bool m_stop_const_fold{flag_to_bool(std::getenv("STOP_CONST_FOLD"))};
+  bool m_pipeline_tiles{
+      flag_to_bool(std::getenv("NGRAPH_HE_PIPELINE_TILES"))};
+  bool m_dense_plaintext{
+      flag_to_bool(std::getenv("NGRAPH_HE_DENSE_PLAINTEXT"), true)};
 };
 }  // namespace ngraph::runtime::he
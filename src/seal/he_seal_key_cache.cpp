@@ -0,0 +1,182 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#include "seal/he_seal_key_cache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/log.hpp"
+#include "seal/seal.h"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+HESealKeyCache::HESealKeyCache(size_t max_bytes, std::string spill_directory)
+    : m_max_bytes(max_bytes) {
+  set_spill_directory(spill_directory);
+}
+
+void HESealKeyCache::set_max_bytes(size_t max_bytes) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_max_bytes = max_bytes;
+  evict();
+}
+
+void HESealKeyCache::set_spill_directory(const std::string& spill_directory) {
+  if (!spill_directory.empty()) {
+    std::filesystem::create_directories(spill_directory);
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_spill_directory = spill_directory;
+}
+
+std::string HESealKeyCache::entry_id(
+    const std::string& fingerprint,
+    const std::shared_ptr<seal::SEALContext>& context) const {
+  // The fingerprint names a file, so reject anything else
+  NGRAPH_CHECK(is_key_fingerprint(fingerprint), "Invalid key fingerprint ",
+               fingerprint);
+  return hash_to_string(context->key_parms_id()) + "-" + fingerprint;
+}
+
+std::string HESealKeyCache::spill_path(const std::string& id) const {
+  return (std::filesystem::path(m_spill_directory) / (id + ".keys")).string();
+}
+
+std::optional<HESealKeyCache::Keys> HESealKeyCache::find(
+    const std::string& fingerprint,
+    const std::shared_ptr<seal::SEALContext>& context) {
+  std::string id = entry_id(fingerprint, context);
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_index.find(id);
+    if (it != m_index.end()) {
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      NGRAPH_HE_LOG(3) << "Key cache hit for " << fingerprint;
+      return it->second->keys;
+    }
+    if (m_spill_directory.empty()) {
+      return std::nullopt;
+    }
+    path = spill_path(id);
+  }
+
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    return std::nullopt;
+  }
+  Keys keys;
+  try {
+    bool has_relin_keys = false;
+    stream.read(reinterpret_cast<char*>(&has_relin_keys),
+                sizeof(has_relin_keys));
+    keys.public_key = std::make_shared<seal::PublicKey>();
+    keys.public_key->load(context, stream);
+    if (has_relin_keys) {
+      keys.relin_keys = std::make_shared<seal::RelinKeys>();
+      keys.relin_keys->load(context, stream);
+    }
+  } catch (const std::exception& e) {
+    NGRAPH_WARN << "Error loading cached keys from " << path << ": "
+                << e.what();
+    return std::nullopt;
+  }
+  NGRAPH_HE_LOG(3) << "Key cache loaded " << fingerprint << " from disk";
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  insert_in_memory(id, keys, std::filesystem::file_size(path));
+  return keys;
+}
+
+void HESealKeyCache::insert(const std::string& fingerprint,
+                            const std::shared_ptr<seal::SEALContext>& context,
+                            Keys keys, size_t byte_count) {
+  NGRAPH_CHECK(keys.public_key != nullptr, "Cached keys need a public key");
+  std::string id = entry_id(fingerprint, context);
+
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    insert_in_memory(id, keys, byte_count);
+    if (m_spill_directory.empty()) {
+      return;
+    }
+    path = spill_path(id);
+  }
+
+  // Write to a temporary file first, so concurrent readers never see a
+  // partial file
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream stream(tmp_path, std::ios::binary | std::ios::trunc);
+    NGRAPH_CHECK(stream.good(), "Error writing cached keys to ", tmp_path);
+    bool has_relin_keys = keys.relin_keys != nullptr;
+    stream.write(reinterpret_cast<const char*>(&has_relin_keys),
+                 sizeof(has_relin_keys));
+    keys.public_key->save(stream);
+    if (has_relin_keys) {
+      keys.relin_keys->save(stream);
+    }
+  }
+  std::filesystem::rename(tmp_path, path);
+  NGRAPH_HE_LOG(3) << "Key cache wrote " << fingerprint << " to " << path;
+}
+
+void HESealKeyCache::insert_in_memory(const std::string& id, Keys keys,
+                                      size_t byte_count) {
+  auto it = m_index.find(id);
+  if (it != m_index.end()) {
+    m_byte_count -= it->second->byte_count;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+  m_entries.push_front(Entry{id, std::move(keys), byte_count});
+  m_index[id] = m_entries.begin();
+  m_byte_count += byte_count;
+  evict();
+}
+
+void HESealKeyCache::evict() {
+  // Keep the most recent entry, even if it exceeds the bound on its own
+  while (m_byte_count > m_max_bytes && m_entries.size() > 1) {
+    const Entry& entry = m_entries.back();
+    NGRAPH_HE_LOG(3) << "Key cache evicting " << entry.id;
+    m_byte_count -= entry.byte_count;
+    m_index.erase(entry.id);
+    m_entries.pop_back();
+  }
+}
+
+size_t HESealKeyCache::size() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_entries.size();
+}
+
+size_t HESealKeyCache::byte_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_byte_count;
+}
+
+}  // namespace ngraph::runtime::he
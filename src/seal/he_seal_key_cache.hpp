@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+/// \brief Server-side LRU cache of client keys, so a returning client skips
+/// key generation and the key upload.
+///
+/// Entries are keyed by the key fingerprint and the parameter hash, and store
+/// the loaded keys, so they are not parsed again. The cache is bounded by the
+/// serialized size of the keys. If a spill directory is set, keys are also
+/// written to disk on insertion, and loaded from disk when missing in memory,
+/// for instance after eviction or a server restart.
+class HESealKeyCache {
+ public:
+  /// \brief Keys of one client
+  struct Keys {
+    std::shared_ptr<seal::PublicKey> public_key;
+    /// \brief Null if the encryption parameters do not use key switching
+    std::shared_ptr<seal::RelinKeys> relin_keys;
+  };
+
+  /// \brief Default memory bound in bytes
+  static constexpr size_t default_max_bytes = 1024UL * 1024 * 1024;
+
+  /// \brief Constructs an empty cache
+  /// \param[in] max_bytes Maximum total size of the cached keys in memory
+  /// \param[in] spill_directory Directory to persist keys in. Empty to keep
+  /// keys in memory only
+  explicit HESealKeyCache(size_t max_bytes = default_max_bytes,
+                          std::string spill_directory = "");
+
+  /// \brief Sets the memory bound, evicting entries as needed
+  /// \param[in] max_bytes Maximum total size of the cached keys in memory
+  void set_max_bytes(size_t max_bytes);
+
+  /// \brief Sets the directory to persist keys in
+  /// \param[in] spill_directory Directory, created if needed. Empty to keep
+  /// keys in memory only
+  void set_spill_directory(const std::string& spill_directory);
+
+  /// \brief Looks up keys, first in memory, then on disk
+  /// \param[in] fingerprint Key fingerprint, see key_fingerprint()
+  /// \param[in] context SEAL context the keys belong to
+  /// \returns Cached keys, or nullopt if they are not cached
+  std::optional<Keys> find(const std::string& fingerprint,
+                           const std::shared_ptr<seal::SEALContext>& context);
+
+  /// \brief Inserts keys as the most recently used entry
+  /// \param[in] fingerprint Key fingerprint, see key_fingerprint()
+  /// \param[in] context SEAL context the keys belong to
+  /// \param[in] keys Loaded keys
+  /// \param[in] byte_count Serialized size of the keys
+  void insert(const std::string& fingerprint,
+              const std::shared_ptr<seal::SEALContext>& context, Keys keys,
+              size_t byte_count);
+
+  /// \brief Returns the number of entries in memory
+  size_t size() const;
+
+  /// \brief Returns the total size of the entries in memory in bytes
+  size_t byte_count() const;
+
+ private:
+  struct Entry {
+    std::string id;
+    Keys keys;
+    size_t byte_count;
+  };
+
+  std::string entry_id(const std::string& fingerprint,
+                       const std::shared_ptr<seal::SEALContext>& context) const;
+
+  std::string spill_path(const std::string& id) const;
+
+  void insert_in_memory(const std::string& id, Keys keys, size_t byte_count);
+
+  void evict();
+
+  mutable std::mutex m_mutex;
+  size_t m_max_bytes;
+  std::string m_spill_directory;
+  size_t m_byte_count{0};
+
+  // Most recently used entry first
+  std::list<Entry> m_entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+};
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_memory_pools.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+namespace {
+std::atomic<uint64_t> next_pools_id{0};
+}  // namespace
+
+HESealMemoryPools::HESealMemoryPools(size_t max_bytes)
+    : m_id(next_pools_id++), m_max_bytes(max_bytes) {}
+
+const seal::MemoryPoolHandle& HESealMemoryPools::local() const {
+  // Instance ids are never reused, so entries of destroyed instances are
+  // never looked up again
+  thread_local std::unordered_map<uint64_t, const seal::MemoryPoolHandle*>
+      cache;
+  auto it = cache.find(m_id);
+  if (it != cache.end()) {
+    return *it->second;
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto& pool = m_pools[std::this_thread::get_id()];
+  if (!pool) {
+    pool = seal::MemoryPoolHandle::New();
+  }
+  cache.emplace(m_id, &pool);
+  return pool;
+}
+
+size_t HESealMemoryPools::alloc_byte_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return alloc_byte_count_locked();
+}
+
+size_t HESealMemoryPools::alloc_byte_count_locked() const {
+  size_t byte_count = 0;
+  for (const auto& [thread_id, pool] : m_pools) {
+    byte_count += pool.alloc_byte_count();
+  }
+  for (const auto& pool : m_retired_pools) {
+    byte_count += pool.alloc_byte_count();
+  }
+  return byte_count;
+}
+
+HESealMemoryPools::Usage HESealMemoryPools::trim() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  // Pools no longer referenced by any object are freed with their last handle
+  m_retired_pools.erase(
+      std::remove_if(m_retired_pools.begin(), m_retired_pools.end(),
+                     [](const seal::MemoryPoolHandle& pool) {
+                       return pool.use_count() == 1;
+                     }),
+      m_retired_pools.end());
+
+  Usage usage;
+  usage.peak_bytes = alloc_byte_count_locked();
+  usage.current_bytes = usage.peak_bytes;
+  if (usage.peak_bytes > m_max_bytes) {
+    for (auto& [thread_id, pool] : m_pools) {
+      if (pool.use_count() > 1) {
+        m_retired_pools.emplace_back(pool);
+      }
+      pool = seal::MemoryPoolHandle::New();
+    }
+    usage.current_bytes = alloc_byte_count_locked();
+  }
+  return usage;
+}
+}  // namespace ngraph::runtime::he
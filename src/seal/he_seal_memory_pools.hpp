@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+/// \brief SEAL memory pools for temporary allocations, one per thread.
+///
+/// SEAL's global memory pool is guarded by a single mutex, which kernels
+/// running under OpenMP contend on. Each thread instead allocates
+/// temporaries from its own pool, whether it is an OpenMP thread, a message
+/// worker or any other thread. SEAL pools retain freed memory for reuse, so
+/// pools are optionally freed between ops once they exceed a byte limit.
+class HESealMemoryPools {
+ public:
+  /// \brief Memory usage of the pools
+  struct Usage {
+    /// \brief Bytes allocated by the pools after trimming, including freed
+    /// pools still referenced by live objects
+    size_t current_bytes{0};
+    /// \brief Maximum number of bytes allocated by the pools
+    size_t peak_bytes{0};
+  };
+
+  /// \brief Constructs an empty set of pools. Each thread's pool is created
+  /// on its first call to local()
+  /// \param[in] max_bytes Number of bytes above which trim() frees the pools
+  explicit HESealMemoryPools(
+      size_t max_bytes = std::numeric_limits<size_t>::max());
+
+  /// \brief Returns the pool of the calling thread. Only the first call from
+  /// each thread takes a lock
+  const seal::MemoryPoolHandle& local() const;
+
+  /// \brief Returns the number of bytes allocated by the pools, including
+  /// freed pools still referenced by live objects
+  size_t alloc_byte_count() const;
+
+  /// \brief Returns the number of bytes above which trim() frees the pools
+  size_t max_bytes() const { return m_max_bytes; }
+
+  /// \brief Sets the number of bytes above which trim() frees the pools
+  void set_max_bytes(size_t max_bytes) { m_max_bytes = max_bytes; }
+
+  /// \brief Frees the pools if they allocated more than max_bytes(). Must only
+  /// be called while no temporaries from the pools are alive, such as between
+  /// ops, and not while other threads use their pools. Pools still
+  /// referenced by objects allocated from them, such as ciphertexts, are
+  /// replaced but retained until those objects are destroyed
+  /// \returns The usage before and after trimming
+  Usage trim();
+
+ private:
+  size_t alloc_byte_count_locked() const;
+
+  // Distinguishes instances in the per-thread caches of local()
+  uint64_t m_id;
+  size_t m_max_bytes;
+  mutable std::mutex m_mutex;
+  // Entries are never erased, so local() can cache references to them
+  mutable std::unordered_map<std::thread::id, seal::MemoryPoolHandle> m_pools;
+  std::vector<seal::MemoryPoolHandle> m_retired_pools;
+};
+}  // namespace ngraph::runtime::he
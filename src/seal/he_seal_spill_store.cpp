@@ -0,0 +1,247 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#include "seal/he_seal_spill_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+// Numbers spill files uniquely across stores in this process
+std::atomic<size_t> spill_file_count{0};
+
+size_t byte_count(const seal::Ciphertext& cipher) {
+  return cipher.uint64_count() * sizeof(std::uint64_t);
+}
+
+// Shared mapping of a whole spill file, unmapped on destruction
+class SpillFileMapping {
+ public:
+  SpillFileMapping(const std::string& path, size_t size, bool writable)
+      : m_size(size) {
+    int flags = writable ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY;
+    m_fd = ::open(path.c_str(), flags | O_CLOEXEC, 0600);
+    NGRAPH_CHECK(m_fd >= 0, "Error opening spill file ", path, ": ",
+                 std::strerror(errno));
+    if (writable) {
+      // Allocate up front, so a full file system fails here rather than
+      // raising SIGBUS on a later write to the mapping
+      int error = posix_fallocate(m_fd, 0, static_cast<off_t>(size));
+      if (error != 0) {
+        ::close(m_fd);
+        ::unlink(path.c_str());
+        NGRAPH_CHECK(false, "Error allocating ", size,
+                     " bytes for spill file ", path, ": ",
+                     std::strerror(error));
+      }
+    }
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* mapping = mmap(nullptr, size, protection, MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED) {
+      int error = errno;
+      ::close(m_fd);
+      if (writable) {
+        ::unlink(path.c_str());
+      }
+      NGRAPH_CHECK(false, "Error mapping spill file ", path, ": ",
+                   std::strerror(error));
+    }
+    m_data = static_cast<std::byte*>(mapping);
+  }
+
+  ~SpillFileMapping() {
+    munmap(m_data, m_size);
+    ::close(m_fd);
+  }
+
+  SpillFileMapping(const SpillFileMapping&) = delete;
+  SpillFileMapping& operator=(const SpillFileMapping&) = delete;
+
+  std::byte* data() const { return m_data; }
+
+ private:
+  size_t m_size;
+  int m_fd;
+  std::byte* m_data{nullptr};
+};
+}  // namespace
+
+HESealSpillStore::HESealSpillStore(std::shared_ptr<seal::SEALContext> context,
+                                   const std::string& directory)
+    : m_context(std::move(context)), m_directory(directory) {
+  std::filesystem::create_directories(m_directory);
+}
+
+HESealSpillStore::~HESealSpillStore() { clear(); }
+
+size_t HESealSpillStore::resident_bytes(HETensor& tensor) {
+  size_t bytes = 0;
+  for (const auto& he_type : tensor.data()) {
+    if (he_type.is_ciphertext() && he_type.get_ciphertext() != nullptr) {
+      bytes += byte_count(he_type.get_ciphertext()->ciphertext());
+    }
+  }
+  return bytes;
+}
+
+size_t HESealSpillStore::spill(HETensor& tensor) {
+  NGRAPH_CHECK(!is_spilled(tensor), "Tensor ", tensor.get_name(),
+               " is already spilled");
+  auto& data = tensor.data();
+
+  Entry entry;
+  entry.file_size = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    const auto& cipher = data[i].get_ciphertext();
+    if (data[i].is_ciphertext() && cipher != nullptr &&
+        cipher.use_count() == 1) {
+      size_t size = ciphertext_size(cipher->ciphertext());
+      entry.records.push_back({i, entry.file_size, size});
+      entry.file_size += size;
+    }
+  }
+  if (entry.records.empty()) {
+    return 0;
+  }
+  entry.path = (std::filesystem::path(m_directory) /
+                ("he_spill_" + std::to_string(getpid()) + "_" +
+                 std::to_string(spill_file_count++) + ".ct"))
+                   .string();
+
+  {
+    SpillFileMapping mapping(entry.path, entry.file_size, true);
+#pragma omp parallel for
+    for (size_t i = 0; i < entry.records.size(); ++i) {
+      Record& record = entry.records[i];
+      record.size = save(data[record.element].get_ciphertext()->ciphertext(),
+                         mapping.data() + record.offset);
+    }
+  }
+
+  size_t freed_bytes = 0;
+  for (const Record& record : entry.records) {
+    auto& cipher = data[record.element].get_ciphertext();
+    freed_bytes += byte_count(cipher->ciphertext());
+    cipher = nullptr;
+  }
+  ++m_stats.spilled;
+  m_stats.bytes += entry.file_size;
+  NGRAPH_HE_LOG(5) << "Spilled " << entry.records.size()
+                   << " ciphertexts of " << tensor.get_name() << " to "
+                   << entry.path;
+  m_entries.emplace(&tensor, std::move(entry));
+  return freed_bytes;
+}
+
+void HESealSpillStore::load_entry(
+    HETensor& tensor, const Entry& entry,
+    const std::shared_ptr<seal::SEALContext>& context, bool parallel) {
+  SpillFileMapping mapping(entry.path, entry.file_size, false);
+  madvise(mapping.data(), entry.file_size, MADV_SEQUENTIAL);
+#pragma omp parallel for if (parallel)
+  for (size_t i = 0; i < entry.records.size(); ++i) {
+    const Record& record = entry.records[i];
+    auto cipher = std::make_shared<SealCiphertextWrapper>();
+    load(cipher->ciphertext(), context, mapping.data() + record.offset,
+         record.size);
+    tensor.data(record.element).set_ciphertext(cipher);
+  }
+}
+
+void HESealSpillStore::prefetch(const std::shared_ptr<HETensor>& tensor) {
+  auto it = m_entries.find(tensor.get());
+  if (it == m_entries.end() || it->second.prefetch.valid()) {
+    return;
+  }
+  // Load sequentially, leaving the OpenMP threads to the running op
+  it->second.prefetch =
+      std::async(std::launch::async,
+                 [tensor, &entry = it->second, context = m_context]() {
+                   load_entry(*tensor, entry, context, false);
+                 });
+}
+
+void HESealSpillStore::restore(HETensor& tensor) {
+  auto it = m_entries.find(&tensor);
+  if (it == m_entries.end()) {
+    return;
+  }
+  Entry& entry = it->second;
+  if (entry.prefetch.valid()) {
+    entry.prefetch.get();
+    ++m_stats.prefetched;
+  } else {
+    load_entry(tensor, entry, m_context, true);
+    ++m_stats.restored;
+  }
+  NGRAPH_HE_LOG(5) << "Restored " << entry.records.size()
+                   << " ciphertexts of " << tensor.get_name();
+  remove(it);
+}
+
+void HESealSpillStore::discard(HETensor& tensor) {
+  auto it = m_entries.find(&tensor);
+  if (it == m_entries.end()) {
+    return;
+  }
+  if (it->second.prefetch.valid()) {
+    it->second.prefetch.wait();
+  }
+  ++m_stats.discarded;
+  remove(it);
+}
+
+void HESealSpillStore::clear() {
+  while (!m_entries.empty()) {
+    auto it = m_entries.begin();
+    if (it->second.prefetch.valid()) {
+      it->second.prefetch.wait();
+    }
+    ++m_stats.discarded;
+    remove(it);
+  }
+}
+
+void HESealSpillStore::remove(
+    std::unordered_map<const HETensor*, Entry>::iterator it) {
+  std::error_code error;
+  std::filesystem::remove(it->second.path, error);
+  if (error) {
+    NGRAPH_HE_LOG(1) << "Error removing spill file " << it->second.path
+                     << ": " << error.message();
+  }
+  m_entries.erase(it);
+}
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,137 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "he_tensor.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+/// \brief Store for the ciphertexts of tensors evicted to disk.
+///
+/// Spilling a tensor saves its ciphertexts, uncompressed, to a file in the
+/// spill directory and frees them, leaving the tensor's plaintexts and layout
+/// in memory. The file is memory-mapped in both directions, so ciphertexts
+/// are saved and loaded without staging buffers. A tensor is loaded back
+/// either synchronously, or in the background by a prefetch ahead of the op
+/// consuming it. The store is not thread-safe: all calls must come from the
+/// thread running the ops.
+class HESealSpillStore {
+ public:
+  /// \brief Spill statistics
+  struct Stats {
+    /// \brief Number of tensors spilled to disk
+    size_t spilled{0};
+    /// \brief Number of spilled tensors loaded back by a prefetch
+    size_t prefetched{0};
+    /// \brief Number of spilled tensors loaded back on demand
+    size_t restored{0};
+    /// \brief Number of spilled tensors dropped without being loaded back
+    size_t discarded{0};
+    /// \brief Total size in bytes of the ciphertexts written to disk
+    size_t bytes{0};
+  };
+
+  /// \brief Constructs an empty store
+  /// \param[in] context SEAL context to validate loaded ciphertexts against
+  /// \param[in] directory Directory for spill files, created if needed
+  HESealSpillStore(std::shared_ptr<seal::SEALContext> context,
+                   const std::string& directory);
+
+  /// \brief Waits for prefetches in flight and removes all spill files
+  ~HESealSpillStore();
+
+  HESealSpillStore(const HESealSpillStore&) = delete;
+  HESealSpillStore& operator=(const HESealSpillStore&) = delete;
+
+  /// \brief Returns the size in bytes of the ciphertexts a tensor holds in
+  /// memory
+  /// \param[in] tensor Tensor to measure
+  static size_t resident_bytes(HETensor& tensor);
+
+  /// \brief Writes the tensor's ciphertexts to disk and frees them.
+  /// Ciphertexts shared with other tensors stay in memory, since spilling
+  /// them frees nothing
+  /// \param[in,out] tensor Tensor to spill, which must not be spilled
+  /// \returns The number of bytes freed
+  size_t spill(HETensor& tensor);
+
+  /// \brief Starts loading a spilled tensor back in the background. Does
+  /// nothing if the tensor is not spilled, or already being prefetched
+  /// \param[in,out] tensor Tensor to prefetch, kept alive until the prefetch
+  /// is restored or discarded
+  void prefetch(const std::shared_ptr<HETensor>& tensor);
+
+  /// \brief Loads a spilled tensor back, waiting for its prefetch if one is
+  /// in flight, and removes its file. Does nothing if the tensor is not
+  /// spilled
+  /// \param[in,out] tensor Tensor to restore
+  void restore(HETensor& tensor);
+
+  /// \brief Removes the file of a spilled tensor without loading it back,
+  /// for instance once the tensor is dead. Does nothing if the tensor is not
+  /// spilled
+  /// \param[in,out] tensor Tensor to discard
+  void discard(HETensor& tensor);
+
+  /// \brief Discards all spilled tensors
+  void clear();
+
+  /// \brief Returns whether or not the tensor has ciphertexts on disk
+  /// \param[in] tensor Tensor to check
+  bool is_spilled(const HETensor& tensor) const {
+    return m_entries.find(&tensor) != m_entries.end();
+  }
+
+  /// \brief Returns the spill statistics
+  const Stats& stats() const { return m_stats; }
+
+ private:
+  // Location of one saved ciphertext
+  struct Record {
+    size_t element;
+    size_t offset;
+    size_t size;
+  };
+
+  struct Entry {
+    std::string path;
+    size_t file_size;
+    std::vector<Record> records;
+    // Valid once a prefetch has started
+    std::future<void> prefetch;
+  };
+
+  static void load_entry(HETensor& tensor, const Entry& entry,
+                         const std::shared_ptr<seal::SEALContext>& context,
+                         bool parallel);
+
+  void remove(std::unordered_map<const HETensor*, Entry>::iterator it);
+
+  std::shared_ptr<seal::SEALContext> m_context;
+  std::string m_directory;
+  std::unordered_map<const HETensor*, Entry> m_entries;
+  Stats m_stats;
+};
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,162 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_zero_pool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+HESealZeroPool::HESealZeroPool(std::shared_ptr<seal::SEALContext> context,
+                               std::shared_ptr<seal::Encryptor> encryptor,
+                               std::vector<seal::parms_id_type> parms_ids,
+                               size_t capacity, size_t refill_thread_count)
+    : m_context(std::move(context)),
+      m_encryptor(std::move(encryptor)),
+      m_evaluator(m_context),
+      m_capacity(capacity) {
+  for (const auto& parms_id : parms_ids) {
+    NGRAPH_CHECK(m_context->get_context_data(parms_id) != nullptr,
+                 "Invalid parms_id for zero pool");
+    m_levels.emplace_back(Level{parms_id, {}});
+  }
+  if (m_capacity == 0 || m_levels.empty()) {
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Starting " << refill_thread_count
+                   << " zero pool refill threads";
+  for (size_t i = 0; i < refill_thread_count; ++i) {
+    m_refill_threads.emplace_back([this]() { refill(); });
+  }
+}
+
+HESealZeroPool::~HESealZeroPool() {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stop = true;
+  }
+  m_refill_cond.notify_all();
+  for (auto& thread : m_refill_threads) {
+    thread.join();
+  }
+}
+
+HESealZeroPool::Pause::Pause(HESealZeroPool& pool) : m_pool(pool) {
+  std::lock_guard<std::mutex> guard(m_pool.m_mutex);
+  ++m_pool.m_pauses;
+}
+
+HESealZeroPool::Pause::~Pause() {
+  {
+    std::lock_guard<std::mutex> guard(m_pool.m_mutex);
+    if (--m_pool.m_pauses != 0) {
+      return;
+    }
+  }
+  m_pool.m_refill_cond.notify_all();
+}
+
+HESealZeroPool::Level* HESealZeroPool::next_level_to_refill() {
+  // Refill the emptiest level first
+  Level* next = nullptr;
+  for (auto& level : m_levels) {
+    if (level.zeros.size() < m_capacity &&
+        (next == nullptr || level.zeros.size() < next->zeros.size())) {
+      next = &level;
+    }
+  }
+  return next;
+}
+
+void HESealZeroPool::refill() {
+  while (true) {
+    seal::parms_id_type parms_id;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_refill_cond.wait(lock, [this]() {
+        return m_stop ||
+               (m_pauses == 0 && next_level_to_refill() != nullptr);
+      });
+      if (m_stop) {
+        return;
+      }
+      parms_id = next_level_to_refill()->parms_id;
+    }
+
+    seal::Ciphertext zero;
+    m_encryptor->encrypt_zero(parms_id, zero);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto& level : m_levels) {
+      // Several threads may refill the last free entry of a level
+      if (level.parms_id == parms_id && level.zeros.size() < m_capacity) {
+        level.zeros.emplace_back(std::move(zero));
+        break;
+      }
+    }
+  }
+}
+
+void HESealZeroPool::encrypt(const seal::Plaintext& plain,
+                             seal::Ciphertext& destination) {
+  bool hit = false;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto& level : m_levels) {
+      if (level.parms_id == plain.parms_id() && !level.zeros.empty()) {
+        destination = std::move(level.zeros.front());
+        level.zeros.pop_front();
+        hit = true;
+        break;
+      }
+    }
+  }
+
+  if (!hit) {
+    ++m_misses;
+    m_encryptor->encrypt(plain, destination);
+    return;
+  }
+  ++m_hits;
+  m_refill_cond.notify_one();
+
+  // An encryption of zero has no meaningful scale, so adopt the plaintext's
+  destination.scale() = plain.scale();
+  m_evaluator.add_plain_inplace(destination, plain);
+}
+
+HESealZeroPool::Stats HESealZeroPool::stats() const {
+  Stats stats;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (const auto& level : m_levels) {
+      stats.size += level.zeros.size();
+    }
+  }
+  stats.capacity = m_capacity;
+  stats.refill_threads = m_refill_threads.size();
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  return stats;
+}
+
+}  // namespace ngraph::runtime::he
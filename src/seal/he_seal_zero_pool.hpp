@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+/// \brief Pool of precomputed public-key encryptions of zero.
+///
+/// Public-key encryption samples noise and performs NTTs for each ciphertext.
+/// Refill threads precompute encryptions of zero in the background, so
+/// encrypting a plaintext online reduces to a polynomial addition. When the
+/// pool for a level is empty, encryption falls back to the encryptor.
+/// Refilling pauses while a Pause is in scope, so it only uses idle cores.
+///
+/// Each encryption of zero is used at most once.
+class HESealZeroPool {
+ public:
+  /// \brief Pool statistics
+  struct Stats {
+    /// \brief Number of encryptions of zero in the pool
+    size_t size{0};
+    /// \brief Maximum number of encryptions of zero per level
+    size_t capacity{0};
+    /// \brief Number of refill threads
+    size_t refill_threads{0};
+    /// \brief Number of encryptions which used the pool
+    size_t hits{0};
+    /// \brief Number of encryptions which fell back to the encryptor
+    size_t misses{0};
+
+    /// \brief Returns the fraction of encryptions which used the pool
+    double hit_rate() const {
+      size_t total = hits + misses;
+      return total == 0 ? 0.
+                        : static_cast<double>(hits) / static_cast<double>(total);
+    }
+  };
+
+  /// \brief Pauses refilling while in scope, so the refill threads don't
+  /// compete for cores with online work. Refill threads finish the encryption
+  /// of zero in progress. Scopes may overlap, and refilling resumes when the
+  /// last one exits
+  class Pause {
+   public:
+    explicit Pause(HESealZeroPool& pool);
+    ~Pause();
+    Pause(const Pause&) = delete;
+    Pause& operator=(const Pause&) = delete;
+
+   private:
+    HESealZeroPool& m_pool;
+  };
+
+  /// \brief Constructs a pool and starts the refill threads
+  /// \param[in] context SEAL context
+  /// \param[in] encryptor Encryptor with the public key
+  /// \param[in] parms_ids Levels at which to precompute encryptions of zero
+  /// \param[in] capacity Maximum number of encryptions of zero per level. Zero
+  /// disables precomputation
+  /// \param[in] refill_thread_count Number of refill threads
+  HESealZeroPool(std::shared_ptr<seal::SEALContext> context,
+                 std::shared_ptr<seal::Encryptor> encryptor,
+                 std::vector<seal::parms_id_type> parms_ids, size_t capacity,
+                 size_t refill_thread_count);
+
+  /// \brief Stops and joins the refill threads
+  ~HESealZeroPool();
+
+  HESealZeroPool(const HESealZeroPool&) = delete;
+  HESealZeroPool& operator=(const HESealZeroPool&) = delete;
+
+  /// \brief Encrypts a plaintext, using an encryption of zero from the pool if
+  /// one is available at the level of the plaintext. Safe to call from any
+  /// thread
+  /// \param[in] plain Plaintext to encrypt, in NTT form
+  /// \param[out] destination Encryption of the plaintext
+  void encrypt(const seal::Plaintext& plain, seal::Ciphertext& destination);
+
+  /// \brief Returns the pool statistics
+  Stats stats() const;
+
+ private:
+  struct Level {
+    seal::parms_id_type parms_id;
+    std::deque<seal::Ciphertext> zeros;
+  };
+
+  void refill();
+
+  // Returns the level to refill, or nullptr if all levels are full
+  Level* next_level_to_refill();
+
+  std::shared_ptr<seal::SEALContext> m_context;
+  std::shared_ptr<seal::Encryptor> m_encryptor;
+  seal::Evaluator m_evaluator;
+  size_t m_capacity;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_refill_cond;
+  std::vector<Level> m_levels;
+  bool m_stop{false};
+  // Number of Pause objects in scope
+  size_t m_pauses{0};
+
+  std::atomic<size_t> m_hits{0};
+  std::atomic<size_t> m_misses{0};
+
+  std::vector<std::thread> m_refill_threads;
+};
+}  // namespace ngraph::runtime::he
@@ -17,9 +17,42 @@
 #include "seal/kernel/add_seal.hpp"
 
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/elementwise_seal.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
+namespace {
+/// \brief Adds operands which are each entirely plaintext or entirely
+/// ciphertext, with matching complex packing
+template <bool CipherArg0, bool CipherArg1>
+void add_seal_homogeneous(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
+                          std::vector<HEType>& out, size_t count,
+                          HESealBackend& he_seal_backend) {
+  const bool complex_packing = arg0[0].complex_packing();
+  prepare_homogeneous_outputs<CipherArg0 || CipherArg1>(out, count,
+                                                        complex_packing);
+
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (CipherArg0 && CipherArg1) {
+      scalar_add_seal(*arg0[i].get_ciphertext(), *arg1[i].get_ciphertext(),
+                      out[i].get_ciphertext(), he_seal_backend,
+                      he_seal_backend.memory_pool());
+    } else if constexpr (CipherArg0) {
+      scalar_add_seal(*arg0[i].get_ciphertext(), arg1[i].get_plaintext(),
+                      out[i].get_ciphertext(), complex_packing,
+                      he_seal_backend);
+    } else if constexpr (CipherArg1) {
+      scalar_add_seal(*arg1[i].get_ciphertext(), arg0[i].get_plaintext(),
+                      out[i].get_ciphertext(), complex_packing,
+                      he_seal_backend);
+    } else {
+      scalar_add_seal(arg0[i].get_plaintext(), arg1[i].get_plaintext(),
+                      out[i].get_plaintext());
+    }
+  }
+}
+}  // namespace
 
 void scalar_add_seal(SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
                      std::shared_ptr<SealCiphertextWrapper>& out,
@@ -48,7 +81,8 @@ void scalar_add_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
       auto p = SealPlaintextWrapper(complex_packing);
       encode(p, arg1, *he_seal_backend.get_ckks_encoder(),
              arg0.ciphertext().parms_id(), element::f32,
-             arg0.ciphertext().scale(), complex_packing);
+             arg0.ciphertext().scale(), complex_packing,
+             he_seal_backend.memory_pool());
       size_t chain_ind0 = he_seal_backend.get_chain_index(arg0);
       size_t chain_ind1 = he_seal_backend.get_chain_index(p);
       NGRAPH_CHECK(chain_ind0 == chain_ind1, "Chain inds ", chain_ind0, ",  ",
@@ -92,7 +126,8 @@ void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_add_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
-                    out.get_ciphertext(), he_seal_backend);
+                    out.get_ciphertext(), he_seal_backend,
+                    he_seal_backend.memory_pool());
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
@@ -127,6 +162,14 @@ void add_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
+  if (dispatch_homogeneous(arg0, arg1, count, [&](auto cipher0, auto cipher1) {
+        add_seal_homogeneous<decltype(cipher0)::value,
+                             decltype(cipher1)::value>(arg0, arg1, out, count,
+                                                       he_seal_backend);
+      })) {
+    return;
+  }
+
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_add_seal(arg0[i], arg1[i], out[i], he_seal_backend);
@@ -36,7 +36,7 @@ namespace ngraph::runtime::he {
 void scalar_add_seal(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     std::shared_ptr<SealCiphertextWrapper>& out, HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Adds a ciphertext with a plaintext
 /// \param[in,out] arg0 Ciphertext argument to add. May be rescaled
@@ -39,7 +39,8 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
                               const seal::parms_id_type& parms_id, double scale,
                               seal::CKKSEncoder& ckks_encoder,
                               seal::Encryptor& encryptor,
-                              seal::Decryptor& decryptor) {
+                              seal::Decryptor& decryptor,
+                              bool symmetric_encryption) {
   if (arg.is_plaintext()) {
     out.set_plaintext(arg.get_plaintext());
     scalar_bounded_relu_seal(arg.get_plaintext(), out.get_plaintext(), alpha);
@@ -49,7 +50,8 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
             ckks_encoder);
     scalar_bounded_relu_seal(plain, plain, alpha);
     encrypt(out.get_ciphertext(), plain, parms_id, element::f32, scale,
-            ckks_encoder, encryptor, arg.complex_packing());
+            ckks_encoder, encryptor, arg.complex_packing(),
+            seal::MemoryPoolHandle::ThreadLocal(), symmetric_encryption);
   }
 }
 
@@ -58,7 +60,8 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
   scalar_bounded_relu_seal(
       arg, out, alpha, he_seal_backend.get_context()->first_parms_id(),
       he_seal_backend.get_scale(), *he_seal_backend.get_ckks_encoder(),
-      *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor());
+      *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor(),
+      he_seal_backend.symmetric_encryption());
 }
 
 void bounded_relu_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
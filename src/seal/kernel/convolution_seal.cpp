@@ -34,6 +34,27 @@ void convolution_seal(
     size_t batch_axis_result, size_t output_channel_axis_result,
     const element::Type& element_type, size_t batch_size,
     HESealBackend& he_seal_backend, bool verbose) {
+  convolution_seal(arg0, arg1, out, arg0_shape, arg1_shape, out_shape,
+                   window_movement_strides, window_dilation_strides,
+                   padding_below, padding_above, data_dilation_strides,
+                   batch_axis_data, input_channel_axis_data,
+                   input_channel_axis_filters, output_channel_axis_filters,
+                   batch_axis_result, output_channel_axis_result, element_type,
+                   batch_size, 0, shape_size(out_shape), he_seal_backend,
+                   verbose);
+}
+
+void convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    const element::Type& element_type, size_t batch_size, size_t out_begin,
+    size_t out_end, HESealBackend& he_seal_backend, bool verbose) {
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
 
@@ -54,16 +75,16 @@ void convolution_seal(
     out_coords.emplace_back(out_coord);
   }
   size_t out_transform_size = out_coords.size();
+  NGRAPH_CHECK(out_begin <= out_end && out_end <= out_transform_size,
+               "Invalid convolution output range [", out_begin, ", ", out_end,
+               ") for output size ", out_transform_size);
   if (verbose) {
     NGRAPH_HE_LOG(5) << "Convolution output size " << out_transform_size;
   }
 
 #pragma omp parallel for
-  for (size_t out_coord_idx = 0; out_coord_idx < out_transform_size;
+  for (size_t out_coord_idx = out_begin; out_coord_idx < out_end;
        ++out_coord_idx) {
-    // Init thread-local memory pool for each thread
-    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
-
     const Coordinate& out_coord = out_coords[out_coord_idx];
 
     // for (Coordinate out_coord : output_transform)
@@ -208,7 +229,7 @@ void convolution_seal(
     }
     if (first_add) {
       // TODO(fboemer): batch size number of zeros?
-      HEPlaintext zero(std::vector<double>{0});
+      HEPlaintext zero{0};
       out[out_coord_idx].set_plaintext(zero);
     } else {
       // Write the sum back.
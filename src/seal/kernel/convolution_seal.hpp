@@ -41,4 +41,18 @@ void convolution_seal(
     const element::Type& element_type, size_t batch_size,
     HESealBackend& he_seal_backend, bool verbose = true);
 
+/// \brief Computes the output elements [out_begin, out_end) of a convolution,
+/// in row-major order of out_shape. Other output elements are left unchanged
+void convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    const element::Type& element_type, size_t batch_size, size_t out_begin,
+    size_t out_end, HESealBackend& he_seal_backend, bool verbose = true);
+
 }  // namespace ngraph::runtime::he
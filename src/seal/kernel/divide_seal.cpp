@@ -57,7 +57,7 @@ void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
 
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     HEType arg1_inv = arg1;
-    HEPlaintext& arg1_plain = arg1.get_plaintext();
+    const HEPlaintext& arg1_plain = arg1.get_plaintext();
     HEPlaintext& arg1_inv_plain = arg1_inv.get_plaintext();
     for (size_t i = 0; i < arg1.get_plaintext().size(); ++i) {
       arg1_inv_plain[i] = 1 / arg1_plain[i];
@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "he_type.hpp"
+#include "ngraph/check.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Selects the specialization of a binary elementwise kernel matching
+/// its operands. func is invoked once with two std::bool_constant arguments
+/// stating whether arg0 and arg1 hold ciphertexts
+/// \param[in] arg0 First operand of the kernel
+/// \param[in] arg1 Second operand of the kernel
+/// \param[in] count Number of elements the kernel processes
+/// \param[in] func Callable instantiating the specialized kernel
+/// \returns false, without invoking func, if either operand mixes plaintexts
+/// and ciphertexts or the operands use different complex packing. Callers
+/// then fall back to per-element dispatch
+template <typename Func>
+bool dispatch_homogeneous(const std::vector<HEType>& arg0,
+                          const std::vector<HEType>& arg1, size_t count,
+                          Func&& func) {
+  const HETypeKind kind0 = homogeneous_kind(arg0, count);
+  const HETypeKind kind1 = homogeneous_kind(arg1, count);
+  if (kind0 == HETypeKind::mixed || kind1 == HETypeKind::mixed ||
+      arg0[0].complex_packing() != arg1[0].complex_packing()) {
+    return false;
+  }
+  const bool cipher0 = kind0 == HETypeKind::ciphertext;
+  const bool cipher1 = kind1 == HETypeKind::ciphertext;
+  if (cipher0 && cipher1) {
+    func(std::true_type{}, std::true_type{});
+  } else if (cipher0) {
+    func(std::true_type{}, std::false_type{});
+  } else if (cipher1) {
+    func(std::false_type{}, std::true_type{});
+  } else {
+    func(std::false_type{}, std::false_type{});
+  }
+  return true;
+}
+
+/// \brief Gives the first count outputs of a specialized elementwise kernel
+/// their final representation before the kernel's loop runs
+/// \tparam Cipher Whether the outputs hold ciphertexts
+/// \param[in,out] out Outputs to prepare
+/// \param[in] count Number of outputs to prepare
+/// \param[in] complex_packing Complex packing of the outputs
+template <bool Cipher>
+void prepare_homogeneous_outputs(std::vector<HEType>& out, size_t count,
+                                 bool complex_packing) {
+  NGRAPH_CHECK(count <= out.size(), "Count ", count,
+               " is too large for out, with size ", out.size());
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (Cipher) {
+      if (!out[i].is_ciphertext()) {
+        out[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+      }
+    } else {
+      if (!out[i].is_plaintext()) {
+        out[i].set_plaintext(HEPlaintext());
+      }
+    }
+    out[i].complex_packing() = complex_packing;
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -36,7 +36,8 @@ void scalar_exp_seal(const HEPlaintext& arg, HEPlaintext& out) {
 void scalar_exp_seal(const HEType& arg, HEType& out,
                      const seal::parms_id_type& parms_id, double scale,
                      seal::CKKSEncoder& ckks_encoder,
-                     seal::Encryptor& encryptor, seal::Decryptor& decryptor) {
+                     seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+                     bool symmetric_encryption) {
   if (arg.is_plaintext()) {
     out.set_plaintext(arg.get_plaintext());
     scalar_exp_seal(arg.get_plaintext(), out.get_plaintext());
@@ -46,7 +47,8 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
             ckks_encoder);
     scalar_exp_seal(plain, plain);
     encrypt(out.get_ciphertext(), plain, parms_id, element::f32, scale,
-            ckks_encoder, encryptor, arg.complex_packing());
+            ckks_encoder, encryptor, arg.complex_packing(),
+            seal::MemoryPoolHandle::ThreadLocal(), symmetric_encryption);
   }
 }
 
@@ -55,7 +57,8 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
   scalar_exp_seal(
       arg, out, he_seal_backend.get_context()->first_parms_id(),
       he_seal_backend.get_scale(), *he_seal_backend.get_ckks_encoder(),
-      *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor());
+      *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor(),
+      he_seal_backend.symmetric_encryption());
 }
 
 void exp_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
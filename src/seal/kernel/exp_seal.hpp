@@ -31,7 +31,8 @@ void scalar_exp_seal(const HEPlaintext& arg, HEPlaintext& out);
 void scalar_exp_seal(const HEType& arg, HEType& out,
                      const seal::parms_id_type& parms_id, double scale,
                      seal::CKKSEncoder& ckks_encoder,
-                     seal::Encryptor& encryptor, seal::Decryptor& decryptor);
+                     seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+                     bool symmetric_encryption = false);
 
 void scalar_exp_seal(const HEType& arg, HEType& out,
                      const HESealBackend& he_seal_backend);
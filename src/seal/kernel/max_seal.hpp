@@ -33,10 +33,11 @@ inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                      const AxisSet& reduction_axes, size_t batch_size,
                      const seal::parms_id_type& parms_id, double scale,
                      seal::CKKSEncoder& ckks_encoder,
-                     seal::Encryptor& encryptor, seal::Decryptor& decryptor) {
+                     seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+                     bool symmetric_encryption = false) {
   std::vector<HEPlaintext> out_plain(
-      out.size(), HEPlaintext(std::vector<double>(
-                      batch_size, -std::numeric_limits<double>::infinity())));
+      out.size(),
+      HEPlaintext(batch_size, -std::numeric_limits<double>::infinity()));
 
   CoordinateTransform output_transform(out_shape);
   CoordinateTransform input_transform(in_shape);
@@ -66,7 +67,8 @@ inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
     } else {
       encrypt(out[out_idx].get_ciphertext(), out_plain[out_idx], parms_id,
               element::f32, scale, ckks_encoder, encryptor,
-              out[out_idx].complex_packing());
+              out[out_idx].complex_packing(),
+              seal::MemoryPoolHandle::ThreadLocal(), symmetric_encryption);
     }
   }
 }
@@ -78,7 +80,8 @@ inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
   max_seal(arg, out, in_shape, out_shape, reduction_axes, batch_size,
            he_seal_backend.get_context()->first_parms_id(),
            he_seal_backend.get_scale(), *he_seal_backend.get_ckks_encoder(),
-           *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor());
+           *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor(),
+           he_seal_backend.symmetric_encryption());
 }
 
 }  // namespace ngraph::runtime::he
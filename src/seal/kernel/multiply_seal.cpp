@@ -17,6 +17,7 @@
 #include "seal/kernel/multiply_seal.hpp"
 
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/elementwise_seal.hpp"
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/seal_util.hpp"
 
@@ -41,18 +42,19 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
 
     seal::Ciphertext& c0 = arg0.ciphertext();
     seal::Ciphertext& c1 = arg1.ciphertext();
-    seal::Ciphertext c0_conj;
-    seal::Ciphertext c1_conj;
+    // Temporaries are freed on this thread, so allocate them from its pool
+    seal::Ciphertext c0_conj(pool);
+    seal::Ciphertext c1_conj(pool);
 
     he_seal_backend.get_evaluator()->complex_conjugate(
-        c0, *he_seal_backend.get_galois_keys(), c0_conj);
+        c0, *he_seal_backend.get_galois_keys(), c0_conj, pool);
     he_seal_backend.get_evaluator()->complex_conjugate(
-        c1, *he_seal_backend.get_galois_keys(), c1_conj);
+        c1, *he_seal_backend.get_galois_keys(), c1_conj, pool);
 
-    seal::Ciphertext c0_re;
-    seal::Ciphertext c0_im;
-    seal::Ciphertext c1_re;
-    seal::Ciphertext c1_im;
+    seal::Ciphertext c0_re(pool);
+    seal::Ciphertext c0_im(pool);
+    seal::Ciphertext c1_re(pool);
+    seal::Ciphertext c1_im(pool);
 
     he_seal_backend.get_evaluator()->add(c0, c0_conj, c0_re);
     he_seal_backend.get_evaluator()->sub(c0, c0_conj, c0_im);
@@ -65,11 +67,11 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
     c0_im.scale() *= 2;
     c1_im.scale() *= 2;
 
-    seal::Ciphertext prod_re;
-    seal::Ciphertext prod_im;
+    seal::Ciphertext prod_re(pool);
+    seal::Ciphertext prod_im(pool);
 
-    he_seal_backend.get_evaluator()->multiply(c0_re, c1_re, prod_re);
-    he_seal_backend.get_evaluator()->multiply(c0_im, c1_im, prod_im);
+    he_seal_backend.get_evaluator()->multiply(c0_re, c1_re, prod_re, pool);
+    he_seal_backend.get_evaluator()->multiply(c0_im, c1_im, prod_im, pool);
 
     he_seal_backend.get_evaluator()->relinearize_inplace(
         prod_re, *(he_seal_backend.get_relin_keys()), pool);
@@ -81,17 +83,20 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
     auto ckks_encoder = he_seal_backend.get_ckks_encoder();
     const size_t slot_count = ckks_encoder->slot_count();
     std::vector<std::complex<double>> complex_vals(slot_count, {0, -1});
-    seal::Plaintext neg_i;
-    ckks_encoder->encode(complex_vals, prod_im.parms_id(), encode_scale, neg_i);
+    seal::Plaintext neg_i(pool);
+    ckks_encoder->encode(complex_vals, prod_im.parms_id(), encode_scale, neg_i,
+                         pool);
 
-    he_seal_backend.get_evaluator()->multiply_plain_inplace(prod_im, neg_i);
+    he_seal_backend.get_evaluator()->multiply_plain_inplace(prod_im, neg_i,
+                                                            pool);
 
     std::vector<std::complex<double>> new_complex_vals(slot_count, {1, 0});
-    seal::Plaintext fudge_re;
+    seal::Plaintext fudge_re(pool);
     ckks_encoder->encode(new_complex_vals, prod_re.parms_id(), encode_scale,
-                         fudge_re);
+                         fudge_re, pool);
 
-    he_seal_backend.get_evaluator()->multiply_plain_inplace(prod_re, fudge_re);
+    he_seal_backend.get_evaluator()->multiply_plain_inplace(prod_re, fudge_re,
+                                                            pool);
     he_seal_backend.get_evaluator()->add(prod_re, prod_im, out->ciphertext());
 
     he_seal_backend.get_evaluator()->rescale_to_next_inplace(out->ciphertext(),
@@ -112,7 +117,7 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
   // TODO(fboemer): check if abs(values) < scale?
   if (std::all_of(arg1.begin(), arg1.end(),
                   [](double f) { return std::abs(f) < 1e-5f; })) {
-    HEPlaintext zeros({std::vector<double>(arg1.size(), 0)});
+    HEPlaintext zeros(arg1.size(), 0);
     out.set_plaintext(zeros);
   } else if (arg1.size() == 1) {
     if (!out.is_ciphertext()) {
@@ -135,7 +140,7 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
     auto p = SealPlaintextWrapper(false);
     encode(p, arg1, *he_seal_backend.get_ckks_encoder(),
            arg0.ciphertext().parms_id(), element::f32,
-           arg0.ciphertext().scale(), false);
+           arg0.ciphertext().scale(), false, pool);
 
     size_t chain_ind0 = he_seal_backend.get_chain_index(arg0);
     size_t chain_ind1 = he_seal_backend.get_chain_index(p);
@@ -189,19 +194,19 @@ void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
     }
     scalar_multiply_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
                          out.get_ciphertext(), arg0.complex_packing(),
-                         he_seal_backend);
+                         he_seal_backend, he_seal_backend.memory_pool());
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_multiply_seal(*arg0.get_ciphertext(), arg1.get_plaintext(), out,
-                         he_seal_backend);
+                         he_seal_backend, he_seal_backend.memory_pool());
   } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_multiply_seal(*arg1.get_ciphertext(), arg0.get_plaintext(), out,
-                         he_seal_backend);
+                         he_seal_backend, he_seal_backend.memory_pool());
   } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -214,6 +219,40 @@ void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
   out.complex_packing() = arg0.complex_packing();
 }
 
+namespace {
+/// \brief Multiplies operands which are each entirely plaintext or entirely
+/// ciphertext, with matching complex packing
+template <bool CipherArg0, bool CipherArg1>
+void multiply_seal_homogeneous(std::vector<HEType>& arg0,
+                               std::vector<HEType>& arg1,
+                               std::vector<HEType>& out, size_t count,
+                               HESealBackend& he_seal_backend) {
+  const bool complex_packing = arg0[0].complex_packing();
+  prepare_homogeneous_outputs<CipherArg0 || CipherArg1>(out, count,
+                                                        complex_packing);
+
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (CipherArg0 && CipherArg1) {
+      scalar_multiply_seal(*arg0[i].get_ciphertext(), *arg1[i].get_ciphertext(),
+                           out[i].get_ciphertext(), complex_packing,
+                           he_seal_backend, he_seal_backend.memory_pool());
+    } else if constexpr (CipherArg0) {
+      scalar_multiply_seal(*arg0[i].get_ciphertext(), arg1[i].get_plaintext(),
+                           out[i], he_seal_backend,
+                           he_seal_backend.memory_pool());
+    } else if constexpr (CipherArg1) {
+      scalar_multiply_seal(*arg1[i].get_ciphertext(), arg0[i].get_plaintext(),
+                           out[i], he_seal_backend,
+                           he_seal_backend.memory_pool());
+    } else {
+      scalar_multiply_seal(arg0[i].get_plaintext(), arg1[i].get_plaintext(),
+                           out[i].get_plaintext());
+    }
+  }
+}
+}  // namespace
+
 void multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
                    std::vector<HEType>& out, size_t count,
                    const element::Type& element_type,
@@ -225,6 +264,14 @@ void multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
+  if (dispatch_homogeneous(arg0, arg1, count, [&](auto cipher0, auto cipher1) {
+        multiply_seal_homogeneous<decltype(cipher0)::value,
+                                  decltype(cipher1)::value>(
+            arg0, arg1, out, count, he_seal_backend);
+      })) {
+    return;
+  }
+
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_multiply_seal(arg0[i], arg1[i], out[i], he_seal_backend);
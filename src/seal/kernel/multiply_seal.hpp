@@ -39,7 +39,7 @@ void scalar_multiply_seal(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     std::shared_ptr<SealCiphertextWrapper>& out, const bool complex_packing,
     HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Multiplies a ciphertext with a plaintext
 /// \param[in,out] arg0 Ciphertext argument to multiply. May be rescaled
@@ -50,7 +50,7 @@ void scalar_multiply_seal(
 void scalar_multiply_seal(
     SealCiphertextWrapper& arg0, const HEPlaintext& arg1, HEType& out,
     HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Multiplies two plaintexts
 /// \param[in] arg0 Plaintext argument to multiply
@@ -30,4 +30,35 @@ void scalar_negate_seal(const HEPlaintext& arg, HEPlaintext& out) {
   out = std::move(out_vals);
 }
 
+void negate_seal(const HETensorStorage& arg, HETensorStorage& out,
+                 const element::Type& element_type,
+                 const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+  NGRAPH_CHECK(arg.size() == out.size(), "Argument size ", arg.size(),
+               " doesn't match output size ", out.size());
+  NGRAPH_CHECK(&arg != &out, "In-place negation is unsupported");
+
+  for (size_t i = 0; i < arg.size(); ++i) {
+    if (arg.is_ciphertext(i)) {
+      out.emplace_ciphertext(i);
+    } else {
+      out.copy(i, arg, i);
+    }
+  }
+  std::vector<double>& values = out.plaintext_values();
+  std::transform(values.begin(), values.end(), values.begin(), std::negate<>());
+
+  if (arg.ciphertext_count() == 0) {
+    return;
+  }
+#pragma omp parallel for
+  for (size_t i = 0; i < arg.size(); ++i) {
+    if (arg.is_ciphertext(i)) {
+      he_seal_backend.get_evaluator()->negate(
+          arg.ciphertext(i)->ciphertext(), out.ciphertext(i)->ciphertext());
+    }
+  }
+}
+
 }  // namespace ngraph::runtime::he
@@ -19,6 +19,8 @@
 #include <memory>
 #include <vector>
 
+#include "he_tensor_storage.hpp"
+#include "he_type.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
@@ -51,6 +53,24 @@ inline void scalar_negate_seal(HEType& arg, HEType& out,
   }
 }
 
+/// \brief Negates arguments which are all plaintexts or all ciphertexts into
+/// outputs of the same kind and complex packing
+/// \tparam Cipher Whether arg and out hold ciphertexts
+template <bool Cipher>
+void negate_seal_homogeneous(std::vector<HEType>& arg,
+                             std::vector<HEType>& out, size_t count,
+                             const HESealBackend& he_seal_backend) {
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (Cipher) {
+      scalar_negate_seal(*arg[i].get_ciphertext(), out[i].get_ciphertext(),
+                         he_seal_backend);
+    } else {
+      scalar_negate_seal(arg[i].get_plaintext(), out[i].get_plaintext());
+    }
+  }
+}
+
 inline void negate_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
                         size_t count, const element::Type& element_type,
                         const HESealBackend& he_seal_backend) {
@@ -61,10 +81,27 @@ inline void negate_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
   NGRAPH_CHECK(count <= out.size(), "Count ", count,
                " is too large for out, with size ", out.size());
 
+  const HETypeKind kind = homogeneous_kind(arg, count);
+  if (kind != HETypeKind::mixed && homogeneous_kind(out, count) == kind &&
+      arg[0].complex_packing() == out[0].complex_packing()) {
+    if (kind == HETypeKind::ciphertext) {
+      negate_seal_homogeneous<true>(arg, out, count, he_seal_backend);
+    } else {
+      negate_seal_homogeneous<false>(arg, out, count, he_seal_backend);
+    }
+    return;
+  }
+
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_negate_seal(arg[i], out[i], element_type, he_seal_backend);
   }
 }
 
+/// \brief Negates each element. Plaintext values are negated in one linear
+/// pass over the storage's plaintext buffer
+void negate_seal(const HETensorStorage& arg, HETensorStorage& out,
+                 const element::Type& element_type,
+                 const HESealBackend& he_seal_backend);
+
 }  // namespace ngraph::runtime::he
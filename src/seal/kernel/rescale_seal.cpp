@@ -23,8 +23,15 @@ namespace ngraph::runtime::he {
 
 void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
                   const bool verbose) {
+  rescale_seal(arg, 0, arg.size(), he_seal_backend, verbose);
+}
+
+void rescale_seal(std::vector<HEType>& arg, size_t begin, size_t end,
+                  HESealBackend& he_seal_backend, const bool verbose) {
+  NGRAPH_CHECK(begin <= end && end <= arg.size(), "Invalid rescale range [",
+               begin, ", ", end, ") for ", arg.size(), " elements");
   if (verbose) {
-    NGRAPH_HE_LOG(3) << "Rescaling " << arg.size() << " elements";
+    NGRAPH_HE_LOG(3) << "Rescaling " << end - begin << " elements";
   }
 
   using Clock = std::chrono::high_resolution_clock;
@@ -32,7 +39,8 @@ void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
   size_t new_chain_index = std::numeric_limits<size_t>::max();
 
   bool all_plaintexts = true;
-  for (auto& he_type : arg) {
+  for (size_t i = begin; i < end; ++i) {
+    auto& he_type = arg[i];
     if (he_type.is_ciphertext()) {
       size_t curr_chain_index =
           he_seal_backend.get_chain_index(*he_type.get_ciphertext());
@@ -66,11 +74,11 @@ void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
   }
 
 #pragma omp parallel for
-  for (size_t i = 0; i < arg.size(); ++i) {  // NOLINT
+  for (size_t i = begin; i < end; ++i) {  // NOLINT
     auto cipher = arg[i];
     if (arg[i].is_ciphertext()) {
       he_seal_backend.get_evaluator()->rescale_to_next_inplace(
-          arg[i].get_ciphertext()->ciphertext());
+          arg[i].get_ciphertext()->ciphertext(), he_seal_backend.memory_pool());
     }
   }
   if (verbose) {
@@ -27,4 +27,13 @@ namespace ngraph::runtime::he {
 void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
                   const bool verbose = false);
 
+/// \brief Rescales the elements [begin, end) of arg to the next chain index
+/// \param[in,out] arg Data to rescale
+/// \param[in] begin Index of first element to rescale
+/// \param[in] end Index one past the last element to rescale
+/// \param[in] he_seal_backend Backend used to perform the rescaling
+/// \param[in] verbose Whether or not to log timing information
+void rescale_seal(std::vector<HEType>& arg, size_t begin, size_t end,
+                  HESealBackend& he_seal_backend, const bool verbose = false);
+
 }  // namespace ngraph::runtime::he
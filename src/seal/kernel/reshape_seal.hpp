@@ -18,6 +18,7 @@
 
 #include <vector>
 
+#include "he_tensor_storage.hpp"
 #include "he_type.hpp"
 #include "ngraph/axis_vector.hpp"
 #include "ngraph/coordinate_transform.hpp"
@@ -50,4 +51,26 @@ inline void reshape_seal(const std::vector<HEType>& arg,
   }
 }
 
+inline void reshape_seal(const HETensorStorage& arg, HETensorStorage& out,
+                         const Shape& in_shape,
+                         const AxisVector& in_axis_order,
+                         const Shape& out_shape) {
+  Shape in_start_corner(in_shape.size(), 0);  // (0,...0)
+  Strides in_strides(in_shape.size(), 1);     // (1,...,1)
+
+  CoordinateTransform input_transform(in_shape, in_start_corner, in_shape,
+                                      in_strides, in_axis_order);
+
+  NGRAPH_CHECK(shape_size(input_transform.get_target_shape()) ==
+               shape_size(out_shape));
+  NGRAPH_CHECK(out.size() == shape_size(out_shape), "Output size ",
+               out.size(), " doesn't match shape ", out_shape);
+
+  // The output is filled in order, so it streams through memory linearly
+  size_t out_idx = 0;
+  for (const Coordinate& input_coord : input_transform) {
+    out.copy(out_idx++, arg, input_transform.index(input_coord));
+  }
+}
+
 }  // namespace ngraph::runtime::he
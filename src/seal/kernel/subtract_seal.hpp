@@ -22,6 +22,7 @@
 #include "he_type.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/elementwise_seal.hpp"
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
@@ -36,7 +37,7 @@ namespace ngraph::runtime::he {
 void scalar_subtract_seal(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     std::shared_ptr<SealCiphertextWrapper>& out, HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Subtracts a ciphertext by a plaintext
 /// \param[in,out] arg0 Ciphertext argument to subtract from. May be rescaled
@@ -82,7 +83,8 @@ inline void scalar_subtract_seal(HEType& arg0, HEType& arg1, HEType& out,
 
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     scalar_subtract_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
-                         out.get_ciphertext(), he_seal_backend);
+                         out.get_ciphertext(), he_seal_backend,
+                         he_seal_backend.memory_pool());
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     scalar_subtract_seal(*arg0.get_ciphertext(), arg1.get_plaintext(),
                          out.get_ciphertext(), arg0.complex_packing(),
@@ -97,6 +99,40 @@ inline void scalar_subtract_seal(HEType& arg0, HEType& arg1, HEType& out,
   }
 }
 
+/// \brief Subtracts operands which are each entirely plaintext or entirely
+/// ciphertext, with matching complex packing
+/// \tparam CipherArg0 Whether arg0 holds ciphertexts
+/// \tparam CipherArg1 Whether arg1 holds ciphertexts
+template <bool CipherArg0, bool CipherArg1>
+void subtract_seal_homogeneous(std::vector<HEType>& arg0,
+                               std::vector<HEType>& arg1,
+                               std::vector<HEType>& out, size_t count,
+                               HESealBackend& he_seal_backend) {
+  const bool complex_packing = arg0[0].complex_packing();
+  prepare_homogeneous_outputs<CipherArg0 || CipherArg1>(out, count,
+                                                        complex_packing);
+
+#pragma omp parallel for
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (CipherArg0 && CipherArg1) {
+      scalar_subtract_seal(*arg0[i].get_ciphertext(), *arg1[i].get_ciphertext(),
+                           out[i].get_ciphertext(), he_seal_backend,
+                           he_seal_backend.memory_pool());
+    } else if constexpr (CipherArg0) {
+      scalar_subtract_seal(*arg0[i].get_ciphertext(), arg1[i].get_plaintext(),
+                           out[i].get_ciphertext(), complex_packing,
+                           he_seal_backend);
+    } else if constexpr (CipherArg1) {
+      scalar_subtract_seal(arg0[i].get_plaintext(), *arg1[i].get_ciphertext(),
+                           out[i].get_ciphertext(), complex_packing,
+                           he_seal_backend);
+    } else {
+      scalar_subtract_seal(arg0[i].get_plaintext(), arg1[i].get_plaintext(),
+                           out[i].get_plaintext());
+    }
+  }
+}
+
 /// \brief Subtracts two vectors of ciphertext/plaintext elements element-wise
 /// \param[in] arg0 Cipher or plaintext data to subtract from
 /// \param[in] arg1 Cipher or plaintext data to subtract
@@ -115,6 +151,14 @@ inline void subtract_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
+  if (dispatch_homogeneous(arg0, arg1, count, [&](auto cipher0, auto cipher1) {
+        subtract_seal_homogeneous<decltype(cipher0)::value,
+                                  decltype(cipher1)::value>(
+            arg0, arg1, out, count, he_seal_backend);
+      })) {
+    return;
+  }
+
 #pragma omp parallel for
   for (size_t i = 0; i < count; ++i) {
     scalar_subtract_seal(arg0[i], arg1[i], out[i], he_seal_backend);
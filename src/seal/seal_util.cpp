@@ -19,13 +19,21 @@
 #include "seal/seal_util.hpp"
 
 #include <chrono>
+#include <cstring>
+#include <iomanip>
 #include <limits>
+#include <random>
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/runtime/tensor.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_zero_pool.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/util/hash.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/uintarith.h"
 
@@ -49,6 +57,65 @@ seal::sec_level_type seal_security_level(size_t bits) {
   throw ngraph_error("Invalid security level " + std::to_string(bits));
 }
 
+std::string hash_to_string(
+    const seal::util::HashFunction::hash_block_type& hash) {
+  std::stringstream ss;
+  for (const auto& word : hash) {
+    ss << std::hex << std::setw(16) << std::setfill('0') << word;
+  }
+  return ss.str();
+}
+
+std::string key_fingerprint(const std::string& public_key_bytes,
+                            const std::string& relin_keys_bytes) {
+  // Hash the length of each key first, so zero padding and the boundary
+  // between the keys do not cause collisions
+  auto word_count = [](const std::string& bytes) {
+    return 1 + (bytes.size() + 7) / 8;
+  };
+  std::vector<std::uint64_t> words(
+      word_count(public_key_bytes) + word_count(relin_keys_bytes), 0);
+  size_t offset = 0;
+  for (const std::string* bytes : {&public_key_bytes, &relin_keys_bytes}) {
+    words[offset] = bytes->size();
+    std::memcpy(words.data() + offset + 1, bytes->data(), bytes->size());
+    offset += word_count(*bytes);
+  }
+
+  seal::util::HashFunction::hash_block_type hash;
+  seal::util::HashFunction::hash(words.data(), words.size(), hash);
+  return hash_to_string(hash);
+}
+
+bool is_key_fingerprint(const std::string& fingerprint) {
+  return fingerprint.size() ==
+             16 * seal::util::HashFunction::hash_block_uint64_count &&
+         fingerprint.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+std::string generate_session_token() {
+  // std::random_device reads the operating system's entropy source on the
+  // supported platforms
+  std::random_device random_device;
+  std::uniform_int_distribution<std::uint64_t> distribution;
+  seal::util::HashFunction::hash_block_type words;
+  for (auto& word : words) {
+    word = distribution(random_device);
+  }
+  return hash_to_string(words);
+}
+
+bool tokens_equal(const std::string& token, const std::string& expected) {
+  if (token.size() != expected.size()) {
+    return false;
+  }
+  unsigned char difference = 0;
+  for (size_t i = 0; i < token.size(); ++i) {
+    difference |= static_cast<unsigned char>(token[i] ^ expected[i]);
+  }
+  return difference == 0;
+}
+
 void match_modulus_and_scale_inplace(SealCiphertextWrapper& arg0,
                                      SealCiphertextWrapper& arg1,
                                      const HESealBackend& he_seal_backend,
@@ -110,7 +177,7 @@ void add_plain_inplace(seal::Ciphertext& encrypted, double value,
   std::vector<std::uint64_t> plaintext_vals(coeff_mod_count, 0);
   double scale = encrypted.scale();
   encode(value, element::f32, scale, encrypted.parms_id(), plaintext_vals,
-         he_seal_backend);
+         he_seal_backend, he_seal_backend.memory_pool());
 
   for (size_t j = 0; j < coeff_mod_count; j++) {
     // Add poly scalar instead of poly poly
@@ -162,7 +229,7 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
   // # of rescalings
   double scale = encrypted.scale();
   encode(value, element::f32, scale, encrypted.parms_id(), plaintext_vals,
-         he_seal_backend);
+         he_seal_backend, pool);
   double new_scale = scale * scale;
   // Check that scale is positive and not too large
   if (new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
@@ -229,12 +296,20 @@ void multiply_poly_scalar_coeffmod64(const uint64_t* poly, size_t coeff_count,
 
 size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
                                      const HESealBackend& he_seal_backend) {
-  size_t num_elements = he_types.size();
+  return match_to_smallest_chain_index(he_types, 0, he_types.size(),
+                                       he_seal_backend);
+}
+
+size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
+                                     size_t begin, size_t end,
+                                     const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(begin <= end && end <= he_types.size(), "Invalid range [",
+               begin, ", ", end, ") for ", he_types.size(), " elements");
 
   // (idx, smallest chain_index)
   std::pair<size_t, size_t> smallest_chain_ind{
       0, std::numeric_limits<size_t>::max()};
-  for (size_t idx = 0; idx < num_elements; ++idx) {
+  for (size_t idx = begin; idx < end; ++idx) {
     if (he_types[idx].is_ciphertext()) {
       auto& cipher = *he_types[idx].get_ciphertext();
       size_t chain_ind = he_seal_backend.get_chain_index(cipher);
@@ -253,12 +328,13 @@ size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
   // TODO(fboemer): loop over only ciphertext indices?
   auto smallest_cipher = *he_types[smallest_chain_ind.first].get_ciphertext();
 #pragma omp parallel for
-  for (size_t idx = 0; idx < num_elements; ++idx) {
+  for (size_t idx = begin; idx < end; ++idx) {
     if (he_types[idx].is_ciphertext()) {
       auto& cipher = *he_types[idx].get_ciphertext();
       if (idx != smallest_chain_ind.second) {
         match_modulus_and_scale_inplace(smallest_cipher, cipher,
-                                        he_seal_backend);
+                                        he_seal_backend,
+                                        he_seal_backend.memory_pool());
         size_t chain_ind = he_seal_backend.get_chain_index(cipher);
         NGRAPH_CHECK(chain_ind == smallest_chain_ind.second, "chain_ind",
                      chain_ind, " does not match smallest ",
@@ -440,7 +516,7 @@ void encode(double value, const element::Type& element_type, double scale,
 void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
             seal::CKKSEncoder& ckks_encoder, seal::parms_id_type parms_id,
             const element::Type& element_type, double scale,
-            bool complex_packing) {
+            bool complex_packing, const seal::MemoryPoolHandle& pool) {
   const size_t slot_count = ckks_encoder.slot_count();
 
   switch (element_type.get_type_enum()) {
@@ -454,24 +530,27 @@ void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
           std::complex<double> val(plaintext[0], plaintext[0]);
           complex_vals = std::vector<std::complex<double>>(slot_count, val);
         } else {
-          real_vec_to_complex_vec(complex_vals, plaintext);
+          real_vec_to_complex_vec(
+              complex_vals,
+              std::vector<double>(plaintext.begin(), plaintext.end()));
         }
         NGRAPH_CHECK(complex_vals.size() <= slot_count, "Cannot encode ",
                      complex_vals.size(), " elements, maximum size is ",
                      slot_count);
 
         ckks_encoder.encode(complex_vals, parms_id, scale,
-                            destination.plaintext());
+                            destination.plaintext(), pool);
       } else {
         if (plaintext.size() == 1) {
           ckks_encoder.encode(plaintext[0], parms_id, scale,
-                              destination.plaintext());
+                              destination.plaintext(), pool);
         } else {
           NGRAPH_CHECK(plaintext.size() <= slot_count, "Cannot encode ",
                        plaintext.size(), " elements, maximum size is ",
                        slot_count);
-          ckks_encoder.encode(plaintext, parms_id, scale,
-                              destination.plaintext());
+          ckks_encoder.encode(
+              std::vector<double>(plaintext.begin(), plaintext.end()),
+              parms_id, scale, destination.plaintext(), pool);
         }
       }
       break;
@@ -497,30 +576,51 @@ void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
              const HEPlaintext& input, seal::parms_id_type parms_id,
              const element::Type& element_type, double scale,
              seal::CKKSEncoder& ckks_encoder, const seal::Encryptor& encryptor,
-             bool complex_packing) {
+             bool complex_packing, const seal::MemoryPoolHandle& pool,
+             bool symmetric) {
   auto plaintext = SealPlaintextWrapper(complex_packing);
   encode(plaintext, input, ckks_encoder, parms_id, element_type, scale,
-         complex_packing);
-  encryptor.encrypt(plaintext.plaintext(), output->ciphertext());
+         complex_packing, pool);
+  if (symmetric) {
+    encryptor.encrypt_symmetric(plaintext.plaintext(), output->ciphertext(),
+                                pool);
+  } else {
+    encryptor.encrypt(plaintext.plaintext(), output->ciphertext(), pool);
+  }
+}
+
+void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
+             const HEPlaintext& input, seal::parms_id_type parms_id,
+             const element::Type& element_type, double scale,
+             seal::CKKSEncoder& ckks_encoder, HESealZeroPool& zero_pool,
+             bool complex_packing, const seal::MemoryPoolHandle& pool) {
+  auto plaintext = SealPlaintextWrapper(complex_packing);
+  encode(plaintext, input, ckks_encoder, parms_id, element_type, scale,
+         complex_packing, pool);
+  zero_pool.encrypt(plaintext.plaintext(), output->ciphertext());
 }
 
 void decode(HEPlaintext& output, const SealPlaintextWrapper& input,
-            seal::CKKSEncoder& ckks_encoder) {
+            seal::CKKSEncoder& ckks_encoder,
+            const seal::MemoryPoolHandle& pool) {
+  std::vector<double> values;
   if (input.complex_packing()) {
     std::vector<std::complex<double>> complex_vals;
-    ckks_encoder.decode(input.plaintext(), complex_vals);
-    complex_vec_to_real_vec(output, complex_vals);
+    ckks_encoder.decode(input.plaintext(), complex_vals, pool);
+    complex_vec_to_real_vec(values, complex_vals);
   } else {
-    ckks_encoder.decode(input.plaintext(), output);
+    ckks_encoder.decode(input.plaintext(), values, pool);
   }
+  output.assign(values.begin(), values.end());
 }
 
 void decrypt(HEPlaintext& output, const SealCiphertextWrapper& input,
              const bool complex_packing, seal::Decryptor& decryptor,
-             seal::CKKSEncoder& ckks_encoder) {
+             seal::CKKSEncoder& ckks_encoder,
+             const seal::MemoryPoolHandle& pool) {
   auto plaintext_wrapper = SealPlaintextWrapper(complex_packing);
   decryptor.decrypt(input.ciphertext(), plaintext_wrapper.plaintext());
-  decode(output, plaintext_wrapper, ckks_encoder);
+  decode(output, plaintext_wrapper, ckks_encoder, pool);
 }
 
 }  // namespace ngraph::runtime::he
@@ -24,11 +24,13 @@
 #include "ngraph/check.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal.h"
+#include "seal/util/hash.h"
 
 namespace ngraph::runtime::he {
 class SealCiphertextWrapper;
 class SealPlaintextWrapper;
 class HESealBackend;
+class HESealZeroPool;
 
 /// \brief Returns SEAL's security level type from the number of bits of
 /// security
@@ -36,6 +38,34 @@ class HESealBackend;
 /// \throws ngraph_error if security level is invalid number of bits
 seal::sec_level_type seal_security_level(size_t bits);
 
+/// \brief Returns the hexadecimal representation of a hash block, such as a
+/// parms_id
+/// \param[in] hash Hash block to represent
+std::string hash_to_string(
+    const seal::util::HashFunction::hash_block_type& hash);
+
+/// \brief Returns a fingerprint identifying a set of client keys, namely a
+/// hexadecimal hash of the serialized public and relinearization keys
+/// \param[in] public_key_bytes Serialized public key
+/// \param[in] relin_keys_bytes Serialized relinearization keys. Empty if the
+/// encryption parameters don't use key switching
+std::string key_fingerprint(const std::string& public_key_bytes,
+                            const std::string& relin_keys_bytes);
+
+/// \brief Returns whether or not a string is a valid key fingerprint
+/// \param[in] fingerprint String to check
+bool is_key_fingerprint(const std::string& fingerprint);
+
+/// \brief Returns a random hexadecimal token, with which a client proves
+/// that its data connections belong to its session
+std::string generate_session_token();
+
+/// \brief Returns whether two tokens are equal, in time independent of where
+/// they differ
+/// \param[in] token Token to check
+/// \param[in] expected Expected token
+bool tokens_equal(const std::string& token, const std::string& expected);
+
 /// \brief Returns the smallest chain index of a vector of HE data
 /// \param[in] he_types Vector of HE data
 /// \param[in] he_seal_backend Backend whose context is used to determine the
@@ -45,6 +75,18 @@ seal::sec_level_type seal_security_level(size_t bits);
 size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
                                      const HESealBackend& he_seal_backend);
 
+/// \brief Matches the elements [begin, end) of a vector of HE data to their
+/// smallest chain index
+/// \param[in,out] he_types Vector of HE data
+/// \param[in] begin Index of first element to match
+/// \param[in] end Index one past the last element to match
+/// \param[in] he_seal_backend Backend whose context is used to determine the
+/// chain index
+/// \returns The minimum chain index of the HE data in the range
+size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
+                                     size_t begin, size_t end,
+                                     const HESealBackend& he_seal_backend);
+
 /// \brief Returns whether or not two cipher/plaintexts have a similar scale
 /// \param[in] arg0 Ciphertext or plaintext
 /// \param[in] arg1 Ciphertext or plaintext
@@ -84,7 +126,7 @@ inline void match_scale(S& arg0, const T& arg1) {
 void match_modulus_and_scale_inplace(
     SealCiphertextWrapper& arg0, SealCiphertextWrapper& arg1,
     const HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Adds a ciphertext with a scalar in every slot
 /// \param[in,out] encrypted Ciphertext to add to.
@@ -175,7 +217,7 @@ inline void add_poly_scalar_coeffmod(const std::uint64_t* poly,
 void multiply_plain_inplace(
     seal::Ciphertext& encrypted, double value,
     const HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Multiplies a ciphertext with a scalar in every slot
 /// \param[in] encrypted Ciphertext to multply
@@ -187,7 +229,7 @@ void multiply_plain_inplace(
 inline void multiply_plain(
     const seal::Ciphertext& encrypted, double value,
     seal::Ciphertext& destination, const HESealBackend& he_seal_backend,
-    seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool()) {
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal()) {
   destination = encrypted;
   multiply_plain_inplace(destination, value, he_seal_backend, std::move(pool));
 }
@@ -204,7 +246,7 @@ void encode(
     double value, const element::Type& element_type, double scale,
     seal::parms_id_type parms_id, std::vector<std::uint64_t>& destination,
     const HESealBackend& he_seal_backend,
-    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Encode value into each slot of a plaintext
 /// \param[out] destination Encoded value in CRT form
@@ -215,10 +257,12 @@ void encode(
 /// \param[in] scale Scale at which to encode value
 /// \param[in] complex_packing Whether or not to use complex packing during
 /// encoding
-void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
-            seal::CKKSEncoder& ckks_encoder, seal::parms_id_type parms_id,
-            const element::Type& element_type, double scale,
-            bool complex_packing);
+/// \param[in] pool Memory pool used for temporary allocations
+void encode(
+    SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
+    seal::CKKSEncoder& ckks_encoder, seal::parms_id_type parms_id,
+    const element::Type& element_type, double scale, bool complex_packing,
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Encrypt plaintext into ciphertext
 /// \param[out] output Encrypted value
@@ -230,18 +274,45 @@ void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
 /// \param[in] encryptor Used for encrypting
 /// \param[in] complex_packing Whether or not to use complex packing during
 /// encoding
-void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
-             const HEPlaintext& input, seal::parms_id_type parms_id,
-             const element::Type& element_type, double scale,
-             seal::CKKSEncoder& ckks_encoder, const seal::Encryptor& encryptor,
-             bool complex_packing);
+/// \param[in] pool Memory pool used for temporary allocations
+/// \param[in] symmetric Whether or not to encrypt with the secret key. The
+/// encryptor must then hold a secret key
+void encrypt(
+    std::shared_ptr<SealCiphertextWrapper>& output, const HEPlaintext& input,
+    seal::parms_id_type parms_id, const element::Type& element_type,
+    double scale, seal::CKKSEncoder& ckks_encoder,
+    const seal::Encryptor& encryptor, bool complex_packing,
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal(),
+    bool symmetric = false);
+
+/// \brief Encrypt plaintext into ciphertext, using a precomputed encryption of
+/// zero if available
+/// \param[out] output Encrypted value
+/// \param[in] input Plaintext to encode
+/// \param[in] parms_id Seal parameter id to use in encoding
+/// \param[in] element_type Datatype used for encoding
+/// \param[in] scale Scale at which to encode value
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] zero_pool Used for encrypting
+/// \param[in] complex_packing Whether or not to use complex packing during
+/// encoding
+/// \param[in] pool Memory pool used for temporary allocations
+void encrypt(
+    std::shared_ptr<SealCiphertextWrapper>& output, const HEPlaintext& input,
+    seal::parms_id_type parms_id, const element::Type& element_type,
+    double scale, seal::CKKSEncoder& ckks_encoder, HESealZeroPool& zero_pool,
+    bool complex_packing,
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Decode SEAL plaintext into plaintext values
 /// \param[out] output Decoded values
 /// \param[in] input Plaintext to decode
 /// \param[in] ckks_encoder Used for decoding
-void decode(HEPlaintext& output, const SealPlaintextWrapper& input,
-            seal::CKKSEncoder& ckks_encoder);
+/// \param[in] pool Memory pool used for temporary allocations
+void decode(
+    HEPlaintext& output, const SealPlaintextWrapper& input,
+    seal::CKKSEncoder& ckks_encoder,
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 /// \brief Decrypts and decodes a ciphertext to plaintext values
 /// \param[out] output Destination to write values to
@@ -250,8 +321,11 @@ void decode(HEPlaintext& output, const SealPlaintextWrapper& input,
 /// packing
 /// \param[in] decryptor Used for decryption
 /// \param[in] ckks_encoder Used for decoding
-void decrypt(HEPlaintext& output, const SealCiphertextWrapper& input,
-             const bool complex_packing, seal::Decryptor& decryptor,
-             seal::CKKSEncoder& ckks_encoder);
+/// \param[in] pool Memory pool used for temporary allocations while decoding
+void decrypt(
+    HEPlaintext& output, const SealCiphertextWrapper& input,
+    const bool complex_packing, seal::Decryptor& decryptor,
+    seal::CKKSEncoder& ckks_encoder,
+    const seal::MemoryPoolHandle& pool = seal::MemoryPoolHandle::ThreadLocal());
 
 }  // namespace ngraph::runtime::he
@@ -16,59 +16,124 @@
 
 #include "tcp/tcp_client.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <deque>
+#include <exception>
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_dispatcher.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
+#include "tcp/tcp_write_queue.hpp"
 
 namespace ngraph::runtime::he {
+namespace {
+std::vector<TransportEndpoint> to_transport_endpoints(
+    const boost::asio::ip::tcp::resolver::results_type& endpoints) {
+  std::vector<TransportEndpoint> transport_endpoints;
+  for (const auto& entry : endpoints) {
+    transport_endpoints.emplace_back(entry.endpoint());
+  }
+  return transport_endpoints;
+}
+}  // namespace
+
 /// \brief Class representing a Client over a TCP connection
 
 TCPClient::TCPClient(
     boost::asio::io_context& io_context,
     const boost::asio::ip::tcp::resolver::results_type& endpoints,
-    const std::function<void(const TCPMessage&)>& message_handler)
+    const std::function<void(const TCPMessage&)>& message_handler,
+    size_t worker_count)
+    : TCPClient(io_context, to_transport_endpoints(endpoints),
+                TransportType::tcp, message_handler, worker_count, 0) {}
+
+TCPClient::TCPClient(
+    boost::asio::io_context& io_context, const TransportAddress& address,
+    const std::function<void(const TCPMessage&)>& message_handler,
+    size_t worker_count, size_t ring_capacity)
+    : TCPClient(io_context, address.resolve(io_context), address.type(),
+                message_handler, worker_count, ring_capacity) {}
+
+TCPClient::TCPClient(
+    boost::asio::io_context& io_context,
+    std::vector<TransportEndpoint> endpoints, TransportType transport,
+    const std::function<void(const TCPMessage&)>& message_handler,
+    size_t worker_count, size_t ring_capacity)
     : m_io_context(io_context),
       m_socket(io_context),
-      m_message_callback(std::bind(message_handler, std::placeholders::_1)) {
-  do_connect(endpoints);
+      m_endpoints(std::move(endpoints)),
+      m_transport(transport),
+      m_ring_capacity(ring_capacity),
+      m_dispatcher(message_handler, worker_count) {
+  // Handler errors leave the I/O loop, as if the handler ran on it
+  m_dispatcher.set_error_handler([this](std::exception_ptr error) {
+    boost::asio::post(m_io_context,
+                      [error]() { std::rethrow_exception(error); });
+  });
+  do_connect();
 }
 
 /// \brief Closes the socket
 void TCPClient::close() {
   NGRAPH_HE_LOG(1) << "Closing socket";
-  m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
+  m_socket.shutdown(TransportSocket::shutdown_both);
   boost::asio::post(m_io_context, [this]() { m_socket.close(); });
 }
 
 /// \brief Asynchronously writes the message
 /// \param[in,out] message Message to write
 void TCPClient::write_message(TCPMessage&& message) {
-  bool write_in_progress = !m_message_queue.empty();
-  m_message_queue.push_back(std::move(message));
-  if (!write_in_progress) {
+  buffer_ptr buffer;
+  if (m_transport != TransportType::shared_memory) {
+    buffer = TCPWriteQueue::pack(message);
+  } else if (auto channel = std::atomic_load(&m_channel)) {
+    buffer = channel->pack(message);
+  } else {
+    // Written before the channel was created
+    buffer = SharedMemoryChannel::pack_inline(message);
+  }
+  NGRAPH_HE_LOG(4) << "Client queueing message size " << buffer->size()
+                   << " bytes";
+  if (m_write_queue.push(std::move(buffer))) {
     boost::asio::post(m_io_context, [this]() { do_write(); });
   }
 }
 
-void TCPClient::do_connect(
-    const boost::asio::ip::tcp::resolver::results_type& endpoints,
-    size_t delay_ms) {
+void TCPClient::wait_until_connected() {
+  std::unique_lock<std::mutex> lock(m_connected_mutex);
+  m_connected_cond.wait(lock, [this]() { return m_connected; });
+}
+
+void TCPClient::set_connected() {
+  std::lock_guard<std::mutex> guard(m_connected_mutex);
+  m_connected = true;
+  m_connected_cond.notify_all();
+}
+
+void TCPClient::do_connect(size_t delay_ms) {
   boost::asio::async_connect(
-      m_socket, endpoints,
-      [this, delay_ms, &endpoints](
-          const boost::system::error_code& ec,
-          const boost::asio::ip::tcp::endpoint& connect_endpoint) {
+      m_socket, m_endpoints,
+      [this, delay_ms](const boost::system::error_code& ec,
+                       const TransportEndpoint& connect_endpoint) {
         static_cast<void>(connect_endpoint);  // Avoid unused-parameter warning
         if (!ec) {
           NGRAPH_HE_LOG(1) << "Connected to server";
-          do_read_header();
+          if (m_transport == TransportType::shared_memory) {
+            do_write_handshake();
+          } else {
+            set_connected();
+            do_read_header();
+          }
         } else {
           NGRAPH_INFO << "error connecting to server: " << ec.message();
           std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
@@ -77,19 +142,84 @@ void TCPClient::do_connect(
             new_delay_ms *= 2;
           }
           NGRAPH_INFO << "Trying to connect again";
-          do_connect(endpoints, new_delay_ms);
+          do_connect(new_delay_ms);
+        }
+      });
+}
+
+void TCPClient::do_write_handshake() {
+  // Further connections of a session send an empty name, and share the
+  // channel of the first connection once the server attached them
+  std::string name;
+  if (m_ring_capacity > 0) {
+    auto channel = SharedMemoryChannel::create(m_ring_capacity);
+    name = channel->name();
+    // Writers pack messages into the channel from now on
+    std::atomic_store(&m_channel, std::move(channel));
+  }
+  m_handshake.resize(header_length + name.size());
+  TCPMessage::encode_header(m_handshake, name.size());
+  std::copy(name.begin(), name.end(), m_handshake.begin() + header_length);
+
+  boost::asio::async_write(
+      m_socket, boost::asio::buffer(m_handshake),
+      [this](boost::system::error_code ec, std::size_t /* length */) {
+        NGRAPH_CHECK(!ec, "Client error writing shared memory handshake: ",
+                     ec.message());
+        m_handshake_written = true;
+        set_connected();
+        do_read_header();
+        if (m_write_deferred) {
+          m_write_deferred = false;
+          do_write();
         }
       });
 }
 
 void TCPClient::do_read_header() {
+  if (m_transport == TransportType::shared_memory) {
+    do_read_descriptor();
+  } else {
+    do_read_socket_header();
+  }
+}
+
+void TCPClient::do_read_descriptor() {
+  boost::asio::async_read(
+      m_socket,
+      boost::asio::buffer(&m_descriptor,
+                          SharedMemoryChannel::descriptor_length),
+      [this](boost::system::error_code ec, std::size_t /* length */) {
+        // Reads are cancelled if a message handler closes the connection
+        NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message ||
+                         ec == boost::asio::error::operation_aborted,
+                     "Client error reading message descriptor: ",
+                     ec.message());
+        if (!ec) {
+          if (m_descriptor.offset == SharedMemoryChannel::inline_offset) {
+            // Message which didn't fit into the ring follows on the socket
+            do_read_socket_header();
+          } else {
+            auto channel = std::atomic_load(&m_channel);
+            NGRAPH_CHECK(channel != nullptr,
+                         "Client received shared memory message without "
+                         "channel");
+            dispatch_message(channel->receive(m_descriptor));
+          }
+        }
+      });
+}
+
+void TCPClient::do_read_socket_header() {
   if (m_read_buffer.size() < header_length) {
     m_read_buffer.resize(header_length);
   }
   boost::asio::async_read(
       m_socket, boost::asio::buffer(&m_read_buffer[0], header_length),
       [this](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message,
+        // Reads are cancelled if a message handler closes the connection
+        NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message ||
+                         ec == boost::asio::error::operation_aborted,
                      "Client error reading message header: ", ec.message());
         if (!ec) {
           size_t msg_len = TCPMessage::decode_header(m_read_buffer);
@@ -103,32 +233,65 @@ void TCPClient::do_read_body(size_t body_length) {
   boost::asio::async_read(
       m_socket, boost::asio::buffer(&m_read_buffer[header_length], body_length),
       [this](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message,
+        // Reads are cancelled if a message handler closes the connection
+        NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message ||
+                         ec == boost::asio::error::operation_aborted,
                      "Client error reading message body: ", ec.message());
         if (!ec) {
-          m_read_message.unpack(m_read_buffer);
-          m_message_callback(m_read_message);
-          do_read_header();
+          dispatch_message();
         }
       });
 }
 
+void TCPClient::dispatch_message(SharedMemoryChannel::View view) {
+  // Keep the I/O thread running until the message is handled, since the
+  // handler may write a reply or close the connection
+  auto work = std::make_shared<
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
+      m_io_context.get_executor());
+  // Resume reading on the I/O thread once the workers caught up
+  auto resume = [this]() {
+    boost::asio::post(m_io_context, [this]() { do_read_header(); });
+  };
+  bool queued =
+      view != nullptr
+          ? m_dispatcher.push(std::move(view), m_descriptor.length, work,
+                              resume)
+          : m_dispatcher.push(std::move(m_read_buffer), work, resume);
+  if (queued) {
+    do_read_header();
+  }
+}
+
 void TCPClient::do_write() {
-  auto message = m_message_queue.front();
-  message.pack(m_write_buffer);
-  NGRAPH_HE_LOG(4) << "Client writing message size " << m_write_buffer.size()
-                   << " bytes";
+  if (m_transport == TransportType::shared_memory && !m_handshake_written) {
+    // The server reads the name of the channel first
+    m_write_deferred = true;
+    return;
+  }
+  // With shared memory, the buffers hold the descriptors of the messages,
+  // followed by the messages written inline
+  auto batch = m_write_queue.take_batch();
+  if (batch.empty()) {
+    return;
+  }
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(batch.size());
+  for (const auto& buffer : batch) {
+    buffers.emplace_back(boost::asio::buffer(*buffer));
+  }
+  NGRAPH_HE_LOG(4) << "Client writing " << batch.size() << " messages";
 
   boost::asio::async_write(
-      m_socket, boost::asio::buffer(m_write_buffer),
-      [this](boost::system::error_code ec, std::size_t /* length */) {
+      m_socket, buffers,
+      [this, batch = std::move(batch)](boost::system::error_code ec,
+                                       std::size_t /* length */) {
         if (!ec) {
-          m_message_queue.pop_front();
-          if (!m_message_queue.empty()) {
-            do_write();
-          }
+          m_write_queue.finish_batch(batch.size());
+          do_write();
         } else {
           NGRAPH_ERR << "Client error writing message: " << ec.message();
+          m_write_queue.fail(ec.message());
         }
       });
 }
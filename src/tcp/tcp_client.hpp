@@ -16,56 +16,140 @@
 
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_dispatcher.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
+#include "tcp/tcp_write_queue.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing a Client over a TCP connection
+/// \brief Class representing a Client over a TCP connection, a Unix-domain
+/// socket, or shared memory
 class TCPClient {
  public:
   using data_buffer = TCPMessage::data_buffer;
+  using buffer_ptr = TCPWriteQueue::buffer_ptr;
   size_t header_length = TCPMessage::header_length;
 
   /// \brief Connects client to hostname:port and reads message
   /// \param[in] io_context Boost context for I/O functionality
   /// \param[in] endpoints Socket to connect to
-  /// \param[in] message_handler Function to handle responses from the server
+  /// \param[in] message_handler Function to handle responses from the server.
+  /// Called from a pool of worker threads, not the I/O thread
+  /// \param[in] worker_count Number of threads handling messages
   TCPClient(boost::asio::io_context& io_context,
             const boost::asio::ip::tcp::resolver::results_type& endpoints,
-            const std::function<void(const TCPMessage&)>& message_handler);
+            const std::function<void(const TCPMessage&)>& message_handler,
+            size_t worker_count = TCPMessageDispatcher::default_worker_count);
+
+  /// \brief Connects client to the server at the given address
+  /// \param[in] io_context Boost context for I/O functionality
+  /// \param[in] address Address of the server, see TransportAddress::parse
+  /// \param[in] message_handler Function to handle responses from the server.
+  /// Called from a pool of worker threads, not the I/O thread
+  /// \param[in] worker_count Number of threads handling messages
+  /// \param[in] ring_capacity Capacity of each shared-memory ring in bytes.
+  /// Zero for a further connection of a session, which shares the channel of
+  /// the session's first connection, see set_channel()
+  TCPClient(
+      boost::asio::io_context& io_context, const TransportAddress& address,
+      const std::function<void(const TCPMessage&)>& message_handler,
+      size_t worker_count = TCPMessageDispatcher::default_worker_count,
+      size_t ring_capacity = SharedMemoryChannel::default_ring_capacity);
 
   /// \brief Closes the socket
   void close();
 
-  /// \brief Asynchronously writes the message
+  /// \brief Asynchronously writes the message. Safe to call from any thread.
+  /// The message is packed on the calling thread
   /// \param[in,out] message Message to write
   void write_message(TCPMessage&& message);
 
+  /// \brief Returns whether or not a message is queued to be written
+  bool is_writing() const { return m_write_queue.is_writing(); }
+
+  /// \brief Blocks until all queued messages have been written. Must not be
+  /// called from the I/O thread
+  void wait_until_written() { m_write_queue.wait_until_written(); }
+
+  /// \brief Blocks until the client is connected and ready to write. Must not
+  /// be called from the I/O thread
+  void wait_until_connected();
+
+  /// \brief Returns the shared-memory channel of the connection. Null for
+  /// other transports, or before the client is connected
+  std::shared_ptr<SharedMemoryChannel> channel() const {
+    return std::atomic_load(&m_channel);
+  }
+
+  /// \brief Passes the messages written from now on through the given
+  /// channel, e.g. that of the session's first connection. Call once the
+  /// server attached this connection to the session, i.e. once it can
+  /// resolve the channel, and before the server writes through it
+  /// \param[in] channel Channel to share. Null to keep writing on the socket
+  void set_channel(std::shared_ptr<SharedMemoryChannel> channel) {
+    std::atomic_store(&m_channel, std::move(channel));
+  }
+
  private:
-  void do_connect(const boost::asio::ip::tcp::resolver::results_type& endpoints,
-                  size_t delay_ms = 10);
+  TCPClient(boost::asio::io_context& io_context,
+            std::vector<TransportEndpoint> endpoints, TransportType transport,
+            const std::function<void(const TCPMessage&)>& message_handler,
+            size_t worker_count, size_t ring_capacity);
+
+  void do_connect(size_t delay_ms = 10);
+
+  void set_connected();
+
+  void do_write_handshake();
 
   void do_read_header();
 
+  void do_read_descriptor();
+
+  void do_read_socket_header();
+
   void do_read_body(size_t body_length);
 
+  void dispatch_message(SharedMemoryChannel::View view = nullptr);
+
   void do_write();
 
   boost::asio::io_context& m_io_context;
-  boost::asio::ip::tcp::socket m_socket;
+  TransportSocket m_socket;
+  std::vector<TransportEndpoint> m_endpoints;
 
   data_buffer m_read_buffer;
-  data_buffer m_write_buffer;
-  TCPMessage m_read_message;
-  std::deque<TCPMessage> m_message_queue;
+  TCPWriteQueue m_write_queue;
+
+  TransportType m_transport;
+  size_t m_ring_capacity;
+  // Accessed atomically, since writers pack into it on their own thread
+  std::shared_ptr<SharedMemoryChannel> m_channel;
+  SharedMemoryChannel::Descriptor m_descriptor{};
+  data_buffer m_handshake;
+  bool m_handshake_written{false};
+  bool m_write_deferred{false};
+
+  std::mutex m_connected_mutex;
+  std::condition_variable m_connected_cond;
+  bool m_connected{false};
 
   inline static std::string s_expected_teardown_message{"End of file"};
 
-  std::function<void(const TCPMessage&)> m_message_callback;
+  // Declared last, so the workers are joined before the other members are
+  // destroyed
+  TCPMessageDispatcher m_dispatcher;
 };
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/tcp_flow_control.hpp"
+
+#include <algorithm>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+TCPFlowControl::TCPFlowControl(const Config& config)
+    : m_config(config), m_batch_bytes(config.initial_batch_bytes) {
+  NGRAPH_CHECK(m_config.min_batch_bytes <= m_config.max_batch_bytes,
+               "Minimum batch size ", m_config.min_batch_bytes,
+               " larger than maximum batch size ", m_config.max_batch_bytes);
+  m_batch_bytes = std::clamp(m_batch_bytes, m_config.min_batch_bytes,
+                             m_config.max_batch_bytes);
+}
+
+void TCPFlowControl::reset() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(m_in_flight.empty(), "Reset with ", m_in_flight.size(),
+               " batches in flight");
+  m_in_flight_bytes = 0;
+  m_done_element_count = 0;
+  m_stats = Stats();
+}
+
+size_t TCPFlowControl::batch_bytes() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_batch_bytes;
+}
+
+size_t TCPFlowControl::wait_for_capacity() {
+  auto start = clock::now();
+  std::unique_lock<std::mutex> mlock(m_mutex);
+  m_cond.wait(mlock, [this]() {
+    return m_in_flight_bytes < m_config.max_in_flight_bytes;
+  });
+  m_stats.wait_time += std::chrono::duration_cast<std::chrono::microseconds>(
+      clock::now() - start);
+  return m_config.max_in_flight_bytes - m_in_flight_bytes;
+}
+
+void TCPFlowControl::on_send(size_t batch_id, size_t bytes,
+                             size_t element_count) {
+  auto now = clock::now();
+  std::lock_guard<std::mutex> guard(m_mutex);
+  bool inserted =
+      m_in_flight.emplace(batch_id, InFlightBatch{bytes, element_count, now})
+          .second;
+  NGRAPH_CHECK(inserted, "Batch ", batch_id, " already in flight");
+  if (m_stats.batch_count == 0) {
+    m_first_send_time = now;
+    m_last_reply_time = now;
+  }
+  m_in_flight_bytes += bytes;
+  m_stats.batch_count++;
+  m_stats.element_count += element_count;
+  m_stats.bytes_sent += bytes;
+}
+
+void TCPFlowControl::on_reply(size_t batch_id) {
+  auto now = clock::now();
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_in_flight.find(batch_id);
+  NGRAPH_CHECK(it != m_in_flight.end(), "Reply to unknown batch ", batch_id);
+  const InFlightBatch batch = it->second;
+  m_in_flight.erase(it);
+
+  m_in_flight_bytes -= batch.bytes;
+  m_done_element_count += batch.element_count;
+
+  // Estimate the client's throughput from the spacing of the replies. When
+  // the window is full, replies are spaced by the client's processing time
+  auto since_last_reply =
+      std::max(now - m_last_reply_time,
+               clock::duration(std::chrono::microseconds(1)));
+  m_last_reply_time = now;
+  double seconds = std::chrono::duration<double>(since_last_reply).count();
+  double rate = static_cast<double>(batch.bytes) / seconds;
+  m_throughput = (m_throughput == 0) ? rate : 0.5 * m_throughput + 0.5 * rate;
+
+  double target_seconds =
+      std::chrono::duration<double>(m_config.target_batch_duration).count();
+  auto target_bytes = static_cast<size_t>(m_throughput * target_seconds);
+  m_batch_bytes = std::clamp(target_bytes, m_config.min_batch_bytes,
+                             m_config.max_batch_bytes);
+
+  m_stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      now - m_first_send_time);
+  m_stats.throughput = m_throughput;
+
+  NGRAPH_HE_LOG(5) << "Batch " << batch_id << " replied after "
+                   << std::chrono::duration_cast<std::chrono::milliseconds>(
+                          now - batch.send_time)
+                          .count()
+                   << " ms; next batch size " << m_batch_bytes << " bytes";
+  m_cond.notify_all();
+}
+
+void TCPFlowControl::wait_until_done() {
+  auto start = clock::now();
+  std::unique_lock<std::mutex> mlock(m_mutex);
+  m_cond.wait(mlock, [this]() { return m_in_flight.empty(); });
+  m_stats.wait_time += std::chrono::duration_cast<std::chrono::microseconds>(
+      clock::now() - start);
+}
+
+size_t TCPFlowControl::done_element_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_done_element_count;
+}
+
+TCPFlowControl::Stats TCPFlowControl::stats() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_stats;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,123 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace ngraph::runtime::he {
+/// \brief Flow control for batched request/reply exchanges with the client,
+/// such as client-aided ReLU.
+///
+/// Bounds the number of bytes in flight, and adapts the batch size to the
+/// rate at which the client returns replies, so that each batch takes roughly
+/// target_batch_duration to process. Batches are identified by an id, e.g.
+/// the index of their first element. All methods are thread-safe.
+class TCPFlowControl {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /// \brief Tuning parameters
+  struct Config {
+    /// Size of the first batches, before any reply has been received
+    size_t initial_batch_bytes{4 * 1024 * 1024};
+    /// Smallest batch size. A batch always holds at least one element
+    size_t min_batch_bytes{256 * 1024};
+    /// Largest batch size
+    size_t max_batch_bytes{64 * 1024 * 1024};
+    /// Maximum number of bytes sent but not yet replied to
+    size_t max_in_flight_bytes{256 * 1024 * 1024};
+    /// Client processing time targeted for each batch
+    std::chrono::milliseconds target_batch_duration{50};
+  };
+
+  /// \brief Statistics of the exchanges since the last reset
+  struct Stats {
+    size_t batch_count{0};
+    size_t element_count{0};
+    size_t bytes_sent{0};
+    /// Time from the first send until the last reply
+    std::chrono::microseconds elapsed{0};
+    /// Time spent waiting for window capacity or for outstanding replies
+    std::chrono::microseconds wait_time{0};
+    /// Estimated client throughput, in bytes per second
+    double throughput{0};
+  };
+
+  /// \brief Constructs flow control with default parameters
+  TCPFlowControl() : TCPFlowControl(Config()) {}
+
+  /// \brief Constructs flow control with the given parameters
+  /// \param[in] config Tuning parameters
+  explicit TCPFlowControl(const Config& config);
+
+  /// \brief Starts a new exchange. Keeps the adapted batch size and
+  /// throughput estimate, which carry over between layers
+  void reset();
+
+  /// \brief Returns the current target size of a batch, in bytes
+  size_t batch_bytes() const;
+
+  /// \brief Blocks until there is room in the window
+  /// \returns Number of bytes which may be sent before the window is full
+  size_t wait_for_capacity();
+
+  /// \brief Records that a batch was sent
+  /// \param[in] batch_id Unique identifier of the batch within the exchange
+  /// \param[in] bytes Serialized size of the batch
+  /// \param[in] element_count Number of elements in the batch
+  void on_send(size_t batch_id, size_t bytes, size_t element_count);
+
+  /// \brief Records that the reply to a batch was received and processed
+  /// \param[in] batch_id Identifier of the batch passed to on_send
+  void on_reply(size_t batch_id);
+
+  /// \brief Blocks until all sent batches have been replied to
+  void wait_until_done();
+
+  /// \brief Returns the number of elements which have been replied to
+  size_t done_element_count() const;
+
+  /// \brief Returns the statistics since the last reset
+  Stats stats() const;
+
+ private:
+  struct InFlightBatch {
+    size_t bytes;
+    size_t element_count;
+    clock::time_point send_time;
+  };
+
+  Config m_config;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cond;
+
+  std::unordered_map<size_t, InFlightBatch> m_in_flight;
+  size_t m_in_flight_bytes{0};
+  size_t m_batch_bytes;
+  double m_throughput{0};
+
+  size_t m_done_element_count{0};
+  Stats m_stats;
+  clock::time_point m_first_send_time;
+  clock::time_point m_last_reply_time;
+};
+}  // namespace ngraph::runtime::he
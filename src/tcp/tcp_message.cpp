@@ -52,22 +52,38 @@ size_t TCPMessage::decode_header(const TCPMessage::data_buffer& buffer) {
   return body_length;
 }
 
+size_t TCPMessage::packed_size() const {
+  NGRAPH_CHECK(m_proto_message != nullptr, "Can't pack empty proto message");
+  return TCPMessage::header_length + m_proto_message->ByteSize();
+}
+
 bool TCPMessage::pack(TCPMessage::data_buffer& buffer) {
+  buffer.resize(packed_size());
+  return pack(buffer.data(), buffer.size());
+}
+
+bool TCPMessage::pack(char* data, size_t size) const {
   NGRAPH_CHECK(m_proto_message != nullptr, "Can't pack empty proto message");
-  size_t msg_size = m_proto_message->ByteSize();
-  buffer.resize(TCPMessage::header_length + msg_size);
-  encode_header(buffer, msg_size);
-  return m_proto_message->SerializeToArray(&buffer[TCPMessage::header_length],
+  NGRAPH_CHECK(size >= TCPMessage::header_length, "Buffer too small");
+  size_t msg_size = size - TCPMessage::header_length;
+  std::memcpy(data, &msg_size, TCPMessage::header_length);
+  return m_proto_message->SerializeToArray(data + TCPMessage::header_length,
                                            msg_size);
 }
 
 bool TCPMessage::unpack(const TCPMessage::data_buffer& buffer) {
+  return unpack(buffer.data(), buffer.size());
+}
+
+bool TCPMessage::unpack(const char* data, size_t size) {
+  if (size < TCPMessage::header_length) {
+    return false;
+  }
   if (!m_proto_message) {
     m_proto_message = std::make_shared<pb::TCPMessage>();
   }
-  return m_proto_message->ParseFromArray(
-      &buffer[TCPMessage::header_length],
-      buffer.size() - TCPMessage::header_length);
+  return m_proto_message->ParseFromArray(data + TCPMessage::header_length,
+                                         size - TCPMessage::header_length);
 }
 
 }  // namespace ngraph::runtime::he
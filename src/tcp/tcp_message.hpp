@@ -50,17 +50,35 @@ class TCPMessage {
   /// \returns size of message stored in buffer
   static size_t decode_header(const data_buffer& buffer);
 
+  /// \brief Returns the number of bytes the packed message takes, including
+  /// the header
+  /// \throws ngraph_error if message is empty
+  size_t packed_size() const;
+
   /// \brief Writes the message to a buffer
   /// \param[in,out] buffer Buffer to write the message to
   /// \throws ngraph_error if message is empty
   /// \returns Whether or not the operation was successful
   bool pack(data_buffer& buffer);
 
+  /// \brief Writes the message to memory, e.g. in a shared-memory ring
+  /// \param[out] data Memory to write the header and body of the message to
+  /// \param[in] size Number of bytes at data, as returned by packed_size()
+  /// \throws ngraph_error if message is empty
+  /// \returns Whether or not the operation was successful
+  bool pack(char* data, size_t size) const;
+
   /// \brief Writes a given buffer to the message
   /// \param[in] buffer Buffer to read the message from
   /// \returns Whether or not the operation was successful
   bool unpack(const data_buffer& buffer);
 
+  /// \brief Reads the message from memory, e.g. in a shared-memory ring
+  /// \param[in] data Memory storing the header and body of the message
+  /// \param[in] size Number of bytes at data
+  /// \returns Whether or not the operation was successful
+  bool unpack(const char* data, size_t size);
+
  private:
   std::shared_ptr<pb::TCPMessage> m_proto_message;
 };
@@ -0,0 +1,189 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/tcp_message_dispatcher.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+TCPMessageDispatcher::TCPMessageDispatcher(
+    std::function<void(const TCPMessage&)> message_handler, size_t worker_count,
+    size_t max_queued_messages)
+    : m_message_handler(std::move(message_handler)),
+      m_max_queued_messages(std::max(max_queued_messages, size_t(1))) {
+  worker_count = std::max(worker_count, size_t(1));
+  m_workers.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; ++i) {
+    m_workers.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+TCPMessageDispatcher::~TCPMessageDispatcher() {
+  stop();
+  for (auto& worker : m_workers) {
+    if (!worker.joinable()) {
+      continue;
+    }
+    // The owner may be released from within a message handler
+    if (worker.get_id() == std::this_thread::get_id()) {
+      worker.detach();
+    } else {
+      worker.join();
+    }
+  }
+}
+
+bool TCPMessageDispatcher::push(data_buffer&& buffer,
+                                std::shared_ptr<void> keep_alive,
+                                std::function<void()> resume) {
+  return push(QueuedMessage{std::move(buffer), nullptr, 0,
+                            std::move(keep_alive)},
+              std::move(resume));
+}
+
+bool TCPMessageDispatcher::push(std::shared_ptr<const char> data, size_t size,
+                                std::shared_ptr<void> keep_alive,
+                                std::function<void()> resume) {
+  return push(QueuedMessage{data_buffer(), std::move(data), size,
+                            std::move(keep_alive)},
+              std::move(resume));
+}
+
+bool TCPMessageDispatcher::push(QueuedMessage&& message,
+                                std::function<void()> resume) {
+  rethrow_error();
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(!m_has_parked_message,
+               "Pushed message while reading should be paused");
+  if (m_stopped) {
+    return false;
+  }
+  if (m_queue.size() < m_max_queued_messages) {
+    m_queue.push_back(std::move(message));
+    m_queue_cond.notify_one();
+    return true;
+  }
+  NGRAPH_HE_LOG(4) << "Message queue full (" << m_queue.size()
+                   << " messages); pausing reads";
+  m_parked_message = std::move(message);
+  m_has_parked_message = true;
+  m_resume = std::move(resume);
+  return false;
+}
+
+void TCPMessageDispatcher::set_error_handler(
+    std::function<void(std::exception_ptr)> error_handler) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_error_handler = std::move(error_handler);
+}
+
+void TCPMessageDispatcher::rethrow_error() {
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    std::swap(error, m_error);
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TCPMessageDispatcher::handle_error(std::exception_ptr error) {
+  std::function<void(std::exception_ptr)> error_handler;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_error_handler) {
+      // Keep the first error
+      if (m_error == nullptr) {
+        m_error = std::move(error);
+      }
+      return;
+    }
+    error_handler = m_error_handler;
+  }
+  error_handler(std::move(error));
+}
+
+void TCPMessageDispatcher::stop() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_stopped = true;
+  m_queue.clear();
+  m_has_parked_message = false;
+  m_parked_message = QueuedMessage();
+  m_resume = nullptr;
+  m_queue_cond.notify_all();
+}
+
+size_t TCPMessageDispatcher::queued_message_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_queue.size();
+}
+
+void TCPMessageDispatcher::worker_loop() {
+  while (true) {
+    QueuedMessage queued;
+    std::function<void()> resume;
+    {
+      std::unique_lock<std::mutex> mlock(m_mutex);
+      m_queue_cond.wait(mlock,
+                        [this]() { return m_stopped || !m_queue.empty(); });
+      if (m_stopped) {
+        return;
+      }
+      queued = std::move(m_queue.front());
+      m_queue.pop_front();
+
+      // Room is available again; queue the parked message and resume reading
+      if (m_has_parked_message) {
+        m_queue.emplace_back(std::move(m_parked_message));
+        m_has_parked_message = false;
+        resume = std::move(m_resume);
+        m_resume = nullptr;
+        m_queue_cond.notify_one();
+      }
+    }
+    if (resume) {
+      resume();
+    }
+
+    try {
+      TCPMessage message;
+      if (queued.data != nullptr) {
+        // Released with queued, once the message has been handled
+        message.unpack(queued.data.get(), queued.size);
+      } else {
+        message.unpack(queued.buffer);
+        queued.buffer = data_buffer();
+      }
+      m_message_handler(message);
+    } catch (const std::exception& e) {
+      // Throwing here would terminate the process, so the owner rethrows
+      NGRAPH_ERR << "Error handling message: " << e.what();
+      handle_error(std::current_exception());
+    } catch (...) {
+      NGRAPH_ERR << "Unknown error handling message";
+      handle_error(std::current_exception());
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
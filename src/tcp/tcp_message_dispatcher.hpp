@@ -0,0 +1,144 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Receive pipeline shared by TCPSession and TCPClient. The I/O thread
+/// only frames messages and pushes the raw buffers onto a bounded queue; a
+/// pool of worker threads unpacks the buffers and invokes the message handler.
+/// This keeps the socket read loop running while expensive handlers, e.g.
+/// deserializing thousands of ciphertexts, are in progress.
+///
+/// Handlers may run concurrently on different workers, so they must not rely
+/// on the order in which messages arrived on the socket.
+class TCPMessageDispatcher {
+ public:
+  using data_buffer = TCPMessage::data_buffer;
+
+  /// \brief Default number of worker threads
+  static constexpr size_t default_worker_count = 2;
+
+  /// \brief Default maximum number of framed messages waiting for a worker
+  static constexpr size_t default_max_queued_messages = 64;
+
+  /// \brief Starts the worker threads
+  /// \param[in] message_handler Function invoked on every unpacked message
+  /// \param[in] worker_count Number of worker threads
+  /// \param[in] max_queued_messages Maximum number of messages waiting for a
+  /// worker before the reader is paused
+  explicit TCPMessageDispatcher(
+      std::function<void(const TCPMessage&)> message_handler,
+      size_t worker_count = default_worker_count,
+      size_t max_queued_messages = default_max_queued_messages);
+
+  /// \brief Stops and joins the worker threads. Messages which have not been
+  /// dispatched yet are dropped
+  ~TCPMessageDispatcher();
+
+  TCPMessageDispatcher(const TCPMessageDispatcher&) = delete;
+  TCPMessageDispatcher& operator=(const TCPMessageDispatcher&) = delete;
+
+  /// \brief Hands a framed message to the worker pool. Never blocks.
+  /// \param[in,out] buffer Buffer storing header and body of the message
+  /// \param[in] keep_alive Held until the message has been handled, e.g. to
+  /// keep the I/O loop running while a handler may still write a reply
+  /// \param[in] resume Called from a worker thread once the queue has room
+  /// again, if the queue is full
+  /// \returns True if the message was queued and the caller may continue
+  /// reading. False if the queue is full; the message is then parked and will
+  /// be queued before resume is invoked, so the caller should stop reading
+  /// until then.
+  bool push(data_buffer&& buffer, std::shared_ptr<void> keep_alive,
+            std::function<void()> resume);
+
+  /// \brief Hands a framed message stored elsewhere, e.g. in a shared-memory
+  /// ring, to the worker pool. Never blocks. The message is parsed straight
+  /// from data, which is released once the message has been handled
+  /// \param[in] data Header and body of the message
+  /// \param[in] size Number of bytes at data
+  /// \param[in] keep_alive See above
+  /// \param[in] resume See above
+  /// \returns See above
+  bool push(std::shared_ptr<const char> data, size_t size,
+            std::shared_ptr<void> keep_alive, std::function<void()> resume);
+
+  /// \brief Sets the function called with the error of a failed message
+  /// handler. Called from the worker thread, so it should hand the error to
+  /// the owner's thread, e.g. by posting a rethrow to its I/O loop. Without
+  /// an error handler, the error is rethrown by the next push
+  /// \param[in] error_handler Function invoked with the handler's exception
+  void set_error_handler(
+      std::function<void(std::exception_ptr)> error_handler);
+
+  /// \brief Rethrows the first error of a message handler not yet handed to
+  /// an error handler or rethrown, if any
+  void rethrow_error();
+
+  /// \brief Stops the worker threads after their current message
+  void stop();
+
+  /// \brief Returns the number of worker threads
+  size_t worker_count() const { return m_workers.size(); }
+
+  /// \brief Returns the number of messages waiting for a worker
+  size_t queued_message_count() const;
+
+ private:
+  void worker_loop();
+
+  void handle_error(std::exception_ptr error);
+
+  std::function<void(const TCPMessage&)> m_message_handler;
+  std::function<void(std::exception_ptr)> m_error_handler;
+  size_t m_max_queued_messages;
+
+  // Message stored in buffer, or at data if data is set
+  struct QueuedMessage {
+    data_buffer buffer;
+    std::shared_ptr<const char> data;
+    size_t size{0};
+    std::shared_ptr<void> keep_alive;
+  };
+
+  bool push(QueuedMessage&& message, std::function<void()> resume);
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_queue_cond;
+  std::deque<QueuedMessage> m_queue;
+  bool m_stopped{false};
+  std::exception_ptr m_error;
+
+  // Message parked while the queue is full, and the function to resume reading
+  bool m_has_parked_message{false};
+  QueuedMessage m_parked_message;
+  std::function<void()> m_resume;
+
+  std::vector<std::thread> m_workers;
+};
+}  // namespace ngraph::runtime::he
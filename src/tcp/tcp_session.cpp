@@ -16,24 +16,132 @@
 
 #include "tcp/tcp_session.hpp"
 
-#include <deque>
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_dispatcher.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
+#include "tcp/tcp_write_queue.hpp"
 
 namespace ngraph::runtime::he {
 TCPSession::TCPSession(
-    boost::asio::ip::tcp::socket socket,
-    const std::function<void(const TCPMessage&)>& message_handler)
+    TransportSocket socket,
+    const std::function<void(const TCPMessage&)>& message_handler,
+    size_t worker_count, TransportType transport)
     : m_socket(std::move(socket)),
-      m_message_callback(std::bind(message_handler, std::placeholders::_1)) {}
+      m_transport(transport),
+      m_dispatcher(message_handler, worker_count) {
+  // Handler errors leave the I/O loop, as if the handler ran on it
+  m_dispatcher.set_error_handler([this](std::exception_ptr error) {
+    boost::asio::post(m_socket.get_executor(),
+                      [error]() { std::rethrow_exception(error); });
+  });
+}
+
+void TCPSession::set_handshake_check(
+    std::function<bool(const TCPMessage&)> handshake_check) {
+  m_handshake_check = std::move(handshake_check);
+}
+
+void TCPSession::start() {
+  if (m_transport == TransportType::shared_memory) {
+    do_read_handshake();
+  } else {
+    do_read_header();
+  }
+}
+
+void TCPSession::do_read_handshake() {
+  m_read_buffer.resize(header_length);
+  auto self(shared_from_this());
+  boost::asio::async_read(
+      m_socket, boost::asio::buffer(&m_read_buffer[0], header_length),
+      [this, self](boost::system::error_code ec, std::size_t /* length */) {
+        NGRAPH_CHECK(!ec, "Server error reading shared memory handshake: ",
+                     ec.message());
+        size_t name_length = TCPMessage::decode_header(m_read_buffer);
+        NGRAPH_CHECK(name_length < 4096, "Invalid shared memory name length ",
+                     name_length);
+        if (name_length == 0) {
+          // The channel is shared with another session, see set_channel()
+          finish_handshake(nullptr);
+          return;
+        }
+        m_read_buffer.resize(name_length);
+        boost::asio::async_read(
+            m_socket, boost::asio::buffer(&m_read_buffer[0], name_length),
+            [this, self](boost::system::error_code ec,
+                         std::size_t /* length */) {
+              NGRAPH_CHECK(!ec,
+                           "Server error reading shared memory handshake: ",
+                           ec.message());
+              finish_handshake(SharedMemoryChannel::open(
+                  std::string(m_read_buffer.begin(), m_read_buffer.end())));
+            });
+      });
+}
+
+void TCPSession::finish_handshake(
+    std::shared_ptr<SharedMemoryChannel> channel) {
+  if (channel != nullptr) {
+    // Writers pack messages into the channel from now on
+    std::atomic_store(&m_channel, std::move(channel));
+  }
+  m_handshake_read = true;
+  do_read_header();
+  if (m_write_deferred) {
+    m_write_deferred = false;
+    do_write();
+  }
+}
 
 void TCPSession::do_read_header() {
+  if (m_transport == TransportType::shared_memory) {
+    do_read_descriptor();
+  } else {
+    do_read_socket_header();
+  }
+}
+
+void TCPSession::do_read_descriptor() {
+  auto self(shared_from_this());
+  boost::asio::async_read(
+      m_socket,
+      boost::asio::buffer(&m_descriptor,
+                          SharedMemoryChannel::descriptor_length),
+      [this, self](boost::system::error_code ec, std::size_t /* length */) {
+        NGRAPH_CHECK(
+            !ec || ec.message() == TCPSession::s_expected_teardown_message,
+            "Server error reading message descriptor: ", ec.message());
+        if (!ec) {
+          if (m_descriptor.offset == SharedMemoryChannel::inline_offset) {
+            // Message which didn't fit into the ring follows on the socket
+            do_read_socket_header();
+          } else if (auto channel = std::atomic_load(&m_channel)) {
+            dispatch_message(channel->receive(m_descriptor));
+          } else {
+            // Any process may connect, so don't fail the server
+            NGRAPH_ERR << "Server closing session: shared memory message "
+                          "without channel";
+            boost::system::error_code close_ec;
+            m_socket.shutdown(TransportSocket::shutdown_both, close_ec);
+            m_socket.close(close_ec);
+          }
+        }
+      });
+}
+
+void TCPSession::do_read_socket_header() {
   if (m_read_buffer.size() < header_length) {
     m_read_buffer.resize(header_length);
   }
@@ -62,40 +170,113 @@ void TCPSession::do_read_body(size_t body_length) {
             !ec || ec.message() == TCPSession::s_expected_teardown_message,
             "Server error reading message body: ", ec.message());
         if (!ec) {
-          m_read_message.unpack(m_read_buffer);
-          m_message_callback(m_read_message);
-          do_read_header();
+          dispatch_message();
         }
       });
 }
 
+void TCPSession::dispatch_message(SharedMemoryChannel::View view) {
+  if (m_handshake_check) {
+    if (view != nullptr) {
+      m_read_buffer.assign(view.get(), view.get() + m_descriptor.length);
+    }
+    check_handshake();
+    return;
+  }
+  // Keep the I/O thread running until the message is handled, since the
+  // handler may write a reply
+  auto work = std::make_shared<
+      boost::asio::executor_work_guard<TransportSocket::executor_type>>(
+      m_socket.get_executor());
+  // Resume reading on the I/O thread once the workers caught up
+  std::weak_ptr<TCPSession> weak_self = shared_from_this();
+  auto resume = [weak_self]() {
+    if (auto session = weak_self.lock()) {
+      boost::asio::post(session->m_socket.get_executor(),
+                        [session]() { session->do_read_header(); });
+    }
+  };
+  bool queued =
+      view != nullptr
+          ? m_dispatcher.push(std::move(view), m_descriptor.length, work,
+                              resume)
+          : m_dispatcher.push(std::move(m_read_buffer), work, resume);
+  if (queued) {
+    do_read_header();
+  }
+}
+
+void TCPSession::check_handshake() {
+  auto handshake_check = std::move(m_handshake_check);
+  m_handshake_check = nullptr;
+
+  // Checked here rather than by the dispatcher, whose workers may handle the
+  // following messages first
+  TCPMessage message;
+  bool valid = false;
+  try {
+    valid = message.unpack(m_read_buffer) && handshake_check(message);
+  } catch (const std::exception& e) {
+    NGRAPH_ERR << "Server error checking handshake: " << e.what();
+  }
+  if (!valid) {
+    NGRAPH_HE_LOG(1) << "Server closing session with invalid handshake";
+    boost::system::error_code ec;
+    m_socket.shutdown(TransportSocket::shutdown_both, ec);
+    m_socket.close(ec);
+    return;
+  }
+  do_read_header();
+}
+
 void TCPSession::write_message(TCPMessage&& message) {
-  bool write_in_progress = is_writing();
-  m_message_queue.emplace_back(std::move(message));
-  if (!write_in_progress) {
-    do_write();
+  buffer_ptr buffer;
+  if (m_transport != TransportType::shared_memory) {
+    buffer = TCPWriteQueue::pack(message);
+  } else if (auto channel = std::atomic_load(&m_channel)) {
+    buffer = channel->pack(message);
+  } else {
+    // Written before the client sent the name of the channel
+    buffer = SharedMemoryChannel::pack_inline(message);
+  }
+  NGRAPH_HE_LOG(4) << "Server queueing message size " << buffer->size()
+                   << " bytes";
+  if (m_write_queue.push(std::move(buffer))) {
+    auto self(shared_from_this());
+    boost::asio::post(m_socket.get_executor(), [this, self]() { do_write(); });
   }
 }
 
 void TCPSession::do_write() {
-  std::lock_guard<std::mutex> lock(m_write_mtx);
-  m_is_writing.notify_all();
-  auto self(shared_from_this());
-  auto message = m_message_queue.front();
-  message.pack(m_write_buffer);
-  NGRAPH_HE_LOG(4) << "Server writing message size " << m_write_buffer.size()
-                   << " bytes";
+  if (m_transport == TransportType::shared_memory && !m_handshake_read) {
+    // Wait for the client to send the name of the channel
+    m_write_deferred = true;
+    return;
+  }
+  // With shared memory, the buffers hold the descriptors of the messages,
+  // followed by the messages written inline
+  auto batch = m_write_queue.take_batch();
+  if (batch.empty()) {
+    return;
+  }
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(batch.size());
+  for (const auto& buffer : batch) {
+    buffers.emplace_back(boost::asio::buffer(*buffer));
+  }
+  NGRAPH_HE_LOG(4) << "Server writing " << batch.size() << " messages";
 
+  auto self(shared_from_this());
   boost::asio::async_write(
-      m_socket, boost::asio::buffer(m_write_buffer),
-      [this, self](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(!ec, "Server error writing message: ", ec.message());
-        m_message_queue.pop_front();
-        if (!m_message_queue.empty()) {
-          do_write();
-        } else {
-          m_is_writing.notify_all();
+      m_socket, buffers,
+      [this, self, batch = std::move(batch)](boost::system::error_code ec,
+                                             std::size_t /* length */) {
+        if (ec) {
+          m_write_queue.fail(ec.message());
         }
+        NGRAPH_CHECK(!ec, "Server error writing message: ", ec.message());
+        m_write_queue.finish_batch(batch.size());
+        do_write();
       });
 }
 
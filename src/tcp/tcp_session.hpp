@@ -16,62 +16,122 @@
 
 #pragma once
 
-#include <deque>
+#include <atomic>
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_dispatcher.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
+#include "tcp/tcp_write_queue.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing a session over TCP
+/// \brief Class representing a session over TCP, a Unix-domain socket, or
+/// shared memory
 class TCPSession : public std::enable_shared_from_this<TCPSession> {
   using data_buffer = TCPMessage::data_buffer;
+  using buffer_ptr = TCPWriteQueue::buffer_ptr;
   size_t header_length = TCPMessage::header_length;
 
  public:
   /// \brief Constructs a session with a given message handler
-  TCPSession(boost::asio::ip::tcp::socket socket,
-             const std::function<void(const TCPMessage&)>& message_handler);
+  /// \param[in] socket Connected socket
+  /// \param[in] message_handler Function to handle messages from the client.
+  /// Called from a pool of worker threads, not the I/O thread
+  /// \param[in] worker_count Number of threads handling messages
+  /// \param[in] transport Transport of the socket. With shared memory, the
+  /// client first sends the name of the SharedMemoryChannel to open, or an
+  /// empty name if the session shares the channel of another session, see
+  /// set_channel()
+  TCPSession(TransportSocket socket,
+             const std::function<void(const TCPMessage&)>& message_handler,
+             size_t worker_count = TCPMessageDispatcher::default_worker_count,
+             TransportType transport = TransportType::tcp);
+
+  /// \brief Sets a check of the first message, e.g. a session token. The
+  /// check runs on the I/O thread before the next message is read, and the
+  /// first message doesn't reach the message handler. If the check fails,
+  /// the session is closed. Call before start()
+  /// \param[in] handshake_check Returns whether the first message is valid
+  void set_handshake_check(
+      std::function<bool(const TCPMessage&)> handshake_check);
 
   /// \brief Start the session
-  void start() { do_read_header(); }
+  void start();
 
-  /// \brief Reads a header
+  /// \brief Reads a header. With shared memory, reads the descriptor of the
+  /// next message instead
   void do_read_header();
 
-  /// \brief Reads message body of specified length
+  /// \brief Reads message body of specified length, and hands the message to
+  /// the dispatcher
   /// \param[in] body_length Number of bytes to read
   void do_read_body(size_t body_length);
 
-  /// \brief Adds a message to the message-writing queue
+  /// \brief Adds a message to the message-writing queue. Safe to call from
+  /// any thread. The message is packed on the calling thread
   /// \param[in,out] message Message to write
   void write_message(TCPMessage&& message);
 
   /// \brief Returns whether or not a message is queued to be written
-  bool is_writing() const { return !m_message_queue.empty(); }
+  bool is_writing() const { return m_write_queue.is_writing(); }
 
-  /// \brief Returns a condition variable notified when the session is done
-  /// writing a message
-  std::condition_variable& is_writing_cond() { return m_is_writing; }
+  /// \brief Blocks until all queued messages have been written
+  void wait_until_written() { m_write_queue.wait_until_written(); }
+
+  /// \brief Returns the shared-memory channel the client opened. Null for
+  /// other transports, or before the channel is open
+  std::shared_ptr<SharedMemoryChannel> channel() const {
+    return std::atomic_load(&m_channel);
+  }
+
+  /// \brief Passes messages through the given channel, e.g. that of the
+  /// first connection of the client, if the client sent an empty channel
+  /// name. Call on the I/O thread, e.g. from the handshake check
+  /// \param[in] channel Channel to share
+  void set_channel(std::shared_ptr<SharedMemoryChannel> channel) {
+    std::atomic_store(&m_channel, std::move(channel));
+  }
 
  private:
+  void do_read_handshake();
+
+  void finish_handshake(std::shared_ptr<SharedMemoryChannel> channel);
+
+  void do_read_descriptor();
+
+  void do_read_socket_header();
+
+  void dispatch_message(SharedMemoryChannel::View view = nullptr);
+
+  void check_handshake();
+
   void do_write();
 
  private:
-  std::deque<TCPMessage> m_message_queue;
-  TCPMessage m_read_message;
+  TCPWriteQueue m_write_queue;
 
   data_buffer m_read_buffer;
-  data_buffer m_write_buffer;
-  boost::asio::ip::tcp::socket m_socket;
-  std::condition_variable m_is_writing;
-  std::mutex m_write_mtx;
+  TransportSocket m_socket;
+
+  TransportType m_transport;
+  // Accessed atomically, since writers pack into it on their own thread
+  std::shared_ptr<SharedMemoryChannel> m_channel;
+  SharedMemoryChannel::Descriptor m_descriptor{};
+  bool m_handshake_read{false};
+  bool m_write_deferred{false};
+  std::function<bool(const TCPMessage&)> m_handshake_check;
 
   inline static std::string s_expected_teardown_message{"End of file"};
 
-  std::function<void(const TCPMessage&)> m_message_callback;
+  // Declared last, so the workers are joined before the other members are
+  // destroyed
+  TCPMessageDispatcher m_dispatcher;
 };
 }  // namespace ngraph::runtime::he
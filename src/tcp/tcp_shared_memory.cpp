@@ -0,0 +1,332 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/tcp_shared_memory.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+constexpr uint64_t channel_magic = 0x6e6768655f73686dULL;  // "nghe_shm"
+constexpr size_t page_size = 4096;
+const std::string channel_prefix{"ngraph-he-"};
+
+/// \brief Directory holding channel files: /dev/shm, or the temporary
+/// directory if /dev/shm is unavailable
+std::filesystem::path channel_directory() {
+  std::filesystem::path directory{"/dev/shm"};
+  if (!std::filesystem::is_directory(directory)) {
+    directory = std::filesystem::temp_directory_path();
+  }
+  return directory;
+}
+}  // namespace
+
+/// \brief Header at the start of the mapped file. Ring 0 carries messages
+/// from the creator (client) to the server, ring 1 from the server back.
+/// Each counter sits on its own cache line, since the two processes update
+/// them concurrently
+struct SharedMemoryChannel::Layout {
+  struct Ring {
+    alignas(64) std::atomic<uint64_t> head;  // Bytes written by the producer
+    alignas(64) std::atomic<uint64_t> tail;  // Bytes released by the consumer
+  };
+
+  uint64_t magic;
+  uint64_t ring_capacity;
+  Ring rings[2];
+
+  static size_t data_offset() {
+    return (sizeof(Layout) + page_size - 1) / page_size * page_size;
+  }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory rings require lock-free 64-bit atomics");
+
+std::shared_ptr<SharedMemoryChannel> SharedMemoryChannel::create(
+    size_t ring_capacity) {
+  NGRAPH_CHECK(ring_capacity > 0, "Ring capacity must be positive");
+
+  static std::atomic<size_t> channel_count{0};
+  std::string name =
+      (channel_directory() / (channel_prefix + std::to_string(getpid()) + "-" +
+                    std::to_string(channel_count++)))
+          .string();
+
+  int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  NGRAPH_CHECK(fd >= 0, "Error creating shared memory ", name, ": ",
+               std::strerror(errno));
+
+  size_t mapping_size = Layout::data_offset() + 2 * ring_capacity;
+  // Allocate up front, so a full file system fails here rather than raising
+  // SIGBUS on a later write to the mapping
+  int error = posix_fallocate(fd, 0, static_cast<off_t>(mapping_size));
+  if (error != 0) {
+    ::close(fd);
+    ::unlink(name.c_str());
+    NGRAPH_CHECK(false, "Error allocating ", mapping_size,
+                 " bytes of shared memory in ", name, ": ",
+                 std::strerror(error));
+  }
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    error = errno;
+    ::close(fd);
+    ::unlink(name.c_str());
+    NGRAPH_CHECK(false, "Error mapping shared memory ", name, ": ",
+                 std::strerror(error));
+  }
+
+  auto* layout = new (mapping) Layout;
+  layout->ring_capacity = ring_capacity;
+  for (auto& ring : layout->rings) {
+    ring.head.store(0, std::memory_order_relaxed);
+    ring.tail.store(0, std::memory_order_relaxed);
+  }
+  // Publish the magic number last, so the server never sees a partially
+  // initialized layout
+  std::atomic_thread_fence(std::memory_order_release);
+  layout->magic = channel_magic;
+
+  NGRAPH_HE_LOG(3) << "Created shared memory channel " << name << " with "
+                   << ring_capacity << " bytes per ring";
+  return std::shared_ptr<SharedMemoryChannel>(
+      new SharedMemoryChannel(name, true, fd, mapping, mapping_size));
+}
+
+std::shared_ptr<SharedMemoryChannel> SharedMemoryChannel::open(
+    const std::string& name) {
+  // Only open files created by SharedMemoryChannel::create, since the server
+  // writes to, and removes, the file named by the client. The name must match
+  // the one create() builds exactly, so it can't reach another directory
+  // through ".." or a symbolic link
+  std::string filename = std::filesystem::path(name).filename().string();
+  NGRAPH_CHECK(filename.rfind(channel_prefix, 0) == 0 &&
+                   name == (channel_directory() / filename).string(),
+               "Invalid shared memory name ", name);
+
+  int fd = ::open(name.c_str(), O_RDWR | O_NOFOLLOW);
+  NGRAPH_CHECK(fd >= 0, "Error opening shared memory ", name, ": ",
+               std::strerror(errno));
+
+  struct stat file_stat {};
+  // The owner check rejects files planted by other users, who could
+  // otherwise make the server write to, or remove, files they can't access
+  if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) ||
+      file_stat.st_uid != geteuid() ||
+      static_cast<size_t>(file_stat.st_size) < Layout::data_offset()) {
+    ::close(fd);
+    NGRAPH_CHECK(false, "Invalid shared memory file ", name);
+  }
+  auto mapping_size = static_cast<size_t>(file_stat.st_size);
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    int error = errno;
+    ::close(fd);
+    NGRAPH_CHECK(false, "Error mapping shared memory ", name, ": ",
+                 std::strerror(error));
+  }
+
+  const auto* layout = static_cast<const Layout*>(mapping);
+  bool valid = layout->magic == channel_magic &&
+               Layout::data_offset() + 2 * layout->ring_capacity ==
+                   mapping_size;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!valid) {
+    munmap(mapping, mapping_size);
+    ::close(fd);
+    NGRAPH_CHECK(false, "Invalid shared memory file ", name);
+  }
+  ::unlink(name.c_str());
+
+  NGRAPH_HE_LOG(3) << "Opened shared memory channel " << name;
+  return std::shared_ptr<SharedMemoryChannel>(
+      new SharedMemoryChannel(name, false, fd, mapping, mapping_size));
+}
+
+SharedMemoryChannel::SharedMemoryChannel(std::string name, bool is_creator,
+                                         int fd, void* mapping,
+                                         size_t mapping_size)
+    : m_name(std::move(name)),
+      m_is_creator(is_creator),
+      m_fd(fd),
+      m_mapping(mapping),
+      m_mapping_size(mapping_size) {
+  auto* layout = static_cast<Layout*>(m_mapping);
+  m_ring_capacity = layout->ring_capacity;
+
+  char* data = static_cast<char*>(m_mapping) + Layout::data_offset();
+  size_t send_ring = m_is_creator ? 0 : 1;
+  size_t receive_ring = 1 - send_ring;
+  m_send_data = data + send_ring * m_ring_capacity;
+  m_receive_data = data + receive_ring * m_ring_capacity;
+  m_send_head = &layout->rings[send_ring].head;
+  m_send_tail = &layout->rings[send_ring].tail;
+  m_receive_head = &layout->rings[receive_ring].head;
+  m_receive_tail = &layout->rings[receive_ring].tail;
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+  munmap(m_mapping, m_mapping_size);
+  ::close(m_fd);
+  if (m_is_creator) {
+    // Usually already removed by the server
+    ::unlink(m_name.c_str());
+  }
+}
+
+uint64_t SharedMemoryChannel::message_offset(uint64_t offset,
+                                             uint64_t length) const {
+  // Messages are contiguous, so skip the end of the ring if the message does
+  // not fit before it
+  uint64_t position = offset % m_ring_capacity;
+  if (position + length > m_ring_capacity) {
+    return offset + m_ring_capacity - position;
+  }
+  return offset;
+}
+
+std::optional<uint64_t> SharedMemoryChannel::reserve(size_t length) {
+  std::lock_guard<std::mutex> guard(m_send_mutex);
+  uint64_t head = m_send_head->load(std::memory_order_relaxed);
+  uint64_t tail = m_send_tail->load(std::memory_order_acquire);
+  uint64_t end = message_offset(head, length) + length;
+  if (end - tail > m_ring_capacity) {
+    return std::nullopt;
+  }
+  m_send_head->store(end, std::memory_order_release);
+  return head;
+}
+
+SharedMemoryChannel::buffer_ptr SharedMemoryChannel::pack(
+    TCPMessage& message) {
+  size_t length = message.packed_size();
+  std::optional<uint64_t> offset;
+  if (length <= m_ring_capacity) {
+    offset = reserve(length);
+  }
+  if (!offset.has_value()) {
+    return pack_inline(message);
+  }
+  // Other writers fill the space before and after the message concurrently
+  char* data = m_send_data + message_offset(offset.value(), length) %
+                                 m_ring_capacity;
+  NGRAPH_CHECK(message.pack(data, length), "Error packing message");
+  // Orders the message before its descriptor, which the peer reads from the
+  // socket before reading the message
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Descriptor descriptor{offset.value(), length};
+  auto buffer = std::make_shared<data_buffer>(descriptor_length);
+  std::memcpy(buffer->data(), &descriptor, descriptor_length);
+  return buffer;
+}
+
+SharedMemoryChannel::buffer_ptr SharedMemoryChannel::pack_inline(
+    TCPMessage& message) {
+  size_t length = message.packed_size();
+  auto buffer = std::make_shared<data_buffer>(descriptor_length + length);
+  Descriptor descriptor{inline_offset, length};
+  std::memcpy(buffer->data(), &descriptor, descriptor_length);
+  NGRAPH_CHECK(message.pack(buffer->data() + descriptor_length, length),
+               "Error packing message");
+  return buffer;
+}
+
+SharedMemoryChannel::View SharedMemoryChannel::receive(
+    const Descriptor& descriptor) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t head = m_receive_head->load(std::memory_order_acquire);
+
+  std::lock_guard<std::mutex> guard(m_receive_mutex);
+  uint64_t tail = m_receive_tail->load(std::memory_order_relaxed);
+  bool valid = descriptor.length >= TCPMessage::header_length &&
+               descriptor.length <= m_ring_capacity &&
+               descriptor.offset >= tail && descriptor.offset <= head;
+  uint64_t start = 0;
+  uint64_t end = 0;
+  if (valid) {
+    start = message_offset(descriptor.offset, descriptor.length);
+    end = start + descriptor.length;
+    // The space must not overlap the space of a message received before
+    auto next = m_received.lower_bound(descriptor.offset);
+    valid = end <= head &&
+            (next == m_received.end() || next->first >= end) &&
+            (next == m_received.begin() ||
+             std::prev(next)->second.first <= descriptor.offset);
+  }
+  NGRAPH_CHECK(valid, "Invalid shared memory descriptor (offset ",
+               descriptor.offset, ", length ", descriptor.length, ")");
+
+  const char* data = m_receive_data + start % m_ring_capacity;
+  size_t body_length = 0;
+  std::memcpy(&body_length, data, TCPMessage::header_length);
+  NGRAPH_CHECK(body_length + TCPMessage::header_length == descriptor.length,
+               "Shared memory message length mismatch");
+
+  m_received.emplace(descriptor.offset, std::make_pair(end, false));
+  // The view keeps the mapping alive until it is released, e.g. by a worker
+  // thread of the message dispatcher
+  auto self = shared_from_this();
+  return View(data, [self, offset = descriptor.offset](const char*) {
+    self->release(offset);
+  });
+}
+
+void SharedMemoryChannel::release(uint64_t offset) {
+  std::lock_guard<std::mutex> guard(m_receive_mutex);
+  auto it = m_received.find(offset);
+  if (it == m_received.end()) {
+    return;
+  }
+  it->second.second = true;
+
+  // The writer reuses the space once every message before it was released
+  uint64_t tail = m_receive_tail->load(std::memory_order_relaxed);
+  uint64_t new_tail = tail;
+  for (it = m_received.begin();
+       it != m_received.end() && it->first == new_tail && it->second.second;
+       it = m_received.erase(it)) {
+    new_tail = it->second.first;
+  }
+  if (new_tail != tail) {
+    m_receive_tail->store(new_tail, std::memory_order_release);
+  }
+}
+
+}  // namespace ngraph::runtime::he
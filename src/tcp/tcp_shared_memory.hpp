@@ -0,0 +1,162 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "tcp/tcp_message.hpp"
+#include "tcp/tcp_write_queue.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Pair of byte rings in a memory-mapped file, one per direction,
+/// shared by a client and a server on the same host.
+///
+/// Writers serialize a message straight into the sending ring, and only a
+/// small Descriptor with its offset and length is written to the socket. The
+/// receiver hands a view of the message in its ring to the message handler,
+/// and the space is released once the view is dropped. Messages are parsed
+/// from the ring, so neither side copies them through an intermediate
+/// buffer. Messages which don't fit into the free space of a ring are
+/// written inline on the socket after their descriptor.
+///
+/// Any thread may write into the sending ring, and views may be released in
+/// any order. The client creates the channel and sends its name to the
+/// server, which opens it and removes the file, so no file outlives the
+/// connection.
+class SharedMemoryChannel
+    : public std::enable_shared_from_this<SharedMemoryChannel> {
+ public:
+  using data_buffer = TCPMessage::data_buffer;
+  using buffer_ptr = TCPWriteQueue::buffer_ptr;
+
+  /// \brief Location of a message in the sending ring
+  struct Descriptor {
+    /// \brief Offset of the space reserved for the message, counted in bytes
+    /// ever reserved in the ring. If the message does not fit before the end
+    /// of the ring, it starts at the beginning of the ring, and the space
+    /// includes the skipped end. inline_offset if the message follows on the
+    /// socket
+    uint64_t offset;
+    /// \brief Length of the packed message, including its header
+    uint64_t length;
+  };
+
+  /// \brief Number of bytes a descriptor takes on the socket
+  static constexpr size_t descriptor_length = sizeof(Descriptor);
+
+  /// \brief Descriptor offset of a message written inline on the socket
+  static constexpr uint64_t inline_offset =
+      std::numeric_limits<uint64_t>::max();
+
+  /// \brief Default capacity of each ring in bytes
+  static constexpr size_t default_ring_capacity = 128 * 1024 * 1024;
+
+  /// \brief Packed message in the receiving ring. Its space is released once
+  /// the last copy of the view is dropped
+  using View = std::shared_ptr<const char>;
+
+  /// \brief Creates a new channel backed by a file in /dev/shm, or in the
+  /// temporary directory if /dev/shm is unavailable. Called by the client
+  /// \param[in] ring_capacity Capacity of each ring in bytes
+  /// \throws ngraph_error if the file cannot be created or allocated
+  static std::shared_ptr<SharedMemoryChannel> create(
+      size_t ring_capacity = default_ring_capacity);
+
+  /// \brief Opens a channel created by the peer and removes its file. Called
+  /// by the server. The file must lie in the directory create() uses and be
+  /// owned by the calling user
+  /// \param[in] name Name of the channel, as returned by name()
+  /// \throws ngraph_error if name does not refer to a valid channel
+  static std::shared_ptr<SharedMemoryChannel> open(const std::string& name);
+
+  ~SharedMemoryChannel();
+
+  SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+  SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+  /// \brief Returns the name of the channel, to send to the peer
+  const std::string& name() const { return m_name; }
+
+  /// \brief Returns the capacity of each ring in bytes
+  size_t ring_capacity() const { return m_ring_capacity; }
+
+  /// \brief Packs a message into the sending ring. Safe to call from any
+  /// thread
+  /// \param[in] message Message to pack
+  /// \returns Bytes to write to the socket: the descriptor of the message,
+  /// or, if the ring has no room for it, the descriptor followed by the
+  /// message, see pack_inline()
+  buffer_ptr pack(TCPMessage& message);
+
+  /// \brief Packs a message to write inline on the socket after its
+  /// descriptor. Safe to call from any thread
+  /// \param[in] message Message to pack
+  /// \returns Bytes to write to the socket
+  static buffer_ptr pack_inline(TCPMessage& message);
+
+  /// \brief Returns a view of a message in the receiving ring. Called on the
+  /// I/O thread, in the order descriptors arrive
+  /// \param[in] descriptor Descriptor read from the socket
+  /// \returns View of the header and body of the message, of
+  /// descriptor.length bytes
+  /// \throws ngraph_error if the descriptor is invalid
+  View receive(const Descriptor& descriptor);
+
+ private:
+  struct Layout;
+
+  SharedMemoryChannel(std::string name, bool is_creator, int fd, void* mapping,
+                      size_t mapping_size);
+
+  uint64_t message_offset(uint64_t offset, uint64_t length) const;
+
+  std::optional<uint64_t> reserve(size_t length);
+
+  void release(uint64_t offset);
+
+  std::string m_name;
+  bool m_is_creator;
+  int m_fd;
+  void* m_mapping;
+  size_t m_mapping_size;
+  size_t m_ring_capacity;
+
+  char* m_send_data;
+  char* m_receive_data;
+  std::atomic<uint64_t>* m_send_head;
+  std::atomic<uint64_t>* m_send_tail;
+  std::atomic<uint64_t>* m_receive_head;
+  std::atomic<uint64_t>* m_receive_tail;
+
+  // Serializes reserving space in the sending ring
+  std::mutex m_send_mutex;
+
+  // Space of the messages received but not yet passed by the tail of the
+  // receiving ring, by offset: its end, and whether or not it was released
+  std::mutex m_receive_mutex;
+  std::map<uint64_t, std::pair<uint64_t, bool>> m_received;
+};
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,107 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#include "tcp/tcp_transport.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+
+namespace ngraph::runtime::he {
+TransportAddress::TransportAddress(std::string hostname, size_t port)
+    : m_type{TransportType::tcp},
+      m_hostname{std::move(hostname)},
+      m_port{port} {}
+
+TransportAddress TransportAddress::parse(const std::string& uri) {
+  const std::string separator{"://"};
+  size_t scheme_end = uri.find(separator);
+  NGRAPH_CHECK(scheme_end != std::string::npos, "Invalid URI ", uri,
+               " (expected scheme://address)");
+  std::string scheme = uri.substr(0, scheme_end);
+  std::string address = uri.substr(scheme_end + separator.size());
+
+  TransportAddress result;
+  if (scheme == "unix" || scheme == "shm") {
+    NGRAPH_CHECK(!address.empty() && address[0] == '/', "Invalid URI ", uri,
+                 " (expected absolute socket path)");
+    result.m_type = scheme == "unix" ? TransportType::unix_socket
+                                     : TransportType::shared_memory;
+    result.m_path = address;
+    return result;
+  }
+  NGRAPH_CHECK(scheme == "tcp", "Invalid URI scheme ", scheme,
+               " (expected tcp, unix, or shm)");
+
+  size_t port_start = address.rfind(':');
+  NGRAPH_CHECK(port_start != std::string::npos && port_start > 0 &&
+                   port_start + 1 < address.size(),
+               "Invalid URI ", uri, " (expected tcp://hostname:port)");
+  std::string hostname = address.substr(0, port_start);
+  // Strip brackets around IPv6 addresses, i.e. "[::1]" => "::1"
+  if (hostname.size() > 2 && hostname.front() == '[' &&
+      hostname.back() == ']') {
+    hostname = hostname.substr(1, hostname.size() - 2);
+  }
+  std::string port_str = address.substr(port_start + 1);
+  NGRAPH_CHECK(
+      port_str.find_first_not_of("0123456789") == std::string::npos &&
+          port_str.size() <= 5 && std::stoul(port_str) <= 65535,
+      "Invalid port ", port_str, " in URI ", uri);
+
+  result.m_type = TransportType::tcp;
+  result.m_hostname = hostname;
+  result.m_port = std::stoul(port_str);
+  return result;
+}
+
+std::string TransportAddress::uri() const {
+  switch (m_type) {
+    case TransportType::tcp:
+      if (m_hostname.find(':') != std::string::npos) {
+        return "tcp://[" + m_hostname + "]:" + std::to_string(m_port);
+      }
+      return "tcp://" + m_hostname + ":" + std::to_string(m_port);
+    case TransportType::unix_socket:
+      return "unix://" + m_path;
+    case TransportType::shared_memory:
+      return "shm://" + m_path;
+  }
+  throw ngraph_error("Unknown transport type");
+}
+
+std::vector<TransportEndpoint> TransportAddress::resolve(
+    boost::asio::io_context& io_context) const {
+  std::vector<TransportEndpoint> endpoints;
+  if (is_local()) {
+    endpoints.emplace_back(
+        boost::asio::local::stream_protocol::endpoint(m_path));
+    return endpoints;
+  }
+  boost::asio::ip::tcp::resolver resolver(io_context);
+  for (const auto& entry :
+       resolver.resolve(m_hostname, std::to_string(m_port))) {
+    endpoints.emplace_back(entry.endpoint());
+  }
+  return endpoints;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,98 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "boost/asio.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Transport carrying messages between the client and the server
+enum class TransportType {
+  /// \brief TCP socket
+  tcp,
+  /// \brief Unix-domain socket, for a client on the same host as the server
+  unix_socket,
+  /// \brief Unix-domain socket for control, with message payloads passed
+  /// through shared-memory ring buffers
+  shared_memory
+};
+
+/// \brief Socket used by TCPSession and TCPClient for every transport
+using TransportSocket = boost::asio::generic::stream_protocol::socket;
+
+/// \brief Acceptor used by the server for every transport
+using TransportAcceptor =
+    boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol>;
+
+/// \brief Endpoint of a TransportSocket
+using TransportEndpoint = boost::asio::generic::stream_protocol::endpoint;
+
+/// \brief Address of a server. Parsed from a URI of one of the forms
+///     1) tcp://hostname:port
+///     2) unix:///path/to/socket
+///     3) shm:///path/to/socket
+class TransportAddress {
+ public:
+  /// \brief Default server URI
+  inline static const std::string default_uri{"tcp://0.0.0.0:34000"};
+
+  /// \brief Constructs a TCP address
+  /// \param[in] hostname Hostname of the server
+  /// \param[in] port Port of the server
+  TransportAddress(std::string hostname, size_t port);
+
+  /// \brief Parses an address from a URI
+  /// \param[in] uri URI of the server
+  /// \throws ngraph_error if the URI is malformed
+  static TransportAddress parse(const std::string& uri);
+
+  /// \brief Returns the transport type
+  TransportType type() const { return m_type; }
+
+  /// \brief Returns the hostname of a TCP address
+  const std::string& hostname() const { return m_hostname; }
+
+  /// \brief Returns the port of a TCP address
+  size_t port() const { return m_port; }
+
+  /// \brief Returns the socket path of a Unix-domain or shared-memory address
+  const std::string& path() const { return m_path; }
+
+  /// \brief Returns whether or not the address uses a Unix-domain socket
+  bool is_local() const { return m_type != TransportType::tcp; }
+
+  /// \brief Returns the address as a URI
+  std::string uri() const;
+
+  /// \brief Resolves the address to the endpoints to connect or bind to
+  /// \param[in] io_context Context used to resolve TCP hostnames
+  std::vector<TransportEndpoint> resolve(
+      boost::asio::io_context& io_context) const;
+
+ private:
+  TransportAddress() = default;
+
+  TransportType m_type{TransportType::tcp};
+  std::string m_hostname;
+  size_t m_port{0};
+  std::string m_path;
+};
+}  // namespace ngraph::runtime::he
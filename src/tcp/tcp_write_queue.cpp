@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/tcp_write_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+TCPWriteQueue::TCPWriteQueue(size_t max_gathered_messages,
+                             size_t max_gathered_bytes)
+    : m_max_gathered_messages(std::max(max_gathered_messages, size_t(1))),
+      m_max_gathered_bytes(max_gathered_bytes) {}
+
+TCPWriteQueue::buffer_ptr TCPWriteQueue::pack(TCPMessage& message) {
+  auto buffer = std::make_shared<data_buffer>();
+  NGRAPH_CHECK(message.pack(*buffer), "Error packing message");
+  return buffer;
+}
+
+bool TCPWriteQueue::push(buffer_ptr buffer) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(!m_failed, "Cannot write message after error: ", m_error);
+  m_queue.emplace_back(std::move(buffer));
+  if (m_write_in_progress) {
+    return false;
+  }
+  m_write_in_progress = true;
+  return true;
+}
+
+std::vector<TCPWriteQueue::buffer_ptr> TCPWriteQueue::take_batch() {
+  std::vector<buffer_ptr> batch;
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(m_in_flight_count == 0, "Previous batch not finished");
+
+  size_t batch_bytes = 0;
+  while (!m_queue.empty() && batch.size() < m_max_gathered_messages) {
+    size_t buffer_bytes = m_queue.front()->size();
+    if (!batch.empty() && batch_bytes + buffer_bytes > m_max_gathered_bytes) {
+      break;
+    }
+    batch_bytes += buffer_bytes;
+    batch.emplace_back(std::move(m_queue.front()));
+    m_queue.pop_front();
+  }
+  m_in_flight_count = batch.size();
+  if (batch.empty()) {
+    m_write_in_progress = false;
+    m_written_cond.notify_all();
+  }
+  return batch;
+}
+
+void TCPWriteQueue::finish_batch(size_t batch_size) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(batch_size == m_in_flight_count, "Finished batch of size ",
+               batch_size, ", expected ", m_in_flight_count);
+  m_in_flight_count = 0;
+}
+
+void TCPWriteQueue::fail(const std::string& error) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (!m_failed) {
+    m_failed = true;
+    m_error = error;
+  }
+  m_queue.clear();
+  m_in_flight_count = 0;
+  m_write_in_progress = false;
+  m_written_cond.notify_all();
+}
+
+bool TCPWriteQueue::failed() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_failed;
+}
+
+bool TCPWriteQueue::is_writing() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_write_in_progress;
+}
+
+void TCPWriteQueue::wait_until_written() {
+  std::unique_lock<std::mutex> mlock(m_mutex);
+  m_written_cond.wait(mlock, [this]() { return !m_write_in_progress; });
+  NGRAPH_CHECK(!m_failed, "Error writing message: ", m_error);
+}
+
+size_t TCPWriteQueue::pending_message_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_queue.size() + m_in_flight_count;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Multi-producer, single-consumer queue of packed outgoing messages,
+/// shared by TCPSession and TCPClient.
+///
+/// Producers pack messages on their own thread and push the resulting buffers
+/// under a short lock. The I/O thread is the only consumer: it takes all
+/// queued buffers (up to a limit) at once and writes them with a single
+/// gathered write, so several messages are in flight per system call.
+class TCPWriteQueue {
+ public:
+  using data_buffer = TCPMessage::data_buffer;
+  using buffer_ptr = std::shared_ptr<const data_buffer>;
+
+  /// \brief Default maximum number of messages combined into one write
+  static constexpr size_t default_max_gathered_messages = 64;
+
+  /// \brief Default maximum number of bytes combined into one write. A single
+  /// larger message is still written on its own
+  static constexpr size_t default_max_gathered_bytes = 64 * 1024 * 1024;
+
+  /// \brief Constructs an empty write queue
+  /// \param[in] max_gathered_messages Maximum number of messages combined into
+  /// one write
+  /// \param[in] max_gathered_bytes Maximum number of bytes combined into one
+  /// write
+  explicit TCPWriteQueue(
+      size_t max_gathered_messages = default_max_gathered_messages,
+      size_t max_gathered_bytes = default_max_gathered_bytes);
+
+  /// \brief Packs a message into a newly-allocated buffer. Safe to call from
+  /// any thread
+  /// \param[in] message Message to pack
+  /// \returns Buffer storing the header and body of the message
+  static buffer_ptr pack(TCPMessage& message);
+
+  /// \brief Adds a packed message to the queue. Safe to call from any thread
+  /// \param[in] buffer Packed message
+  /// \returns True if no write is in progress, in which case the caller must
+  /// start one on the I/O thread
+  /// \throws ngraph::CheckFailure if a write failed before
+  bool push(buffer_ptr buffer);
+
+  /// \brief Removes the next batch of buffers to write. Called on the I/O
+  /// thread only
+  /// \returns Buffers to write with one gathered write. Empty if the queue is
+  /// empty, in which case no write is in progress anymore
+  std::vector<buffer_ptr> take_batch();
+
+  /// \brief Marks the current batch as written. Called on the I/O thread only
+  /// \param[in] batch_size Number of messages in the written batch
+  void finish_batch(size_t batch_size);
+
+  /// \brief Marks the queue as failed after a write error, dropping the
+  /// queued messages and waking the waiters. Called on the I/O thread only
+  /// \param[in] error Description of the write error
+  void fail(const std::string& error);
+
+  /// \brief Returns whether or not a write failed
+  bool failed() const;
+
+  /// \brief Returns whether or not any message is queued or being written
+  bool is_writing() const;
+
+  /// \brief Blocks until all queued messages have been written
+  /// \throws ngraph::CheckFailure if a write failed
+  void wait_until_written();
+
+  /// \brief Returns the number of messages queued or being written
+  size_t pending_message_count() const;
+
+ private:
+  size_t m_max_gathered_messages;
+  size_t m_max_gathered_bytes;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_written_cond;
+  std::deque<buffer_ptr> m_queue;
+  size_t m_in_flight_count{0};
+  bool m_write_in_progress{false};
+  bool m_failed{false};
+  std::string m_error;
+};
+}  // namespace ngraph::runtime::he
@@ -243,4 +243,40 @@ NGRAPH_TEST(${BACKEND_NAME}, add_wrong_output_type) {
   }
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, add_mixed_tensor) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{3};
+  bool packed = false;
+
+  auto mixed_tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, true, packed));
+  auto plain_tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, false, packed));
+  auto result_tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, false, packed));
+
+  copy_data(mixed_tensor, std::vector<float>{1, 2, 3});
+  copy_data(plain_tensor, std::vector<float>{10, 20, 30});
+  mixed_tensor->data(1).set_plaintext(HEPlaintext{2});
+
+  EXPECT_EQ(homogeneous_kind(mixed_tensor->data(), 3), HETypeKind::mixed);
+  EXPECT_EQ(homogeneous_kind(plain_tensor->data(), 3), HETypeKind::plaintext);
+
+  add_seal(mixed_tensor->data(), plain_tensor->data(), result_tensor->data(),
+           3, element::f32, *he_backend);
+  EXPECT_TRUE(result_tensor->data(0).is_ciphertext());
+  EXPECT_TRUE(result_tensor->data(1).is_plaintext());
+  EXPECT_TRUE(test::all_close(read_vector<float>(result_tensor),
+                              std::vector<float>{11, 22, 33}, 1e-3f));
+
+  add_seal(plain_tensor->data(), plain_tensor->data(), result_tensor->data(),
+           3, element::f32, *he_backend);
+  EXPECT_EQ(homogeneous_kind(result_tensor->data(), 3),
+            HETypeKind::plaintext);
+  EXPECT_TRUE(test::all_close(read_vector<float>(result_tensor),
+                              std::vector<float>{20, 40, 60}, 1e-3f));
+}
+
 }  // namespace ngraph::runtime::he
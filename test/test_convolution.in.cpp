@@ -17,6 +17,7 @@
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/convolution_seal.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -893,4 +894,68 @@ NGRAPH_TEST(${BACKEND_NAME},
       true, true, false, false);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, convolution_seal_range) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape data_shape{1, 1, 4, 4};
+  Shape filter_shape{2, 1, 2, 2};
+  Shape out_shape{1, 2, 3, 3};
+  size_t out_size = shape_size(out_shape);
+
+  for (bool encrypted : {false, true}) {
+    std::vector<HEType> data;
+    for (size_t i = 0; i < shape_size(data_shape); ++i) {
+      HEPlaintext plain{static_cast<double>(i % 5) - 2};
+      if (encrypted) {
+        auto cipher = HESealBackend::create_empty_ciphertext();
+        he_backend->encrypt(cipher, plain, element::f32, false);
+        data.emplace_back(cipher, false, 1);
+      } else {
+        data.emplace_back(plain, false);
+      }
+    }
+    std::vector<HEType> filter;
+    for (size_t i = 0; i < shape_size(filter_shape); ++i) {
+      filter.emplace_back(HEPlaintext{static_cast<double>(i % 3) - 1}, false);
+    }
+
+    auto convolve = [&](std::vector<HEType>& out, size_t begin, size_t end) {
+      convolution_seal(data, filter, out, data_shape, filter_shape, out_shape,
+                       Strides{1, 1}, Strides{1, 1}, CoordinateDiff{0, 0},
+                       CoordinateDiff{0, 0}, Strides{1, 1}, 0, 1, 1, 0, 0, 1,
+                       element::f32, 1, begin, end, *he_backend, false);
+    };
+    auto value = [&](const HEType& he_type) {
+      if (he_type.is_plaintext()) {
+        return he_type.get_plaintext()[0];
+      }
+      HEPlaintext plain;
+      he_backend->decrypt(plain, *he_type.get_ciphertext(), false);
+      return plain[0];
+    };
+
+    std::vector<HEType> full_out(out_size, HEType(HEPlaintext(), false));
+    convolve(full_out, 0, out_size);
+
+    // Tiles covering the output compute the same values as the full range
+    std::vector<HEType> tiled_out(out_size, HEType(HEPlaintext(), false));
+    for (size_t begin : {0, 5, 12}) {
+      size_t end = begin == 12 ? out_size : (begin == 0 ? 5 : 12);
+      convolve(tiled_out, begin, end);
+
+      // Elements past the tile are not computed yet
+      for (size_t i = end; i < out_size; ++i) {
+        EXPECT_TRUE(tiled_out[i].is_plaintext());
+        EXPECT_TRUE(tiled_out[i].get_plaintext().empty());
+      }
+    }
+    for (size_t i = 0; i < out_size; ++i) {
+      EXPECT_EQ(tiled_out[i].is_ciphertext(), encrypted);
+      EXPECT_NEAR(value(tiled_out[i]), value(full_out[i]), 1e-3);
+    }
+    EXPECT_ANY_THROW(convolve(tiled_out, 12, out_size + 1));
+  }
+}
+
 }  // namespace ngraph::runtime::he
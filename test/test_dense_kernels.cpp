@@ -0,0 +1,125 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <vector>
+
+#include "dense_kernels.hpp"
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(dense_kernels, elementwise) {
+  std::vector<double> arg0{1, -2, 3};
+  std::vector<double> arg1{2, 2, -1};
+  std::vector<double> out;
+
+  dense_add(arg0, arg1, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{3, 0, 2}));
+  dense_subtract(arg0, arg1, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{-1, -4, 4}));
+  dense_multiply(arg0, arg1, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{2, -4, -3}));
+  dense_divide(arg0, arg1, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{0.5, -1, -3}));
+  dense_minimum(arg0, arg1, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{1, -2, -1}));
+  dense_negate(arg0, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{-1, 2, -3}));
+  dense_relu(arg0, out);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{1, 0, 3}));
+  dense_bounded_relu(arg0, out, 2);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{1, 0, 2}));
+
+  EXPECT_ANY_THROW(dense_add(arg0, std::vector<double>{1}, out));
+}
+
+TEST(dense_kernels, dot) {
+  std::vector<double> arg0{1, 2, 3, 4, 5, 6};
+  std::vector<double> arg1{1, 0, -1, 2, 1, 1};
+  std::vector<double> out;
+
+  dense_dot(arg0, arg1, out, Shape{2, 3}, Shape{3, 2}, 1);
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{2, 7, 5, 16}));
+
+  // Scalar times tensor
+  dense_dot(std::vector<double>{2}, arg1, out, Shape{}, Shape{3, 2}, 0);
+  EXPECT_TRUE(
+      test::all_close(out, std::vector<double>{2, 0, -2, 4, 2, 2}));
+
+  EXPECT_ANY_THROW(
+      dense_dot(arg0, arg1, out, Shape{2, 3}, Shape{2, 3}, 1));
+}
+
+TEST(dense_kernels, convolution) {
+  // 1x1x3x3 data, 1x1x2x2 filter
+  std::vector<double> data{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<double> filter{1, 0, 0, -1};
+  std::vector<double> out;
+
+  dense_convolution(data, filter, out, Shape{1, 1, 3, 3}, Shape{1, 1, 2, 2},
+                    Shape{1, 1, 2, 2}, Strides{1, 1}, Strides{1, 1},
+                    CoordinateDiff{0, 0}, CoordinateDiff{0, 0},
+                    Strides{1, 1});
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{-4, -4, -4, -4}));
+
+  // Padding contributes zeros
+  dense_convolution(data, filter, out, Shape{1, 1, 3, 3}, Shape{1, 1, 2, 2},
+                    Shape{1, 1, 2, 2}, Strides{2, 2}, Strides{1, 1},
+                    CoordinateDiff{1, 1}, CoordinateDiff{0, 0},
+                    Strides{1, 1});
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{-1, -3, -7, -4}));
+}
+
+TEST(dense_kernels, pool) {
+  // 1x1x3x3 data, 2x2 windows with unit stride and one row of padding below
+  std::vector<double> data{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<double> out;
+
+  dense_max_pool(data, out, Shape{1, 1, 3, 3}, Shape{1, 1, 3, 2}, Shape{2, 2},
+                 Strides{1, 1}, Shape{1, 0}, Shape{0, 0});
+  EXPECT_TRUE(
+      test::all_close(out, std::vector<double>{2, 3, 5, 6, 8, 9}));
+
+  dense_avg_pool(data, out, Shape{1, 1, 3, 3}, Shape{1, 1, 3, 2},
+                 Shape{2, 2}, Strides{1, 1}, Shape{1, 0}, Shape{0, 0}, false);
+  EXPECT_TRUE(
+      test::all_close(out, std::vector<double>{1.5, 2.5, 3, 4, 6, 7}));
+
+  dense_avg_pool(data, out, Shape{1, 1, 3, 3}, Shape{1, 1, 3, 2},
+                 Shape{2, 2}, Strides{1, 1}, Shape{1, 0}, Shape{0, 0}, true);
+  EXPECT_TRUE(
+      test::all_close(out, std::vector<double>{0.75, 1.25, 3, 4, 6, 7}));
+}
+
+TEST(dense_kernels, broadcast_reshape) {
+  std::vector<double> out;
+
+  dense_broadcast(std::vector<double>{1, 2}, out, Shape{2}, Shape{2, 2, 3},
+                  AxisSet{0, 2});
+  EXPECT_TRUE(test::all_close(
+      out, std::vector<double>{1, 1, 1, 2, 2, 2, 1, 1, 1, 2, 2, 2}));
+
+  std::vector<double> arg{1, 2, 3, 4, 5, 6};
+  dense_reshape(arg, out, Shape{2, 3}, AxisVector{1, 0});
+  EXPECT_TRUE(test::all_close(out, std::vector<double>{1, 4, 2, 5, 3, 6}));
+  dense_reshape(arg, out, Shape{2, 3}, AxisVector{0, 1});
+  EXPECT_TRUE(test::all_close(out, arg));
+}
+
+}  // namespace ngraph::runtime::he
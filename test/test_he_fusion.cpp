@@ -17,6 +17,7 @@
 #include "ngraph/ngraph.hpp"
 #include "ngraph/pass/constant_folding.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 #include "pass/he_fusion.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "test_util.hpp"
@@ -114,4 +115,63 @@ TEST(he_fusion, bounded_relu_no_fusion) {
     check_no_fusion(f);
   }
 }
+
+TEST(he_fusion, relu_max_pool_fusion) {
+  Shape shape{2, 1, 6};
+  Shape window_shape{3};
+  auto make_function = [&](bool bounded) {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    std::shared_ptr<Node> relu = std::make_shared<op::Relu>(a);
+    if (bounded) {
+      auto alpha = op::Constant::create<float>(
+          element::f32, shape, std::vector<float>(shape_size(shape), 1.5f));
+      relu = std::make_shared<op::Minimum>(relu, alpha);
+    }
+    auto max_pool = std::make_shared<op::MaxPool>(relu, window_shape);
+    return std::make_shared<Function>(max_pool, ParameterVector{a});
+  };
+
+  std::vector<float> input{-1, 2, -3, 1, 0.5, -2, 4, -1, 3, -5, 1, 2};
+  for (bool bounded : {false, true}) {
+    auto he_f = make_function(bounded);
+    auto int_f = make_function(bounded);
+
+    auto he_backend = runtime::Backend::create("HE_SEAL");
+    auto he_handle = he_backend->compile(he_f);
+    EXPECT_EQ(1, count_ops_of_type<op::ReluMaxPool>(he_f));
+    EXPECT_EQ(0, count_ops_of_type<op::MaxPool>(he_f));
+
+    auto he_a = he_backend->create_tensor(element::f32, shape);
+    auto he_result = he_backend->create_tensor(
+        element::f32, he_f->get_output_shape(0));
+    copy_data(he_a, input);
+    he_handle->call_with_validate({he_result}, {he_a});
+
+    auto int_backend = runtime::Backend::create("INTERPRETER");
+    auto int_handle = int_backend->compile(int_f);
+    auto int_a = int_backend->create_tensor(element::f32, shape);
+    auto int_result = int_backend->create_tensor(
+        element::f32, int_f->get_output_shape(0));
+    copy_data(int_a, input);
+    int_handle->call_with_validate({int_result}, {int_a});
+
+    EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                                read_vector<float>(int_result), 1e-3f));
+  }
+}
+
+TEST(he_fusion, relu_max_pool_no_fusion) {
+  // Relu output is also a function output
+  Shape shape{1, 1, 6};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(a);
+  auto max_pool = std::make_shared<op::MaxPool>(relu, Shape{2});
+  auto f = std::make_shared<Function>(NodeVector{max_pool, relu},
+                                      ParameterVector{a});
+
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto handle = backend->compile(f);
+  EXPECT_EQ(0, count_ops_of_type<op::ReluMaxPool>(f));
+  EXPECT_EQ(1, count_ops_of_type<op::MaxPool>(f));
+}
 }  // namespace ngraph::runtime::he
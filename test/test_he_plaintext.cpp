@@ -115,10 +115,109 @@ TEST(he_plaintext, write) {
   ngraph_free(src);
 }
 
+TEST(he_plaintext, inline_storage) {
+  // Heap and single-precision storage overlay the inline values
+  EXPECT_LE(sizeof(HEPlaintext),
+            HEPlaintext::inline_capacity * sizeof(double) + 8);
+
+  HEPlaintext plain{1, 2};
+  EXPECT_TRUE(plain.is_inline());
+  EXPECT_EQ(plain.capacity(), HEPlaintext::inline_capacity);
+
+  plain.resize(HEPlaintext::inline_capacity, 3);
+  EXPECT_TRUE(plain.is_inline());
+  EXPECT_DOUBLE_EQ(plain.back(), 3.0);
+
+  plain.emplace_back(4);
+  EXPECT_FALSE(plain.is_inline());
+  EXPECT_EQ(plain.size(), HEPlaintext::inline_capacity + 1);
+  EXPECT_DOUBLE_EQ(plain[0], 1.0);
+  EXPECT_DOUBLE_EQ(plain[1], 2.0);
+  EXPECT_DOUBLE_EQ(plain.back(), 4.0);
+
+  HEPlaintext large(2 * HEPlaintext::inline_capacity, 5);
+  EXPECT_FALSE(large.is_inline());
+  large.resize(1);
+  EXPECT_EQ(large.size(), 1);
+  EXPECT_DOUBLE_EQ(large[0], 5.0);
+}
+
+TEST(he_plaintext, copy_move) {
+  for (size_t size : {size_t(1), 2 * HEPlaintext::inline_capacity}) {
+    HEPlaintext plain(size, 7);
+
+    HEPlaintext copy(plain);
+    EXPECT_EQ(copy, plain);
+    EXPECT_NE(copy.data(), plain.data());
+
+    HEPlaintext assigned{1};
+    assigned = plain;
+    EXPECT_EQ(assigned, plain);
+
+    HEPlaintext moved(std::move(copy));
+    EXPECT_EQ(moved, plain);
+    EXPECT_EQ(moved.is_inline(), plain.is_inline());
+
+    HEPlaintext move_assigned;
+    move_assigned = std::move(moved);
+    EXPECT_EQ(move_assigned, plain);
+
+    // Data pointer must refer to the object's own inline buffer
+    HEPlaintext small{3};
+    small = std::move(move_assigned);
+    EXPECT_EQ(small, plain);
+    small.emplace_back(8);
+    EXPECT_DOUBLE_EQ(small.back(), 8.0);
+  }
+}
+
 TEST(he_plaintext, ostream) {
   std::stringstream ss;
   HEPlaintext plain{1, 2, 3};
   EXPECT_NO_THROW(ss << plain);
 }
 
+TEST(he_plaintext, float_storage) {
+  HEPlaintext plain(2 * HEPlaintext::inline_capacity, 1.5);
+  plain[1] = 0.1;
+  plain.to_float();
+  EXPECT_TRUE(plain.is_float());
+  EXPECT_EQ(plain.size(), 2 * HEPlaintext::inline_capacity);
+
+  const HEPlaintext& const_plain = plain;
+  EXPECT_DOUBLE_EQ(const_plain[0], 1.5);
+  EXPECT_DOUBLE_EQ(const_plain[1], static_cast<double>(0.1f));
+  std::vector<double> values(const_plain.begin(), const_plain.end());
+  EXPECT_EQ(values.size(), plain.size());
+
+  // Copies are widened, moves keep single precision
+  HEPlaintext copy(plain);
+  EXPECT_FALSE(copy.is_float());
+  EXPECT_EQ(copy, plain);
+  copy = plain;
+  EXPECT_FALSE(copy.is_float());
+  EXPECT_EQ(copy, plain);
+  HEPlaintext moved(std::move(plain));
+  EXPECT_TRUE(moved.is_float());
+  EXPECT_EQ(moved, copy);
+
+  // Single-precision values are only modified after widening
+  EXPECT_ANY_THROW(moved.data());
+  EXPECT_ANY_THROW(moved[0] = 1);
+  EXPECT_ANY_THROW(moved.emplace_back(2));
+  EXPECT_ANY_THROW(moved.resize(1));
+  EXPECT_TRUE(moved.is_float());
+  moved.to_double();
+  EXPECT_FALSE(moved.is_float());
+  moved.emplace_back(2);
+  EXPECT_DOUBLE_EQ(moved[1], static_cast<double>(0.1f));
+  EXPECT_DOUBLE_EQ(moved.back(), 2.0);
+
+  // Inline values stay in double precision
+  HEPlaintext scalar{0.1};
+  scalar.to_float();
+  EXPECT_FALSE(scalar.is_float());
+  EXPECT_DOUBLE_EQ(scalar[0], 0.1);
+}
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,132 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_ciphertext_pool.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::shared_ptr<SealCiphertextWrapper> encrypt_value(HESealBackend& backend,
+                                                     double value) {
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  backend.encrypt(cipher, HEPlaintext{value}, element::f32, false);
+  return cipher;
+}
+}  // namespace
+
+TEST(he_seal_ciphertext_pool, acquire_empty) {
+  HESealCiphertextPool pool;
+  auto cipher = pool.acquire(seal::parms_id_zero);
+  ASSERT_NE(cipher, nullptr);
+  EXPECT_EQ(cipher->ciphertext().size(), 0);
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.acquired, 1);
+  EXPECT_EQ(stats.reused, 0);
+  EXPECT_EQ(stats.size, 0);
+}
+
+TEST(he_seal_ciphertext_pool, reuse) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  HESealCiphertextPool pool;
+  auto cipher = encrypt_value(*he_backend, 1);
+  const SealCiphertextWrapper* raw_cipher = cipher.get();
+
+  pool.release(cipher);
+  EXPECT_EQ(cipher, nullptr);
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.released, 1);
+  EXPECT_EQ(stats.size, 1);
+  EXPECT_GT(stats.bytes, 0);
+
+  auto reused = pool.acquire(he_backend->get_context()->first_parms_id());
+  EXPECT_EQ(reused.get(), raw_cipher);
+  stats = pool.stats();
+  EXPECT_EQ(stats.reused, 1);
+  EXPECT_EQ(stats.size, 0);
+  EXPECT_EQ(stats.bytes, 0);
+  EXPECT_DOUBLE_EQ(stats.reuse_rate(), 1.0);
+}
+
+TEST(he_seal_ciphertext_pool, not_pooled) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  HESealCiphertextPool pool;
+
+  // Shared ciphertexts are still in use
+  auto cipher = encrypt_value(*he_backend, 1);
+  auto copy = cipher;
+  pool.release(cipher);
+  EXPECT_NE(cipher, nullptr);
+
+  // Empty ciphertexts hold no buffer
+  auto empty = HESealBackend::create_empty_ciphertext();
+  pool.release(empty);
+  EXPECT_NE(empty, nullptr);
+  EXPECT_EQ(pool.stats().size, 0);
+
+  // Ciphertexts beyond the byte limit are freed
+  HESealCiphertextPool limited_pool(0);
+  copy = nullptr;
+  limited_pool.release(cipher);
+  EXPECT_NE(cipher, nullptr);
+  EXPECT_EQ(limited_pool.stats().size, 0);
+}
+
+TEST(he_seal_ciphertext_pool, matching_bucket) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  HESealCiphertextPool pool;
+  auto small = encrypt_value(*he_backend, 1);
+  he_backend->get_evaluator()->mod_switch_to_next_inplace(small->ciphertext());
+  auto large = encrypt_value(*he_backend, 2);
+  const SealCiphertextWrapper* raw_small = small.get();
+  const SealCiphertextWrapper* raw_large = large.get();
+  seal::parms_id_type small_parms_id = small->ciphertext().parms_id();
+  seal::parms_id_type large_parms_id = large->ciphertext().parms_id();
+
+  pool.release(large);
+  pool.release(small);
+  EXPECT_EQ(pool.stats().size, 2);
+
+  // Ciphertexts come from the bucket of the requested parameters and size
+  EXPECT_EQ(pool.acquire(small_parms_id, 3)->ciphertext().size(), 0);
+  EXPECT_EQ(pool.acquire(small_parms_id).get(), raw_small);
+  EXPECT_EQ(pool.acquire(small_parms_id)->ciphertext().size(), 0);
+  EXPECT_EQ(pool.stats().size, 1);
+
+  auto cipher = pool.acquire(large_parms_id);
+  EXPECT_EQ(cipher.get(), raw_large);
+  EXPECT_EQ(cipher->ciphertext().parms_id(), large_parms_id);
+  EXPECT_EQ(pool.stats().reused, 2);
+
+  pool.release(cipher);
+  pool.clear();
+  EXPECT_EQ(pool.stats().size, 0);
+  EXPECT_EQ(pool.stats().bytes, 0);
+}
+
+}  // namespace ngraph::runtime::he
@@ -14,13 +14,16 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <filesystem>
 #include <sstream>
 #include <unordered_set>
 
 #include "gtest/gtest.h"
 #include "ngraph/ngraph.hpp"
+#include "protos/message.pb.h"
 #include "seal/he_seal_executable.hpp"
 #include "seal/seal.h"
+#include "seal/seal_util.hpp"
 #include "test_util.hpp"
 #include "util/test_tools.hpp"
 
@@ -270,4 +273,368 @@ TEST(he_seal_executable, provenance_tag) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
 }
 
+TEST(he_seal_executable, galois_keys_on_demand) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  he_backend->update_encryption_parameters(
+      HESealEncryptionParameters::default_complex_packing_parms());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+
+  // No rotations needed
+  auto add = std::make_shared<op::Add>(a, b);
+  he_backend->compile(std::make_shared<Function>(add, ParameterVector{a, b}));
+  EXPECT_ANY_THROW(he_backend->get_galois_keys());
+
+  // Multiplication with complex packing needs the conjugation key only
+  auto mult = std::make_shared<op::Multiply>(a, b);
+  he_backend->compile(std::make_shared<Function>(mult, ParameterVector{a, b}));
+  auto galois_keys = he_backend->get_galois_keys();
+  ASSERT_NE(galois_keys, nullptr);
+  EXPECT_EQ(galois_keys->size(), 1U);
+  EXPECT_TRUE(
+      galois_keys->has_key(he_backend->complex_conjugate_galois_element()));
+
+  // Keys are generated once
+  EXPECT_EQ(he_backend->get_galois_keys(), galois_keys);
+}
+
+TEST(he_seal_executable, galois_keys_dot) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  he_backend->update_encryption_parameters(
+      HESealEncryptionParameters::default_complex_packing_parms());
+
+  // Dot multiplies ciphertexts without a Multiply op in the graph
+  Shape shape_a{2, 3};
+  Shape shape_b{3, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape_b);
+  auto dot = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(dot, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), test::config_from_flags(false, true, false)},
+       {b->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape_b, true, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, Shape{2, 2}, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  copy_data(t_b, std::vector<float>{1, 2, 3, 4, 5, 6});
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{22, 28, 49, 64}, 1e-3f));
+}
+
+TEST(he_seal_executable, key_cache_upload) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto f = std::make_shared<Function>(a, ParameterVector{a});
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  auto context = he_backend->get_context();
+
+  auto serialize = [](const auto& key) {
+    std::stringstream stream;
+    key.save(stream);
+    return stream.str();
+  };
+  seal::KeyGenerator keygen(context);
+  std::string public_key = serialize(keygen.public_key());
+  std::string relin_keys = serialize(keygen.relin_keys());
+  std::string fingerprint = key_fingerprint(public_key, relin_keys);
+
+  // Uploads the public key with the given relinearization keys, as the
+  // server handles a key upload from a client
+  auto upload = [&](const std::string& upload_relin_keys,
+                    const std::string& upload_fingerprint) {
+    pb::TCPMessage proto_msg;
+    proto_msg.set_type(pb::TCPMessage_Type_RESPONSE);
+    proto_msg.mutable_public_key()->set_public_key(public_key);
+    proto_msg.mutable_eval_key()->set_eval_key(upload_relin_keys);
+    proto_msg.mutable_key_fingerprint()->set_fingerprint(upload_fingerprint);
+    he_handle->load_public_key(proto_msg);
+    he_handle->load_eval_key(proto_msg);
+    he_handle->handle_key_fingerprint(proto_msg);
+  };
+  auto cached_relin_keys = [&]() {
+    auto keys = he_backend->key_cache().find(fingerprint, context);
+    EXPECT_TRUE(keys.has_value() && keys->relin_keys != nullptr);
+    return keys.has_value() ? serialize(*keys->relin_keys) : "";
+  };
+
+  upload(relin_keys, fingerprint);
+  EXPECT_EQ(cached_relin_keys(), relin_keys);
+
+  // A second client knowing the public key can't replace the entry with its
+  // own relinearization keys
+  seal::KeyGenerator other_keygen(context);
+  std::string other_relin_keys = serialize(other_keygen.relin_keys());
+  EXPECT_ANY_THROW(upload(other_relin_keys, fingerprint));
+  EXPECT_EQ(cached_relin_keys(), relin_keys);
+  EXPECT_EQ(he_backend->key_cache().size(), 1);
+
+  // Under the fingerprint of its keys, it gets an entry of its own
+  upload(other_relin_keys, key_fingerprint(public_key, other_relin_keys));
+  EXPECT_EQ(he_backend->key_cache().size(), 2);
+  EXPECT_EQ(cached_relin_keys(), relin_keys);
+}
+
+TEST(he_seal_executable, ciphertext_pool) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto sum = std::make_shared<op::Add>(a, b);
+  auto prod = std::make_shared<op::Multiply>(sum, b);
+  auto t = std::make_shared<op::Add>(prod, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), test::config_from_flags(false, true, false)},
+       {b->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{0, -1, 2, -3});
+  std::vector<float> exp_result{1, 1, 13, 1};
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
+  auto stats = he_handle->ciphertext_pool_stats();
+  EXPECT_GT(stats.released, 0U);
+
+  // Dead intermediates of the first call are reused by the second
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
+  EXPECT_GT(he_handle->ciphertext_pool_stats().reused, stats.reused);
+}
+
+TEST(he_seal_executable, memory_usage) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  EXPECT_ANY_THROW(
+      he_backend->set_config({{"memory_pool_bytes", "-1"}}, error_str));
+  he_backend->set_config(
+      {{"memory_pool_bytes", "0"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_EQ(he_backend->memory_pools().max_bytes(), 0);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, false, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{2, 3, 4, 5});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{2, 6, 12, 20}, 1e-3f));
+
+  auto usage = he_handle->get_memory_usage();
+  auto it = usage.find(t->get_name());
+  ASSERT_NE(it, usage.end());
+  EXPECT_GT(it->second.peak_bytes, 0);
+  // Pools are freed after each op when over the limit
+  EXPECT_EQ(it->second.current_bytes, 0);
+}
+
+TEST(he_seal_executable, spill) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  // sum is used by the first and the last op, so it is spilled in between
+  auto sum = std::make_shared<op::Add>(a, b);
+  auto prod = std::make_shared<op::Multiply>(sum, b);
+  auto t0 = std::make_shared<op::Add>(prod, b);
+  auto t1 = std::make_shared<op::Add>(t0, a);
+  auto t2 = std::make_shared<op::Add>(t1, b);
+  auto t = std::make_shared<op::Add>(t2, sum);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  auto spill_dir =
+      std::filesystem::temp_directory_path() / "he_seal_executable_spill";
+  std::string error_str;
+  EXPECT_ANY_THROW(he_backend->set_config({{"spill_bytes", "-1"}}, error_str));
+  he_backend->set_config(
+      {{"spill_bytes", "0"},
+       {"spill_dir", spill_dir.string()},
+       {a->get_name(), test::config_from_flags(false, true, false)},
+       {b->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_EQ(he_backend->spill_bytes(), 0);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{0, -1, 2, -3});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{2, 0, 22, -4}, 1e-3f));
+
+  auto stats = he_handle->spill_stats();
+  EXPECT_GT(stats.spilled, 0);
+  EXPECT_GT(stats.prefetched, 0);
+  EXPECT_GT(stats.bytes, 0);
+  EXPECT_TRUE(std::filesystem::is_empty(spill_dir));
+}
+
+TEST(he_seal_executable, dense_plaintext) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape data_shape{1, 1, 4, 4};
+  Shape filter_shape{2, 1, 2, 2};
+  Shape weight_shape{8, 2};
+  Shape bias_shape{1, 2};
+  auto data = std::make_shared<op::Parameter>(element::f32, data_shape);
+  auto filter = std::make_shared<op::Parameter>(element::f32, filter_shape);
+  auto weight = std::make_shared<op::Parameter>(element::f32, weight_shape);
+  auto bias = std::make_shared<op::Parameter>(element::f32, bias_shape);
+  auto conv = std::make_shared<op::Convolution>(data, filter);
+  auto relu = std::make_shared<op::Relu>(conv);
+  auto max_pool =
+      std::make_shared<op::MaxPool>(relu, Shape{2, 2}, Strides{1, 1});
+  auto reshape = std::make_shared<op::Reshape>(
+      max_pool, AxisVector{0, 1, 2, 3}, Shape{1, 8});
+  auto dot = std::make_shared<op::Dot>(reshape, weight);
+  auto t = std::make_shared<op::Add>(dot, bias);
+  auto f = std::make_shared<Function>(
+      t, ParameterVector{data, filter, weight, bias});
+
+  std::vector<float> data_values(shape_size(data_shape));
+  std::vector<float> filter_values(shape_size(filter_shape));
+  std::vector<float> weight_values(shape_size(weight_shape));
+  for (size_t i = 0; i < data_values.size(); ++i) {
+    data_values[i] = static_cast<float>(i % 5) - 2;
+  }
+  for (size_t i = 0; i < filter_values.size(); ++i) {
+    filter_values[i] = static_cast<float>(i % 3) - 1;
+  }
+  for (size_t i = 0; i < weight_values.size(); ++i) {
+    weight_values[i] = static_cast<float>(i % 4) / 2;
+  }
+
+  // Runs the function with bias encrypted or not, returning the result
+  auto run = [&](bool dense, bool encrypt_bias) {
+    std::string error_str;
+    he_backend->set_config(
+        {{bias->get_name(),
+          test::config_from_flags(false, encrypt_bias, false)}},
+        error_str);
+    auto he_handle =
+        std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+    he_handle->set_dense_plaintext(dense);
+
+    auto t_data =
+        test::tensor_from_flags(*he_backend, data_shape, false, false);
+    auto t_filter =
+        test::tensor_from_flags(*he_backend, filter_shape, false, false);
+    auto t_weight =
+        test::tensor_from_flags(*he_backend, weight_shape, false, false);
+    auto t_bias =
+        test::tensor_from_flags(*he_backend, bias_shape, encrypt_bias, false);
+    auto t_result =
+        test::tensor_from_flags(*he_backend, bias_shape, encrypt_bias, false);
+    copy_data(t_data, data_values);
+    copy_data(t_filter, filter_values);
+    copy_data(t_weight, weight_values);
+    copy_data(t_bias, std::vector<float>{0.5, -1});
+
+    he_handle->call_with_validate({t_result},
+                                  {t_data, t_filter, t_weight, t_bias});
+    return read_vector<float>(t_result);
+  };
+
+  auto exp_result = run(false, false);
+  EXPECT_TRUE(test::all_close(run(true, false), exp_result, 1e-3f));
+  // The encrypted Add reads the dense Dot result from an HETensor
+  EXPECT_TRUE(test::all_close(run(true, true), exp_result, 1e-3f));
+}
+
+TEST(he_seal_executable, constant_tensors) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto bias = std::make_shared<op::Constant>(element::f32, Shape{3},
+                                             std::vector<float>{1, 2, 3});
+  auto scale = std::make_shared<op::Constant>(
+      element::f32, Shape{3, 2}, std::vector<float>{1, -1, 2, -2, 3, -3});
+  auto broadcast = std::make_shared<op::Broadcast>(bias, shape, AxisSet{0});
+  auto reshape = std::make_shared<op::Reshape>(scale, AxisVector{1, 0}, shape);
+  auto t = std::make_shared<op::Multiply>(
+      std::make_shared<op::Add>(a, broadcast), reshape);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  for (bool dense : {false, true}) {
+    for (bool encrypt : {false, true}) {
+      std::string error_str;
+      he_backend->set_config(
+          {{a->get_name(), test::config_from_flags(false, encrypt, false)}},
+          error_str);
+      auto he_handle =
+          std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+      he_handle->set_dense_plaintext(dense);
+
+      // Later calls reuse the constants computed by the first
+      for (float offset : {0.f, 1.f, -2.f}) {
+        auto t_a = test::tensor_from_flags(*he_backend, shape, encrypt, false);
+        auto t_result =
+            test::tensor_from_flags(*he_backend, shape, encrypt, false);
+        std::vector<float> a_values{offset, 1, 2, 3, 4, 5};
+        copy_data(t_a, a_values);
+        he_handle->call_with_validate({t_result}, {t_a});
+
+        std::vector<float> bias_values{1, 2, 3};
+        std::vector<float> scale_values{1, 2, 3, -1, -2, -3};
+        std::vector<float> exp_result(shape_size(shape));
+        for (size_t i = 0; i < exp_result.size(); ++i) {
+          exp_result[i] = (a_values[i] + bias_values[i % 3]) * scale_values[i];
+        }
+        EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result,
+                                    1e-3f));
+      }
+    }
+  }
+}
+
 }  // namespace ngraph::runtime::he
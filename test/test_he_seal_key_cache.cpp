@@ -0,0 +1,142 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_key_cache.hpp"
+#include "seal/seal.h"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::shared_ptr<seal::SEALContext> make_context() {
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {40, 30, 40}));
+  return seal::SEALContext::Create(parms);
+}
+
+std::pair<std::string, HESealKeyCache::Keys> make_keys(
+    const std::shared_ptr<seal::SEALContext>& context) {
+  seal::KeyGenerator keygen(context);
+  HESealKeyCache::Keys keys;
+  keys.public_key = std::make_shared<seal::PublicKey>(keygen.public_key());
+  keys.relin_keys = std::make_shared<seal::RelinKeys>(keygen.relin_keys());
+
+  std::stringstream pk_stream;
+  keys.public_key->save(pk_stream);
+  std::stringstream evk_stream;
+  keys.relin_keys->save(evk_stream);
+  return {key_fingerprint(pk_stream.str(), evk_stream.str()), keys};
+}
+}  // namespace
+
+TEST(he_seal_key_cache, fingerprint) {
+  std::string fingerprint = key_fingerprint("public key", "relin keys");
+  EXPECT_TRUE(is_key_fingerprint(fingerprint));
+  EXPECT_EQ(fingerprint, key_fingerprint("public key", "relin keys"));
+  EXPECT_NE(fingerprint, key_fingerprint("public kez", "relin keys"));
+  EXPECT_NE(fingerprint, key_fingerprint("public key", "relin kez"));
+  EXPECT_NE(fingerprint, key_fingerprint("public key", ""));
+  EXPECT_NE(key_fingerprint("", ""), key_fingerprint(std::string(1, '\0'), ""));
+  EXPECT_NE(key_fingerprint("ab", ""), key_fingerprint("a", "b"));
+
+  EXPECT_FALSE(is_key_fingerprint(""));
+  EXPECT_FALSE(is_key_fingerprint("../" + fingerprint.substr(3)));
+  EXPECT_FALSE(is_key_fingerprint(fingerprint + "0"));
+}
+
+TEST(he_seal_key_cache, lru_eviction) {
+  auto context = make_context();
+  auto [fingerprint_a, keys_a] = make_keys(context);
+  auto [fingerprint_b, keys_b] = make_keys(context);
+  auto [fingerprint_c, keys_c] = make_keys(context);
+
+  HESealKeyCache cache(250);
+  EXPECT_FALSE(cache.find(fingerprint_a, context).has_value());
+  EXPECT_ANY_THROW(cache.find("../secret_key", context));
+
+  cache.insert(fingerprint_a, context, keys_a, 100);
+  cache.insert(fingerprint_b, context, keys_b, 100);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.byte_count(), 200);
+
+  // Touch a, so b is the least recently used entry
+  auto found = cache.find(fingerprint_a, context);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->public_key, keys_a.public_key);
+  EXPECT_EQ(found->relin_keys, keys_a.relin_keys);
+
+  cache.insert(fingerprint_c, context, keys_c, 100);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.byte_count(), 200);
+  EXPECT_TRUE(cache.find(fingerprint_a, context).has_value());
+  EXPECT_FALSE(cache.find(fingerprint_b, context).has_value());
+  EXPECT_TRUE(cache.find(fingerprint_c, context).has_value());
+
+  // The most recent entry is kept, even if it exceeds the bound on its own
+  cache.set_max_bytes(10);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.find(fingerprint_c, context).has_value());
+}
+
+TEST(he_seal_key_cache, spill_directory) {
+  auto context = make_context();
+  auto [fingerprint, keys] = make_keys(context);
+
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "he_seal_key_cache_test";
+  std::filesystem::remove_all(directory);
+  {
+    HESealKeyCache cache(HESealKeyCache::default_max_bytes,
+                         directory.string());
+    cache.insert(fingerprint, context, keys, 100);
+  }
+
+  // A new cache, e.g. after a server restart, loads the keys from disk
+  HESealKeyCache cache(HESealKeyCache::default_max_bytes, directory.string());
+  auto found = cache.find(fingerprint, context);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(cache.size(), 1);
+
+  std::stringstream expected_stream;
+  keys.public_key->save(expected_stream);
+  std::stringstream found_stream;
+  found->public_key->save(found_stream);
+  EXPECT_EQ(expected_stream.str(), found_stream.str());
+  ASSERT_NE(found->relin_keys, nullptr);
+  EXPECT_EQ(found->relin_keys->size(), keys.relin_keys->size());
+
+  // Keys are specific to the encryption parameters
+  seal::EncryptionParameters other_parms(seal::scheme_type::CKKS);
+  other_parms.set_poly_modulus_degree(8192);
+  other_parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(8192, {60, 40, 60}));
+  auto other_context = seal::SEALContext::Create(other_parms);
+  EXPECT_FALSE(cache.find(fingerprint, other_context).has_value());
+
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_memory_pools.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+TEST(he_seal_memory_pools, local) {
+  HESealMemoryPools pools;
+  EXPECT_EQ(pools.alloc_byte_count(), 0);
+
+  const seal::MemoryPoolHandle& pool = pools.local();
+  ASSERT_TRUE(pool);
+  {
+    auto values = seal::util::allocate_uint(1024, pool);
+  }
+  EXPECT_GE(pools.alloc_byte_count(), 1024 * sizeof(std::uint64_t));
+
+  // Freed memory stays in the pool for reuse
+  size_t byte_count = pools.alloc_byte_count();
+  {
+    auto values = seal::util::allocate_uint(1024, pools.local());
+  }
+  EXPECT_EQ(pools.alloc_byte_count(), byte_count);
+}
+
+TEST(he_seal_memory_pools, trim) {
+  HESealMemoryPools pools;
+  {
+    auto values = seal::util::allocate_uint(1024, pools.local());
+  }
+  size_t byte_count = pools.alloc_byte_count();
+
+  // Within the limit
+  auto usage = pools.trim();
+  EXPECT_EQ(usage.peak_bytes, byte_count);
+  EXPECT_EQ(usage.current_bytes, byte_count);
+  EXPECT_EQ(pools.alloc_byte_count(), byte_count);
+
+  // Over the limit
+  pools.set_max_bytes(byte_count - 1);
+  EXPECT_EQ(pools.max_bytes(), byte_count - 1);
+  usage = pools.trim();
+  EXPECT_EQ(usage.peak_bytes, byte_count);
+  EXPECT_EQ(usage.current_bytes, 0);
+  EXPECT_EQ(pools.alloc_byte_count(), 0);
+}
+
+TEST(he_seal_memory_pools, trim_retained) {
+  HESealMemoryPools pools(0);
+  {
+    auto values = seal::util::allocate_uint(1024, pools.local());
+  }
+  size_t byte_count = pools.alloc_byte_count();
+
+  // Objects allocated from a pool, such as ciphertexts, keep it alive
+  seal::MemoryPoolHandle retained = pools.local();
+  auto usage = pools.trim();
+  EXPECT_EQ(usage.peak_bytes, byte_count);
+  EXPECT_EQ(usage.current_bytes, byte_count);
+  EXPECT_EQ(pools.alloc_byte_count(), byte_count);
+
+  retained = seal::MemoryPoolHandle();
+  usage = pools.trim();
+  EXPECT_EQ(usage.current_bytes, 0);
+  EXPECT_EQ(pools.alloc_byte_count(), 0);
+}
+
+TEST(he_seal_memory_pools, threads) {
+  HESealMemoryPools pools;
+  const seal::MemoryPoolHandle& pool = pools.local();
+  EXPECT_EQ(&pools.local(), &pool);
+
+  // Threads outside OpenMP regions get their own pools
+  const seal::MemoryPoolHandle* thread_pool = nullptr;
+  std::thread thread([&]() { thread_pool = &pools.local(); });
+  thread.join();
+  ASSERT_NE(thread_pool, nullptr);
+  EXPECT_NE(thread_pool, &pool);
+}
+
+}  // namespace ngraph::runtime::he
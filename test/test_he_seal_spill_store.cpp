@@ -0,0 +1,124 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_spill_store.hpp"
+#include "seal/seal.h"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::filesystem::path spill_test_directory() {
+  return std::filesystem::temp_directory_path() / "he_seal_spill_store_test";
+}
+}  // namespace
+
+TEST(he_seal_spill_store, spill_restore) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, true, false));
+  std::vector<float> values{1, -2, 3, -4, 5, -6};
+  copy_data(tensor, values);
+  size_t bytes = HESealSpillStore::resident_bytes(*tensor);
+  EXPECT_GT(bytes, 0);
+
+  HESealSpillStore store(he_backend->get_context(),
+                         spill_test_directory().string());
+  EXPECT_EQ(store.spill(*tensor), bytes);
+  EXPECT_TRUE(store.is_spilled(*tensor));
+  EXPECT_EQ(HESealSpillStore::resident_bytes(*tensor), 0);
+  EXPECT_FALSE(std::filesystem::is_empty(spill_test_directory()));
+  EXPECT_ANY_THROW(store.spill(*tensor));
+
+  store.restore(*tensor);
+  EXPECT_FALSE(store.is_spilled(*tensor));
+  EXPECT_EQ(HESealSpillStore::resident_bytes(*tensor), bytes);
+  EXPECT_TRUE(std::filesystem::is_empty(spill_test_directory()));
+  EXPECT_TRUE(test::all_close(read_vector<float>(tensor), values, 1e-3f));
+
+  auto stats = store.stats();
+  EXPECT_EQ(stats.spilled, 1);
+  EXPECT_EQ(stats.restored, 1);
+  EXPECT_EQ(stats.prefetched, 0);
+}
+
+TEST(he_seal_spill_store, prefetch) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4};
+  auto tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, true, false));
+  std::vector<float> values{1, 2, 3, 4};
+  copy_data(tensor, values);
+
+  HESealSpillStore store(he_backend->get_context(),
+                         spill_test_directory().string());
+  store.spill(*tensor);
+  store.prefetch(tensor);
+  // A second prefetch of the same tensor is ignored
+  store.prefetch(tensor);
+  store.restore(*tensor);
+  EXPECT_EQ(store.stats().prefetched, 1);
+  EXPECT_TRUE(test::all_close(read_vector<float>(tensor), values, 1e-3f));
+}
+
+TEST(he_seal_spill_store, not_spilled) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2};
+  auto plain_tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, false, false));
+  copy_data(plain_tensor, std::vector<float>{1, 2});
+  auto cipher_tensor = std::static_pointer_cast<HETensor>(
+      test::tensor_from_flags(*he_backend, shape, true, false));
+  copy_data(cipher_tensor, std::vector<float>{1, 2});
+
+  HESealSpillStore store(he_backend->get_context(),
+                         spill_test_directory().string());
+
+  // Plaintexts stay in memory
+  EXPECT_EQ(store.spill(*plain_tensor), 0);
+  EXPECT_FALSE(store.is_spilled(*plain_tensor));
+
+  // Ciphertexts shared with another tensor stay in memory
+  auto shared_cipher = cipher_tensor->data(0).get_ciphertext();
+  size_t bytes = HESealSpillStore::resident_bytes(*cipher_tensor);
+  EXPECT_LT(store.spill(*cipher_tensor), bytes);
+  EXPECT_EQ(cipher_tensor->data(0).get_ciphertext(), shared_cipher);
+
+  // Discarded tensors lose their spilled ciphertexts
+  store.discard(*cipher_tensor);
+  EXPECT_FALSE(store.is_spilled(*cipher_tensor));
+  EXPECT_EQ(cipher_tensor->data(1).get_ciphertext(), nullptr);
+  EXPECT_EQ(store.stats().discarded, 1);
+  EXPECT_TRUE(std::filesystem::is_empty(spill_test_directory()));
+}
+
+}  // namespace ngraph::runtime::he
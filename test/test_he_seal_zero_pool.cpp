@@ -0,0 +1,156 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_zero_pool.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+namespace {
+struct ZeroPoolTest {
+  ZeroPoolTest() {
+    seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+    size_t poly_modulus_degree = 4096;
+    parms.set_poly_modulus_degree(poly_modulus_degree);
+    parms.set_coeff_modulus(
+        seal::CoeffModulus::Create(poly_modulus_degree, {40, 30, 40}));
+    context = seal::SEALContext::Create(parms);
+
+    seal::KeyGenerator keygen(context);
+    encryptor = std::make_shared<seal::Encryptor>(context, keygen.public_key());
+    decryptor = std::make_shared<seal::Decryptor>(context, keygen.secret_key());
+    encoder = std::make_shared<seal::CKKSEncoder>(context);
+  }
+
+  // Encrypts values with the pool and returns the decrypted values
+  std::vector<double> round_trip(HESealZeroPool& pool,
+                                 const std::vector<double>& values) {
+    seal::Plaintext plain;
+    encoder->encode(values, context->first_parms_id(), scale, plain);
+    seal::Ciphertext cipher;
+    pool.encrypt(plain, cipher);
+    EXPECT_EQ(cipher.parms_id(), context->first_parms_id());
+    EXPECT_DOUBLE_EQ(cipher.scale(), scale);
+
+    seal::Plaintext decrypted;
+    decryptor->decrypt(cipher, decrypted);
+    std::vector<double> result;
+    encoder->decode(decrypted, result);
+    result.resize(values.size());
+    return result;
+  }
+
+  std::shared_ptr<seal::SEALContext> context;
+  std::shared_ptr<seal::Encryptor> encryptor;
+  std::shared_ptr<seal::Decryptor> decryptor;
+  std::shared_ptr<seal::CKKSEncoder> encoder;
+  double scale = 1 << 30;
+};
+
+void wait_until_full(const HESealZeroPool& pool) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (pool.stats().size < pool.stats().capacity &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+}  // namespace
+
+TEST(he_seal_zero_pool, encrypt) {
+  ZeroPoolTest test;
+  HESealZeroPool pool(test.context, test.encryptor,
+                      {test.context->first_parms_id()}, 4, 2);
+  wait_until_full(pool);
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.size, 4);
+  EXPECT_EQ(stats.capacity, 4);
+  EXPECT_EQ(stats.refill_threads, 2);
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.);
+
+  std::vector<double> values{1.5, -2.25, 3, 0};
+  auto result = test.round_trip(pool, values);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i], 1e-3);
+  }
+  EXPECT_EQ(pool.stats().hits, 1);
+  EXPECT_EQ(pool.stats().misses, 0);
+
+  // The pool refills in the background
+  wait_until_full(pool);
+  EXPECT_EQ(pool.stats().size, 4);
+}
+
+TEST(he_seal_zero_pool, disabled) {
+  ZeroPoolTest test;
+  HESealZeroPool pool(test.context, test.encryptor,
+                      {test.context->first_parms_id()}, 0, 2);
+  EXPECT_EQ(pool.stats().refill_threads, 0);
+
+  std::vector<double> values{4, 5, 6};
+  auto result = test.round_trip(pool, values);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i], 1e-3);
+  }
+  EXPECT_EQ(pool.stats().hits, 0);
+  EXPECT_EQ(pool.stats().misses, 1);
+}
+
+TEST(he_seal_zero_pool, pause) {
+  ZeroPoolTest test;
+  HESealZeroPool pool(test.context, test.encryptor,
+                      {test.context->first_parms_id()}, 2, 1);
+  wait_until_full(pool);
+
+  {
+    HESealZeroPool::Pause pause(pool);
+    HESealZeroPool::Pause nested_pause(pool);
+    test.round_trip(pool, {1, 2});
+    EXPECT_EQ(pool.stats().hits, 1);
+
+    // No refilling while paused
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(pool.stats().size, 1);
+  }
+
+  wait_until_full(pool);
+  EXPECT_EQ(pool.stats().size, 2);
+}
+
+TEST(he_seal_zero_pool, other_level) {
+  ZeroPoolTest test;
+  auto last_parms_id = test.context->last_parms_id();
+  HESealZeroPool pool(test.context, test.encryptor, {last_parms_id}, 2, 1);
+  wait_until_full(pool);
+
+  // No encryptions of zero at the first level, so fall back to the encryptor
+  std::vector<double> values{7, 8};
+  auto result = test.round_trip(pool, values);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i], 1e-3);
+  }
+  EXPECT_EQ(pool.stats().misses, 1);
+  EXPECT_EQ(pool.stats().size, 2);
+}
+
+}  // namespace ngraph::runtime::he
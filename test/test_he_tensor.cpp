@@ -14,6 +14,7 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -195,6 +196,84 @@ TEST(he_tensor, load) {
                               read_vector<float>(saved_he_tensor)));
 }
 
+TEST(he_tensor, load_striped) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  he_backend->update_encryption_parameters(parms);
+
+  Shape shape{10};
+  auto tensor = he_backend->create_cipher_tensor(element::f32, shape, false,
+                                                 "tensor_name");
+  std::vector<float> tensor_data{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  copy_data(tensor, tensor_data);
+  auto saved_he_tensor = std::static_pointer_cast<HETensor>(tensor);
+
+  // One element per proto
+  std::vector<pb::HETensor> protos;
+  saved_he_tensor->write_to_protos(protos, 1);
+  ASSERT_EQ(protos.size(), 10);
+  for (size_t proto_idx = 0; proto_idx < protos.size(); ++proto_idx) {
+    EXPECT_EQ(protos[proto_idx].offset(), proto_idx);
+    EXPECT_EQ(protos[proto_idx].data_size(), 1);
+  }
+  EXPECT_ANY_THROW(saved_he_tensor->write_to_protos(protos, 0));
+
+  // Chunks may arrive out of order
+  std::reverse(protos.begin(), protos.end());
+  auto loaded_he_tensor = HETensor::load_from_proto_tensors(
+      protos, *he_backend->get_ckks_encoder(), he_backend->get_context(),
+      *he_backend->get_encryptor(), *he_backend->get_decryptor(),
+      he_backend->get_encryption_parameters());
+
+  EXPECT_TRUE(loaded_he_tensor->done_loading());
+  EXPECT_TRUE(test::all_close(read_vector<float>(loaded_he_tensor),
+                              tensor_data, 1e-3f));
+}
+
+TEST(he_tensor, write_read_range) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  he_backend->update_encryption_parameters(parms);
+
+  Shape shape{10};
+  auto tensor = he_backend->create_cipher_tensor(element::f32, shape, false,
+                                                 "tensor_name");
+  std::vector<float> tensor_data{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  copy_data(tensor, tensor_data);
+  auto saved_he_tensor = std::static_pointer_cast<HETensor>(tensor);
+  EXPECT_GE(saved_he_tensor->proto_chunk_size(HETensor::max_proto_bytes), 10);
+  EXPECT_EQ(saved_he_tensor->proto_chunk_size(1), 1);
+
+  // Elements [3, 7)
+  std::vector<pb::HETensor> protos;
+  saved_he_tensor->write_to_protos(protos, HETensor::max_proto_bytes, 3, 7);
+  ASSERT_EQ(protos.size(), 1);
+  EXPECT_EQ(protos[0].offset(), 3);
+  EXPECT_EQ(protos[0].data_size(), 4);
+  EXPECT_ANY_THROW(saved_he_tensor->write_to_protos(
+      protos, HETensor::max_proto_bytes, 7, 11));
+
+  auto loaded_he_tensor =
+      std::static_pointer_cast<HETensor>(he_backend->create_cipher_tensor(
+          element::f32, shape, false, "tensor_name"));
+  HETensor::load_from_proto_tensor(loaded_he_tensor, protos[0],
+                                   he_backend->get_context());
+  EXPECT_FALSE(loaded_he_tensor->done_loading());
+
+  // Reads only the loaded range into its place in the whole tensor
+  std::vector<float> read_data(10, -1);
+  loaded_he_tensor->read(read_data.data(), read_data.size() * sizeof(float), 3,
+                         7);
+  for (size_t i = 0; i < read_data.size(); ++i) {
+    float expected = (i >= 3 && i < 7) ? tensor_data[i] : -1;
+    EXPECT_NEAR(read_data[i], expected, 1e-3f);
+  }
+  EXPECT_ANY_THROW(loaded_he_tensor->read(
+      read_data.data(), read_data.size() * sizeof(float), 7, 3));
+}
+
 TEST(he_tensor, load_from_context) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -271,4 +350,77 @@ TEST(he_tensor, zero) {
 
   EXPECT_EQ(t_zero->get_batched_element_count(), 0);
 }
+
+TEST(he_tensor, unspecified_type) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto t_a = std::static_pointer_cast<HETensor>(
+      he_backend->create_cipher_tensor(element::f32, Shape{2, 3}, false));
+  t_a->data()[4].get_ciphertext() = nullptr;
+
+  std::vector<float> values(6, 1);
+  EXPECT_ANY_THROW(t_a->write(values.data(), values.size() * sizeof(float)));
+  EXPECT_ANY_THROW(t_a->read(values.data(), values.size() * sizeof(float)));
+}
+
+TEST(he_tensor, float_plaintexts) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{8, 2};
+  auto tensor = std::static_pointer_cast<HETensor>(
+      he_backend->create_plain_tensor(element::f32, shape, true));
+  std::vector<float> values{0.1f,  -1.5f, 2.25f, 3,  4,  5,  6,  7,
+                            -8.5f, 9,     10,    11, 12, 13, 14, 15.75f};
+  copy_data(tensor, values);
+  EXPECT_FALSE(tensor->float_plaintexts());
+
+  tensor->set_float_plaintexts(true);
+  for (auto& elem : tensor->data()) {
+    EXPECT_TRUE(elem.get_plaintext().is_float());
+  }
+  // f32 values are stored exactly
+  EXPECT_EQ(read_vector<float>(tensor), values);
+
+  // Writes keep single precision
+  std::reverse(values.begin(), values.end());
+  copy_data(tensor, values);
+  EXPECT_TRUE(tensor->data(0).get_plaintext().is_float());
+  EXPECT_EQ(read_vector<float>(tensor), values);
+
+  tensor->set_float_plaintexts(false);
+  EXPECT_FALSE(tensor->data(0).get_plaintext().is_float());
+  EXPECT_EQ(read_vector<float>(tensor), values);
+}
+
+TEST(he_tensor, packed_write_read_types) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Spans several blocks of elements and batch values
+  Shape shape{70, 100};
+  auto test_type = [&](auto zero, const element::Type& type) {
+    using T = decltype(zero);
+    std::vector<T> values(shape_size(shape));
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<T>(static_cast<int64_t>(i % 23) - 11);
+    }
+    for (bool encrypted : {false, true}) {
+      auto tensor = encrypted
+                        ? he_backend->create_packed_cipher_tensor(type, shape)
+                        : he_backend->create_packed_plain_tensor(type, shape);
+      copy_data(tensor, values);
+      std::vector<T> result = read_vector<T>(tensor);
+      ASSERT_EQ(result.size(), values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_NEAR(result[i], values[i], 1e-3);
+      }
+    }
+  };
+  test_type(float{0}, element::f32);
+  test_type(double{0}, element::f64);
+  test_type(int32_t{0}, element::i32);
+  test_type(int64_t{0}, element::i64);
+}
 }  // namespace ngraph::runtime::he
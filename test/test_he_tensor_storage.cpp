@@ -0,0 +1,151 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "he_plaintext.hpp"
+#include "he_tensor_storage.hpp"
+#include "he_type.hpp"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/negate_seal.hpp"
+#include "seal/kernel/reshape_seal.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_tensor_storage, plaintext) {
+  HETensorStorage storage(3, 2, false);
+  EXPECT_EQ(storage.size(), 3);
+  EXPECT_EQ(storage.batch_size(), 2);
+  EXPECT_FALSE(storage.complex_packing());
+  EXPECT_EQ(storage.tag(0), HETensorStorage::Tag::empty);
+
+  storage.set_plaintext(0, HEPlaintext{1, 2});
+  storage.set_plaintext(2, HEPlaintext{5});
+  EXPECT_EQ(storage.tag(0), HETensorStorage::Tag::plaintext);
+  EXPECT_EQ(storage.tag(1), HETensorStorage::Tag::empty);
+  EXPECT_EQ(storage.tag(2), HETensorStorage::Tag::scalar);
+  EXPECT_TRUE(storage.is_plaintext(0));
+  EXPECT_FALSE(storage.is_plaintext(1));
+  EXPECT_EQ(storage.ciphertext_count(), 0);
+
+  // Values are stored contiguously, batch_size per element
+  EXPECT_EQ(storage.plaintext_values().size(), 6);
+  EXPECT_EQ(storage.plaintext_values()[1], 2);
+  EXPECT_EQ(storage.plaintext_values()[4], 5);
+
+  EXPECT_TRUE(test::all_close(storage.get(0).get_plaintext(),
+                              HEPlaintext{1, 2}));
+  EXPECT_TRUE(
+      test::all_close(storage.get(2).get_plaintext(), HEPlaintext{5}));
+  EXPECT_TRUE(storage.get(1).get_plaintext().empty());
+
+  EXPECT_ANY_THROW(storage.set_plaintext(1, HEPlaintext{1, 2, 3}));
+  EXPECT_ANY_THROW(storage.ciphertext(0));
+}
+
+TEST(he_tensor_storage, ciphertext) {
+  HETensorStorage storage(2, 4, false);
+
+  seal::Ciphertext& cipher = storage.emplace_ciphertext(0);
+  EXPECT_EQ(cipher.pool(), storage.pool());
+  EXPECT_TRUE(storage.is_ciphertext(0));
+  EXPECT_EQ(storage.ciphertext_count(), 1);
+
+  HEType value = storage.get(0);
+  EXPECT_TRUE(value.is_ciphertext());
+  EXPECT_EQ(value.batch_size(), 4);
+  EXPECT_EQ(value.get_ciphertext(), storage.ciphertext(0));
+
+  storage.set_plaintext(0, HEPlaintext{1});
+  EXPECT_FALSE(storage.is_ciphertext(0));
+  EXPECT_EQ(storage.ciphertext_count(), 0);
+
+  EXPECT_ANY_THROW(storage.set_ciphertext(1, nullptr));
+}
+
+TEST(he_tensor_storage, he_types) {
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  std::vector<HEType> values{HEType(HEPlaintext{1, 2}, false),
+                             HEType(cipher, false, 2),
+                             HEType(HEPlaintext{3}, false)};
+
+  HETensorStorage storage(values, 2, false);
+  EXPECT_EQ(storage.ciphertext_count(), 1);
+  EXPECT_EQ(storage.ciphertext(1), cipher);
+
+  HETensorStorage copy(3, 2, false);
+  for (size_t i = 0; i < storage.size(); ++i) {
+    copy.copy(2 - i, storage, i);
+  }
+  EXPECT_EQ(copy.tag(0), HETensorStorage::Tag::scalar);
+  EXPECT_EQ(copy.ciphertext(1), cipher);
+
+  std::vector<HEType> loaded;
+  copy.to_he_types(loaded);
+  ASSERT_EQ(loaded.size(), 3);
+  EXPECT_TRUE(test::all_close(loaded[0].get_plaintext(), HEPlaintext{3}));
+  EXPECT_TRUE(loaded[1].is_ciphertext());
+  EXPECT_TRUE(test::all_close(loaded[2].get_plaintext(), HEPlaintext{1, 2}));
+
+  EXPECT_ANY_THROW(HETensorStorage(values, 2, true));
+  EXPECT_ANY_THROW(copy.copy(0, HETensorStorage(1, 3, false), 0));
+}
+
+TEST(he_tensor_storage, reshape) {
+  // Transpose a 2x3 matrix
+  HETensorStorage arg(6, 1, false);
+  for (size_t i = 0; i < arg.size(); ++i) {
+    arg.set_plaintext(i, HEPlaintext{static_cast<double>(i)});
+  }
+  HETensorStorage out(6, 1, false);
+  reshape_seal(arg, out, Shape{2, 3}, AxisVector{1, 0}, Shape{3, 2});
+
+  EXPECT_TRUE(test::all_close(out.plaintext_values(),
+                              std::vector<double>{0, 3, 1, 4, 2, 5}));
+}
+
+TEST(he_tensor_storage, negate) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  HETensorStorage arg(3, 1, false);
+  arg.set_plaintext(0, HEPlaintext{1});
+  arg.set_plaintext(1, HEPlaintext{-2});
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  he_backend->encrypt(cipher, HEPlaintext{3}, element::f32, false);
+  arg.set_ciphertext(2, cipher);
+
+  HETensorStorage out(3, 1, false);
+  negate_seal(arg, out, element::f32, *he_backend);
+
+  EXPECT_EQ(out.plaintext(0)[0], -1);
+  EXPECT_EQ(out.plaintext(1)[0], 2);
+  ASSERT_TRUE(out.is_ciphertext(2));
+  EXPECT_NE(out.ciphertext(2), cipher);
+
+  HEPlaintext decrypted;
+  he_backend->decrypt(decrypted, *out.ciphertext(2), false);
+  EXPECT_NEAR(decrypted[0], -3, 1e-3);
+
+  EXPECT_ANY_THROW(negate_seal(arg, arg, element::f32, *he_backend));
+}
+
+}  // namespace ngraph::runtime::he
@@ -15,6 +15,7 @@
 //*****************************************************************************
 
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "he_plaintext.hpp"
@@ -146,4 +147,25 @@ TEST(he_type, save_load) {
   }
 }
 
+TEST(he_type, homogeneous_kind) {
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  std::vector<HEType> values{HEType(HEPlaintext{1}, false),
+                             HEType(HEPlaintext{2}, false)};
+
+  EXPECT_EQ(homogeneous_kind(values, 0), HETypeKind::mixed);
+  EXPECT_EQ(homogeneous_kind(values, 2), HETypeKind::plaintext);
+
+  values[1].complex_packing() = true;
+  EXPECT_EQ(homogeneous_kind(values, 1), HETypeKind::plaintext);
+  EXPECT_EQ(homogeneous_kind(values, 2), HETypeKind::mixed);
+
+  values[1].complex_packing() = false;
+  values[1].set_ciphertext(cipher);
+  EXPECT_EQ(homogeneous_kind(values, 2), HETypeKind::mixed);
+
+  values[0].set_ciphertext(cipher);
+  EXPECT_EQ(homogeneous_kind(values, 2), HETypeKind::ciphertext);
+  EXPECT_ANY_THROW(homogeneous_kind(values, 3));
+}
+
 }  // namespace ngraph::runtime::he
@@ -85,6 +85,17 @@ TEST(he_util, flag_to_bool) {
   EXPECT_ANY_THROW(flag_to_bool("DUMMY_VAL"));
 }
 
+TEST(he_util, env_to_size_t) {
+  EXPECT_EQ(env_to_size_t(nullptr, 7), 7);
+  EXPECT_EQ(env_to_size_t("0", 7), 0);
+  EXPECT_EQ(env_to_size_t("1024", 7), 1024);
+
+  EXPECT_ANY_THROW(env_to_size_t("", 7));
+  EXPECT_ANY_THROW(env_to_size_t("-1", 7));
+  EXPECT_ANY_THROW(env_to_size_t("12x", 7));
+  EXPECT_ANY_THROW(env_to_size_t("1234567890123456789", 7));
+}
+
 TEST(he_util, type_to_double) {
   auto test_type_to_double = [](auto x) {
     EXPECT_DOUBLE_EQ(
@@ -25,6 +25,7 @@
 #include "ngraph/type/element_type.hpp"
 #include "node_wrapper.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 #include "test_util.hpp"
 #include "util/test_tools.hpp"
 
@@ -175,6 +176,19 @@ TEST(node_wrapper, product) { ASSERT_TRUE(check_nullary<op::Product>()); }
 
 TEST(node_wrapper, relu) { ASSERT_TRUE(check_nullary<op::Relu>()); }
 
+TEST(node_wrapper, relu_max_pool) {
+  Shape shape{1, 1, 4};
+  auto param = std::make_shared<op::Parameter>(element::f32, shape);
+  auto node = std::make_shared<op::ReluMaxPool>(param, Shape{2}, Strides{2},
+                                                Shape{0}, Shape{0}, 6.0f);
+  NodeWrapper node_wrapper(node);
+
+  EXPECT_NO_THROW(node_wrapper.get_typeid());
+  EXPECT_EQ(node->get_shape(), (Shape{1, 1, 2}));
+  ASSERT_TRUE((node_wrapper.get_node() != nullptr) &&
+              (node_wrapper.get_op() != nullptr));
+}
+
 TEST(node_wrapper, reshape) { ASSERT_TRUE(check_nullary<op::Reshape>()); }
 
 TEST(node_wrapper, result) { ASSERT_TRUE(check_nullary<op::Result>()); }
@@ -14,6 +14,10 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
@@ -25,6 +29,25 @@
 #include "util/test_control.hpp"
 #include "util/test_tools.hpp"
 
+namespace {
+// Calls to the global operator new, replaced below, across the unit tests
+std::atomic<size_t> allocation_count{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept {
+  std::free(ptr);
+}
+
 namespace ngraph::runtime::he {
 
 TEST(perf_micro, encode) {
@@ -216,4 +239,106 @@ TEST(perf_micro, encode) {
   }
 }
 
+TEST(perf_micro, encrypt_symmetric) {
+  auto perf_test = [](size_t poly_modulus_degree,
+                      const std::vector<int>& coeff_modulus_bits) {
+    int encrypt_test_cnt = 50;
+
+    std::chrono::high_resolution_clock::time_point time_start, time_end;
+    std::chrono::nanoseconds time_public_sum(0);
+    std::chrono::nanoseconds time_symmetric_sum(0);
+
+    seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+    parms.set_poly_modulus_degree(poly_modulus_degree);
+    parms.set_coeff_modulus(
+        seal::CoeffModulus::Create(poly_modulus_degree, coeff_modulus_bits));
+
+    auto context = seal::SEALContext::Create(parms);
+    seal::CKKSEncoder encoder(context);
+    seal::KeyGenerator keygen(context);
+    seal::Encryptor encryptor(context, keygen.public_key(),
+                              keygen.secret_key());
+
+    seal::Plaintext plain;
+    encoder.encode(1.0, context->first_parms_id(), pow(2.0, 20), plain);
+    seal::Ciphertext encrypted(context);
+
+    for (int test_run = 0; test_run < encrypt_test_cnt; ++test_run) {
+      time_start = std::chrono::high_resolution_clock::now();
+      encryptor.encrypt(plain, encrypted);
+      time_end = std::chrono::high_resolution_clock::now();
+      time_public_sum += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          time_end - time_start);
+
+      time_start = std::chrono::high_resolution_clock::now();
+      encryptor.encrypt_symmetric(plain, encrypted);
+      time_end = std::chrono::high_resolution_clock::now();
+      time_symmetric_sum +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(time_end -
+                                                               time_start);
+    }
+
+    auto time_public_avg = time_public_sum.count() / encrypt_test_cnt;
+    auto time_symmetric_avg = time_symmetric_sum.count() / encrypt_test_cnt;
+
+    NGRAPH_INFO << "poly_modulus_degree " << poly_modulus_degree;
+    NGRAPH_INFO << "time_public_encrypt_avg (ns) " << time_public_avg;
+    NGRAPH_INFO << "time_symmetric_encrypt_avg (ns) " << time_symmetric_avg;
+    NGRAPH_INFO << "Runtime improvement: "
+                << (time_public_avg / float(time_symmetric_avg)) << "\n";
+  };
+
+  std::vector<size_t> poly_modulus_degrees{4096, 8192, 16384};
+  std::vector<std::vector<int>> coeff_modulus_bits{
+      {30, 30, 30}, {30, 30, 30, 30, 30}, {30, 30, 30, 30, 30, 30, 30, 30, 30}};
+
+  for (size_t parm_ind = 0; parm_ind < poly_modulus_degrees.size();
+       ++parm_ind) {
+    perf_test(poly_modulus_degrees[parm_ind], coeff_modulus_bits[parm_ind]);
+  }
+}
+
+TEST(perf_micro, scalar_plaintext) {
+  size_t value_count = 1 << 20;
+
+  std::chrono::high_resolution_clock::time_point time_start, time_end;
+
+  time_start = std::chrono::high_resolution_clock::now();
+  size_t allocations_start = allocation_count;
+  std::vector<std::vector<double>> vectors(value_count);
+  for (size_t i = 0; i < value_count; ++i) {
+    vectors[i] = std::vector<double>{static_cast<double>(i)};
+  }
+  std::vector<std::vector<double>> vector_copies(vectors);
+  size_t vector_allocations = allocation_count - allocations_start;
+  time_end = std::chrono::high_resolution_clock::now();
+  auto time_vector = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      time_end - time_start);
+
+  time_start = std::chrono::high_resolution_clock::now();
+  allocations_start = allocation_count;
+  std::vector<HEPlaintext> plains(value_count);
+  for (size_t i = 0; i < value_count; ++i) {
+    plains[i] = HEPlaintext{static_cast<double>(i)};
+  }
+  std::vector<HEPlaintext> plain_copies(plains);
+  size_t plain_allocations = allocation_count - allocations_start;
+  time_end = std::chrono::high_resolution_clock::now();
+  auto time_plain = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      time_end - time_start);
+
+  EXPECT_TRUE(std::all_of(plain_copies.begin(), plain_copies.end(),
+                          [](const HEPlaintext& p) { return p.is_inline(); }));
+  // One allocation per std::vector<double>, none per scalar plaintext
+  EXPECT_EQ(vector_allocations, 2 * value_count + 2);
+  EXPECT_EQ(plain_allocations, 2);
+
+  NGRAPH_INFO << "vector allocations " << vector_allocations;
+  NGRAPH_INFO << "plaintext allocations " << plain_allocations;
+  NGRAPH_INFO << "time_vector (ns) " << time_vector.count();
+  NGRAPH_INFO << "time_plaintext (ns) " << time_plain.count();
+  NGRAPH_INFO << "Runtime improvement: "
+              << (time_vector.count() / float(time_plain.count())) << "\n";
+}
+
 }  // namespace ngraph::runtime::he
@@ -17,6 +17,8 @@
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/rescale_seal.hpp"
+#include "seal/seal_util.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -83,4 +85,52 @@ NGRAPH_TEST(${BACKEND_NAME}, skip_rescale_lowest) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-1f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, rescale_range) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Ciphertexts of 2 * i at the squared scale, with a plaintext at index 2
+  auto make_values = [&]() {
+    std::vector<HEType> values;
+    for (size_t i = 0; i < 4; ++i) {
+      if (i == 2) {
+        values.emplace_back(HEPlaintext{4}, false);
+        continue;
+      }
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      he_backend->encrypt(cipher, HEPlaintext{static_cast<double>(i)},
+                          element::f32, false);
+      multiply_plain_inplace(cipher->ciphertext(), 2, *he_backend);
+      values.emplace_back(cipher, false, 1);
+    }
+    return values;
+  };
+  auto chain_index = [&](const HEType& he_type) {
+    return he_backend->get_chain_index(*he_type.get_ciphertext());
+  };
+
+  // Rescaling [1, 3) rescales only those elements, like the full-range kernel
+  // applied to them alone
+  auto values = make_values();
+  size_t top_chain_index = chain_index(values[0]);
+  rescale_seal(values, 1, 3, *he_backend);
+
+  auto all_values = make_values();
+  std::vector<HEType> sub_values{all_values.begin() + 1,
+                                 all_values.begin() + 3};
+  rescale_seal(sub_values, *he_backend);
+
+  EXPECT_EQ(chain_index(values[0]), top_chain_index);
+  EXPECT_EQ(chain_index(values[1]), chain_index(sub_values[0]));
+  EXPECT_EQ(chain_index(values[1]), top_chain_index - 1);
+  EXPECT_TRUE(values[2].is_plaintext());
+  EXPECT_EQ(chain_index(values[3]), top_chain_index);
+  for (size_t i : std::vector<size_t>{0, 1, 3}) {
+    HEPlaintext plain;
+    he_backend->decrypt(plain, *values[i].get_ciphertext(), false);
+    EXPECT_NEAR(plain[0], 2. * i, 1e-2);
+  }
+  EXPECT_ANY_THROW(rescale_seal(values, 3, 1, *he_backend));
+}
+
 }  // namespace ngraph::runtime::he
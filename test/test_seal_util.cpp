@@ -41,6 +41,20 @@ TEST(seal_util, seal_security_level) {
   EXPECT_ANY_THROW({ seal_security_level(42); });
 }
 
+TEST(seal_util, session_token) {
+  std::string token = generate_session_token();
+  EXPECT_EQ(token.size(), 64);
+  EXPECT_EQ(token.find_first_not_of("0123456789abcdef"), std::string::npos);
+  EXPECT_NE(generate_session_token(), token);
+
+  std::string other = token;
+  EXPECT_TRUE(tokens_equal(other, token));
+  other.back() = other.back() == '0' ? '1' : '0';
+  EXPECT_FALSE(tokens_equal(other, token));
+  EXPECT_FALSE(tokens_equal(token.substr(1), token));
+  EXPECT_FALSE(tokens_equal("", token));
+}
+
 TEST(seal_util, save) {
   seal::EncryptionParameters parms(seal::scheme_type::CKKS);
   size_t poly_modulus_degree = 8192;
@@ -327,6 +341,61 @@ TEST(seal_util, match_to_smallest_chain_index) {
   }
 }
 
+TEST(seal_util, match_to_smallest_chain_index_range) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Ciphertexts of 0, 1, 2, 3, where the value i is switched i % 3 times
+  // down the modulus chain
+  auto make_ciphers = [&]() {
+    std::vector<HEType> ciphers;
+    for (size_t i = 0; i < 4; ++i) {
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      he_backend->encrypt(cipher, HEPlaintext{static_cast<double>(i)},
+                          element::f32, false);
+      for (size_t j = 0; j < i % 3; ++j) {
+        he_backend->get_evaluator()->mod_switch_to_next_inplace(
+            cipher->ciphertext());
+      }
+      ciphers.emplace_back(cipher, false, 1);
+    }
+    return ciphers;
+  };
+  auto chain_index = [&](const HEType& he_type) {
+    return he_backend->get_chain_index(*he_type.get_ciphertext());
+  };
+
+  // Matching [1, 3) matches only those elements, like the full-range kernel
+  // applied to them alone
+  auto ciphers = make_ciphers();
+  std::vector<size_t> chain_indices;
+  for (const auto& cipher : ciphers) {
+    chain_indices.push_back(chain_index(cipher));
+  }
+  auto all_ciphers = make_ciphers();
+  std::vector<HEType> sub_ciphers{all_ciphers.begin() + 1,
+                                  all_ciphers.begin() + 3};
+  size_t sub_index = match_to_smallest_chain_index(sub_ciphers, *he_backend);
+  EXPECT_EQ(match_to_smallest_chain_index(ciphers, 1, 3, *he_backend),
+            sub_index);
+  EXPECT_EQ(sub_index, chain_indices[2]);
+
+  EXPECT_EQ(chain_index(ciphers[0]), chain_indices[0]);
+  EXPECT_EQ(chain_index(ciphers[1]), chain_index(sub_ciphers[0]));
+  EXPECT_EQ(chain_index(ciphers[2]), chain_index(sub_ciphers[1]));
+  EXPECT_EQ(chain_index(ciphers[3]), chain_indices[3]);
+  for (size_t i = 0; i < ciphers.size(); ++i) {
+    HEPlaintext plain;
+    he_backend->decrypt(plain, *ciphers[i].get_ciphertext(), false);
+    EXPECT_NEAR(plain[0], static_cast<double>(i), 1e-3);
+  }
+
+  // An empty range or a range of plaintexts matches nothing
+  EXPECT_EQ(match_to_smallest_chain_index(ciphers, 2, 2, *he_backend),
+            std::numeric_limits<size_t>::max());
+  EXPECT_ANY_THROW(match_to_smallest_chain_index(ciphers, 3, 5, *he_backend));
+}
+
 TEST(seal_util, encode_invalid) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -492,4 +561,37 @@ TEST(seal_util, encode_plaintext_wrapper_wrong_element_type) {
                           false));
 }
 
+TEST(seal_util, encrypt_symmetric) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  EXPECT_TRUE(he_backend->symmetric_encryption());
+
+  HEPlaintext plain{1, 2, 3};
+  auto context = he_backend->get_context();
+  for (bool symmetric : {false, true}) {
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    encrypt(cipher, plain, context->first_parms_id(), element::f32,
+            he_backend->get_scale(), *he_backend->get_ckks_encoder(),
+            *he_backend->get_encryptor(), false,
+            seal::MemoryPoolHandle::ThreadLocal(), symmetric);
+
+    HEPlaintext decrypted;
+    decrypt(decrypted, *cipher, false, *he_backend->get_decryptor(),
+            *he_backend->get_ckks_encoder());
+    for (size_t i = 0; i < plain.size(); ++i) {
+      EXPECT_NEAR(decrypted[i], plain[i], 1e-3);
+    }
+  }
+
+  std::string error;
+  he_backend->set_config({{"symmetric_encryption", "False"}}, error);
+  EXPECT_FALSE(he_backend->symmetric_encryption());
+  he_backend->set_config({{"symmetric_encryption", "True"}}, error);
+  EXPECT_TRUE(he_backend->symmetric_encryption());
+
+  // Keys from a client disable symmetric encryption
+  he_backend->set_public_key(*he_backend->get_public_key());
+  EXPECT_FALSE(he_backend->symmetric_encryption());
+}
+
 }  // namespace ngraph::runtime::he
@@ -16,6 +16,9 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -23,6 +26,7 @@
 #include "ngraph/ngraph.hpp"
 #include "ngraph/op/util/op_annotations.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/relu_max_pool.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_client.hpp"
 #include "seal/he_seal_executable.hpp"
@@ -368,6 +372,363 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu) {
   EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
 }
 
+NGRAPH_TEST(${BACKEND_unix_socket}, server_client_add_3_relu_unix_socket) {
+  auto backend = runtime::Backend::create("${BACKEND_unix_socket}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string uri{"unix:///tmp/ngraph-he-server-client.sock"};
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"server_uri", uri},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient(uri, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_shared_memory}, server_client_add_3_relu_shared_memory) {
+  auto backend = runtime::Backend::create("${BACKEND_shared_memory}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string uri{"shm:///tmp/ngraph-he-server-client-shm.sock"};
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"server_uri", uri},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient(uri, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_data_connections) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  EXPECT_ANY_THROW(
+      he_backend->set_config({{"data_connections", "0"}}, error_str));
+  EXPECT_ANY_THROW(
+      he_backend->set_config({{"data_connections", "x"}}, error_str));
+  he_backend->set_config({{"enable_client", "true"},
+                          {"data_connections", "3"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_key_cache) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string key_dir =
+      (std::filesystem::temp_directory_path() / "he_client_keys").string();
+  std::filesystem::remove_all(key_dir);
+  setenv("NGRAPH_HE_CLIENT_KEY_DIR", key_dir.c_str(), 1);
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // The first client generates and uploads its keys, the second client loads
+  // them from disk and the server finds them in its key cache
+  for (size_t run = 0; run < 2; ++run) {
+    auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+    auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+    copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+    std::vector<float> results;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, -0.2, 3};
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {b->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    auto handle =
+        std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(
+        test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+    EXPECT_EQ(he_backend->key_cache().size(), 1);
+  }
+  unsetenv("NGRAPH_HE_CLIENT_KEY_DIR");
+  std::filesystem::remove_all(key_dir);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_session) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(a);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {a->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), 99));
+
+  // One connection and key generation serve all inferences, each with its
+  // own batch size
+  std::vector<size_t> batch_sizes{2, 1, 4};
+  std::vector<std::vector<float>> inputs;
+  std::vector<std::vector<float>> exp_results;
+  for (size_t batch_size : batch_sizes) {
+    std::vector<float> input(3 * batch_size);
+    std::vector<float> exp_result(3 * batch_size);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input[i] = static_cast<float>(i) - 2.5f;
+      exp_result[i] = input[i] > 0 ? input[i] : 0;
+    }
+    inputs.emplace_back(input);
+    exp_results.emplace_back(exp_result);
+  }
+
+  std::vector<std::vector<double>> results(batch_sizes.size());
+  auto client_thread = std::thread([&]() {
+    HESealClient he_client("tcp://localhost:34000");
+
+    // Queue all inferences up front. They are performed one at a time
+    std::vector<std::future<std::vector<double>>> futures;
+    for (size_t i = 0; i < batch_sizes.size(); ++i) {
+      futures.emplace_back(he_client.infer(
+          HETensorConfigMap<float>{
+              {a->get_name(), make_pair("encrypt", inputs[i])}},
+          batch_sizes[i]));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+      results[i] = futures[i].get();
+    }
+    EXPECT_ANY_THROW(
+        he_client
+            .infer(HETensorConfigMap<float>{{a->get_name(),
+                                             make_pair("encrypt", inputs[0])}},
+                   100000)
+            .get());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  EXPECT_EQ(handle->serve({t_result}, {t_dummy}), batch_sizes.size());
+
+  client_thread.join();
+  for (size_t i = 0; i < batch_sizes.size(); ++i) {
+    EXPECT_TRUE(test::all_close(
+        std::vector<float>(results[i].begin(), results[i].end()),
+        exp_results[i], 1e-3f));
+  }
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_views) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(a);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {a->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), 99));
+
+  size_t batch_size = 2;
+  std::vector<float> input(3 * batch_size);
+  std::vector<float> exp_result(3 * batch_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i) - 2.5f;
+    exp_result[i] = input[i] > 0 ? input[i] : 0;
+  }
+
+  // Decrypted straight into the destination, once in the datatype of the
+  // result and once converted to double
+  std::vector<float> float_result;
+  std::vector<double> double_result;
+  std::vector<Shape> result_shapes;
+  auto client_thread = std::thread([&]() {
+    HESealClient he_client("tcp://localhost:34000");
+    HEInputViewMap inputs{
+        {a->get_name(),
+         HEInputView{"encrypt", input.data(), input.size(), element::f32}}};
+
+    auto float_shape = he_client.infer(
+        inputs, batch_size,
+        [&](const Shape& result_shape, const element::Type& type) {
+          EXPECT_EQ(type, element::f32);
+          float_result.resize(shape_size(result_shape));
+          return HEOutputView{float_result.data(), float_result.size(),
+                              element::f32};
+        });
+    auto double_shape = he_client.infer(
+        inputs, batch_size,
+        [&](const Shape& result_shape, const element::Type& /*type*/) {
+          double_result.resize(shape_size(result_shape));
+          return HEOutputView{double_result.data(), double_result.size(),
+                              element::f64};
+        });
+    result_shapes.emplace_back(float_shape.get());
+    result_shapes.emplace_back(double_shape.get());
+
+    // The destination must hold the result
+    EXPECT_ANY_THROW(he_client
+                         .infer(inputs, batch_size,
+                                [&](const Shape& /*result_shape*/,
+                                    const element::Type& /*type*/) {
+                                  return HEOutputView{float_result.data(), 1,
+                                                      element::f32};
+                                })
+                         .get());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  EXPECT_EQ(handle->serve({t_result}, {t_dummy}), 3);
+
+  client_thread.join();
+  ASSERT_EQ(result_shapes.size(), 2);
+  EXPECT_EQ(result_shapes[0], (Shape{batch_size, 3}));
+  EXPECT_EQ(result_shapes[1], (Shape{batch_size, 3}));
+  EXPECT_TRUE(test::all_close(float_result, exp_result, 1e-3f));
+  EXPECT_TRUE(test::all_close(
+      std::vector<float>(double_result.begin(), double_result.end()),
+      exp_result, 1e-3f));
+}
+
 NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_double) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -896,6 +1257,57 @@ NGRAPH_TEST(${BACKEND_NAME},
       true, false, true);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_max_pool_fused) {
+  for (bool bounded : {false, true}) {
+    auto backend = runtime::Backend::create("${BACKEND_NAME}");
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+    Shape shape{1, 1, 6};
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    std::shared_ptr<Node> relu = std::make_shared<op::Relu>(a);
+    if (bounded) {
+      relu = std::make_shared<op::BoundedRelu>(a, 1.5f);
+    }
+    auto t = std::make_shared<op::MaxPool>(relu, Shape{3});
+    auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+    std::string error_str;
+    he_backend->set_config(
+        {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+        error_str);
+
+    auto t_dummy = test::tensor_from_flags(*he_backend, shape, true, false);
+    auto t_result =
+        test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+    copy_data(t_dummy, std::vector<float>(shape_size(shape), 99));
+
+    std::vector<float> input{-1, -2, -3, 1, 2, -2};
+    std::vector<float> results;
+    auto client_thread = std::thread([&]() {
+      auto he_client =
+          HESealClient("localhost", 34000, 1,
+                       HETensorConfigMap<float>{
+                           {a->get_name(), make_pair("encrypt", input)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    auto handle =
+        std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+    EXPECT_EQ(1, count_ops_of_type<op::ReluMaxPool>(f));
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    std::vector<float> expected{0, 1, 2, 2};
+    if (bounded) {
+      expected = {0, 1, 1.5, 1.5};
+    }
+    EXPECT_TRUE(test::all_close(results, expected, 1e-3f));
+  }
+}
+
 NGRAPH_TEST(${BACKEND_NAME},
             server_client_pad_max_pool_1d_1channel_1image_plain) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
@@ -951,4 +1363,167 @@ NGRAPH_TEST(${BACKEND_NAME},
       1e-3f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, server_client_conv_add_relu_pipeline_tiles) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape data_shape{batch_size, 1, 4, 4};
+  Shape filter_shape{2, 1, 2, 2};
+  Shape out_shape{batch_size, 2, 3, 3};
+  auto data = std::make_shared<op::Parameter>(element::f32, data_shape);
+  auto filter = op::Constant::create(element::f32, filter_shape,
+                                     {1, -1, 0.5, 0, -0.5, 1, 0, 2});
+  auto conv = std::make_shared<op::Convolution>(data, filter);
+  auto bias = op::Constant::create(
+      element::f32, out_shape,
+      std::vector<float>(shape_size(out_shape), -0.5));
+  auto add = std::make_shared<op::Add>(conv, bias);
+  auto relu = std::make_shared<op::Relu>(add);
+  auto f = std::make_shared<Function>(relu, ParameterVector{data});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {data->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::vector<float> inputs;
+  for (size_t i = 0; i < shape_size(data_shape); ++i) {
+    inputs.emplace_back(static_cast<float>(i % 5) - 2);
+  }
+
+  // Runs the graph untiled, then with relu pipelined per output tile
+  std::vector<std::vector<float>> results(2);
+  for (size_t run = 0; run < 2; ++run) {
+    if (run == 1) {
+      setenv("NGRAPH_HE_PIPELINE_TILES", "1", 1);
+    }
+    auto t_dummy = he_backend->create_plain_tensor(element::f32, data_shape);
+    auto t_result = he_backend->create_cipher_tensor(element::f32, out_shape);
+    copy_data(t_dummy, std::vector<float>(shape_size(data_shape), 99));
+
+    auto client_thread = std::thread([&]() {
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {data->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results[run] =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    auto handle =
+        std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+    handle->call_with_validate({t_result}, {t_dummy});
+    client_thread.join();
+    unsetenv("NGRAPH_HE_PIPELINE_TILES");
+  }
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(f);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  auto int_a = int_backend->create_tensor(element::f32, data_shape);
+  copy_data(int_a, inputs);
+  int_handle->call_with_validate({int_result}, {int_a});
+  auto expected = read_vector<float>(int_result);
+
+  EXPECT_EQ(results[0].size(), shape_size(out_shape));
+  EXPECT_TRUE(test::all_close(results[1], results[0], 1e-3f));
+  EXPECT_TRUE(test::all_close(results[0], expected, 1e-3f));
+}
+
+// Benchmarks how much of the client's ReLU work overlaps with the server
+// computing later tiles. Within the exchange, the server is busy whenever it
+// is not waiting on the client, so the two are busy concurrently for at
+// least their summed busy time minus the elapsed time
+NGRAPH_TEST(${BACKEND_NAME}, server_client_pipeline_overlap) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape data_shape{batch_size, 1, 16, 16};
+  Shape filter_shape{4, 1, 3, 3};
+  Shape out_shape{batch_size, 4, 14, 14};
+  auto data = std::make_shared<op::Parameter>(element::f32, data_shape);
+  std::vector<float> filter_values;
+  for (size_t i = 0; i < shape_size(filter_shape); ++i) {
+    filter_values.emplace_back(static_cast<float>(i % 3) - 1);
+  }
+  auto filter = op::Constant::create(element::f32, filter_shape, filter_values);
+  auto conv = std::make_shared<op::Convolution>(data, filter);
+  auto bias = op::Constant::create(
+      element::f32, out_shape,
+      std::vector<float>(shape_size(out_shape), -0.5));
+  auto add = std::make_shared<op::Add>(conv, bias);
+  auto relu = std::make_shared<op::Relu>(add);
+  auto f = std::make_shared<Function>(relu, ParameterVector{data});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {data->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::vector<float> inputs;
+  for (size_t i = 0; i < shape_size(data_shape); ++i) {
+    inputs.emplace_back(static_cast<float>(i % 5) - 2);
+  }
+
+  // Runs the graph untiled, as a baseline, then with relu pipelined per
+  // output tile
+  std::vector<std::vector<float>> results(2);
+  std::vector<std::chrono::microseconds> overlaps(2);
+  for (size_t run = 0; run < 2; ++run) {
+    if (run == 1) {
+      setenv("NGRAPH_HE_PIPELINE_TILES", "1", 1);
+    }
+    auto t_dummy = he_backend->create_plain_tensor(element::f32, data_shape);
+    auto t_result = he_backend->create_cipher_tensor(element::f32, out_shape);
+    copy_data(t_dummy, std::vector<float>(shape_size(data_shape), 99));
+
+    std::chrono::microseconds client_busy{0};
+    auto client_thread = std::thread([&]() {
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {data->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      client_busy = he_client.busy_time();
+      results[run] =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    auto handle =
+        std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+    handle->call_with_validate({t_result}, {t_dummy});
+    client_thread.join();
+    unsetenv("NGRAPH_HE_PIPELINE_TILES");
+
+    auto stats = handle->relu_stats();
+    auto server_busy = stats.elapsed - stats.wait_time;
+    overlaps[run] = server_busy + client_busy - stats.elapsed;
+    NGRAPH_INFO << (run == 0 ? "Untiled" : "Tiled") << " relu: elapsed "
+                << stats.elapsed.count() << "us, server busy "
+                << server_busy.count() << "us, client busy "
+                << client_busy.count() << "us, overlap at least "
+                << overlaps[run].count() << "us";
+  }
+  EXPECT_GT(overlaps[1].count(), 0);
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(f);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  auto int_a = int_backend->create_tensor(element::f32, data_shape);
+  copy_data(int_a, inputs);
+  int_handle->call_with_validate({int_result}, {int_a});
+  auto expected = read_vector<float>(int_result);
+
+  EXPECT_EQ(results[0].size(), shape_size(out_shape));
+  EXPECT_TRUE(test::all_close(results[1], results[0], 1e-3f));
+  EXPECT_TRUE(test::all_close(results[0], expected, 1e-3f));
+}
+
 }  // namespace ngraph::runtime::he
@@ -14,8 +14,11 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <string>
+#include <thread>
 
 #include "boost/asio.hpp"
 #include "gtest/gtest.h"
@@ -132,9 +135,10 @@ class MockClient {
     boost::asio::ip::tcp::resolver resolver(io_context);
     auto endpoints = resolver.resolve(hostname, std::to_string(port));
     auto client_callback = [this](const TCPMessage& message) {
-      m_message_count++;
+      // Handlers run concurrently on the client's worker threads
+      size_t message_count = ++m_message_count;
 
-      if (m_message_count < m_max_message_count) {
+      if (message_count < m_max_message_count) {
         for (size_t i = 0; i < m_max_message_count; ++i) {
           TCPMessage return_message(message);
           m_tcp_client->write_message(std::move(return_message));
@@ -151,7 +155,7 @@ class MockClient {
  private:
   std::unique_ptr<TCPClient> m_tcp_client;
 
-  size_t m_message_count{0};
+  std::atomic<size_t> m_message_count{0};
   size_t m_max_message_count;
 };
 
@@ -185,4 +189,47 @@ TEST(tcp_client, non_empty_message_queue) {
   client_thread.join();
 }
 
+TEST(tcp_client, write_to_closed_peer) {
+  size_t port{34001};
+  boost::asio::io_context server_io_context;
+  boost::asio::ip::tcp::acceptor acceptor(
+      server_io_context,
+      boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port));
+
+  boost::asio::io_context io_context;
+  boost::asio::ip::tcp::resolver resolver(io_context);
+  auto endpoints = resolver.resolve("localhost", std::to_string(port));
+  TCPClient client(io_context, endpoints, [](const TCPMessage&) {});
+  auto io_guard = boost::asio::make_work_guard(io_context);
+  std::thread io_thread([&]() {
+    try {
+      io_context.run();
+    } catch (const std::exception& e) {
+      NGRAPH_HE_LOG(1) << "Client I/O error " << e.what();
+    }
+  });
+
+  // The peer closes the connection right away
+  acceptor.accept().close();
+  client.wait_until_connected();
+
+  // Writes eventually fail, instead of leaving the queue waiting forever
+  pb::TCPMessage proto_msg;
+  proto_msg.mutable_function()->set_function(std::string(1 << 20, 'a'));
+  bool write_failed = false;
+  for (size_t i = 0; i < 100 && !write_failed; ++i) {
+    try {
+      client.write_message(TCPMessage(pb::TCPMessage(proto_msg)));
+      client.wait_until_written();
+    } catch (const std::exception&) {
+      write_failed = true;
+    }
+  }
+  EXPECT_TRUE(write_failed);
+
+  io_guard.reset();
+  io_context.stop();
+  io_thread.join();
+}
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,112 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ngraph/check.hpp"
+#include "tcp/tcp_flow_control.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(tcp_flow_control, window) {
+  TCPFlowControl::Config config;
+  config.initial_batch_bytes = 10;
+  config.min_batch_bytes = 1;
+  config.max_batch_bytes = 100;
+  config.max_in_flight_bytes = 20;
+  TCPFlowControl flow_control(config);
+
+  EXPECT_EQ(flow_control.batch_bytes(), 10);
+  EXPECT_EQ(flow_control.wait_for_capacity(), 20);
+  flow_control.on_send(0, 10, 1);
+  EXPECT_EQ(flow_control.wait_for_capacity(), 10);
+  flow_control.on_send(1, 10, 1);
+
+  std::atomic<bool> has_capacity{false};
+  std::thread sender([&]() {
+    flow_control.wait_for_capacity();
+    has_capacity = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(has_capacity);
+
+  flow_control.on_reply(1);
+  sender.join();
+  EXPECT_TRUE(has_capacity);
+  EXPECT_EQ(flow_control.done_element_count(), 1);
+
+  EXPECT_ANY_THROW(flow_control.on_reply(1));
+  EXPECT_ANY_THROW(flow_control.on_send(0, 10, 1));
+  EXPECT_ANY_THROW(flow_control.reset());
+}
+
+TEST(tcp_flow_control, adapt_batch_size) {
+  TCPFlowControl::Config config;
+  config.initial_batch_bytes = 1000;
+  config.min_batch_bytes = 10;
+  config.max_batch_bytes = 1000 * 1000;
+  config.target_batch_duration = std::chrono::milliseconds(100);
+  TCPFlowControl flow_control(config);
+
+  // Slow client: 1000 bytes per ~20ms, i.e. at most 50 kB/s
+  for (size_t batch_id = 0; batch_id < 4; ++batch_id) {
+    flow_control.on_send(batch_id, 1000, 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    flow_control.on_reply(batch_id);
+  }
+  EXPECT_LE(flow_control.batch_bytes(), 5000);
+  EXPECT_GE(flow_control.batch_bytes(), config.min_batch_bytes);
+
+  auto stats = flow_control.stats();
+  EXPECT_EQ(stats.batch_count, 4);
+  EXPECT_EQ(stats.element_count, 40);
+  EXPECT_EQ(stats.bytes_sent, 4000);
+  EXPECT_GT(stats.throughput, 0);
+  EXPECT_GE(stats.elapsed.count(), 80 * 1000);
+
+  // Fast client: replies immediately, so the batch size grows to the maximum
+  flow_control.reset();
+  for (size_t batch_id = 0; batch_id < 4; ++batch_id) {
+    flow_control.on_send(batch_id, 1000 * 1000, 10);
+    flow_control.on_reply(batch_id);
+  }
+  EXPECT_EQ(flow_control.batch_bytes(), config.max_batch_bytes);
+}
+
+TEST(tcp_flow_control, wait_until_done) {
+  TCPFlowControl flow_control;
+  flow_control.reset();
+  flow_control.wait_until_done();
+
+  const size_t batch_count = 100;
+  for (size_t batch_id = 0; batch_id < batch_count; ++batch_id) {
+    flow_control.on_send(batch_id, 1, 2);
+  }
+  std::thread replier([&]() {
+    for (size_t batch_id = 0; batch_id < batch_count; ++batch_id) {
+      flow_control.on_reply(batch_count - 1 - batch_id);
+    }
+  });
+  flow_control.wait_until_done();
+  EXPECT_EQ(flow_control.done_element_count(), 2 * batch_count);
+  replier.join();
+  flow_control.reset();
+}
+
+}  // namespace ngraph::runtime::he
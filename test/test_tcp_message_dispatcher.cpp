@@ -0,0 +1,201 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "protos/message.pb.h"
+#include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_dispatcher.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+TCPMessage::data_buffer packed_function_message(const std::string& function) {
+  pb::TCPMessage proto_msg;
+  proto_msg.mutable_function()->set_function(function);
+  TCPMessage message(std::move(proto_msg));
+  TCPMessage::data_buffer buffer;
+  message.pack(buffer);
+  return buffer;
+}
+}  // namespace
+
+TEST(tcp_message_dispatcher, dispatch_all) {
+  size_t message_count = 100;
+  std::atomic<size_t> handled_count{0};
+  std::mutex mtx;
+  std::condition_variable cond;
+
+  TCPMessageDispatcher dispatcher(
+      [&](const TCPMessage& message) {
+        EXPECT_EQ(message.proto_message()->function().function(), "123");
+        std::lock_guard<std::mutex> guard(mtx);
+        handled_count++;
+        cond.notify_all();
+      },
+      4, message_count);
+  EXPECT_EQ(dispatcher.worker_count(), 4);
+
+  for (size_t i = 0; i < message_count; ++i) {
+    EXPECT_TRUE(
+        dispatcher.push(packed_function_message("123"), nullptr, nullptr));
+  }
+  std::unique_lock<std::mutex> mlock(mtx);
+  cond.wait_for(mlock, std::chrono::seconds(10),
+                [&]() { return handled_count == message_count; });
+  EXPECT_EQ(handled_count, message_count);
+}
+
+TEST(tcp_message_dispatcher, pause_when_full) {
+  std::mutex mtx;
+  std::condition_variable cond;
+  bool release_handler{false};
+  size_t handled_count{0};
+  std::atomic<bool> resumed{false};
+
+  TCPMessageDispatcher dispatcher(
+      [&](const TCPMessage& /* message */) {
+        std::unique_lock<std::mutex> mlock(mtx);
+        cond.wait(mlock, [&]() { return release_handler; });
+        handled_count++;
+        cond.notify_all();
+      },
+      1, 1);
+
+  // First message is taken by the worker, which blocks in the handler
+  EXPECT_TRUE(
+      dispatcher.push(packed_function_message("0"), nullptr, nullptr));
+  while (dispatcher.queued_message_count() != 0) {
+    std::this_thread::yield();
+  }
+  // Second message fills the queue, third is parked
+  EXPECT_TRUE(
+      dispatcher.push(packed_function_message("1"), nullptr, nullptr));
+  EXPECT_FALSE(dispatcher.push(packed_function_message("2"), nullptr,
+                               [&]() { resumed = true; }));
+  EXPECT_FALSE(resumed);
+
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    release_handler = true;
+    cond.notify_all();
+  }
+  std::unique_lock<std::mutex> mlock(mtx);
+  cond.wait_for(mlock, std::chrono::seconds(10),
+                [&]() { return handled_count == 3; });
+  EXPECT_EQ(handled_count, 3);
+  EXPECT_TRUE(resumed);
+}
+
+TEST(tcp_message_dispatcher, keep_alive) {
+  std::mutex mtx;
+  std::condition_variable cond;
+  bool handled{false};
+
+  auto keep_alive = std::make_shared<int>(0);
+  std::weak_ptr<int> weak_keep_alive = keep_alive;
+
+  auto dispatcher = std::make_unique<TCPMessageDispatcher>(
+      [&](const TCPMessage& /* message */) {
+        // Still held while the handler runs
+        EXPECT_FALSE(weak_keep_alive.expired());
+        std::lock_guard<std::mutex> guard(mtx);
+        handled = true;
+        cond.notify_all();
+      },
+      1);
+
+  EXPECT_TRUE(dispatcher->push(packed_function_message("123"),
+                               std::move(keep_alive), nullptr));
+  {
+    std::unique_lock<std::mutex> mlock(mtx);
+    cond.wait_for(mlock, std::chrono::seconds(10), [&]() { return handled; });
+  }
+  EXPECT_TRUE(handled);
+
+  // Joins the worker
+  dispatcher.reset();
+  EXPECT_TRUE(weak_keep_alive.expired());
+}
+
+TEST(tcp_message_dispatcher, handler_error) {
+  std::mutex mtx;
+  std::condition_variable cond;
+  bool release_handler{false};
+  size_t handled_count{0};
+
+  TCPMessageDispatcher dispatcher(
+      [&](const TCPMessage& message) {
+        {
+          std::unique_lock<std::mutex> mlock(mtx);
+          cond.wait(mlock, [&]() { return release_handler; });
+          handled_count++;
+          cond.notify_all();
+        }
+        if (message.proto_message()->function().function() == "throw") {
+          throw std::runtime_error("handler error");
+        }
+      },
+      1);
+
+  // Both messages are queued before the first one fails
+  EXPECT_TRUE(
+      dispatcher.push(packed_function_message("throw"), nullptr, nullptr));
+  EXPECT_TRUE(dispatcher.push(packed_function_message("0"), nullptr, nullptr));
+  {
+    std::unique_lock<std::mutex> mlock(mtx);
+    release_handler = true;
+    cond.notify_all();
+    // The worker keeps handling messages after an error
+    cond.wait_for(mlock, std::chrono::seconds(10),
+                  [&]() { return handled_count == 2; });
+  }
+  EXPECT_EQ(handled_count, 2);
+
+  // The error is rethrown once, by the next push on the caller's thread
+  EXPECT_THROW(
+      dispatcher.push(packed_function_message("0"), nullptr, nullptr),
+      std::runtime_error);
+  EXPECT_NO_THROW(dispatcher.rethrow_error());
+
+  // With an error handler, the error is handed to it instead
+  std::exception_ptr handled_error;
+  dispatcher.set_error_handler([&](std::exception_ptr error) {
+    std::lock_guard<std::mutex> guard(mtx);
+    handled_error = std::move(error);
+    cond.notify_all();
+  });
+  EXPECT_TRUE(
+      dispatcher.push(packed_function_message("throw"), nullptr, nullptr));
+  {
+    std::unique_lock<std::mutex> mlock(mtx);
+    cond.wait_for(mlock, std::chrono::seconds(10),
+                  [&]() { return handled_error != nullptr; });
+  }
+  ASSERT_NE(handled_error, nullptr);
+  EXPECT_THROW(std::rethrow_exception(handled_error), std::runtime_error);
+  EXPECT_NO_THROW(dispatcher.rethrow_error());
+}
+
+}  // namespace ngraph::runtime::he
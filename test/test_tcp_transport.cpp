@@ -0,0 +1,387 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "gtest/gtest.h"
+#include "ngraph/check.hpp"
+#include "protos/message.pb.h"
+#include "tcp/tcp_client.hpp"
+#include "tcp/tcp_message.hpp"
+#include "tcp/tcp_session.hpp"
+#include "tcp/tcp_shared_memory.hpp"
+#include "tcp/tcp_transport.hpp"
+#include "tcp/tcp_write_queue.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+TCPMessage function_message(const std::string& function) {
+  pb::TCPMessage proto_msg;
+  pb::Function f;
+  f.set_function(function);
+  *proto_msg.mutable_function() = f;
+  return TCPMessage(std::move(proto_msg));
+}
+
+std::string function_of(const TCPMessage& message) {
+  return message.proto_message()->function().function();
+}
+
+// Server echoing every message back to the client over the given transport.
+// Accepts connection_count connections, one after the other, whose first
+// message must pass handshake_check, if given. With share_channel, the first
+// message of each further connection attaches it to the shared-memory
+// channel of the first connection
+class EchoServer {
+ public:
+  explicit EchoServer(
+      const TransportAddress& address, size_t connection_count = 1,
+      std::function<bool(const TCPMessage&)> handshake_check = nullptr,
+      bool share_channel = false)
+      : m_address(address),
+        m_handshake_check(std::move(handshake_check)),
+        m_share_channel(share_channel) {
+    if (address.is_local()) {
+      std::remove(address.path().c_str());
+    }
+    m_acceptor = std::make_unique<TransportAcceptor>(
+        m_io_context, address.resolve(m_io_context).front());
+    accept(connection_count);
+    m_thread = std::thread([this]() { m_io_context.run(); });
+  }
+
+  ~EchoServer() {
+    m_thread.join();
+    m_acceptor->close();
+  }
+
+ private:
+  void accept(size_t remaining) {
+    m_acceptor->async_accept([this, remaining](boost::system::error_code ec,
+                                               TransportSocket socket) {
+      ASSERT_FALSE(ec) << ec.message();
+      auto weak_session = std::make_shared<std::weak_ptr<TCPSession>>();
+      auto echo = [weak_session](const TCPMessage& message) {
+        weak_session->lock()->write_message(
+            function_message(function_of(message)));
+      };
+      // A single worker preserves the message order
+      auto session = std::make_shared<TCPSession>(std::move(socket), echo, 1,
+                                                  m_address.type());
+      *weak_session = session;
+      if (m_handshake_check) {
+        session->set_handshake_check(m_handshake_check);
+      } else if (m_share_channel && !m_sessions.empty()) {
+        session->set_handshake_check(
+            [first = m_sessions.front(),
+             weak_session = std::weak_ptr<TCPSession>(session)](
+                const TCPMessage& /* message */) {
+              weak_session.lock()->set_channel(first->channel());
+              return true;
+            });
+      }
+      session->start();
+      m_sessions.emplace_back(session);
+      if (remaining > 1) {
+        accept(remaining - 1);
+      }
+    });
+  }
+
+  boost::asio::io_context m_io_context;
+  TransportAddress m_address;
+  std::function<bool(const TCPMessage&)> m_handshake_check;
+  bool m_share_channel;
+  std::unique_ptr<TransportAcceptor> m_acceptor;
+  std::vector<std::shared_ptr<TCPSession>> m_sessions;
+  std::thread m_thread;
+};
+
+// Sends messages of increasing size and checks every echo arrives in order
+void check_echo(
+    const std::string& uri, size_t message_count,
+    size_t ring_capacity = SharedMemoryChannel::default_ring_capacity) {
+  auto address = TransportAddress::parse(uri);
+  EchoServer server(address);
+
+  std::vector<std::string> functions;
+  for (size_t i = 0; i < message_count; ++i) {
+    functions.emplace_back(std::string(i * 1000, 'a') + std::to_string(i));
+  }
+
+  std::mutex mutex;
+  std::vector<std::string> received;
+  // Declared first, since the client's socket is destroyed before it
+  boost::asio::io_context io_context;
+  std::unique_ptr<TCPClient> client;
+  auto handler = [&](const TCPMessage& message) {
+    std::lock_guard<std::mutex> guard(mutex);
+    received.emplace_back(function_of(message));
+    if (received.size() == message_count) {
+      client->close();
+    }
+  };
+  client = std::make_unique<TCPClient>(io_context, address, handler, 1,
+                                       ring_capacity);
+  for (const auto& function : functions) {
+    client->write_message(function_message(function));
+  }
+  io_context.run();
+  EXPECT_EQ(received, functions);
+}
+}  // namespace
+
+TEST(tcp_transport, parse) {
+  auto tcp = TransportAddress::parse("tcp://localhost:34000");
+  EXPECT_EQ(tcp.type(), TransportType::tcp);
+  EXPECT_EQ(tcp.hostname(), "localhost");
+  EXPECT_EQ(tcp.port(), 34000);
+  EXPECT_FALSE(tcp.is_local());
+  EXPECT_EQ(tcp.uri(), "tcp://localhost:34000");
+
+  auto ipv6 = TransportAddress::parse("tcp://[::1]:34000");
+  EXPECT_EQ(ipv6.hostname(), "::1");
+  EXPECT_EQ(ipv6.uri(), "tcp://[::1]:34000");
+
+  auto unix_socket = TransportAddress::parse("unix:///tmp/he.sock");
+  EXPECT_EQ(unix_socket.type(), TransportType::unix_socket);
+  EXPECT_EQ(unix_socket.path(), "/tmp/he.sock");
+  EXPECT_TRUE(unix_socket.is_local());
+  EXPECT_EQ(unix_socket.uri(), "unix:///tmp/he.sock");
+
+  auto shm = TransportAddress::parse("shm:///tmp/he.sock");
+  EXPECT_EQ(shm.type(), TransportType::shared_memory);
+  EXPECT_EQ(shm.path(), "/tmp/he.sock");
+
+  EXPECT_EQ(TransportAddress("localhost", 34001).uri(),
+            "tcp://localhost:34001");
+
+  EXPECT_ANY_THROW(TransportAddress::parse("localhost:34000"));
+  EXPECT_ANY_THROW(TransportAddress::parse("udp://localhost:34000"));
+  EXPECT_ANY_THROW(TransportAddress::parse("tcp://localhost"));
+  EXPECT_ANY_THROW(TransportAddress::parse("tcp://localhost:port"));
+  EXPECT_ANY_THROW(TransportAddress::parse("tcp://localhost:65536"));
+  EXPECT_ANY_THROW(TransportAddress::parse("unix://relative.sock"));
+}
+
+TEST(tcp_transport, shared_memory_ring) {
+  auto client = SharedMemoryChannel::create(64);
+  auto server = SharedMemoryChannel::open(client->name());
+  EXPECT_EQ(server->ring_capacity(), 64);
+  EXPECT_ANY_THROW(SharedMemoryChannel::open(client->name()));
+  EXPECT_ANY_THROW(SharedMemoryChannel::open("/etc/passwd"));
+
+  // Channel names outside the channel directory are rejected, even with the
+  // channel prefix
+  auto other = SharedMemoryChannel::create(64);
+  auto other_path = std::filesystem::path(other->name());
+  auto copy_path = std::filesystem::temp_directory_path() / "ngraph-he-copy";
+  if (other_path.parent_path() == copy_path.parent_path()) {
+    copy_path = std::filesystem::current_path() / "ngraph-he-copy";
+  }
+  std::filesystem::copy_file(other_path, copy_path,
+                             std::filesystem::copy_options::overwrite_existing);
+  EXPECT_ANY_THROW(SharedMemoryChannel::open(copy_path.string()));
+  EXPECT_ANY_THROW(SharedMemoryChannel::open(
+      (other_path.parent_path() / "sub" / ".." / other_path.filename())
+          .string()));
+  std::filesystem::remove(copy_path);
+  EXPECT_NO_THROW(SharedMemoryChannel::open(other->name()));
+
+  auto descriptor_of = [](const TCPWriteQueue::buffer_ptr& buffer) {
+    SharedMemoryChannel::Descriptor descriptor{};
+    std::memcpy(&descriptor, buffer->data(),
+                SharedMemoryChannel::descriptor_length);
+    return descriptor;
+  };
+  auto function_in = [&](const SharedMemoryChannel::View& view,
+                         const TCPWriteQueue::buffer_ptr& packed) {
+    TCPMessage message;
+    EXPECT_TRUE(message.unpack(view.get(), descriptor_of(packed).length));
+    return function_of(message);
+  };
+
+  // Two messages fit into a ring, but not three
+  auto a = function_message(std::string(40, 'a'));
+  auto b = function_message(std::string(40, 'b'));
+  auto c = function_message(std::string(200, 'c'));
+  auto d = function_message(std::string(40, 'd'));
+  size_t length = a.packed_size();
+  ASSERT_LE(2 * length, 128);
+  ASSERT_GT(3 * length, 128);
+
+  // Only the descriptors of a and b are written to the socket; c is too
+  // large for the ring, and d does not fit until a is released
+  auto client_channel = SharedMemoryChannel::create(128);
+  auto server_channel = SharedMemoryChannel::open(client_channel->name());
+  auto packed_a = client_channel->pack(a);
+  auto packed_b = client_channel->pack(b);
+  auto packed_c = client_channel->pack(c);
+  auto packed_d = client_channel->pack(d);
+  EXPECT_EQ(packed_a->size(), SharedMemoryChannel::descriptor_length);
+  EXPECT_EQ(packed_b->size(), SharedMemoryChannel::descriptor_length);
+  EXPECT_EQ(descriptor_of(packed_c).offset,
+            SharedMemoryChannel::inline_offset);
+  EXPECT_EQ(packed_c->size(),
+            SharedMemoryChannel::descriptor_length + c.packed_size());
+  EXPECT_EQ(descriptor_of(packed_d).offset,
+            SharedMemoryChannel::inline_offset);
+
+  // Views may be released in any order
+  auto view_a = server_channel->receive(descriptor_of(packed_a));
+  auto view_b = server_channel->receive(descriptor_of(packed_b));
+  EXPECT_ANY_THROW(server_channel->receive(descriptor_of(packed_b)));
+  EXPECT_EQ(function_in(view_a, packed_a), std::string(40, 'a'));
+  EXPECT_EQ(function_in(view_b, packed_b), std::string(40, 'b'));
+  const char* ring_start = view_a.get();
+  view_b.reset();
+  EXPECT_EQ(client_channel->pack(d)->size(),
+            SharedMemoryChannel::descriptor_length + length);
+  view_a.reset();
+  EXPECT_ANY_THROW(server_channel->receive(descriptor_of(packed_a)));
+
+  // Wraps around to the start of the ring, skipping its end
+  packed_d = client_channel->pack(d);
+  ASSERT_EQ(packed_d->size(), SharedMemoryChannel::descriptor_length);
+  EXPECT_EQ(descriptor_of(packed_d).offset, 2 * length);
+  auto view_d = server_channel->receive(descriptor_of(packed_d));
+  EXPECT_EQ(view_d.get(), ring_start);
+  EXPECT_EQ(function_in(view_d, packed_d), std::string(40, 'd'));
+
+  // Replies use the other ring, and outlive the channel they arrived on
+  auto reply = server_channel->pack(b);
+  auto view_reply = client_channel->receive(descriptor_of(reply));
+  client_channel.reset();
+  EXPECT_EQ(function_in(view_reply, reply), std::string(40, 'b'));
+}
+
+TEST(tcp_transport, handshake_check) {
+  auto address = TransportAddress::parse("tcp://localhost:34003");
+  EchoServer server(address, 2, [](const TCPMessage& message) {
+    return function_of(message) == "token";
+  });
+
+  // Runs a client which sends the given messages, and returns the echoes it
+  // received once the server closed the connection, or echoed all but the
+  // first message
+  auto run_client = [&](const std::vector<std::string>& functions) {
+    std::mutex mutex;
+    std::vector<std::string> received;
+    // Declared first, since the client's socket is destroyed before it
+    boost::asio::io_context io_context;
+    std::unique_ptr<TCPClient> client;
+    auto handler = [&](const TCPMessage& message) {
+      std::lock_guard<std::mutex> guard(mutex);
+      received.emplace_back(function_of(message));
+      if (received.size() + 1 == functions.size()) {
+        client->close();
+      }
+    };
+    client = std::make_unique<TCPClient>(io_context, address, handler, 1);
+    for (const auto& function : functions) {
+      client->write_message(function_message(function));
+    }
+    io_context.run();
+    return received;
+  };
+
+  // The first message is checked, but not handed to the message handler
+  EXPECT_TRUE(run_client({"wrong"}).empty());
+  EXPECT_EQ(run_client({"token", "a", "b"}),
+            (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(tcp_transport, echo_tcp) { check_echo("tcp://localhost:34002", 50); }
+
+TEST(tcp_transport, echo_unix_socket) {
+  check_echo("unix:///tmp/ngraph-he-test-unix.sock", 50);
+}
+
+TEST(tcp_transport, echo_shared_memory) {
+  check_echo("shm:///tmp/ngraph-he-test-shm.sock", 50);
+}
+
+// Messages which don't fit into the free space of the ring are written on the
+// socket
+TEST(tcp_transport, echo_shared_memory_small_ring) {
+  check_echo("shm:///tmp/ngraph-he-test-shm.sock", 50, 16 * 1024);
+}
+
+TEST(tcp_transport, shared_memory_shared_channel) {
+  auto address =
+      TransportAddress::parse("shm:///tmp/ngraph-he-test-shm-shared.sock");
+  EchoServer server(address, 2, nullptr, true);
+
+  std::vector<std::string> functions;
+  for (size_t i = 0; i < 20; ++i) {
+    functions.emplace_back(std::string(i * 1000, 'a') + std::to_string(i));
+  }
+
+  // Declared first, since the clients' sockets are destroyed before it
+  boost::asio::io_context io_context;
+  std::mutex mutex;
+  std::vector<std::vector<std::string>> received(2);
+  std::vector<std::unique_ptr<TCPClient>> clients(2);
+  auto make_handler = [&](size_t client_idx) {
+    return [&, client_idx](const TCPMessage& message) {
+      std::lock_guard<std::mutex> guard(mutex);
+      received[client_idx].emplace_back(function_of(message));
+      if (received[0].size() == functions.size() &&
+          received[1].size() == functions.size()) {
+        clients[0]->close();
+        clients[1]->close();
+      }
+    };
+  };
+  clients[0] = std::make_unique<TCPClient>(io_context, address,
+                                           make_handler(0), 1, 8 * 1024);
+  std::thread io_thread([&]() { io_context.run(); });
+  clients[0]->wait_until_connected();
+  EXPECT_NE(clients[0]->channel(), nullptr);
+
+  // The second connection sends no channel name, and its first message
+  // attaches it to the channel of the first connection
+  clients[1] =
+      std::make_unique<TCPClient>(io_context, address, make_handler(1), 1, 0);
+  clients[1]->wait_until_connected();
+  EXPECT_EQ(clients[1]->channel(), nullptr);
+  clients[1]->write_message(function_message("attach"));
+  clients[1]->wait_until_written();
+  clients[1]->set_channel(clients[0]->channel());
+
+  for (const auto& function : functions) {
+    clients[0]->write_message(function_message(function));
+    clients[1]->write_message(function_message(function));
+  }
+  io_thread.join();
+  EXPECT_EQ(received[0], functions);
+  EXPECT_EQ(received[1], functions);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "protos/message.pb.h"
+#include "tcp/tcp_message.hpp"
+#include "tcp/tcp_write_queue.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+TCPWriteQueue::buffer_ptr dummy_buffer(size_t size) {
+  return std::make_shared<TCPWriteQueue::data_buffer>(size);
+}
+}  // namespace
+
+TEST(tcp_write_queue, pack) {
+  pb::TCPMessage proto_msg;
+  proto_msg.mutable_function()->set_function("123");
+  TCPMessage message(std::move(proto_msg));
+
+  auto buffer = TCPWriteQueue::pack(message);
+  EXPECT_EQ(TCPMessage::decode_header(*buffer),
+            buffer->size() - TCPMessage::header_length);
+
+  TCPMessage unpacked;
+  unpacked.unpack(*buffer);
+  EXPECT_EQ(unpacked.proto_message()->function().function(), "123");
+}
+
+TEST(tcp_write_queue, gather) {
+  TCPWriteQueue queue(3, 100);
+  EXPECT_FALSE(queue.is_writing());
+
+  // Only the first push starts a write
+  EXPECT_TRUE(queue.push(dummy_buffer(10)));
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_FALSE(queue.push(dummy_buffer(10)));
+  }
+  EXPECT_TRUE(queue.is_writing());
+  EXPECT_EQ(queue.pending_message_count(), 5);
+
+  // Limited by message count
+  auto batch = queue.take_batch();
+  EXPECT_EQ(batch.size(), 3);
+  queue.finish_batch(batch.size());
+
+  batch = queue.take_batch();
+  EXPECT_EQ(batch.size(), 2);
+  queue.finish_batch(batch.size());
+  EXPECT_TRUE(queue.is_writing());
+
+  batch = queue.take_batch();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_FALSE(queue.is_writing());
+
+  // Limited by bytes, but a single large message is still written
+  EXPECT_TRUE(queue.push(dummy_buffer(200)));
+  EXPECT_FALSE(queue.push(dummy_buffer(10)));
+  batch = queue.take_batch();
+  EXPECT_EQ(batch.size(), 1);
+  queue.finish_batch(batch.size());
+  batch = queue.take_batch();
+  EXPECT_EQ(batch.size(), 1);
+  queue.finish_batch(batch.size());
+  EXPECT_TRUE(queue.take_batch().empty());
+}
+
+TEST(tcp_write_queue, concurrent_producers) {
+  TCPWriteQueue queue;
+  size_t producer_count = 4;
+  size_t messages_per_producer = 1000;
+
+  std::vector<std::thread> producers;
+  std::atomic<size_t> write_starts{0};
+  for (size_t i = 0; i < producer_count; ++i) {
+    producers.emplace_back([&]() {
+      for (size_t j = 0; j < messages_per_producer; ++j) {
+        if (queue.push(dummy_buffer(1))) {
+          write_starts++;
+        }
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(write_starts, 1);
+
+  size_t written_count = 0;
+  for (auto batch = queue.take_batch(); !batch.empty();
+       batch = queue.take_batch()) {
+    written_count += batch.size();
+    queue.finish_batch(batch.size());
+  }
+  EXPECT_EQ(written_count, producer_count * messages_per_producer);
+  queue.wait_until_written();
+}
+
+TEST(tcp_write_queue, fail) {
+  TCPWriteQueue queue;
+  EXPECT_TRUE(queue.push(dummy_buffer(10)));
+  EXPECT_FALSE(queue.push(dummy_buffer(10)));
+  auto batch = queue.take_batch();
+  EXPECT_EQ(batch.size(), 2);
+
+  std::atomic<bool> waiter_threw{false};
+  std::thread waiter([&]() {
+    try {
+      queue.wait_until_written();
+    } catch (const std::exception&) {
+      waiter_threw = true;
+    }
+  });
+
+  // Wakes the waiter, and rejects further messages
+  queue.fail("Broken pipe");
+  waiter.join();
+  EXPECT_TRUE(waiter_threw);
+  EXPECT_TRUE(queue.failed());
+  EXPECT_FALSE(queue.is_writing());
+  EXPECT_EQ(queue.pending_message_count(), 0);
+  EXPECT_ANY_THROW(queue.push(dummy_buffer(10)));
+  EXPECT_ANY_THROW(queue.wait_until_written());
+}
+
+}  // namespace ngraph::runtime::he
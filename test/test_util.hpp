@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "he_op_annotations.hpp"
+#include "he_plaintext.hpp"
 #include "he_tensor.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/descriptor/layout/tensor_layout.hpp"
@@ -60,6 +61,18 @@ bool all_close(const std::vector<T>& a, const std::vector<T>& b,
   return close;
 }
 
+inline bool all_close(const HEPlaintext& a, const HEPlaintext& b,
+                      double atol = 1e-3) {
+  bool close = true;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::abs(a[i] - b[i]) > atol) {
+      NGRAPH_INFO << a[i] << " is not close to " << b[i] << " at index " << i;
+      close = false;
+    }
+  }
+  return close;
+}
+
 inline std::shared_ptr<HEOpAnnotations> annotation_from_flags(
     const bool from_client, const bool encrypted, const bool packed) {
   return std::make_shared<HEOpAnnotations>(from_client, encrypted, packed);